@@ -13,6 +13,8 @@ TEMPLATE = app
 CXXFLAGS += -g3
 CFLAGS += -g3
 LIBS += -ldl
+# the float32 loops of the built-in inference runtime (CSIInferenceModel) are written to be vectorized by the compiler
+QMAKE_CXXFLAGS += -ftree-vectorize
 # The following define makes your compiler emit warnings if you use
 # any feature of Qt which has been marked as deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
@@ -33,7 +35,7 @@ HEADERS += \
 FORMS += \
         src/*.ui
 		
-QMAKE_PRE_LINK += cd src/filters && make && cd -
+QMAKE_PRE_LINK += cd src/filters && make && cd - && cd src/classifiers && make && cd -
 RESOURCES += \
     src/csiguiresources.qrc
 
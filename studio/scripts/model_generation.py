@@ -9,6 +9,7 @@ from keras.layers import Conv1D, Dropout, Flatten, Dense, MaxPool1D
 from sklearn.metrics import confusion_matrix, precision_recall_fscore_support, accuracy_score
 from sklearn.model_selection import train_test_split
 from sklearn.metrics import mean_squared_error
+from wirelesseye_model import export_model
 
 
 def get_windows(df: pd.DataFrame, window_size, sampling_frequency: int, overlap):
@@ -198,3 +199,6 @@ if __name__ == '__main__':
 
     # Save model
     model.save('model.h5')
+
+    # Export the model for the built-in inference runtime of WirelessEye. WirelessEye checks its outputs for a test window.
+    export_model(model, 'model.wem', X_test[0])
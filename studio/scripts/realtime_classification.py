@@ -5,6 +5,9 @@ import sys
 import tensorflow as tf
 from datetime import datetime
 from multiprocessing.pool import ThreadPool
+import numpy as np
+from wirelesseye_shm import SharedMemoryReader
+from wirelesseye_windows import read_windows, ENV_EXPORT
 
 warnings.filterwarnings('ignore')  # Suppress tensorflow logging
 os.environ['TF_CPP_MIN_LOG_LEVEL'] = '3'  # Suppress errors log
@@ -46,6 +49,26 @@ if __name__ == '__main__':
     sys.stdout.buffer.write(bytes([0xca, 0xff, 0xee]))  # magic number
     sys.stdout.flush()
 
+    # Windowed live export: WirelessEye passes complete windows of frames x subcarriers
+    # The results start with 'R' and the time of the last frame, such that WirelessEye can measure the latency
+    if os.environ.get(ENV_EXPORT) == 'windows':
+        for mac, tensor, info in read_windows():
+            async_result = pool.apply_async(classify, (model, tensor[0:1]))
+            print('R %d %s' % (info['end'], async_result.get()))
+            sys.stdout.flush()
+
+    # Binary live export: read complete frames from shared memory instead of parsing text
+    if os.environ.get(ENV_EXPORT) == 'shm':
+        window = []
+        for frame in SharedMemoryReader():
+            window.append(frame['amplitude'][:frame['nSubCarriers']])
+            if len(window) == time_window_size:
+                async_result = pool.apply_async(classify, (model, np.array([window])))
+                frame_time = int(frame['tv_sec']) * 10**9 + int(frame['tv_nsec'])
+                print('R %d %s' % (frame_time, async_result.get()))
+                sys.stdout.flush()
+                window = []
+
     while True:
         # Keep reading from stdin
         buffer += sys.stdin.readline()
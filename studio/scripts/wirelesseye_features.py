@@ -0,0 +1,46 @@
+import struct
+import sys
+import numpy as np
+
+ENV_EXPORT = 'WIRELESSEYE_EXPORT'
+MAGIC = b'WEFT'
+HEADER = struct.Struct('<4sI6sHIIIIQQ')
+FEATURE_NAMES = ['mean', 'variance', 'min', 'max', 'energy']
+
+
+def read_features(stream=None):
+    """
+    This generator reads the features WirelessEye writes to the standard input of a classifier if 'Features via stdin'
+    is selected (see fileFormats.pdf).
+
+    :param stream: A binary stream, by default the standard input
+    :return: Tuples (mac, features, info) for each message. mac is the MAC address (e.g., 'ca-ff-ee-0-0-1'), features is
+             a float32 array of shape channels x subcarriers x features (channel 0: amplitudes, channel 1: phases), whose
+             last axis holds the values named in FEATURE_NAMES followed by the magnitudes of the frequency bins 1...bins,
+             and info is a dictionary containing 'frames' (window length), 'bins', 'start' and 'end' (times of the first
+             and last frame of the window in ns since 1970)
+    """
+    if stream is None:
+        stream = sys.stdin.buffer
+    while True:
+        header = stream.read(HEADER.size)
+        if len(header) < HEADER.size:
+            return
+        magic, header_len, mac, bins, frames, subcarriers, channels, n_features, start, end = HEADER.unpack(header)
+        if magic != MAGIC:
+            raise ValueError('No features of WirelessEye')
+        stream.read(header_len - HEADER.size)
+        size = channels * subcarriers * n_features * 4
+        data = stream.read(size)
+        if len(data) < size:
+            return
+        features = np.frombuffer(data, dtype='<f4').reshape((channels, subcarriers, n_features))
+        yield '-'.join('%x' % b for b in mac), features, {'frames': frames, 'bins': bins, 'start': start, 'end': end}
+
+
+if __name__ == '__main__':
+    sys.stdout.buffer.write(bytes([0xca, 0xff, 0xee]))  # magic number
+    sys.stdout.flush()
+
+    for mac, features, info in read_features():
+        print('%s %s mean amplitude: %.2f' % (mac, features.shape, features[0, :, 0].mean()), file=sys.stderr)
@@ -0,0 +1,120 @@
+import struct
+import sys
+import numpy as np
+
+MAGIC = b'WEMD'
+VERSION = 1
+HEADER = struct.Struct('<4sIIIIIII')
+LAYER_HEADER = struct.Struct('<IIIIII')
+
+LAYER_DENSE = 0
+LAYER_CONV1D = 1
+LAYER_MAXPOOL1D = 2
+LAYER_FLATTEN = 3
+LAYER_LSTM = 4
+
+ACTIVATIONS = {'linear': 0, 'relu': 1, 'softmax': 2, 'sigmoid': 3, 'tanh': 4}
+
+
+def write_model(file_name, input_shape, layers, test_input=None, test_output=None):
+    """
+    This function writes a model file for the built-in inference runtime of WirelessEye (see fileFormats.pdf).
+
+    :param file_name: Name of the model file, which should end with '.wem'
+    :param input_shape: Tuple (steps, features) of the input, i.e., frames x subcarriers
+    :param layers: List of tuples (type, activation, params, weights), where params is a list of up to 3 integers and
+                   weights a list of arrays in the layout of Keras
+    :param test_input: An input of the shape input_shape, whose outputs are compared to test_output by WirelessEye
+    :param test_output: The outputs of the original model for test_input
+    """
+    steps, features = input_shape
+    n_outputs = steps * features
+    for layer_type, _, params, _ in layers:
+        if layer_type in (LAYER_DENSE, LAYER_LSTM):
+            features = params[0]
+            if layer_type == LAYER_LSTM and not params[1]:
+                steps = 1
+        elif layer_type in (LAYER_CONV1D, LAYER_MAXPOOL1D):
+            kernel_size, stride = params[1:3] if layer_type == LAYER_CONV1D else params[0:2]
+            steps = (steps - kernel_size) // stride + 1
+            features = params[0] if layer_type == LAYER_CONV1D else features
+        elif layer_type == LAYER_FLATTEN:
+            steps, features = 1, steps * features
+        n_outputs = steps * features
+    has_test = test_input is not None and test_output is not None
+
+    with open(file_name, 'wb') as f:
+        f.write(HEADER.pack(MAGIC, VERSION, HEADER.size, len(layers), input_shape[0], input_shape[1], n_outputs,
+                            1 if has_test else 0))
+        for layer_type, activation, params, weights in layers:
+            params = (list(params) + [0, 0, 0])[0:3]
+            f.write(LAYER_HEADER.pack(layer_type, activation, params[0], params[1], params[2], 0))
+            for w in weights:
+                f.write(np.ascontiguousarray(w, dtype='<f4').tobytes())
+        if has_test:
+            f.write(np.ascontiguousarray(test_input, dtype='<f4').tobytes())
+            f.write(np.ascontiguousarray(test_output, dtype='<f4').tobytes())
+
+
+def export_model(model, file_name, test_input=None):
+    """
+    This function exports a Keras model created by model_generation.py to a model file for the built-in inference
+    runtime of WirelessEye. Supported layers: Dense, Conv1D and MaxPool1D (padding 'valid'), Flatten, Dropout and LSTM.
+
+    :param model: The Keras model
+    :param file_name: Name of the model file, which should end with '.wem'
+    :param test_input: A single input of the model, e.g., a window of the test data. If it is given, its outputs are
+                       stored in the file and WirelessEye checks if it computes the same outputs.
+    """
+    layers = []
+    for layer in model.layers:
+        name = layer.__class__.__name__
+        config = layer.get_config()
+        weights = layer.get_weights()
+        activation = ACTIVATIONS.get(config.get('activation', 'linear'))
+        if activation is None:
+            raise ValueError('%s: unsupported activation %s' % (layer.name, config['activation']))
+        if config.get('padding', 'valid') != 'valid':
+            raise ValueError('%s: only padding \'valid\' is supported' % layer.name)
+        if not config.get('use_bias', True):
+            n_bias = config.get('units', config.get('filters', 0)) * (4 if name == 'LSTM' else 1)
+            weights = weights + [np.zeros(n_bias, dtype='float32')]
+        if name == 'Dense':
+            layers.append((LAYER_DENSE, activation, [config['units']], weights))
+        elif name == 'Conv1D':
+            if config['dilation_rate'][0] != 1:
+                raise ValueError('%s: dilation is not supported' % layer.name)
+            layers.append((LAYER_CONV1D, activation, [config['filters'], config['kernel_size'][0], config['strides'][0]],
+                           weights))
+        elif name in ('MaxPool1D', 'MaxPooling1D'):
+            pool_size = config['pool_size'][0]
+            strides = config['strides'][0] if config['strides'] is not None else pool_size
+            layers.append((LAYER_MAXPOOL1D, 0, [pool_size, strides], []))
+        elif name == 'Flatten':
+            layers.append((LAYER_FLATTEN, 0, [], []))
+        elif name == 'Dropout':
+            continue
+        elif name == 'LSTM':
+            if config['activation'] != 'tanh' or config['recurrent_activation'] != 'sigmoid':
+                raise ValueError('%s: only the activations tanh and sigmoid are supported' % layer.name)
+            layers.append((LAYER_LSTM, 0, [config['units'], 1 if config['return_sequences'] else 0], weights))
+        else:
+            raise ValueError('%s: unsupported layer %s' % (layer.name, name))
+
+    input_shape = tuple(model.input_shape[1:3])
+    test_output = None
+    if test_input is not None:
+        test_input = np.asarray(test_input, dtype='float32').reshape((1,) + input_shape)
+        test_output = model.predict(test_input)
+    write_model(file_name, input_shape, layers, test_input, test_output)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print('usage: %s model.h5 model.wem' % sys.argv[0], file=sys.stderr)
+        sys.exit(1)
+    import tensorflow as tf
+
+    keras_model = tf.keras.models.load_model(sys.argv[1])
+    shape = keras_model.input_shape[1:3]
+    export_model(keras_model, sys.argv[2], np.random.default_rng(0).normal(size=shape))
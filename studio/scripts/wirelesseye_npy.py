@@ -0,0 +1,47 @@
+import os
+import numpy as np
+
+COLUMNS = ['amplitude', 'phase', 'timestamp', 'rssi', 'seqNr']
+
+
+def load_recording(path, mmap_mode='r'):
+    """
+    This function loads a recording in the NumPy format of WirelessEye, i.e., a directory containing one subdirectory
+    of .npy files per MAC address. The arrays are mapped into memory instead of being read, unless mmap_mode is None.
+
+    :param path: The recording directory (ending with _npy)
+    :param mmap_mode: Passed to np.load, e.g. 'r' for read-only memory mapping or None to read the arrays into memory
+    :return: A dictionary mapping each MAC address (e.g., 'ca-ff-ee-0-0-1') to a dictionary of the arrays 'amplitude',
+             'phase' (float32, frames x subcarriers), 'timestamp' (int64 nanoseconds since 1970), 'rssi' (float32),
+             'seqNr' (uint16) and 'subcarriers' (uint16, the index of each column in the frames as captured)
+    """
+    recording = dict()
+    for mac in sorted(os.listdir(path)):
+        mac_dir = os.path.join(path, mac)
+        if not os.path.isdir(mac_dir):
+            continue
+        recording[mac] = {c: np.load(os.path.join(mac_dir, c + '.npy'), mmap_mode=mmap_mode) for c in COLUMNS}
+        # recordings of an export bandwidth do not contain the indices, their subcarriers are numbered from 0
+        subcarriers = os.path.join(mac_dir, 'subcarriers.npy')
+        if os.path.exists(subcarriers):
+            recording[mac]['subcarriers'] = np.load(subcarriers)
+        else:
+            recording[mac]['subcarriers'] = np.arange(recording[mac]['amplitude'].shape[1], dtype=np.uint16)
+    return recording
+
+
+def to_datetime(timestamps):
+    """
+    This function converts the timestamps of a recording to datetime64 values.
+
+    :param timestamps: The timestamp array of one MAC address
+    :return: The timestamps as datetime64[ns]
+    """
+    return np.asarray(timestamps).astype('datetime64[ns]')
+
+
+if __name__ == '__main__':
+    import sys
+
+    for mac, arrays in load_recording(sys.argv[1]).items():
+        print('%s: %d frames, %d subcarriers' % (mac, arrays['amplitude'].shape[0], arrays['amplitude'].shape[1]))
@@ -0,0 +1,92 @@
+import mmap
+import os
+import struct
+import numpy as np
+
+ENV_SHM_FD = 'WIRELESSEYE_SHM_FD'
+ENV_EVENTFD = 'WIRELESSEYE_EVENTFD'
+MAGIC = b'WifEyShm'
+HEADER = struct.Struct('<8sIIIIII')
+WRITE_COUNTER_OFFSET = 32
+
+
+def frame_dtype(max_subcarriers, slot_len):
+    """
+    This function returns the NumPy dtype of a slot of the binary live export of WirelessEye (see fileFormats.pdf).
+
+    :param max_subcarriers: Number of amplitudes and phases each slot has space for
+    :param slot_len: Size of each slot in bytes
+    :return: A structured dtype with the fields 'counter', 'tv_sec', 'tv_nsec', 'mac', 'seqNr', 'rssi', 'frame_control',
+             'nSubCarriers', 'amplitude' and 'phase'
+    """
+    return np.dtype({
+        'names': ['counter', 'tv_sec', 'tv_nsec', 'mac', 'seqNr', 'rssi', 'frame_control', 'nSubCarriers', 'amplitude',
+                  'phase'],
+        'formats': ['<u8', '<u8', '<u8', ('u1', 6), '<u2', '<f4', 'u1', '<u4', ('<f4', max_subcarriers),
+                    ('<f4', max_subcarriers)],
+        'offsets': [0, 8, 16, 24, 30, 32, 36, 40, 48, 48 + 4 * max_subcarriers],
+        'itemsize': slot_len})
+
+
+class SharedMemoryReader:
+    """
+    Reads the frames WirelessEye passes to a classifier via shared memory. The file descriptors are inherited from
+    WirelessEye and taken from the environment variables WIRELESSEYE_SHM_FD and WIRELESSEYE_EVENTFD.
+    Only frames received after the reader has been created are returned. Frames the reader was too slow for are counted
+    in the attribute lost.
+    """
+
+    def __init__(self, shm_fd=None, event_fd=None):
+        self.shm_fd = int(os.environ[ENV_SHM_FD]) if shm_fd is None else shm_fd
+        self.event_fd = int(os.environ[ENV_EVENTFD]) if event_fd is None else event_fd
+        self.mm = mmap.mmap(self.shm_fd, os.fstat(self.shm_fd).st_size, mmap.MAP_SHARED, mmap.PROT_READ)
+        magic, version, header_len, slot_len, n_slots, max_subcarriers, _ = HEADER.unpack_from(self.mm, 0)
+        if magic != MAGIC or version != 1:
+            raise ValueError('No binary live export of WirelessEye')
+        self.n_slots = n_slots
+        self.slots = np.frombuffer(self.mm, frame_dtype(max_subcarriers, slot_len), count=n_slots, offset=header_len)
+        self.next = self._write_counter()
+        self.lost = 0
+
+    def _write_counter(self):
+        return struct.unpack_from('<Q', self.mm, WRITE_COUNTER_OFFSET)[0]
+
+    def read(self):
+        """
+        Waits for new frames and returns them.
+
+        :return: A structured array (see frame_dtype) of all frames received since the previous call. Only the first
+                 nSubCarriers entries of 'amplitude' and 'phase' of each frame are valid.
+        """
+        end = self._write_counter()
+        while end <= self.next:
+            os.read(self.event_fd, 8)
+            end = self._write_counter()
+        if end - self.next > self.n_slots:
+            self.lost += end - self.next - self.n_slots
+            self.next = end - self.n_slots
+
+        expected = np.arange(self.next + 1, end + 1, dtype=np.uint64)
+        idx = (expected - 1) % self.n_slots
+        # a frame is valid if its slot has not been changed while it was copied
+        before = self.slots['counter'][idx]
+        frames = self.slots[idx]
+        after = self.slots['counter'][idx]
+        valid = (before == expected) & (after == expected)
+        self.lost += int(np.count_nonzero(~valid))
+        self.next = end
+        return frames[valid]
+
+    def __iter__(self):
+        while True:
+            for frame in self.read():
+                yield frame
+
+
+if __name__ == '__main__':
+    import sys
+
+    for frame in SharedMemoryReader():
+        n = frame['nSubCarriers']
+        print('%d.%09d %s %d %.1f %s' % (frame['tv_sec'], frame['tv_nsec'], '-'.join('%x' % b for b in frame['mac']),
+                                         frame['seqNr'], frame['rssi'], frame['amplitude'][:n]), file=sys.stderr)
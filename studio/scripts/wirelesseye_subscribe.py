@@ -0,0 +1,61 @@
+import io
+import socket
+import struct
+import sys
+import numpy as np
+
+from wirelesseye_features import read_features
+
+DEFAULT_PATH = '/tmp/wirelesseye.sock'
+MAGIC = b'WEPB'
+HEADER = struct.Struct('<4sIII')
+FRAME = struct.Struct('<QQQ6sHfB3sII')
+TOPICS = ['raw', 'filtered', 'features']
+
+
+def subscribe(topics=('filtered',), macs=(), path=DEFAULT_PATH):
+    """
+    This generator connects to the local publisher of WirelessEye (see fileFormats.pdf) and returns the messages of the
+    given topics.
+
+    :param topics: Names of the topics, any of TOPICS
+    :param macs: MAC addresses (e.g., 'ca:ff:ee:00:00:01') the messages are restricted to. Empty => all
+    :param path: Path of the socket
+    :return: Tuples (topic, mac, data, info) for each message. For frames, data is a float32 array of shape
+             2 x subcarriers (amplitudes, phases) and info is a dictionary containing 'counter', 'time' (ns since
+             1970), 'seqNr', 'rssi' and 'frame_control'. For features, data and info are as returned by read_features.
+    """
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(path)
+    line = ','.join(topics)
+    if len(macs) > 0:
+        line += ' ' + ','.join(macs)
+    sock.sendall((line + '\n').encode())
+    stream = sock.makefile('rb')
+    while True:
+        header = stream.read(HEADER.size)
+        if len(header) < HEADER.size:
+            return
+        magic, size, topic, _ = HEADER.unpack(header)
+        if magic != MAGIC:
+            raise ValueError('No message of WirelessEye')
+        data = stream.read(size - HEADER.size)
+        if len(data) < size - HEADER.size:
+            return
+        if TOPICS[topic] == 'features':
+            for mac, features, info in read_features(io.BytesIO(data)):
+                yield TOPICS[topic], mac, features, info
+        else:
+            counter, tv_sec, tv_nsec, mac, seq_nr, rssi, frame_control, _, subcarriers, _ = FRAME.unpack_from(data)
+            values = np.frombuffer(data, dtype='<f4', count=2 * subcarriers, offset=FRAME.size).reshape((2, subcarriers))
+            yield TOPICS[topic], '-'.join('%x' % b for b in mac), values, {
+                'counter': counter, 'time': tv_sec * 1000000000 + tv_nsec, 'seqNr': seq_nr, 'rssi': rssi,
+                'frame_control': frame_control}
+
+
+if __name__ == '__main__':
+    # usage: wirelesseye_subscribe.py [topics] [MAC addresses], e.g., wirelesseye_subscribe.py raw,features ca:ff:ee:00:00:01
+    topics = sys.argv[1].split(',') if len(sys.argv) > 1 else ['filtered']
+    macs = sys.argv[2].split(',') if len(sys.argv) > 2 else []
+    for topic, mac, data, info in subscribe(topics, macs):
+        print('%s %s %s mean amplitude: %.2f' % (topic, mac, data.shape, data[0].mean()))
@@ -0,0 +1,44 @@
+import struct
+import sys
+import numpy as np
+
+ENV_EXPORT = 'WIRELESSEYE_EXPORT'
+MAGIC = b'WEWN'
+HEADER = struct.Struct('<4sI6sHIIIIQQ')
+
+
+def read_windows(stream=None):
+    """
+    This generator reads the windows WirelessEye writes to the standard input of a classifier if 'Windows via stdin' is
+    selected (see fileFormats.pdf).
+
+    :param stream: A binary stream, by default the standard input
+    :return: Tuples (mac, tensor, info) for each window. mac is the MAC address (e.g., 'ca-ff-ee-0-0-1'), tensor is a
+             float32 array of shape channels x frames x subcarriers (channel 0: amplitudes, channel 1: phases) and info
+             is a dictionary containing 'filled' (number of replaced missing frames), 'start' and 'end' (times of the
+             first and last frame in ns since 1970)
+    """
+    if stream is None:
+        stream = sys.stdin.buffer
+    while True:
+        header = stream.read(HEADER.size)
+        if len(header) < HEADER.size:
+            return
+        magic, header_len, mac, filled, frames, subcarriers, channels, _, start, end = HEADER.unpack(header)
+        if magic != MAGIC:
+            raise ValueError('No window of WirelessEye')
+        stream.read(header_len - HEADER.size)
+        size = channels * frames * subcarriers * 4
+        data = stream.read(size)
+        if len(data) < size:
+            return
+        tensor = np.frombuffer(data, dtype='<f4').reshape((channels, frames, subcarriers))
+        yield '-'.join('%x' % b for b in mac), tensor, {'filled': filled, 'start': start, 'end': end}
+
+
+if __name__ == '__main__':
+    sys.stdout.buffer.write(bytes([0xca, 0xff, 0xee]))  # magic number
+    sys.stdout.flush()
+
+    for mac, tensor, info in read_windows():
+        print('%s %s filled: %d' % (mac, tensor.shape, info['filled']), file=sys.stderr)
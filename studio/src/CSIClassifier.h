@@ -0,0 +1,57 @@
+/*
+ * CSIClassifier.h
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSICLASSIFIER_H_
+#define CSICLASSIFIER_H_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+/**
+ * Data exchanged between WirelessEye and classifier plugins (".cci" files). See classifiers/sample_classifier.c.
+ * */
+
+#define CSI_CLASSIFIER_NAME_STLEN 100                   ///Maximum string length for the name of the classifier
+#define CSI_CLASSIFIER_MAX_RESULTS 64                   ///Maximum number of results a classifier plugin can return for one frame or window
+#define CSI_CLASSIFIER_EXTENSION ".cci"                 ///File extension of classifier plugins
+
+/**
+ * One output of a classifier plugin. A plugin can contain multiple classifiers, which are distinguished by classifID.
+ */
+struct CSIClassifierResult{
+  uint32_t classifID;                           ///Counting number of the classifier within the plugin
+  uint32_t classNo;                             ///Class it has identified
+  float certainty;                              ///The certainty of this classification, between 0 and 1
+};
+
+/**
+ * A window of consecutive frames of one sender, as assembled by WirelessEye (see CSIWindowAssembler.h)
+ */
+struct CSIClassifierWindow{
+  uint8_t MAC[6];                               ///MAC address of the sender
+  uint32_t nFilled;                             ///Number of frames of the window that replace missing frames
+  uint32_t nFrames;                             ///Number of frames
+  uint32_t nSubCarriers;                        ///Number of subcarriers
+  uint32_t nChannels;                           ///1: amplitudes only, 2: amplitudes and phases
+  uint64_t tStart;                              ///Time of the first frame in ns since 1970
+  uint64_t tEnd;                                ///Time of the last frame in ns since 1970
+  const float* tensor;                          ///nChannels x nFrames x nSubCarriers values (amplitudes, then phases if nChannels == 2)
+};
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* CSICLASSIFIER_H_ */
@@ -0,0 +1,183 @@
+/*
+ * CSIClassifierObj.cpp
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIClassifierObj.h"
+#include <stdio.h>
+#include <string.h>
+#include <dlfcn.h>
+
+CSIClassifierObj::CSIClassifierObj(){
+  strcpy(fileName, "");
+  strcpy(name, "");
+  do_handle = NULL;
+  initialized = false;
+  shapeWarned = false;
+  fptr_getName = NULL;
+  fptr_init = NULL;
+  fptr_finalize = NULL;
+  fptr_runFrame = NULL;
+  fptr_runWindow = NULL;
+}
+
+CSIClassifierObj::~CSIClassifierObj(){
+  unload();
+}
+
+bool CSIClassifierObj::load(const char* fileName){
+  unload();
+  strncpy(this->fileName, fileName, CSI_CLASSIFIER_PATH_STLEN - 1);
+  this->fileName[CSI_CLASSIFIER_PATH_STLEN - 1] = '\0';
+  shapeWarned = false;
+
+  //model for the built-in inference runtime
+  uint32_t len = strlen(this->fileName);
+  if((len >= strlen(CSI_MODEL_EXTENSION))&&(strcmp(this->fileName + len - strlen(CSI_MODEL_EXTENSION), CSI_MODEL_EXTENSION) == 0)){
+    if(!model.load(this->fileName)){
+      return false;
+    }
+    const char* baseName = strrchr(this->fileName, '/');
+    snprintf(name, CSI_CLASSIFIER_NAME_STLEN, "%s", (baseName != NULL) ? baseName + 1 : this->fileName);
+    return true;
+  }
+
+  do_handle = dlopen(this->fileName, RTLD_NOW);
+  if(do_handle == NULL){
+    fprintf(stderr, "Error loading classifier plugin: %s\n", dlerror());
+    return false;
+  }
+
+  //load pointers
+  fptr_getName = (void (*)(char*)) dlsym(do_handle, "classifier_getName");
+  if(fptr_getName == NULL){
+    printf("Could not load classifier_getName() from library: %s\n", dlerror());
+    unload();
+    return false;
+  }
+  fptr_init = (int (*)(const char*)) dlsym(do_handle, "classifier_init");
+  if(fptr_init == NULL){
+    printf("Could not load classifier_init() from library: %s\n", dlerror());
+    unload();
+    return false;
+  }
+  fptr_finalize = (void (*)()) dlsym(do_handle, "classifier_finalize");
+  if(fptr_finalize == NULL){
+    printf("Could not load classifier_finalize() from library: %s\n", dlerror());
+    unload();
+    return false;
+  }
+  //at least one of the run functions is required
+  fptr_runFrame = (uint32_t (*)(const struct CSIData*, uint64_t, struct CSIClassifierResult*, uint32_t)) dlsym(do_handle, "classifier_runFrame");
+  fptr_runWindow = (uint32_t (*)(const struct CSIClassifierWindow*, struct CSIClassifierResult*, uint32_t)) dlsym(do_handle, "classifier_runWindow");
+  if((fptr_runFrame == NULL)&&(fptr_runWindow == NULL)){
+    printf("Could not load classifier_runFrame() or classifier_runWindow() from library\n");
+    unload();
+    return false;
+  }
+  fptr_getName(name);
+  name[CSI_CLASSIFIER_NAME_STLEN - 1] = '\0';
+  printf("Successfully loaded classifier: %s\n", name);
+  return true;
+}
+
+void CSIClassifierObj::unload(){
+  finalize();
+  model.unload();
+  if(do_handle != NULL){
+    dlclose(do_handle);
+    do_handle = NULL;
+  }
+  fptr_runFrame = NULL;
+  fptr_runWindow = NULL;
+}
+
+bool CSIClassifierObj::initialize(const char* arguments){
+  if(model.isLoaded()){
+    initialized = true;
+    return true;
+  }
+  if(do_handle == NULL){
+    return false;
+  }
+  finalize();
+  if(fptr_init(arguments) != 0){
+    printf("Classifier %s: initialization failed\n", name);
+    return false;
+  }
+  initialized = true;
+  return true;
+}
+
+void CSIClassifierObj::finalize(){
+  if(initialized){
+    if(!model.isLoaded()){
+      fptr_finalize();
+    }
+    initialized = false;
+  }
+}
+
+bool CSIClassifierObj::canRunFrames(){
+  return fptr_runFrame != NULL;
+}
+
+bool CSIClassifierObj::canRunWindows(){
+  return (fptr_runWindow != NULL)||(model.isLoaded());
+}
+
+uint32_t CSIClassifierObj::runFrame(const CSIData* data, uint64_t time, CSIClassifierResult* results, uint32_t maxResults){
+  if((!initialized)||(fptr_runFrame == NULL)){
+    return 0;
+  }
+  uint32_t n = fptr_runFrame(data, time, results, maxResults);
+  return (n > maxResults) ? maxResults : n;
+}
+
+uint32_t CSIClassifierObj::runWindow(const CSIClassifierWindow* window, CSIClassifierResult* results, uint32_t maxResults){
+  if((initialized)&&(model.isLoaded())){
+    return runModel(window, results, maxResults);
+  }
+  if((!initialized)||(fptr_runWindow == NULL)){
+    return 0;
+  }
+  uint32_t n = fptr_runWindow(window, results, maxResults);
+  return (n > maxResults) ? maxResults : n;
+}
+
+uint32_t CSIClassifierObj::runModel(const CSIClassifierWindow* window, CSIClassifierResult* results, uint32_t maxResults){
+  //the model gets the amplitudes, i.e., the first channel
+  if((window->nFrames != model.getInputSteps())||(window->nSubCarriers != model.getInputFeatures())){
+    if(!shapeWarned){
+      printf("Classifier %s: windows of %u frames x %u subcarriers do not fit the input of the model (%u x %u)\n", name,
+             window->nFrames, window->nSubCarriers, model.getInputSteps(), model.getInputFeatures());
+      shapeWarned = true;
+    }
+    return 0;
+  }
+  if(maxResults < 1){
+    return 0;
+  }
+  const float* out = model.run(window->tensor);
+  uint32_t best = 0;
+  for(uint32_t i = 1; i < model.getNOutputs(); i++){
+    if(out[i] > out[best]){
+      best = i;
+    }
+  }
+  results[0].classifID = 0;
+  results[0].classNo = best;
+  results[0].certainty = out[best];
+  return 1;
+}
+
+const char* CSIClassifierObj::getName(){
+  return name;
+}
@@ -0,0 +1,104 @@
+/*
+ * CSIClassifierObj.h
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSICLASSIFIEROBJ_H_
+#define CSICLASSIFIEROBJ_H_
+
+#include "CSIClassifier.h"
+#include "CSIData.h"
+#include "CSIInferenceModel.h"
+
+#define CSI_CLASSIFIER_PATH_STLEN 1024                  ///Maximum string length for the file name of a classifier plugin
+
+/**
+ * \brief Interface to a classifier plugin
+ *
+ * A classifier plugin is a shared object, from which multiple functions are imported using dlsym(), like a filter plugin (see CSIFilterObj).
+ * It runs within WirelessEye and receives the frames or windows in memory instead of via a pipe to a separate process.
+ * The best way to learn the actual interface is looking at sample_classifier.c in the classifiers/ - directory.
+ *
+ * A plugin must provide classifier_runFrame(), classifier_runWindow() or both.
+ *
+ * Instead of a plugin, a model for the built-in inference runtime (CSIInferenceModel) can be loaded. It classifies windows of amplitudes and returns the class with the highest output.
+ */
+class CSIClassifierObj{
+private:
+  char fileName[CSI_CLASSIFIER_PATH_STLEN];                   ///File name of the plugin
+  char name[CSI_CLASSIFIER_NAME_STLEN];                       ///Name of the classifier
+  void* do_handle;                                            ///Handle for the dynamic object. NULL => no plugin loaded
+  bool initialized;                                           ///true => classifier_init() has succeeded and classifier_finalize() has not been called yet
+  CSIInferenceModel model;                                    ///The model, if a model file rather than a plugin has been loaded
+  bool shapeWarned;                                           ///true => a window that does not fit the model has been reported
+
+  /* Function pointers to call functions of the plugin*/
+  void (*fptr_getName)(char*);                                ///Read the name of the classifier
+  int (*fptr_init)(const char*);                              ///Initialize the plugin with the given arguments
+  void (*fptr_finalize)();                                    ///Finalize the plugin
+  uint32_t (*fptr_runFrame)(const struct CSIData*, uint64_t, struct CSIClassifierResult*, uint32_t);      ///Classify one frame. NULL => not provided
+  uint32_t (*fptr_runWindow)(const struct CSIClassifierWindow*, struct CSIClassifierResult*, uint32_t);  ///Classify one window. NULL => not provided
+
+  /**
+   * Classify one window using the model
+   */
+  uint32_t runModel(const CSIClassifierWindow* window, CSIClassifierResult* results, uint32_t maxResults);
+
+public:
+  CSIClassifierObj();
+  ~CSIClassifierObj();
+
+  /**
+   * Load the plugin from the given file using dlopen() and import its functions, or load a model if the file name ends with CSI_MODEL_EXTENSION. A previously loaded plugin is unloaded. Returns false on failure.
+   */
+  bool load(const char* fileName);
+
+  /**
+   * Unload the plugin, finalizing it if necessary.
+   */
+  void unload();
+
+  /**
+   * Call classifier_init() of the plugin with the given arguments. Returns false on failure.
+   */
+  bool initialize(const char* arguments);
+
+  /**
+   * Call classifier_finalize() of the plugin, if it has been initialized.
+   */
+  void finalize();
+
+  /**
+   * Returns true, if the plugin can classify single frames.
+   */
+  bool canRunFrames();
+
+  /**
+   * Returns true, if the plugin can classify windows of frames.
+   */
+  bool canRunWindows();
+
+  /**
+   * Classify one frame received at time (ns since 1970). Up to maxResults results are written to results. Returns the number of results.
+   */
+  uint32_t runFrame(const CSIData* data, uint64_t time, CSIClassifierResult* results, uint32_t maxResults);
+
+  /**
+   * Classify one window. Up to maxResults results are written to results. Returns the number of results.
+   */
+  uint32_t runWindow(const CSIClassifierWindow* window, CSIClassifierResult* results, uint32_t maxResults);
+
+  /**
+   * Read the name of the classifier
+   */
+  const char* getName();
+};
+
+#endif /* CSICLASSIFIEROBJ_H_ */
@@ -0,0 +1,114 @@
+/*
+ * CSIDecisionLatency.cpp
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIDecisionLatency.h"
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static inline uint64_t monotonicNs(){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+CSIDecisionLatency::CSIDecisionLatency(){
+  memset(recHistogram, 0, sizeof(recHistogram));
+  reset();
+}
+
+void CSIDecisionLatency::reset(){
+  mutex.lock();
+  nInputs = 0;
+  memset(histogram, 0, sizeof(histogram));
+  nUnmatched = 0;
+  max = 0;
+  mutex.unlock();
+}
+
+void CSIDecisionLatency::addInput(uint64_t frameTime){
+  uint64_t now = monotonicNs();
+  mutex.lock();
+  input* in = &inputs[nInputs % LATENCY_MAX_INPUTS];
+  in->frameTime = frameTime;
+  in->arrival = now;
+  nInputs++;
+  mutex.unlock();
+}
+
+double CSIDecisionLatency::addDecision(uint64_t frameTime){
+  uint64_t now = monotonicNs();
+  mutex.lock();
+  //results usually refer to one of the most recent inputs
+  uint64_t first = (nInputs > LATENCY_MAX_INPUTS) ? nInputs - LATENCY_MAX_INPUTS : 0;
+  for(uint64_t i = nInputs; i > first; i--){
+    input* in = &inputs[(i - 1) % LATENCY_MAX_INPUTS];
+    if(in->frameTime == frameTime){
+      double latency = (now - in->arrival) / 1e6;
+      int32_t bucket = (latency * 1000 >= 1) ? (int32_t) floor(log2(latency * 1000) * LATENCY_BUCKETS_PER_OCTAVE) : 0;
+      bucket = (bucket < LATENCY_N_BUCKETS) ? bucket : LATENCY_N_BUCKETS - 1;
+      histogram[bucket]++;
+      recHistogram[bucket]++;
+      if(latency > max){
+        max = latency;
+      }
+      mutex.unlock();
+      return latency;
+    }
+  }
+  nUnmatched++;
+  mutex.unlock();
+  return -1;
+}
+
+double CSIDecisionLatency::bucketLimit(uint32_t bucket){
+  return pow(2, (bucket + 1) / (double) LATENCY_BUCKETS_PER_OCTAVE) / 1000;
+}
+
+double CSIDecisionLatency::quantile(double fraction, uint64_t n){
+  uint64_t sum = 0;
+  for(uint32_t i = 0; i < LATENCY_N_BUCKETS; i++){
+    sum += histogram[i];
+    if(sum >= fraction * n){
+      return (bucketLimit(i) < max) ? bucketLimit(i) : max;
+    }
+  }
+  return max;
+}
+
+CSILatencyStats CSIDecisionLatency::getStats(){
+  CSILatencyStats stats;
+  mutex.lock();
+  stats.n = 0;
+  for(uint32_t i = 0; i < LATENCY_N_BUCKETS; i++){
+    stats.n += histogram[i];
+  }
+  stats.nUnmatched = nUnmatched;
+  stats.p50 = quantile(0.5, stats.n);
+  stats.p90 = quantile(0.9, stats.n);
+  stats.p99 = quantile(0.99, stats.n);
+  stats.max = max;
+  mutex.unlock();
+  return stats;
+}
+
+void CSIDecisionLatency::startRecording(){
+  mutex.lock();
+  memset(recHistogram, 0, sizeof(recHistogram));
+  mutex.unlock();
+}
+
+void CSIDecisionLatency::getRecordingHistogram(uint64_t* counts){
+  mutex.lock();
+  memcpy(counts, recHistogram, sizeof(recHistogram));
+  mutex.unlock();
+}
@@ -0,0 +1,105 @@
+/*
+ * CSIDecisionLatency.h
+ * Measures the time from the arrival of the last frame a classification result is based on to the arrival of the result.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIDECISIONLATENCY_H_
+#define CSIDECISIONLATENCY_H_
+
+#include <QMutex>
+#include <inttypes.h>
+
+#define LATENCY_MAX_INPUTS 1024                 ///Number of recent inputs whose arrival times are kept
+#define LATENCY_BUCKETS_PER_OCTAVE 4            ///Resolution of the histogram
+#define LATENCY_N_BUCKETS 96                    ///Number of buckets of the histogram. Bucket i holds latencies below 2^((i + 1) / LATENCY_BUCKETS_PER_OCTAVE) us, the last one all longer ones.
+
+/**
+ * Summary of the latencies measured so far
+ */
+struct CSILatencyStats{
+  uint64_t n;                                   ///Number of results whose latency has been measured
+  uint64_t nUnmatched;                          ///Number of results that refer to an unknown frame
+  double p50;                                   ///Median in ms
+  double p90;                                   ///90th percentile in ms
+  double p99;                                   ///99th percentile in ms
+  double max;                                   ///Maximum in ms
+};
+
+/**
+ * \brief Histogram of the frame-to-decision latency of a classifier
+ *
+ * Whenever a frame or window is passed to the classifier, addInput() records the time of its last frame (as in the recordings and the binary exports) along with the current time.
+ * When a result that refers to this time arrives, addDecision() looks it up and adds the elapsed time to a histogram with logarithmic buckets.
+ * The latency hence includes the queue to the classifier, the classification and reading back the result, but not the time the frame needed to reach WirelessEye.
+ */
+class CSIDecisionLatency{
+private:
+  /**
+   * An input passed to the classifier
+   */
+  struct input{
+    uint64_t frameTime;                         ///Time of the last frame in ns since 1970
+    uint64_t arrival;                           ///CLOCK_MONOTONIC when it was passed on, in ns
+  };
+
+  input inputs[LATENCY_MAX_INPUTS];             ///Ring of the most recent inputs
+  uint64_t nInputs;                             ///Number of inputs added. Input i is at position i % LATENCY_MAX_INPUTS.
+  uint64_t histogram[LATENCY_N_BUCKETS];        ///Number of results per bucket
+  uint64_t recHistogram[LATENCY_N_BUCKETS];     ///Number of results per bucket since startRecording(). Not affected by reset()
+  uint64_t nUnmatched;                          ///Number of results that refer to an unknown frame
+  double max;                                   ///Maximum latency in ms
+  QMutex mutex;                                 ///Protects everything, since inputs and results are added by different threads
+
+  /**
+   * Returns the latency below which the given fraction of results lies. The mutex must be locked by the caller.
+   */
+  double quantile(double fraction, uint64_t n);
+
+public:
+  CSIDecisionLatency();
+
+  /**
+   * Discard all inputs and measurements
+   */
+  void reset();
+
+  /**
+   * Record that a frame or window whose last frame has the given time (ns since 1970) is passed to the classifier now
+   */
+  void addInput(uint64_t frameTime);
+
+  /**
+   * A result referring to the frame with the given time has arrived. Returns the latency in ms, or a negative value if the frame is unknown.
+   */
+  double addDecision(uint64_t frameTime);
+
+  /**
+   * Returns a summary of the measurements
+   */
+  CSILatencyStats getStats();
+
+  /**
+   * Start a new histogram for the recording that begins now, see getRecordingHistogram()
+   */
+  void startRecording();
+
+  /**
+   * Copy the histogram of the results since startRecording() to counts, which must hold LATENCY_N_BUCKETS values
+   */
+  void getRecordingHistogram(uint64_t* counts);
+
+  /**
+   * Upper bound of the given bucket in ms
+   */
+  static double bucketLimit(uint32_t bucket);
+};
+
+#endif /* CSIDECISIONLATENCY_H_ */
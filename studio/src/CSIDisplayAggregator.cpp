@@ -0,0 +1,134 @@
+/*
+ * CSIDisplayAggregator.cpp
+ * Folds several frames into one column of a display widget.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIDisplayAggregator.h"
+#include <stddef.h>
+#include <math.h>
+
+CSIDisplayAggregator::CSIDisplayAggregator(){
+  reducer = CSI_REDUCE_LAST;
+  framesPerColumn = 1;
+  reset();
+}
+
+void CSIDisplayAggregator::setReducer(CSIDisplayReducer reducer){
+  this->reducer = reducer;
+  reset();
+}
+
+void CSIDisplayAggregator::setFramesPerColumn(uint32_t K){
+  framesPerColumn = (K > 0) ? K : 1;
+}
+
+void CSIDisplayAggregator::reset(){
+  count = 0;
+  n = 0;
+}
+
+double* CSIDisplayAggregator::add(const double* values, uint32_t n){
+  if(n > DISPLAY_MAX_SUBCARRIERS){
+    n = DISPLAY_MAX_SUBCARRIERS;
+  }
+  if(n != this->n){
+    this->n = n;
+    count = 0;
+  }
+  count++;
+
+  switch(reducer){
+    case CSI_REDUCE_LAST:
+      for(uint32_t i = 0; i < n; i++){
+        acc[i] = values[i];
+      }
+      break;
+
+    case CSI_REDUCE_MEAN:
+      if(count == 1){
+        for(uint32_t i = 0; i < n; i++){
+          acc[i] = values[i];
+        }
+      }else{
+        for(uint32_t i = 0; i < n; i++){
+          acc[i] += values[i];
+        }
+      }
+      break;
+
+    case CSI_REDUCE_MAXABS:
+      if(count == 1){
+        for(uint32_t i = 0; i < n; i++){
+          acc[i] = values[i];
+        }
+      }else{
+        for(uint32_t i = 0; i < n; i++){
+          if(fabs(values[i]) > fabs(acc[i])){
+            acc[i] = values[i];
+          }
+        }
+      }
+      break;
+
+    case CSI_REDUCE_VARIANCE:
+      if(count == 1){
+        for(uint32_t i = 0; i < n; i++){
+          acc[i] = values[i];
+          accSq[i] = values[i] * values[i];
+        }
+      }else{
+        for(uint32_t i = 0; i < n; i++){
+          acc[i] += values[i];
+          accSq[i] += values[i] * values[i];
+        }
+      }
+      break;
+  }
+
+  if(count >= framesPerColumn){
+    return finish();
+  }
+  return NULL;
+}
+
+double* CSIDisplayAggregator::finish(){
+  if(count == 0){
+    return NULL;
+  }
+  switch(reducer){
+    case CSI_REDUCE_MEAN:
+      for(uint32_t i = 0; i < n; i++){
+        column[i] = acc[i] / count;
+      }
+      break;
+
+    case CSI_REDUCE_VARIANCE:
+      for(uint32_t i = 0; i < n; i++){
+        double mean = acc[i] / count;
+        double var = accSq[i] / count - mean * mean;
+        column[i] = (var > 0) ? var : 0;
+      }
+      break;
+
+    default:
+      //last and max-abs: the accumulated values are the column
+      for(uint32_t i = 0; i < n; i++){
+        column[i] = acc[i];
+      }
+      break;
+  }
+  count = 0;
+  return column;
+}
+
+uint32_t CSIDisplayAggregator::getN(){
+  return n;
+}
@@ -0,0 +1,83 @@
+/*
+ * CSIDisplayAggregator.h
+ * Folds several frames into one column of a display widget.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIDISPLAYAGGREGATOR_H_
+#define CSIDISPLAYAGGREGATOR_H_
+
+#include <inttypes.h>
+#include "CSIDisplayQueue.h"
+
+/**
+ * How the frames of a column are combined, per subcarrier
+ */
+enum CSIDisplayReducer{
+  CSI_REDUCE_LAST = 0,                          ///The value of the last frame
+  CSI_REDUCE_MEAN = 1,                          ///The mean value
+  CSI_REDUCE_MAXABS = 2,                        ///The value with the largest magnitude, including its sign
+  CSI_REDUCE_VARIANCE = 3                       ///The variance of the values
+};
+
+/**
+ * \brief Combines K consecutive frames into one column of a display widget.
+ *
+ * If more frames arrive than the display has columns for the chosen time span, painting a column per frame wastes CPU on columns that scroll out of
+ * view right away. The aggregator accumulates the frames and returns a column only for every K-th frame, so the display load depends on the width of
+ * the display and the time span rather than on the frame rate. A column is started anew if the number of subcarriers changes.
+ */
+class CSIDisplayAggregator{
+  private:
+  CSIDisplayReducer reducer;                    ///How the frames are combined
+  uint32_t framesPerColumn;                     ///K, the number of frames per column
+  uint32_t count;                               ///Frames accumulated for the current column
+  uint32_t n;                                   ///Number of values per frame of the current column
+  double acc[DISPLAY_MAX_SUBCARRIERS];          ///Last values (last), sum (mean, variance) or the value with the largest magnitude (max-abs)
+  double accSq[DISPLAY_MAX_SUBCARRIERS];        ///Sum of the squares (variance)
+  double column[DISPLAY_MAX_SUBCARRIERS];       ///The last completed column
+
+  public:
+  CSIDisplayAggregator();
+
+  /**
+   * Select the reducer. The current column is discarded.
+   */
+  void setReducer(CSIDisplayReducer reducer);
+
+  /**
+   * Set the number of frames per column (at least 1). Takes effect with the current column.
+   */
+  void setFramesPerColumn(uint32_t K);
+
+  /**
+   * Discard the current column
+   */
+  void reset();
+
+  /**
+   * Add the n values of a frame. Returns the column, if this frame completes it, i.e., n values to be displayed that stay valid until the next call
+   * and may be modified by the caller. Otherwise, returns NULL.
+   */
+  double* add(const double* values, uint32_t n);
+
+  /**
+   * Complete the current column early, e.g., at the end of a time slot. Returns the column as add() does, or NULL if it holds no frame.
+   */
+  double* finish();
+
+  /**
+   * Returns the number of values of the current column
+   */
+  uint32_t getN();
+};
+
+#endif /* CSIDISPLAYAGGREGATOR_H_ */
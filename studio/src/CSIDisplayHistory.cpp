@@ -0,0 +1,248 @@
+/*
+ * CSIDisplayHistory.cpp
+ * Compact history of the columns of a display widget at multiple resolutions, for panning and zooming.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIDisplayHistory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define HISTORY_COLUMN_HEADER 12                ///Bytes before the values of a stored column: lower bound and step (float) and time (uint32_t)
+#define HISTORY_CODE_NAN 255                    ///Code of a value that is not finite, e.g., a lane without data
+
+CSIDisplayHistory::CSIDisplayHistory(){
+  for(uint32_t l = 0; l < HISTORY_LEVELS; l++){
+    levels[l].columns = NULL;
+    levels[l].pending = NULL;
+  }
+  combined = NULL;
+  n = 0;
+  stride = 0;
+  spanMs = 0;
+  maxBytes = 0;
+  reducer = CSI_REDUCE_MAXABS;
+}
+
+CSIDisplayHistory::~CSIDisplayHistory(){
+  release();
+}
+
+void CSIDisplayHistory::configure(uint32_t spanMs, uint64_t maxBytes, CSIDisplayReducer reducer){
+  release();
+  this->spanMs = spanMs;
+  this->maxBytes = maxBytes;
+  this->reducer = reducer;
+}
+
+bool CSIDisplayHistory::isEnabled(){
+  return spanMs > 0;
+}
+
+bool CSIDisplayHistory::allocate(uint32_t n){
+  this->n = n;
+  stride = (HISTORY_COLUMN_HEADER + n + 3) & ~3u;
+  combined = (double*) malloc(n * sizeof(double));
+  bool ok = (combined != NULL);
+  for(uint32_t l = 0; l < HISTORY_LEVELS; l++){
+    levels[l].cap = HISTORY_INITIAL_COLUMNS >> l;
+    if(levels[l].cap == 0){
+      levels[l].cap = 1;
+    }
+    levels[l].total = 0;
+    levels[l].hasPending = false;
+    levels[l].columns = (uint8_t*) malloc((size_t) levels[l].cap * stride);
+    levels[l].pending = (double*) malloc(n * sizeof(double));
+    if((levels[l].columns == NULL)||(levels[l].pending == NULL)){
+      ok = false;
+    }
+  }
+  if(!ok){
+    printf("Cannot allocate the display history\n");
+    release();
+  }
+  return ok;
+}
+
+void CSIDisplayHistory::release(){
+  for(uint32_t l = 0; l < HISTORY_LEVELS; l++){
+    free(levels[l].columns);
+    free(levels[l].pending);
+    levels[l].columns = NULL;
+    levels[l].pending = NULL;
+  }
+  free(combined);
+  combined = NULL;
+  n = 0;
+}
+
+bool CSIDisplayHistory::grow(){
+  uint64_t bytes = 0;
+  for(uint32_t l = 0; l < HISTORY_LEVELS; l++){
+    bytes += (uint64_t) levels[l].cap * stride;
+  }
+  if(2 * bytes > maxBytes){
+    return false;
+  }
+  for(uint32_t l = 0; l < HISTORY_LEVELS; l++){
+    level* lv = &levels[l];
+    uint32_t cap = 2 * lv->cap;
+    uint8_t* columns = (uint8_t*) malloc((size_t) cap * stride);
+    if(columns == NULL){
+      return false;
+    }
+    //the capacities are powers of 2, so each kept column moves to its index modulo the new capacity
+    for(uint64_t i = getBegin(l); i < lv->total; i++){
+      memcpy(columns + (i & (cap - 1)) * stride, slot(lv, i), stride);
+    }
+    free(lv->columns);
+    lv->columns = columns;
+    lv->cap = cap;
+  }
+  return true;
+}
+
+uint8_t* CSIDisplayHistory::slot(const level* lv, uint64_t index){
+  return lv->columns + (index & (lv->cap - 1)) * stride;
+}
+
+void CSIDisplayHistory::push(uint32_t l, const double* values, uint32_t timeMs){
+  level* lv = &levels[l];
+
+  //quantize the column between its minimum and maximum
+  float lo = 0;
+  float hi = 0;
+  bool first = true;
+  for(uint32_t i = 0; i < n; i++){
+    if(!isfinite(values[i])){
+      continue;
+    }
+    if((first)||(values[i] < lo)){
+      lo = values[i];
+    }
+    if((first)||(values[i] > hi)){
+      hi = values[i];
+    }
+    first = false;
+  }
+  float step = (hi - lo) / (HISTORY_CODE_NAN - 1);
+  uint8_t* s = slot(lv, lv->total);
+  memcpy(s, &lo, sizeof(float));
+  memcpy(s + 4, &step, sizeof(float));
+  memcpy(s + 8, &timeMs, sizeof(uint32_t));
+  uint8_t* code = s + HISTORY_COLUMN_HEADER;
+  for(uint32_t i = 0; i < n; i++){
+    if(!isfinite(values[i])){
+      code[i] = HISTORY_CODE_NAN;
+    }else if(step > 0){
+      code[i] = (uint8_t) lrintf((values[i] - lo) / step);
+    }else{
+      code[i] = 0;
+    }
+  }
+  lv->total++;
+
+  if(l + 1 >= HISTORY_LEVELS){
+    return;
+  }
+  if(!lv->hasPending){
+    memcpy(lv->pending, values, n * sizeof(double));
+    lv->pendingTime = timeMs;
+    lv->hasPending = true;
+    return;
+  }
+  //values may be the combined buffer itself, so it is combined in place
+  lv->hasPending = false;
+  for(uint32_t i = 0; i < n; i++){
+    double a = lv->pending[i];
+    double b = values[i];
+    switch(reducer){
+      case CSI_REDUCE_LAST:
+        combined[i] = b;
+        break;
+      case CSI_REDUCE_MEAN:
+        //a missing value does not hide the other one
+        combined[i] = isnan(a) ? b : (isnan(b) ? a : (a + b) / 2);
+        break;
+      default:
+        //max-abs. Variances are positive, so they keep their maximum.
+        combined[i] = ((isnan(a))||(fabs(b) > fabs(a))) ? b : a;
+        break;
+    }
+  }
+  push(l + 1, combined, lv->pendingTime);
+}
+
+void CSIDisplayHistory::clear(){
+  for(uint32_t l = 0; l < HISTORY_LEVELS; l++){
+    levels[l].total = 0;
+    levels[l].hasPending = false;
+  }
+}
+
+void CSIDisplayHistory::add(const double* values, uint32_t n, uint32_t timeMs){
+  if((spanMs == 0)||(n == 0)){
+    return;
+  }
+  if(n != this->n){
+    release();
+    if(!allocate(n)){
+      return;
+    }
+  }
+  //keep growing as long as the oldest column is within the time span
+  level* lv = &levels[0];
+  if(lv->total >= lv->cap){
+    uint32_t oldest;
+    memcpy(&oldest, slot(lv, lv->total - lv->cap) + 8, sizeof(uint32_t));
+    if((uint32_t) (timeMs - oldest) < spanMs){
+      grow();
+    }
+  }
+  push(0, values, timeMs);
+}
+
+uint32_t CSIDisplayHistory::getN(){
+  return n;
+}
+
+uint64_t CSIDisplayHistory::getEnd(uint32_t l){
+  if((n == 0)||(l >= HISTORY_LEVELS)){
+    return 0;
+  }
+  return levels[l].total;
+}
+
+uint64_t CSIDisplayHistory::getBegin(uint32_t l){
+  if((n == 0)||(l >= HISTORY_LEVELS)){
+    return 0;
+  }
+  return (levels[l].total > levels[l].cap) ? levels[l].total - levels[l].cap : 0;
+}
+
+bool CSIDisplayHistory::getColumn(uint32_t l, uint64_t index, double* values, uint32_t* timeMs){
+  if((index < getBegin(l))||(index >= getEnd(l))){
+    return false;
+  }
+  float lo, step;
+  uint8_t* s = slot(&levels[l], index);
+  memcpy(&lo, s, sizeof(float));
+  memcpy(&step, s + 4, sizeof(float));
+  if(timeMs != NULL){
+    memcpy(timeMs, s + 8, sizeof(uint32_t));
+  }
+  const uint8_t* code = s + HISTORY_COLUMN_HEADER;
+  for(uint32_t i = 0; i < n; i++){
+    values[i] = (code[i] == HISTORY_CODE_NAN) ? NAN : lo + code[i] * step;
+  }
+  return true;
+}
@@ -0,0 +1,126 @@
+/*
+ * CSIDisplayHistory.h
+ * Compact history of the columns of a display widget at multiple resolutions, for panning and zooming.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIDISPLAYHISTORY_H_
+#define CSIDISPLAYHISTORY_H_
+
+#include <inttypes.h>
+#include "CSIDisplayAggregator.h"
+
+#define HISTORY_LEVELS 16                       ///Number of resolution levels. Level l holds one column per 2^l columns
+#define HISTORY_INITIAL_COLUMNS 1024            ///Initial capacity of level 0 in columns
+
+/**
+ * \brief Keeps the columns shown by a display widget after they have scrolled out of view.
+ *
+ * Each column is quantized to 8 bits per value between the minimum and maximum of the column, and stored along with the time it was added. Values
+ * that are not finite are kept as NaN.
+ * Level 0 holds every column, level l combines two columns of level l - 1 using the selected reducer. Hence, a view of W pixels at any zoom factor
+ * 2^l reads W columns. All levels are rings that are overwritten once full. Their capacity is doubled as long as the oldest column is younger than the
+ * configured time span and the memory limit is not reached, so the history covers the time span regardless of the column rate, within the memory limit.
+ * The number of values per column is taken from the first column. If it changes, the history starts anew.
+ */
+class CSIDisplayHistory{
+  private:
+  /**
+   * A resolution level
+   */
+  struct level{
+    uint8_t* columns;                           ///Ring of cap columns of stride bytes each
+    uint32_t cap;                               ///Capacity in columns
+    uint64_t total;                             ///Number of columns added to this level so far
+    double* pending;                            ///Column waiting to be combined with the next column of the level below
+    uint32_t pendingTime;                       ///Time of the pending column
+    bool hasPending;                            ///true => pending holds a column
+  };
+
+  level levels[HISTORY_LEVELS];                 ///The resolution levels
+  uint32_t n;                                   ///Number of values per column. 0 => no column yet
+  uint32_t stride;                              ///Size of a stored column in bytes
+  uint32_t spanMs;                              ///Time span to be covered in ms. 0 => disabled
+  uint64_t maxBytes;                            ///Memory limit of all levels
+  CSIDisplayReducer reducer;                    ///Combines two columns into one of the next level
+  double* combined;                             ///Buffer for combining two columns
+
+  /**
+   * Allocate the levels for columns of n values. Returns false on failure.
+   */
+  bool allocate(uint32_t n);
+
+  /**
+   * Release the levels
+   */
+  void release();
+
+  /**
+   * Double the capacity of all levels. Returns false if the memory limit would be exceeded or the allocation fails.
+   */
+  bool grow();
+
+  /**
+   * Add a column to level l and pass every second column on to level l + 1
+   */
+  void push(uint32_t l, const double* values, uint32_t timeMs);
+
+  /**
+   * Returns the stored column with the given index of level l
+   */
+  uint8_t* slot(const level* lv, uint64_t index);
+
+  public:
+  CSIDisplayHistory();
+  ~CSIDisplayHistory();
+
+  /**
+   * Set the time span to be kept (0 => disabled), the memory limit and how columns are combined at lower resolutions. The history is cleared.
+   */
+  void configure(uint32_t spanMs, uint64_t maxBytes, CSIDisplayReducer reducer);
+
+  /**
+   * Returns true, if columns are kept
+   */
+  bool isEnabled();
+
+  /**
+   * Discard all columns
+   */
+  void clear();
+
+  /**
+   * Add a column of n values, which was displayed at time timeMs (in ms of any monotonic clock)
+   */
+  void add(const double* values, uint32_t n, uint32_t timeMs);
+
+  /**
+   * Returns the number of values per column
+   */
+  uint32_t getN();
+
+  /**
+   * Returns the number of columns added to level l so far, i.e., the index after the newest column
+   */
+  uint64_t getEnd(uint32_t l);
+
+  /**
+   * Returns the index of the oldest column still kept in level l
+   */
+  uint64_t getBegin(uint32_t l);
+
+  /**
+   * Decode the column with the given index of level l into n values and get its time. Returns false if the column is not kept.
+   */
+  bool getColumn(uint32_t l, uint64_t index, double* values, uint32_t* timeMs);
+};
+
+#endif /* CSIDISPLAYHISTORY_H_ */
@@ -0,0 +1,131 @@
+/*
+ * CSIDisplayLanes.cpp
+ * Splits the displayed frames by sender into lanes and folds them into columns.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIDisplayLanes.h"
+#include <string.h>
+#include <stddef.h>
+
+CSIDisplayLanes::CSIDisplayLanes(){
+  nLanes = 1;
+  framesPerColumn = 1;
+  skipped = 0;
+  clear();
+}
+
+void CSIDisplayLanes::setNLanes(uint32_t nLanes){
+  if(nLanes < 1){
+    nLanes = 1;
+  }
+  if(nLanes > DISPLAY_MAX_LANES){
+    nLanes = DISPLAY_MAX_LANES;
+  }
+  this->nLanes = nLanes;
+  clear();
+}
+
+void CSIDisplayLanes::clear(){
+  for(uint32_t l = 0; l < DISPLAY_MAX_LANES; l++){
+    memset(lanes[l].MAC, 0, 6);
+    lanes[l].nSubCarriers = 0;
+    lanes[l].amplitude.reset();
+    lanes[l].phase.reset();
+    lanes[l].RSSI.reset();
+    //the aggregators never complete a column on their own, the column clock in add() does
+    lanes[l].amplitude.setFramesPerColumn(UINT32_MAX);
+    lanes[l].phase.setFramesPerColumn(UINT32_MAX);
+    lanes[l].RSSI.setFramesPerColumn(UINT32_MAX);
+  }
+  nUsed = 0;
+  count = 0;
+}
+
+void CSIDisplayLanes::setReducer(CSIDisplayReducer reducer){
+  for(uint32_t l = 0; l < DISPLAY_MAX_LANES; l++){
+    lanes[l].amplitude.setReducer(reducer);
+    lanes[l].phase.setReducer(reducer);
+    lanes[l].RSSI.setReducer((reducer == CSI_REDUCE_LAST) ? CSI_REDUCE_LAST : CSI_REDUCE_MEAN);
+  }
+  count = 0;
+}
+
+void CSIDisplayLanes::setFramesPerColumn(uint32_t K){
+  framesPerColumn = (K > 0) ? K : 1;
+}
+
+bool CSIDisplayLanes::add(const CSIDisplayFrame* f){
+  lane* ln = NULL;
+  if(nLanes == 1){
+    ln = &lanes[0];
+    nUsed = 1;
+  }else{
+    for(uint32_t l = 0; l < nUsed; l++){
+      if(memcmp(lanes[l].MAC, f->MAC, 6) == 0){
+        ln = &lanes[l];
+        break;
+      }
+    }
+    if(ln == NULL){
+      if(nUsed >= nLanes){
+        skipped++;
+        return false;
+      }
+      ln = &lanes[nUsed++];
+      memcpy(ln->MAC, f->MAC, 6);
+    }
+  }
+
+  ln->nSubCarriers = f->nSubCarriers;
+  if(f->hasAmplitude){
+    ln->amplitude.add(f->amplitude, f->nSubCarriers);
+  }
+  if(f->hasPhase){
+    ln->phase.add(f->phase, f->nSubCarriers);
+  }
+  if(f->hasRSSI){
+    ln->RSSI.add(&f->RSSI, 1);
+  }
+  count += f->decimation;
+  if(count >= framesPerColumn){
+    count = 0;
+    return true;
+  }
+  return false;
+}
+
+uint32_t CSIDisplayLanes::getNUsed(){
+  return nUsed;
+}
+
+const uint8_t* CSIDisplayLanes::getMAC(uint32_t l){
+  return lanes[l].MAC;
+}
+
+uint32_t CSIDisplayLanes::getNSubCarriers(uint32_t l){
+  return lanes[l].nSubCarriers;
+}
+
+double* CSIDisplayLanes::getAmplitude(uint32_t l){
+  return lanes[l].amplitude.finish();
+}
+
+double* CSIDisplayLanes::getPhase(uint32_t l){
+  return lanes[l].phase.finish();
+}
+
+double* CSIDisplayLanes::getRSSI(uint32_t l){
+  return lanes[l].RSSI.finish();
+}
+
+uint64_t CSIDisplayLanes::getSkipped(){
+  return skipped;
+}
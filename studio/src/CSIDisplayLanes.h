@@ -0,0 +1,118 @@
+/*
+ * CSIDisplayLanes.h
+ * Splits the displayed frames by sender into lanes and folds them into columns.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIDISPLAYLANES_H_
+#define CSIDISPLAYLANES_H_
+
+#include <inttypes.h>
+#include "CSIDisplayQueue.h"
+#include "CSIDisplayAggregator.h"
+
+#define DISPLAY_MAX_LANES 8                     ///Maximum number of lanes, i.e., senders displayed at the same time
+
+/**
+ * \brief Demultiplexes the displayed frames by MAC address.
+ *
+ * Each sender gets its own lane, in the order the senders appear, until all lanes are taken. Frames of further senders are skipped before any
+ * work is done for them. All lanes share one column clock: a column is complete after framesPerColumn frames of any lane, counting the frames shed before
+ * a frame (see CSIDisplayFrame::decimation), and each lane folds its
+ * own frames of the column with its own aggregators. Hence, the columns of all lanes cover the same time, and the display advances by one column
+ * for all lanes, no matter how many senders there are. With a single lane, the frames of all senders share it.
+ */
+class CSIDisplayLanes{
+  private:
+  /**
+   * A sender and the aggregators for its frames
+   */
+  struct lane{
+    uint8_t MAC[6];                             ///MAC address of the sender
+    uint32_t nSubCarriers;                      ///Number of subcarriers of the last frame
+    CSIDisplayAggregator amplitude;             ///Folds the amplitudes of the column
+    CSIDisplayAggregator phase;                 ///Folds the phases of the column
+    CSIDisplayAggregator RSSI;                  ///Folds the RSSI of the column
+  };
+
+  lane lanes[DISPLAY_MAX_LANES];                ///The lanes
+  uint32_t nLanes;                              ///Maximum number of lanes. 1 => all senders share one lane
+  uint32_t nUsed;                               ///Number of lanes taken by a sender
+  uint32_t framesPerColumn;                     ///Frames of all lanes per column
+  uint32_t count;                               ///Frames of the current column, including those shed
+  uint64_t skipped;                             ///Frames of senders without a lane
+
+  public:
+  CSIDisplayLanes();
+
+  /**
+   * Set the maximum number of lanes (1...DISPLAY_MAX_LANES). All lanes are released.
+   */
+  void setNLanes(uint32_t nLanes);
+
+  /**
+   * Release all lanes, e.g., after the stream has been restarted
+   */
+  void clear();
+
+  /**
+   * Select how the frames of a column are combined. The RSSI keeps its unit, so it is averaged unless the last value is selected.
+   */
+  void setReducer(CSIDisplayReducer reducer);
+
+  /**
+   * Set the number of frames per column (at least 1)
+   */
+  void setFramesPerColumn(uint32_t K);
+
+  /**
+   * Add a frame to the lane of its sender, which is assigned if there is a free lane. Returns true if the frame completes a column.
+   * Then, get the column of each lane via getAmplitude(), getPhase() and getRSSI().
+   */
+  bool add(const CSIDisplayFrame* f);
+
+  /**
+   * Returns the number of lanes taken by a sender
+   */
+  uint32_t getNUsed();
+
+  /**
+   * Returns the MAC address of the sender of a lane. All senders share a single lane.
+   */
+  const uint8_t* getMAC(uint32_t l);
+
+  /**
+   * Returns the number of subcarriers of the columns of a lane
+   */
+  uint32_t getNSubCarriers(uint32_t l);
+
+  /**
+   * Returns the amplitudes of the completed column of a lane, or NULL if the lane has got no amplitudes for this column
+   */
+  double* getAmplitude(uint32_t l);
+
+  /**
+   * Returns the phases of the completed column of a lane, or NULL if the lane has got no phases for this column
+   */
+  double* getPhase(uint32_t l);
+
+  /**
+   * Returns the RSSI of the completed column of a lane, or NULL if the lane has got no RSSI for this column
+   */
+  double* getRSSI(uint32_t l);
+
+  /**
+   * Returns the number of frames skipped because all lanes were taken
+   */
+  uint64_t getSkipped();
+};
+
+#endif /* CSIDISPLAYLANES_H_ */
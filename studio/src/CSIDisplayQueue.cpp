@@ -0,0 +1,63 @@
+/*
+ * CSIDisplayQueue.cpp
+ * Lock-free single-producer/single-consumer queue of the frames to be displayed, from the network thread to the GUI thread.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIDisplayQueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+CSIDisplayQueue::CSIDisplayQueue(){
+  frames = (CSIDisplayFrame*) malloc(DISPLAY_QUEUE_LEN * sizeof(CSIDisplayFrame));
+  if(frames == NULL){
+    printf("error: cannot allocate the display queue.\n");
+    exit(1);
+  }
+  head = 0;
+  tail = 0;
+  dropped = 0;
+}
+
+CSIDisplayQueue::~CSIDisplayQueue(){
+  free(frames);
+}
+
+CSIDisplayFrame* CSIDisplayQueue::beginWrite(){
+  //the consumer frees slots by advancing tail, so the slots it has released are visible once tail is
+  if(head - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= DISPLAY_QUEUE_LEN){
+    __atomic_store_n(&dropped, dropped + 1, __ATOMIC_RELAXED);
+    return NULL;
+  }
+  return &frames[head & (DISPLAY_QUEUE_LEN - 1)];
+}
+
+void CSIDisplayQueue::commitWrite(){
+  __atomic_store_n(&head, head + 1, __ATOMIC_RELEASE);
+}
+
+CSIDisplayFrame* CSIDisplayQueue::front(){
+  if(__atomic_load_n(&head, __ATOMIC_ACQUIRE) == tail){
+    return NULL;
+  }
+  return &frames[tail & (DISPLAY_QUEUE_LEN - 1)];
+}
+
+void CSIDisplayQueue::pop(){
+  __atomic_store_n(&tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t CSIDisplayQueue::getDepth(){
+  return head - __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+}
+
+uint64_t CSIDisplayQueue::getDropped(){
+  return __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,88 @@
+/*
+ * CSIDisplayQueue.h
+ * Lock-free single-producer/single-consumer queue of the frames to be displayed, from the network thread to the GUI thread.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIDISPLAYQUEUE_H_
+#define CSIDISPLAYQUEUE_H_
+
+#include <inttypes.h>
+#include "CSIData.h"
+
+#define DISPLAY_QUEUE_LEN 1024                  ///Number of frames the queue can hold, i.e., that can arrive between two refreshes of the display (8 MB). Must be a power of 2
+#define DISPLAY_MAX_SUBCARRIERS 512             ///Maximum number of subcarriers per frame, as in CSIData
+
+/**
+ * A frame to be displayed
+ */
+struct CSIDisplayFrame{
+  uint8_t MAC[6];                               ///MAC address of the sender
+  uint32_t nSubCarriers;                        ///Number of valid amplitudes and phases
+  uint32_t decimation;                          ///Number of frames this frame stands for. > 1 => the frames before it have been shed from the display
+  bool hasAmplitude;                            ///true => amplitude is to be displayed
+  bool hasPhase;                                ///true => phase is to be displayed
+  bool hasRSSI;                                 ///true => RSSI is to be displayed
+  double RSSI;                                  ///RSSI of the frame
+  double amplitude[DISPLAY_MAX_SUBCARRIERS];    ///Amplitude of each subcarrier
+  double phase[DISPLAY_MAX_SUBCARRIERS];        ///Phase of each subcarrier
+};
+
+/**
+ * \brief Passes the frames to be displayed from the network thread to the GUI thread.
+ *
+ * The network thread fills a slot obtained from beginWrite() and publishes it via commitWrite(). The GUI thread renders the queued frames
+ * whenever the display is refreshed, using front() and pop(). Neither side ever waits for the other: if the GUI falls behind, frames are dropped.
+ * There must be only one producer and one consumer.
+ */
+class CSIDisplayQueue{
+  private:
+  CSIDisplayFrame* frames;                      ///The slots of the ring
+  alignas(64) uint64_t head;                    ///Frames written by the producer. Written by the producer only
+  alignas(64) uint64_t tail;                    ///Frames consumed by the consumer. Written by the consumer only
+  alignas(64) uint64_t dropped;                 ///Frames dropped because the queue was full. Written by the producer only
+
+  public:
+  CSIDisplayQueue();
+  ~CSIDisplayQueue();
+
+  /**
+   * Producer: returns the slot for the next frame, or NULL if the queue is full. Then, the frame is dropped.
+   */
+  CSIDisplayFrame* beginWrite();
+
+  /**
+   * Producer: publish the slot returned by beginWrite()
+   */
+  void commitWrite();
+
+  /**
+   * Consumer: returns the oldest queued frame, or NULL if the queue is empty
+   */
+  CSIDisplayFrame* front();
+
+  /**
+   * Consumer: release the frame returned by front()
+   */
+  void pop();
+
+  /**
+   * Producer: returns the number of frames waiting to be consumed
+   */
+  uint64_t getDepth();
+
+  /**
+   * Returns the number of frames dropped so far
+   */
+  uint64_t getDropped();
+};
+
+#endif /* CSIDISPLAYQUEUE_H_ */
@@ -0,0 +1,82 @@
+/*
+ * CSIDisplayShedder.cpp
+ * Decides which frames are displayed when the network thread or the display falls behind, such that recording and live export keep all frames.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIDisplayShedder.h"
+
+CSIDisplayShedder::CSIDisplayShedder(){
+  decimation = 1;
+  phase = 0;
+  sinceAdjust = 0;
+  load = 0;
+  lastStart = 0;
+  offered = 0;
+  shed = 0;
+  events = 0;
+}
+
+uint32_t CSIDisplayShedder::admit(uint64_t queueDepth){
+  __atomic_store_n(&offered, offered + 1, __ATOMIC_RELAXED);
+
+  //double the decimation while the display or the network thread falls behind, halve it once both keep up again
+  sinceAdjust++;
+  if(sinceAdjust >= SHED_ADJUST_FRAMES){
+    sinceAdjust = 0;
+    if((queueDepth > SHED_DEPTH_HIGH)||(load > SHED_LOAD_HIGH)){
+      if(decimation < SHED_MAX_DECIMATION){
+        if(decimation == 1){
+          __atomic_store_n(&events, events + 1, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&decimation, decimation * 2, __ATOMIC_RELAXED);
+      }
+    }else if((queueDepth < SHED_DEPTH_LOW)&&(load < SHED_LOAD_LOW)&&(decimation > 1)){
+      __atomic_store_n(&decimation, decimation / 2, __ATOMIC_RELAXED);
+    }
+  }
+
+  phase++;
+  if(phase >= decimation){
+    uint32_t n = phase;
+    phase = 0;
+    return n;
+  }
+  __atomic_store_n(&shed, shed + 1, __ATOMIC_RELAXED);
+  return 0;
+}
+
+void CSIDisplayShedder::addLoad(uint64_t start, uint64_t busy){
+  if((lastStart > 0)&&(start > lastStart)){
+    double sample = (double) busy / (start - lastStart);
+    if(sample > 1){
+      sample = 1;
+    }
+    load = (1 - SHED_LOAD_SMOOTHING) * load + SHED_LOAD_SMOOTHING * sample;
+  }
+  lastStart = start;
+}
+
+uint32_t CSIDisplayShedder::getDecimation(){
+  return __atomic_load_n(&decimation, __ATOMIC_RELAXED);
+}
+
+uint64_t CSIDisplayShedder::getOffered(){
+  return __atomic_load_n(&offered, __ATOMIC_RELAXED);
+}
+
+uint64_t CSIDisplayShedder::getShed(){
+  return __atomic_load_n(&shed, __ATOMIC_RELAXED);
+}
+
+uint64_t CSIDisplayShedder::getEvents(){
+  return __atomic_load_n(&events, __ATOMIC_RELAXED);
+}
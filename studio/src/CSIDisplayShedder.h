@@ -0,0 +1,87 @@
+/*
+ * CSIDisplayShedder.h
+ * Decides which frames are displayed when the network thread or the display falls behind, such that recording and live export keep all frames.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIDISPLAYSHEDDER_H_
+#define CSIDISPLAYSHEDDER_H_
+
+#include <inttypes.h>
+#include "CSIDisplayQueue.h"
+
+#define SHED_MAX_DECIMATION 64                  ///At least one of this many frames is displayed while shedding. Must be a power of 2
+#define SHED_ADJUST_FRAMES 32                   ///The decimation is changed at most once per this many frames
+#define SHED_DEPTH_HIGH (DISPLAY_QUEUE_LEN / 4) ///More frames waiting in the display queue => the display falls behind
+#define SHED_DEPTH_LOW (DISPLAY_QUEUE_LEN / 16) ///Fewer frames waiting in the display queue => the display keeps up
+#define SHED_LOAD_HIGH 0.8                      ///The network thread is busy for more than this share of the time => it falls behind
+#define SHED_LOAD_LOW 0.5                       ///The network thread is busy for less than this share of the time => it keeps up
+#define SHED_LOAD_SMOOTHING 0.05                ///Weight of the latest frame in the smoothed load of the network thread
+
+/**
+ * \brief Load shedding of the display.
+ *
+ * Recording and the live export to the classifiers have priority: recording gets every frame, waiting for the disk if necessary, and the classifiers get every frame
+ * their queue policy admits (see classifierWrThread).
+ * The display is best effort. If frames pile up in the display queue, or if the network thread is busy for most of the time between two frames, only every
+ * decimation-th frame is displayed. The decimation is doubled while either threshold is crossed and halved once both are well below. The filters of the
+ * display still see every frame, such that their state does not jump, and the frames shed save the copy into the queue and the rendering.
+ * Each frame displayed carries the number of frames it stands for, such that the frame rate, the time per column and the spectrogram refer to all frames.
+ *
+ * admit() and addLoad() are called by the network thread, the getters by the GUI thread.
+ */
+class CSIDisplayShedder{
+  private:
+  uint32_t decimation;                          ///Every decimation-th frame is displayed. Power of 2. Read by the GUI thread
+  uint32_t phase;                               ///Frames since the last one displayed
+  uint32_t sinceAdjust;                         ///Frames since the decimation has been changed
+  double load;                                  ///Smoothed share of the time the network thread is busy, 0...1
+  uint64_t lastStart;                           ///Start of the previous frame in ns. 0 => none
+  uint64_t offered;                             ///Frames offered to the display. Read by the GUI thread
+  uint64_t shed;                                ///Frames not displayed due to load shedding. Read by the GUI thread
+  uint64_t events;                              ///Number of times shedding has started. Read by the GUI thread
+
+  public:
+  CSIDisplayShedder();
+
+  /**
+   * Network thread: decide whether the next frame is displayed, given the number of frames waiting in the display queue.
+   * Returns 0 if it is shed, otherwise the number of frames it stands for, i.e., itself and the frames shed since the previous frame displayed.
+   */
+  uint32_t admit(uint64_t queueDepth);
+
+  /**
+   * Network thread: the processing of a frame has started at start and taken busy ns. The load is the busy time relative to the time since the previous frame started.
+   */
+  void addLoad(uint64_t start, uint64_t busy);
+
+  /**
+   * Current decimation, i.e., one of this many frames is displayed. 1 => no shedding
+   */
+  uint32_t getDecimation();
+
+  /**
+   * Number of frames offered to the display
+   */
+  uint64_t getOffered();
+
+  /**
+   * Number of frames shed
+   */
+  uint64_t getShed();
+
+  /**
+   * Number of times shedding has started, i.e., the decimation has risen above 1
+   */
+  uint64_t getEvents();
+};
+
+#endif /* CSIDISPLAYSHEDDER_H_ */
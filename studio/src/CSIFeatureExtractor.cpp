@@ -0,0 +1,276 @@
+/*
+ * CSIFeatureExtractor.cpp
+ * Computes sliding-window statistics and spectral features of each subcarrier of each MAC address, which are passed to the classifier instead of the raw frames.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIFeatureExtractor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CSI_FEATURE_MAX_SUBCARRIERS 512         ///Size of the arrays in CSIData
+
+CSIFeatureExtractor::CSIFeatureExtractor(){
+  nStates = 0;
+  nFrames = 0;
+  hop = 1;
+  nBins = 0;
+  nChannels = 1;
+  row = NULL;
+  delta = NULL;
+  magnitude = NULL;
+  msg = NULL;
+  msgLen = 0;
+  callback = NULL;
+  context = NULL;
+}
+
+CSIFeatureExtractor::~CSIFeatureExtractor(){
+  clear();
+  free(row);
+  free(delta);
+  free(magnitude);
+  free(msg);
+}
+
+void CSIFeatureExtractor::freeState(macState* s){
+  free(s->rows);
+  free(s->times);
+  free(s->sum);
+  free(s->sumSq);
+  free(s->dftRe);
+  free(s->dftIm);
+  free(s->minQueue);
+  free(s->maxQueue);
+  free(s->queueHeads);
+}
+
+void CSIFeatureExtractor::clear(){
+  for(uint32_t i = 0; i < nStates; i++){
+    freeState(states[i]);
+    delete states[i];
+  }
+  nStates = 0;
+}
+
+bool CSIFeatureExtractor::configure(uint32_t nFrames, uint32_t hop, uint32_t nBins, bool withPhase){
+  //bin k of the Hann-windowed DFT needs bin k + 1, which must not exceed the Nyquist frequency
+  if((nFrames < 2)||(nFrames > CSI_WINDOW_MAX_FRAMES)||(hop == 0)||(nBins > CSI_FEATURE_MAX_BINS)||((nBins > 0)&&(2 * (nBins + 1) > nFrames))){
+    printf("Invalid features: %u frames, hop %u, %u frequency bins\n", nFrames, hop, nBins);
+    return false;
+  }
+  clear();
+  this->nFrames = nFrames;
+  this->hop = hop;
+  this->nBins = nBins;
+  nChannels = withPhase ? 2 : 1;
+
+  free(row);
+  free(delta);
+  free(magnitude);
+  free(msg);
+  row = (float*) malloc(nChannels * CSI_FEATURE_MAX_SUBCARRIERS * sizeof(float));
+  delta = (double*) malloc(nChannels * CSI_FEATURE_MAX_SUBCARRIERS * sizeof(double));
+  magnitude = (double*) malloc(nChannels * CSI_FEATURE_MAX_SUBCARRIERS * sizeof(double));
+  msgLen = sizeof(CSIFeatureHeader) + nChannels * CSI_FEATURE_MAX_SUBCARRIERS * (CSI_FEATURE_N_STATS + nBins) * sizeof(float);
+  msg = (char*) malloc(msgLen);
+  if((!dft.configure(nFrames, nBins))||(row == NULL)||(delta == NULL)||(magnitude == NULL)||(msg == NULL)){
+    printf("Cannot allocate memory for features\n");
+    free(msg);
+    msg = NULL;
+    msgLen = 0;
+    return false;
+  }
+  return true;
+}
+
+void CSIFeatureExtractor::setCallback(CSIWindowCallback callback, void* context){
+  this->callback = callback;
+  this->context = context;
+}
+
+CSIFeatureExtractor::macState* CSIFeatureExtractor::getState(const uint8_t* MAC){
+  for(uint32_t i = 0; i < nStates; i++){
+    if(memcmp(states[i]->MAC, MAC, 6) == 0){
+      return states[i];
+    }
+  }
+  if(nStates >= CSI_FEATURE_MAX_MACS){
+    return NULL;
+  }
+  macState* s = new macState;
+  memset(s, 0, sizeof(macState));
+  memcpy(s->MAC, MAC, 6);
+  states[nStates] = s;
+  nStates++;
+  return s;
+}
+
+bool CSIFeatureExtractor::resetState(macState* s, uint32_t nSubCarriers){
+  uint32_t nValues = nChannels * nSubCarriers;
+  if((s->rows == NULL)||(nValues != s->nValues)){
+    freeState(s);
+    s->rows = (float*) malloc(nFrames * nValues * sizeof(float));
+    s->times = (uint64_t*) malloc(nFrames * sizeof(uint64_t));
+    s->sum = (double*) malloc(nValues * sizeof(double));
+    s->sumSq = (double*) malloc(nValues * sizeof(double));
+    s->dftRe = (double*) malloc((nBins + 2) * nValues * sizeof(double));
+    s->dftIm = (double*) malloc((nBins + 2) * nValues * sizeof(double));
+    s->minQueue = (uint32_t*) malloc(nFrames * nValues * sizeof(uint32_t));
+    s->maxQueue = (uint32_t*) malloc(nFrames * nValues * sizeof(uint32_t));
+    s->queueHeads = (uint32_t*) malloc(4 * nValues * sizeof(uint32_t));
+    if((s->rows == NULL)||(s->times == NULL)||(s->sum == NULL)||(s->sumSq == NULL)||(s->dftRe == NULL)||(s->dftIm == NULL)||
+       (s->minQueue == NULL)||(s->maxQueue == NULL)||(s->queueHeads == NULL)){
+      printf("Cannot allocate memory for features\n");
+      freeState(s);
+      memset(s, 0, sizeof(macState));
+      return false;
+    }
+  }
+  s->nSubCarriers = nSubCarriers;
+  s->nValues = nValues;
+  s->count = 0;
+  memset(s->sum, 0, nValues * sizeof(double));
+  memset(s->sumSq, 0, nValues * sizeof(double));
+  memset(s->dftRe, 0, (nBins + 2) * nValues * sizeof(double));
+  memset(s->dftIm, 0, (nBins + 2) * nValues * sizeof(double));
+  memset(s->queueHeads, 0, 4 * nValues * sizeof(uint32_t));
+  return true;
+}
+
+void CSIFeatureExtractor::pushQueue(const macState* s, uint32_t* q, uint32_t* head, uint32_t v, uint32_t p, float x, bool isMax){
+  uint32_t len = head[1];
+  while(len > 0){
+    float back = s->rows[q[(head[0] + len - 1) % nFrames] * s->nValues + v];
+    if((isMax) ? (back > x) : (back < x)){
+      break;
+    }
+    len--;
+  }
+  q[(head[0] + len) % nFrames] = p;
+  head[1] = len + 1;
+}
+
+void CSIFeatureExtractor::emitFeatures(macState* s){
+  if(callback == NULL){
+    return;
+  }
+  uint32_t nValues = s->nValues;
+  uint32_t nFeatures = CSI_FEATURE_N_STATS + nBins;
+  CSIFeatureHeader* h = (CSIFeatureHeader*) msg;
+  float* features = (float*) (msg + sizeof(CSIFeatureHeader));
+
+  memcpy(h->magic, CSI_FEATURE_MAGIC, 4);
+  h->headerLen = sizeof(CSIFeatureHeader);
+  memcpy(h->MAC, s->MAC, 6);
+  h->nBins = nBins;
+  h->nFrames = nFrames;
+  h->nSubCarriers = s->nSubCarriers;
+  h->nChannels = nChannels;
+  h->nFeatures = nFeatures;
+  h->tStart = s->times[(s->count - nFrames) % nFrames];
+  h->tEnd = s->times[(s->count - 1) % nFrames];
+
+  for(uint32_t v = 0; v < nValues; v++){
+    float* f = features + v * nFeatures;
+    double mean = s->sum[v] / nFrames;
+    double energy = s->sumSq[v] / nFrames;
+    const uint32_t* head = s->queueHeads + 4 * v;
+    f[CSI_FEATURE_MEAN] = mean;
+    //rounding may make the variance of a constant slightly negative
+    f[CSI_FEATURE_VARIANCE] = (energy > mean * mean) ? energy - mean * mean : 0;
+    f[CSI_FEATURE_MIN] = s->rows[s->minQueue[v * nFrames + head[0]] * nValues + v];
+    f[CSI_FEATURE_MAX] = s->rows[s->maxQueue[v * nFrames + head[2]] * nValues + v];
+    f[CSI_FEATURE_ENERGY] = energy;
+  }
+  for(uint32_t k = 1; k <= nBins; k++){
+    dft.getMagnitudes(s->dftRe, s->dftIm, nValues, k, false, magnitude);
+    for(uint32_t v = 0; v < nValues; v++){
+      features[v * nFeatures + CSI_FEATURE_N_STATS + k - 1] = magnitude[v];
+    }
+  }
+  callback(context, msg, sizeof(CSIFeatureHeader) + nValues * nFeatures * sizeof(float));
+}
+
+void CSIFeatureExtractor::addFrame(const CSIData* data, const struct timespec_16bytes* t){
+  uint32_t n = data->nSubCarriers;
+  if(n > CSI_FEATURE_MAX_SUBCARRIERS){
+    n = CSI_FEATURE_MAX_SUBCARRIERS;
+  }
+  if((msg == NULL)||(n == 0)){
+    return;
+  }
+  macState* s = getState(data->senderMAC);
+  if(s == NULL){
+    return;
+  }
+  if(((n != s->nSubCarriers)||(s->rows == NULL))&&(!resetState(s, n))){
+    return;
+  }
+
+  uint32_t nValues = s->nValues;
+  uint32_t p = s->count % nFrames;
+  float* oldRow = s->rows + p * nValues;
+  bool full = s->count >= nFrames;
+  for(uint32_t i = 0; i < n; i++){
+    row[i] = data->amplitude[i];
+  }
+  if(nChannels == 2){
+    for(uint32_t i = 0; i < n; i++){
+      row[n + i] = data->phase[i];
+    }
+  }
+
+  //the frame at position p leaves the window, unless the window is not full yet
+  if(full){
+    for(uint32_t v = 0; v < nValues; v++){
+      delta[v] = (double) row[v] - oldRow[v];
+      s->sumSq[v] += (double) row[v] * row[v] - (double) oldRow[v] * oldRow[v];
+    }
+  }else{
+    for(uint32_t v = 0; v < nValues; v++){
+      delta[v] = row[v];
+      s->sumSq[v] += (double) row[v] * row[v];
+    }
+  }
+  for(uint32_t v = 0; v < nValues; v++){
+    s->sum[v] += delta[v];
+  }
+
+  dft.update(s->dftRe, s->dftIm, delta, nValues);
+
+  //minimum and maximum. The frame leaving the window is the oldest one, so it can only be at the head of a queue.
+  for(uint32_t v = 0; v < nValues; v++){
+    uint32_t* head = s->queueHeads + 4 * v;
+    uint32_t* minQueue = s->minQueue + v * nFrames;
+    uint32_t* maxQueue = s->maxQueue + v * nFrames;
+    if(full){
+      if((head[1] > 0)&&(minQueue[head[0]] == p)){
+        head[0] = (head[0] + 1) % nFrames;
+        head[1]--;
+      }
+      if((head[3] > 0)&&(maxQueue[head[2]] == p)){
+        head[2] = (head[2] + 1) % nFrames;
+        head[3]--;
+      }
+    }
+    pushQueue(s, minQueue, head, v, p, row[v], false);
+    pushQueue(s, maxQueue, head + 2, v, p, row[v], true);
+  }
+
+  memcpy(oldRow, row, nValues * sizeof(float));
+  s->times[p] = t->tv_sec * 1000000000ULL + t->tv_nsec;
+  s->count++;
+  if((s->count >= nFrames)&&((s->count - nFrames) % hop == 0)){
+    emitFeatures(s);
+  }
+}
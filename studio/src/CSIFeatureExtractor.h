@@ -0,0 +1,158 @@
+/*
+ * CSIFeatureExtractor.h
+ * Computes sliding-window statistics and spectral features of each subcarrier of each MAC address, which are passed to the classifier instead of the raw frames.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIFEATUREEXTRACTOR_H_
+#define CSIFEATUREEXTRACTOR_H_
+
+#include <inttypes.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+#include "CSIWindowAssembler.h"
+#include "CSISlidingDFT.h"
+
+#define CSI_FEATURE_MAGIC "WEFT"                ///Magic value at the beginning of each feature message
+#define CSI_FEATURE_MAX_MACS 256                ///Maximum number of MAC addresses features are computed for
+#define CSI_FEATURE_MAX_BINS 64                 ///Maximum number of spectral features per subcarrier
+
+/**
+ * Features of each subcarrier, in the order they appear in a feature message. They are followed by the spectral features.
+ */
+enum CSIFeature{
+  CSI_FEATURE_MEAN = 0,                         ///Mean of the window
+  CSI_FEATURE_VARIANCE = 1,                     ///Variance of the window
+  CSI_FEATURE_MIN = 2,                          ///Minimum of the window
+  CSI_FEATURE_MAX = 3,                          ///Maximum of the window
+  CSI_FEATURE_ENERGY = 4,                       ///Mean of the squared values of the window
+  CSI_FEATURE_N_STATS = 5                       ///Number of statistical features. Features CSI_FEATURE_N_STATS + k - 1 are the magnitudes of the frequency bins k = 1...nBins
+};
+
+/**
+ * Header of each feature message, followed by nChannels x nSubCarriers x nFeatures float32 values (features of the amplitudes, then of the phases if nChannels == 2).
+ * All values are little endian.
+ */
+struct CSIFeatureHeader{
+  char magic[4];                                ///CSI_FEATURE_MAGIC without the terminating 0
+  uint32_t headerLen;                           ///Size of this header, i.e., offset of the features
+  uint8_t MAC[6];                               ///MAC address of the sender
+  uint16_t nBins;                               ///Number of spectral features per subcarrier
+  uint32_t nFrames;                             ///Number of frames of the window the features are computed from
+  uint32_t nSubCarriers;                        ///Number of subcarriers
+  uint32_t nChannels;                           ///1: amplitudes only, 2: amplitudes and phases
+  uint32_t nFeatures;                           ///Features per subcarrier, i.e., CSI_FEATURE_N_STATS + nBins
+  uint64_t tStart;                              ///Time of the first frame of the window in ns since 1970
+  uint64_t tEnd;                                ///Time of the last frame of the window in ns since 1970
+};
+
+/**
+ * \brief Computes features of sliding windows of nFrames consecutive frames per MAC address.
+ *
+ * The features of each subcarrier are the mean, variance, minimum, maximum and energy of its values in the window and, optionally, the magnitudes of the
+ * first nBins frequency bins (without the DC bin) of the Hann-windowed DFT of the window, divided by nFrames.
+ * After the first window of a MAC address is complete, the features are passed to the callback every hop frames.
+ *
+ * Each frame updates the features in a time independent of the window length: the sums of the values and of their squares as well as the DFT bins are updated by
+ * removing the oldest frame and adding the new one (sliding DFT, see CSISlidingDFT), and the minimum and maximum are kept in monotonic queues.
+ * The sums are kept in double precision, so the rounding errors of the updates do not accumulate to a visible level.
+ * The updates run over all subcarriers of a frame in contiguous arrays, such that the compiler can vectorize them.
+ * The memory of each MAC address is allocated when it appears for the first time or its number of subcarriers changes, so there is no allocation per frame.
+ */
+class CSIFeatureExtractor{
+  private:
+  /**
+   * State of one MAC address
+   */
+  struct macState{
+    uint8_t MAC[6];                             ///The MAC address
+    uint32_t nSubCarriers;                      ///Number of subcarriers of the frames in rows
+    uint32_t nValues;                           ///Values per frame, i.e., nChannels * nSubCarriers
+    float* rows;                                ///Ring of nFrames rows of nValues values
+    uint64_t* times;                            ///Time of each row in ns
+    uint64_t count;                             ///Number of rows added since the state has been reset. Row i is at position i % nFrames
+    double* sum;                                ///Sum of each value over the window
+    double* sumSq;                              ///Sum of the squares of each value over the window
+    double* dftRe;                              ///Real parts of the DFT bins 0...nBins + 1 of each value, bin-major
+    double* dftIm;                              ///Imaginary parts of the DFT bins
+    uint32_t* minQueue;                         ///Per value a ring of nFrames row positions whose values increase from the head. The head is the minimum of the window.
+    uint32_t* maxQueue;                         ///Per value a ring of row positions whose values decrease from the head
+    uint32_t* queueHeads;                       ///Head and length of minQueue and maxQueue for each value
+  };
+
+  macState* states[CSI_FEATURE_MAX_MACS];       ///All MAC addresses
+  uint32_t nStates;                             ///Number of entries in states
+  uint32_t nFrames;                             ///Frames per window
+  uint32_t hop;                                 ///Number of frames between two consecutive feature messages
+  uint32_t nBins;                               ///Number of spectral features per subcarrier
+  uint32_t nChannels;                           ///1: amplitudes only, 2: amplitudes and phases
+  CSISlidingDFT dft;                            ///Updates dftRe and dftIm of the states and applies the Hann window
+  float* row;                                   ///The values of the current frame
+  double* delta;                                ///Difference between the values of the current frame and of the frame leaving the window
+  double* magnitude;                            ///Magnitudes of one windowed bin of all values of a frame
+  char* msg;                                    ///Buffer for a feature message
+  uint32_t msgLen;                              ///Size of msg
+  CSIWindowCallback callback;                   ///Called for every feature message
+  void* context;                                ///Passed to callback
+
+  /**
+   * Returns the state of the given MAC address, which is created if needed. Returns NULL if there are too many MAC addresses.
+   */
+  macState* getState(const uint8_t* MAC);
+
+  /**
+   * Discard all frames of s and prepare it for frames of nSubCarriers subcarriers. Returns false if the memory cannot be allocated.
+   */
+  bool resetState(macState* s, uint32_t nSubCarriers);
+
+  /**
+   * Free the arrays of s
+   */
+  static void freeState(macState* s);
+
+  /**
+   * Push row position p, whose value v is about to be stored, to the back of the monotonic queue q with the given head and length.
+   * Removes all entries from the back whose values are not smaller (minQueue) or not greater (maxQueue) than x.
+   */
+  void pushQueue(const macState* s, uint32_t* q, uint32_t* head, uint32_t v, uint32_t p, float x, bool isMax);
+
+  /**
+   * Write the features of the window ending with the most recent row of s into msg and pass it to the callback
+   */
+  void emitFeatures(macState* s);
+
+  /**
+   * Free the state of all MAC addresses
+   */
+  void clear();
+
+  public:
+  CSIFeatureExtractor();
+  ~CSIFeatureExtractor();
+
+  /**
+   * Set the window length, the number of frames between two feature messages and the number of spectral features, discarding all frames received so far.
+   * Returns false if the parameters are invalid.
+   */
+  bool configure(uint32_t nFrames, uint32_t hop, uint32_t nBins, bool withPhase);
+
+  /**
+   * Set the function called for every feature message
+   */
+  void setCallback(CSIWindowCallback callback, void* context);
+
+  /**
+   * Add a frame received at time t
+   */
+  void addFrame(const CSIData* data, const struct timespec_16bytes* t);
+};
+
+#endif /* CSIFEATUREEXTRACTOR_H_ */
@@ -12,6 +12,7 @@
 
 #include <QVector>
 #include <QLineEdit>
+#include <QFileDialog>
 #include "CSIFilterGUIManager.h"
 #include "CSIFilter.h"
 #include "mainwindow.h"
@@ -462,3 +463,14 @@ void CSIFilterGUIManager::attachFilters(){
 CSIFilterManager* CSIFilterGUIManager::getFilterManager(){
   return manager;
 }
+
+/*Store the current filter pipeline in a file selected by the user*/
+void CSIFilterGUIManager::savePipeline(){
+  QString fileName = QFileDialog::getSaveFileName(mw, "Save Filter Pipeline", "pipeline.conf", "Filter pipelines (*.conf);;All files (*)");
+  if(fileName.isEmpty()){
+    return;
+  }
+  if(!manager->savePipelineConfiguration(fileName)){
+    mw->getUI()->statusBar->showMessage("Could not save filter pipeline", 5000);
+  }
+}
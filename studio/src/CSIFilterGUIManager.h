@@ -147,6 +147,12 @@ public slots:
    * Toggle between "filters attached" or "filters detached" from the main window.
    */
   void attachDetach();
+
+  /**
+   * Ask for a file name and store the current filter pipeline (active filters, priorities and parameters) there.
+   * The file can be used to re-filter recordings offline using tools/batch.
+   */
+  void savePipeline();
 };
 
 
@@ -11,8 +11,14 @@
  */
 #include "CSIFilterManager.h"
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
 #include <QtAlgorithms>
 #include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 using namespace std;
 struct sortStruct;
 
@@ -98,3 +104,119 @@ void CSIFilterManager::applyFilterPipeline(CSIData* data){
 
 }
 
+
+void CSIFilterManager::activateDefaultFilters(){
+  char buf[CSI_FILTER_NAME_PARMETER_STLEN];
+  mutex.lock();
+  for(uint32_t i = 0; i < filters.length(); i++){
+    strcpy(buf,"");
+    filters[i]->getParameter((char*) "defaultPriority",buf);
+    if(strcmp(buf,"")!=0){
+      filters[i]->setPriority(atoi(buf));
+    }
+    strcpy(buf,"");
+    filters[i]->getParameter((char*) "defaultActive",buf);
+    filters[i]->setActive(strcmp(buf,"1")==0);
+  }
+  mutex.unlock();
+  updatePriorities();
+}
+
+bool CSIFilterManager::loadPipelineConfiguration(const QString& fileName){
+  QFile file(fileName);
+  if(!file.open(QIODevice::ReadOnly|QIODevice::Text)){
+    cout<<"Could not open pipeline configuration '"<<fileName.toLocal8Bit().data()<<"'"<<endl;
+    return false;
+  }
+  QTextStream in(&file);
+  QVector<bool> listed(filters.length(), false);
+  QStringList tokens;
+  QString line;
+  uint32_t lineNr = 0;
+  bool success = true;
+  int32_t idx;
+  int32_t eq;
+
+  mutex.lock();
+  while(!in.atEnd()){
+    line = in.readLine().trimmed();
+    lineNr++;
+    if((line.isEmpty())||(line.startsWith('#'))){
+      continue;
+    }
+    tokens = line.split(QLatin1Char(';'));
+
+    //find the filter by the name of its .cfi file
+    idx = -1;
+    for(uint32_t i = 0; i < filters.length(); i++){
+      if(QFileInfo(filters[i]->getFileName()).fileName() == tokens[0].trimmed()){
+        idx = i;
+      }
+    }
+    if(idx < 0){
+      printf("%s:%u: filter '%s' has not been loaded\n", fileName.toLocal8Bit().data(), lineNr, tokens[0].toLocal8Bit().data());
+      success = false;
+      continue;
+    }
+    listed[idx] = true;
+    if(tokens.length() > 1){
+      filters[idx]->setPriority(tokens[1].trimmed().toUInt());
+    }
+    filters[idx]->setActive(true);
+    for(int32_t j = 2; j < tokens.length(); j++){
+      eq = tokens[j].indexOf('=');
+      if(eq <= 0){
+        printf("%s:%u: cannot parse parameter '%s'\n", fileName.toLocal8Bit().data(), lineNr, tokens[j].toLocal8Bit().data());
+        success = false;
+        continue;
+      }
+      filters[idx]->setParameter(tokens[j].left(eq).trimmed().toLocal8Bit().data(), tokens[j].mid(eq + 1).trimmed().toLocal8Bit().data());
+    }
+  }
+  for(uint32_t i = 0; i < filters.length(); i++){
+    if(!listed[i]){
+      filters[i]->setActive(false);
+    }
+  }
+  mutex.unlock();
+  file.close();
+  updatePriorities();
+  return success;
+}
+
+bool CSIFilterManager::savePipelineConfiguration(const QString& fileName){
+  char listBuf[CSI_FILTER_NAME_PARMETER_LIST_STLEN];
+  char buf[CSI_FILTER_NAME_PARMETER_STLEN];
+  QStringList parListStrList;
+  QStringList tokens;
+
+  QFile file(fileName);
+  if(!file.open(QIODevice::WriteOnly|QIODevice::Text)){
+    cout<<"Could not create pipeline configuration '"<<fileName.toLocal8Bit().data()<<"'"<<endl;
+    return false;
+  }
+  QTextStream out(&file);
+  out<<"# WirelessEye filter pipeline\n";
+  out<<"# filterFile.cfi;priority;parameter1=value1;parameter2=value2;...\n";
+
+  mutex.lock();
+  for(uint32_t i = 0; i < filters.length(); i++){
+    if(!filters[i]->getActive()){
+      continue;
+    }
+    out<<QFileInfo(filters[i]->getFileName()).fileName()<<";"<<filters[i]->getPriority();
+    strcpy(listBuf,"");
+    filters[i]->getParameterList(listBuf);
+    parListStrList = QString(listBuf).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    for(uint32_t j = 0; j < parListStrList.length(); j++){
+      tokens = parListStrList[j].split(QLatin1Char(','));
+      strcpy(buf,"");
+      filters[i]->getParameter(tokens[0].toLocal8Bit().data(),buf);
+      out<<";"<<tokens[0]<<"="<<buf;
+    }
+    out<<"\n";
+  }
+  mutex.unlock();
+  file.close();
+  return (file.error() == QFileDevice::NoError);
+}
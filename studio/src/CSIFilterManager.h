@@ -61,6 +61,27 @@ public:
   * Create the priorityVector by soring the filters by their execution order.
   */
  void updatePriorities();
+
+ /**
+  * Activate all filters whose "defaultActive" parameter is 1 and set their priorities to "defaultPriority".
+  * All other filters are deactivated. Also updates the priorityVector.
+  */
+ void activateDefaultFilters();
+
+ /**
+  * Load a pipeline configuration from fileName. Each line has the format
+  *    filterFile.cfi;priority;parameter1=value1;parameter2=value2;...
+  * Lines starting with '#' are comments. The filters are identified by the name of their .cfi file (without the path).
+  * All filters listed in the file are activated, all other ones are deactivated. Also updates the priorityVector.
+  * Returns false if the file could not be read or refers to a filter that has not been loaded.
+  */
+ bool loadPipelineConfiguration(const QString& fileName);
+
+ /**
+  * Store the currently active filters, their priorities and all their parameter values in fileName, such that the
+  * pipeline can be restored using loadPipelineConfiguration(). Returns false if the file could not be written.
+  */
+ bool savePipelineConfiguration(const QString& fileName);
 };
 
 
@@ -0,0 +1,421 @@
+/*
+ * CSIHeatmapRenderer.cpp
+ * Renders CSI and RSSI data as a scrolling heatmap into an image. It needs neither a widget nor a display server.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIHeatmapRenderer.h"
+#include <QGuiApplication>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+CSIHeatmapRenderer::CSIHeatmapRenderer(){
+  img = NULL;
+  ringPos = 0;
+  visiblePos = 0;
+  scrollAmount = 0;
+  scrollDelay = 1;
+  upperValueBound = 0;
+  lowerValueBound = 0;
+  dataOffset = 0.0;
+  autoScaling = true;
+  flatCurve = false;
+  NCSISamples = 0;
+  nLanes = 1;
+  for(uint32_t l = 0; l < DISPLAY_MAX_LANES; l++){
+    laneWritten[l] = false;
+  }
+  clearLanes();
+  clock.start();
+  resetScaling();
+
+  //3D curves: positive values from blue to red, negative ones from blue to green
+  for(int32_t c = -255; c <= 255; c++){
+    if(c > 0){
+      colorMap[c + 255] = qRgb(c, 0, 255 - c);
+    }else{
+      colorMap[c + 255] = qRgb(0, -c, 255 + c);
+    }
+  }
+}
+
+CSIHeatmapRenderer::~CSIHeatmapRenderer(){
+  delete img;
+}
+
+void CSIHeatmapRenderer::resize(uint32_t width, uint32_t height){
+  delete img;
+  img = new QImage(width, height, QImage::Format_RGB32);
+  img->fill(QColor(0, 0, 0, 0));
+  ringPos = 0;
+  visiblePos = 0;
+}
+
+uint32_t CSIHeatmapRenderer::getWidth(){
+  return (img == NULL) ? 0 : img->width();
+}
+
+uint32_t CSIHeatmapRenderer::getHeight(){
+  return (img == NULL) ? 0 : img->height();
+}
+
+void CSIHeatmapRenderer::setFlatCurve(bool flatCurve){
+  this->flatCurve = flatCurve;
+  //flat curves scale one value per column
+  resetScaling();
+}
+
+bool CSIHeatmapRenderer::isFlatCurve(){
+  return flatCurve;
+}
+
+void CSIHeatmapRenderer::setNCSISamples(uint32_t NCSISamples){
+  if(NCSISamples != this->NCSISamples){
+    //the values held for the lanes have another layout
+    clearLanes();
+    this->NCSISamples = NCSISamples;
+    resetScaling();
+  }
+}
+
+uint32_t CSIHeatmapRenderer::valuesPerLane(){
+  return flatCurve ? 1 : NCSISamples;
+}
+
+void CSIHeatmapRenderer::setScrollDelay(uint32_t scrollDelay){
+  this->scrollDelay = scrollDelay;
+}
+
+void CSIHeatmapRenderer::setUB(double value){
+  upperValueBound = value;
+}
+
+void CSIHeatmapRenderer::setLB(double value){
+  lowerValueBound = value;
+}
+
+void CSIHeatmapRenderer::setDataOffset(double offset){
+  dataOffset = offset;
+}
+
+double CSIHeatmapRenderer::getDataOffset(){
+  return dataOffset;
+}
+
+void CSIHeatmapRenderer::setAutoScaling(bool onOff){
+  autoScaling = onOff;
+}
+
+void CSIHeatmapRenderer::resetScaling(){
+  //-DBL_MAX is the lowest double. DBL_MIN is the smallest positive one, which is above any negative value such as the RSSI.
+  for(uint32_t l = 0; l < DISPLAY_MAX_LANES; l++){
+    maxValue[l] = -DBL_MAX;
+    minValue[l] = DBL_MAX;
+    scaleSketch[l].configure(HEATMAP_SCALE_WINDOW_COLUMNS * valuesPerLane(), HEATMAP_SCALE_LOWER_QUANTILE, HEATMAP_SCALE_UPPER_QUANTILE);
+  }
+}
+
+double CSIHeatmapRenderer::getMaximumValue(){
+  return maxValue[0];
+}
+
+void CSIHeatmapRenderer::clearLanes(){
+  for(uint32_t l = 0; l < DISPLAY_MAX_LANES; l++){
+    laneTime[l] = -1;
+  }
+  for(uint32_t i = 0; i < DISPLAY_MAX_LANES * DISPLAY_MAX_SUBCARRIERS; i++){
+    laneValues[i] = NAN;
+  }
+}
+
+bool CSIHeatmapRenderer::setNLanes(uint32_t nLanes){
+  if(nLanes < 1){
+    nLanes = 1;
+  }
+  if(nLanes > DISPLAY_MAX_LANES){
+    nLanes = DISPLAY_MAX_LANES;
+  }
+  if(nLanes == this->nLanes){
+    return false;
+  }
+  this->nLanes = nLanes;
+  resetScaling();
+  clearLanes();
+  for(uint32_t l = 0; l < DISPLAY_MAX_LANES; l++){
+    laneWritten[l] = false;
+    laneLabel[l] = "";
+  }
+  if(img != NULL){
+    img->fill(QColor(0, 0, 0));
+  }
+  ringPos = 0;
+  visiblePos = 0;
+  history.clear();
+  return true;
+}
+
+void CSIHeatmapRenderer::setLaneLabel(uint32_t lane, const QString& label){
+  if(lane < DISPLAY_MAX_LANES){
+    laneLabel[lane] = label;
+  }
+}
+
+QRgb CSIHeatmapRenderer::mapColor(double color){
+  if(!((color >= -255.0)&&(color <= 255.0))){
+    //NaN, e.g., if both bounds of the color range are equal
+    return colorMap[255];
+  }
+  return colorMap[(int32_t) color + 255];
+}
+
+QRgb CSIHeatmapRenderer::valueColor(double value, double lb, double ub){
+  double color;
+  /* Goals:
+   * 1) Chop off everything below lb and above rb
+   * 2) bring range to lie within -255, 255
+   * 3) If color is negative, treat like a positive value of same magnitude, but paint in green
+   *
+   * to 1) This would scale between 0...1
+   *  color = (data - minValue) / (maxValue - minValue)
+   * -> modify to "artificial" min and max values
+   *  color = (data - lb) / (ub - lb)
+   * ... and chop of what now lies below 0 or above 1
+   * to 2): Now rescale: color= color * 255;
+   */
+  if(value > 0){
+    color = ((value - lb)/(ub - lb)) * 255;
+  }else{
+    color = -((fabs(value) + lb)/(ub - lb)) * 255;
+  }
+  if(color < -255.0){
+    color = -255.0;
+  }
+  if(color > 255.0){
+    color = 255.0;
+  }
+  return mapColor(color);
+}
+
+void CSIHeatmapRenderer::drawFlatSample(QImage* image, uint32_t x, uint32_t top, uint32_t height, double data, uint32_t lane){
+  if(isnan(data)){
+    for(uint32_t y = 0; y < height; y++){
+      ((QRgb*) image->scanLine(top + y))[x] = qRgb(0, 0, 0);
+    }
+    return;
+  }
+  double color = (data - minValue[lane]) * (double) (255.0)/(maxValue[lane] - minValue[lane]);
+  if(color > 255){
+    color = 255;
+  }
+  if(color < 0){
+    color = 0;
+  }
+  QRgb c = qRgb(255 - (int32_t) color, (int32_t) color, 0);
+  int32_t y1 = ((double)(data - minValue[lane])) * ((double) (height - 1.0))/((double)(maxValue[lane] - minValue[lane]));
+  int32_t y2 = ((double)(data - minValue[lane])) * ((double) (height - 1.9))/((double)(maxValue[lane] - minValue[lane]) +1);
+  for(int32_t y = 0; y < (int32_t) height; y++){
+    ((QRgb*) image->scanLine(top + y))[x] = ((y == y1)||(y == y2)) ? c : qRgb(0, 0, 0);
+  }
+}
+
+void CSIHeatmapRenderer::drawLaneColumn(QImage* image, uint32_t x, uint32_t lane, const double* values){
+  uint32_t laneHeight = image->height() / nLanes;
+  uint32_t top = lane * laneHeight;
+  if((!flatCurve)&&(NCSISamples == 0)){
+    return;
+  }
+  if(flatCurve){
+    drawFlatSample(image, x, top, laneHeight, values[0], lane);
+    return;
+  }
+  double ub = (double) upperValueBound/1000.0 * (maxValue[lane] - minValue[lane]) + minValue[lane];
+  double lb = (double) lowerValueBound/1000.0 * (maxValue[lane] - minValue[lane]) + minValue[lane];
+  //the column is written row by row. scanLine() would check for a shared image on every call.
+  uchar* bits = image->bits();
+  uint32_t bytesPerLine = image->bytesPerLine();
+  uint32_t scaleFactor = laneHeight / NCSISamples;
+  for(uint32_t j = 0; j < NCSISamples; j++){
+    QRgb c = isnan(values[j]) ? qRgb(0, 0, 0) : valueColor(values[j], lb, ub);
+    uchar* row = bits + (top + j*scaleFactor)*bytesPerLine;
+    for(uint32_t i = 0; i < scaleFactor; i++){
+      ((QRgb*) row)[x] = c;
+      row += bytesPerLine;
+    }
+  }
+}
+
+bool CSIHeatmapRenderer::addLaneData(uint32_t lane, double* data, uint32_t n){
+  uint32_t nPerLane = valuesPerLane();
+  if(lane >= nLanes){
+    return false;
+  }
+  if(n != nPerLane){
+    printf("Skipping display data sicne nSamples != NCSISamples. Probably, it has changed recently\n");
+    return false;
+  }
+  if(img == NULL){
+    return false;
+  }
+  double* values = laneValues + lane * nPerLane;
+  for(uint32_t j = 0; j < nPerLane; j++){
+    if(flatCurve){
+      //2D curves are scaled to their range of values
+      values[j] = data[j];
+      if(autoScaling){
+        scaleSketch[lane].add(data[j]);
+      }
+    }else{
+      //3D curves are scaled to the range of magnitudes
+      data[j] = data[j] + dataOffset;
+      values[j] = data[j];
+      if(autoScaling){
+        scaleSketch[lane].add(fabs(data[j]));
+      }
+    }
+  }
+  if((autoScaling)&&(scaleSketch[lane].isValid())){
+    minValue[lane] = scaleSketch[lane].getLower();
+    maxValue[lane] = scaleSketch[lane].getUpper();
+  }
+  if(img->width() > 0){
+    drawLaneColumn(img, ringPos, lane, values);
+  }
+  laneWritten[lane] = true;
+  laneTime[lane] = clock.elapsed();
+  return true;
+}
+
+void CSIHeatmapRenderer::advanceColumn(){
+  ringPos++;
+  if(ringPos >= (uint32_t) img->width()){
+    ringPos = 0;
+  }
+  if(scrollAmount >= scrollDelay-1){
+    visiblePos = ringPos;
+    scrollAmount = 0;
+  }else{
+    scrollAmount++;
+  }
+}
+
+void CSIHeatmapRenderer::nextColumn(){
+  if((img == NULL)||(img->width() == 0)){
+    return;
+  }
+  //only lanes without data for this column cost extra work
+  uint32_t nPerLane = valuesPerLane();
+  qint64 now = clock.elapsed();
+  for(uint32_t l = 0; l < nLanes; l++){
+    if(laneWritten[l]){
+      laneWritten[l] = false;
+      continue;
+    }
+    double* values = laneValues + l * nPerLane;
+    if((laneTime[l] < 0)||(now - laneTime[l] > HEATMAP_LANE_HOLD_MS)){
+      for(uint32_t j = 0; j < nPerLane; j++){
+        values[j] = NAN;
+      }
+    }
+    drawLaneColumn(img, ringPos, l, values);
+  }
+  history.add(laneValues, nPerLane * nLanes, now);
+  if(flatCurve){
+    //flat curves scroll with every sample
+    ringPos = (ringPos + 1) % img->width();
+    visiblePos = ringPos;
+  }else{
+    advanceColumn();
+  }
+}
+
+void CSIHeatmapRenderer::draw(QPainter* p){
+  if(img == NULL){
+    return;
+  }
+  //unwrap the ring: the oldest column visiblePos is shown at the left edge
+  p->drawImage(0, 0, *img, visiblePos, 0, img->width() - visiblePos, img->height());
+  if(visiblePos > 0){
+    p->drawImage(img->width() - visiblePos, 0, *img, 0, 0, visiblePos, img->height());
+  }
+}
+
+void CSIHeatmapRenderer::drawLaneLabels(QPainter* p, uint32_t height){
+  if(nLanes > 1){
+    p->setPen(Qt::white);
+    for(uint32_t l = 0; l < nLanes; l++){
+      p->drawText(4, l * (height / nLanes) + 14, laneLabel[l]);
+    }
+  }
+}
+
+QImage CSIHeatmapRenderer::snapshot(){
+  if((img == NULL)||(img->width() == 0)){
+    return QImage();
+  }
+  QImage image(img->width(), img->height(), QImage::Format_RGB32);
+  QPainter p(&image);
+  draw(&p);
+  //text needs the fonts of a QGuiApplication
+  if(qobject_cast<QGuiApplication*>(QCoreApplication::instance()) != NULL){
+    drawLaneLabels(&p, image.height());
+  }
+  p.end();
+  return image;
+}
+
+void CSIHeatmapRenderer::setHistoryMinutes(int minutes){
+  //lower resolutions keep peaks of CSI, but the RSSI curve keeps its unit
+  history.configure(minutes * 60000, HEATMAP_HISTORY_MAX_BYTES, flatCurve ? CSI_REDUCE_MEAN : CSI_REDUCE_MAXABS);
+}
+
+CSIDisplayHistory* CSIHeatmapRenderer::getHistory(){
+  return &history;
+}
+
+void CSIHeatmapRenderer::renderHistory(QImage* image, bool live, uint32_t level, uint64_t end, QString* label){
+  static double values[DISPLAY_MAX_LANES * DISPLAY_MAX_SUBCARRIERS];
+  uint32_t nPerLane = valuesPerLane();
+  uint32_t width = image->width();
+  image->fill(QColor(0, 0, 0));
+  if((history.getN() == 0)||(history.getN() != nPerLane * nLanes)){
+    *label = "No history";
+    return;
+  }
+  //one column of the level per pixel, so the effort does not depend on the zoom factor
+  if(live){
+    end = history.getEnd(level);
+  }else{
+    end = end >> level;
+  }
+  uint64_t begin = history.getBegin(level);
+  uint32_t newest = 0;
+  bool hasNewest = false;
+  for(uint32_t x = 0; x < width; x++){
+    if(end < width - x){
+      continue;
+    }
+    uint64_t index = end - (width - x);
+    uint32_t t;
+    if((index < begin)||(!history.getColumn(level, index, values, &t))){
+      continue;
+    }
+    newest = t;
+    hasNewest = true;
+    for(uint32_t l = 0; l < nLanes; l++){
+      drawLaneColumn(image, x, l, values + l * nPerLane);
+    }
+  }
+  if(hasNewest){
+    *label = QString("%1 s  x%2").arg(-((double) (uint32_t) ((uint32_t) clock.elapsed() - newest)) / 1000.0, 0, 'f', 1).arg(1u << level);
+  }else{
+    *label = QString("x%1").arg(1u << level);
+  }
+}
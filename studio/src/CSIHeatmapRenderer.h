@@ -0,0 +1,231 @@
+/*
+ * CSIHeatmapRenderer.h
+ * Renders CSI and RSSI data as a scrolling heatmap into an image. It needs neither a widget nor a display server.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIHEATMAPRENDERER_H_
+#define CSIHEATMAPRENDERER_H_
+
+#include <QImage>
+#include <QString>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <inttypes.h>
+#include "CSIDisplayHistory.h"
+#include "CSIDisplayLanes.h"
+#include "CSIQuantileSketch.h"
+
+#define HEATMAP_COLORMAP_LEN (2*255 + 1)        ///Number of entries in the color map, i.e., one per integer color value between -255 and 255
+#define HEATMAP_HISTORY_MAX_BYTES (128 * 1024 * 1024) ///Memory limit of the history of each heatmap
+#define HEATMAP_LANE_HOLD_MS 1000               ///A lane without new data keeps showing its last column for this time in ms. Then, it is cleared.
+#define HEATMAP_SCALE_WINDOW_COLUMNS 1000       ///The color scale follows the values of about this many recent columns
+#define HEATMAP_SCALE_LOWER_QUANTILE 0.01       ///Quantile of the recent values mapped to the lower end of the color scale
+#define HEATMAP_SCALE_UPPER_QUANTILE 0.99       ///Quantile of the recent values mapped to the upper end of the color scale
+
+/**
+ * \brief Draws CSI and RSSI data column by column into an image.
+ *
+ * 3D curves (e.g., CSI amplitudes) show one value per subcarrier in color, flat curves (e.g., RSSI) show one value per column as a line. The height is split into
+ * lanes, e.g., one per sender, each with its own color scale. The image is a ring of columns: new data is written to one column, and the ring is unwrapped only
+ * when it is drawn. The columns are kept in a history for panning and zooming.
+ *
+ * The renderer only uses QImage, so it works without a QWidget, e.g., for snapshots on machines without a display. It is not thread-safe.
+ */
+class CSIHeatmapRenderer{
+  private:
+  QImage* img;                                  ///The ring of columns. NULL => no size set
+  uint32_t ringPos;                             ///Column of img the next column is written to
+  uint32_t visiblePos;                          ///Column of img shown at the left edge, i.e., the oldest column shown. Follows ringPos every scrollDelay columns
+  uint32_t scrollAmount;                        ///Columns written since visiblePos has been moved
+  uint32_t scrollDelay;                         ///The plot scrolls after this many columns by as many pixels
+  QRgb colorMap[HEATMAP_COLORMAP_LEN];          ///Color of each integer color value between -255 and 255 for 3D curves
+  double maxValue[DISPLAY_MAX_LANES];           ///The upper end of the values of each lane, used for scaling the color values. With autoScaling, the upper quantile of the recent values
+  double minValue[DISPLAY_MAX_LANES];           ///The lower end of the values of each lane, used for scaling the color values. With autoScaling, the lower quantile of the recent values
+  CSIQuantileSketch scaleSketch[DISPLAY_MAX_LANES]; ///Estimates the quantiles of the recent values of each lane, so a single outlier does not flatten the color scale
+  double upperValueBound;                       ///Upper end of the color range in 1/1000 of the range of values
+  double lowerValueBound;                       ///Lower end of the color range in 1/1000 of the range of values
+  double dataOffset;                            ///Added to each value of a 3D curve
+  bool autoScaling;                             ///true => minValue and maxValue follow the quantiles of the recent values
+  bool flatCurve;                               ///true => a 2D curve, such as RSSI. false => a 3D curve, e.g., CSI, in color
+  uint32_t NCSISamples;                         ///The number of values per column of a 3D curve, i.e., the number of subcarriers
+  uint32_t nLanes;                              ///Number of lanes the height is split into
+  double laneValues[DISPLAY_MAX_LANES * DISPLAY_MAX_SUBCARRIERS]; ///Values of the current column of all lanes, NaN => no data. This is the column stored in the history
+  qint64 laneTime[DISPLAY_MAX_LANES];           ///Time of the last data of each lane (clock). < 0 => none
+  bool laneWritten[DISPLAY_MAX_LANES];          ///true => the lane has got data for the current column
+  QString laneLabel[DISPLAY_MAX_LANES];         ///Shown in the corner of each lane
+  CSIDisplayHistory history;                    ///The columns rendered so far, for panning and zooming
+  QElapsedTimer clock;                          ///Time base of the history and the lanes
+
+  /**
+   * Returns the color of a value of a 3D curve scaled to -255...255. Negative values are painted in green.
+   */
+  QRgb mapColor(double color);
+
+  /**
+   * Returns the color of a value of a 3D curve, given the bounds lb and ub of the color range
+   */
+  QRgb valueColor(double value, double lb, double ub);
+
+  /**
+   * Draw a sample of a flat curve, scaled for the given lane, into column x of image between the rows top and top + height - 1, which are cleared first
+   */
+  void drawFlatSample(QImage* image, uint32_t x, uint32_t top, uint32_t height, double data, uint32_t lane);
+
+  /**
+   * Draw the values of a lane into column x of image. NaN values are drawn in black.
+   */
+  void drawLaneColumn(QImage* image, uint32_t x, uint32_t lane, const double* values);
+
+  /**
+   * Forget the values and the times of all lanes
+   */
+  void clearLanes();
+
+  /**
+   * Advance ringPos by one column after a column of a 3D curve has been written. The plot scrolls every scrollDelay columns.
+   */
+  void advanceColumn();
+
+  public:
+  CSIHeatmapRenderer();
+  ~CSIHeatmapRenderer();
+
+  /**
+   * Set the size of the plot in pixels. The plot is cleared.
+   */
+  void resize(uint32_t width, uint32_t height);
+
+  /**
+   * Width of the plot in pixels. 0 => no size set
+   */
+  uint32_t getWidth();
+
+  /**
+   * Height of the plot in pixels
+   */
+  uint32_t getHeight();
+
+  /**
+   * Plot a 2D curve (e.g., RSSI) if flatCurve == true, otherwise a 3D curve, e.g., CSI, in which the 3rd dimension is encoded by the color
+   */
+  void setFlatCurve(bool flatCurve);
+
+  /**
+   * Returns true, if a 2D curve is plotted
+   */
+  bool isFlatCurve();
+
+  /**
+   * Set the number of values per column of a 3D curve, i.e., the number of subcarriers. The lanes and the scaling are reset if it changes.
+   */
+  void setNCSISamples(uint32_t NCSISamples);
+
+  /**
+   * Number of values per lane and column
+   */
+  uint32_t valuesPerLane();
+
+  /**
+   * Scroll the plot by N pixels after every N columns. Values above 1 make the plot look less fluent.
+   */
+  void setScrollDelay(uint32_t scrollDelay);
+
+  /**
+   * Set the upper end of the color range in 1/1000 of the range of values. Values above are shown in the color of the upper end.
+   */
+  void setUB(double value);
+
+  /**
+   * Set the lower end of the color range in 1/1000 of the range of values. Values below are shown in the color of the lower end.
+   */
+  void setLB(double value);
+
+  /**
+   * Set the offset added to each value of a 3D curve
+   */
+  void setDataOffset(double offset);
+
+  /**
+   * Read the data offset. See setDataOffset()
+   */
+  double getDataOffset();
+
+  /**
+   * Activate and deactivate the automatic tracking of the range of the recent values
+   */
+  void setAutoScaling(bool onOff);
+
+  /**
+   * Forget the values seen so far by the automatic scaling of all lanes
+   */
+  void resetScaling();
+
+  /**
+   * Get the maximum value to be displayed in the first lane
+   */
+  double getMaximumValue();
+
+  /**
+   * Split the height into the given number of lanes (1...DISPLAY_MAX_LANES). The plot, the history, the labels and the scaling are reset.
+   * Returns false if the number of lanes is unchanged. Then, nothing is reset.
+   */
+  bool setNLanes(uint32_t nLanes);
+
+  /**
+   * Set the text shown in the corner of a lane, e.g., the MAC address of its sender
+   */
+  void setLaneLabel(uint32_t lane, const QString& label);
+
+  /**
+   * Set the values of a lane for the current column. n has to be equal to valuesPerLane(). The values of 3D curves are changed by the offset.
+   * Returns false if the data is not drawn.
+   */
+  bool addLaneData(uint32_t lane, double* data, uint32_t n);
+
+  /**
+   * Complete the current column. Lanes without data keep showing their last values for HEATMAP_LANE_HOLD_MS, then they are cleared.
+   */
+  void nextColumn();
+
+  /**
+   * Draw the plot with the oldest column at the left edge into p, starting at (0, 0)
+   */
+  void draw(QPainter* p);
+
+  /**
+   * Draw the labels of the lanes into p, given the height of the plot. Nothing is drawn with a single lane.
+   */
+  void drawLaneLabels(QPainter* p, uint32_t height);
+
+  /**
+   * Returns a copy of the plot with the oldest column at the left edge, e.g., to be saved while new columns are added. The labels of the lanes are drawn only if
+   * fonts are available, i.e., in a QGuiApplication. Returns a null image if no size is set.
+   */
+  QImage snapshot();
+
+  /**
+   * Keep the columns of the given number of minutes for panning and zooming. 0 => no history
+   */
+  void setHistoryMinutes(int minutes);
+
+  /**
+   * The columns rendered so far
+   */
+  CSIDisplayHistory* getHistory();
+
+  /**
+   * Render the columns of the given history level ending before column end (or the newest ones if live == true) into image, one column of the level per pixel.
+   * The position and the zoom factor are written to label.
+   */
+  void renderHistory(QImage* image, bool live, uint32_t level, uint64_t end, QString* label);
+};
+
+#endif /* CSIHEATMAPRENDERER_H_ */
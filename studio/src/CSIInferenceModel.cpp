@@ -0,0 +1,379 @@
+/*
+ * CSIInferenceModel.cpp
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIInferenceModel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static inline float sigmoid(float x){
+  return 1.0f / (1.0f + expf(-x));
+}
+
+CSIInferenceModel::CSIInferenceModel(){
+  data = NULL;
+  nLayers = 0;
+  inSteps = 0;
+  inFeatures = 0;
+  nOutputs = 0;
+  buf[0] = NULL;
+  buf[1] = NULL;
+  state = NULL;
+  testInput = NULL;
+  testOutput = NULL;
+}
+
+CSIInferenceModel::~CSIInferenceModel(){
+  unload();
+}
+
+void CSIInferenceModel::unload(){
+  free(data);
+  free(buf[0]);
+  free(buf[1]);
+  free(state);
+  data = NULL;
+  buf[0] = NULL;
+  buf[1] = NULL;
+  state = NULL;
+  testInput = NULL;
+  testOutput = NULL;
+  nLayers = 0;
+}
+
+bool CSIInferenceModel::isLoaded(){
+  return nLayers > 0;
+}
+
+uint32_t CSIInferenceModel::getInputSteps(){
+  return inSteps;
+}
+
+uint32_t CSIInferenceModel::getInputFeatures(){
+  return inFeatures;
+}
+
+uint32_t CSIInferenceModel::getNOutputs(){
+  return nOutputs;
+}
+
+bool CSIInferenceModel::load(const char* fileName){
+  unload();
+  FILE* f = fopen(fileName, "rb");
+  if(f == NULL){
+    printf("Cannot open model %s\n", fileName);
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  data = (char*) malloc((len > 0) ? len : 1);
+  if((len <= 0)||(data == NULL)||(fread(data, 1, len, f) != (size_t) len)){
+    printf("Cannot read model %s\n", fileName);
+    fclose(f);
+    unload();
+    return false;
+  }
+  fclose(f);
+  if(!parse(len)){
+    printf("Invalid model file %s\n", fileName);
+    unload();
+    return false;
+  }
+
+  //compare the outputs for the test input to those of the original model
+  if(testInput != NULL){
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    const float* out = run(testInput);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double maxDeviation = 0;
+    for(uint32_t i = 0; i < nOutputs; i++){
+      double deviation = fabs(out[i] - testOutput[i]) / ((fabs(testOutput[i]) > 1) ? fabs(testOutput[i]) : 1);
+      if(!(deviation <= maxDeviation)){
+        maxDeviation = deviation;
+      }
+    }
+    printf("Model %s: %u layers, inference %.3f ms, max. deviation from the original model %g\n", fileName, nLayers,
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6, maxDeviation);
+    if(!(maxDeviation <= CSI_MODEL_TOLERANCE)){
+      printf("Model %s: the outputs differ from those of the original model\n", fileName);
+      unload();
+      return false;
+    }
+  }else{
+    printf("Model %s: %u layers, no test input to compare to the original model\n", fileName, nLayers);
+  }
+  return true;
+}
+
+bool CSIInferenceModel::parse(uint64_t len){
+  CSIModelHeader h;
+  if(len < sizeof(CSIModelHeader)){
+    return false;
+  }
+  memcpy(&h, data, sizeof(CSIModelHeader));
+  if((memcmp(h.magic, CSI_MODEL_MAGIC, 4) != 0)||(h.version != CSI_MODEL_VERSION)){
+    printf("Not a model of version %u\n", CSI_MODEL_VERSION);
+    return false;
+  }
+  if((h.headerLen < sizeof(CSIModelHeader))||(h.headerLen % 4 != 0)||(h.headerLen > len)||(h.nLayers == 0)||(h.nLayers > CSI_MODEL_MAX_LAYERS)||
+     (h.inSteps == 0)||(h.inSteps > CSI_MODEL_MAX_SIZE)||(h.inFeatures == 0)||(h.inFeatures > CSI_MODEL_MAX_SIZE)){
+    return false;
+  }
+
+  uint64_t pos = h.headerLen;
+  uint64_t steps = h.inSteps;
+  uint64_t features = h.inFeatures;
+  uint64_t maxValues = steps * features;
+  uint64_t maxState = 0;
+  for(uint32_t i = 0; i < h.nLayers; i++){
+    CSIModelLayerHeader lh;
+    if(pos + sizeof(CSIModelLayerHeader) > len){
+      printf("Layer %u: truncated\n", i);
+      return false;
+    }
+    memcpy(&lh, data + pos, sizeof(CSIModelLayerHeader));
+    pos += sizeof(CSIModelLayerHeader);
+    if((lh.type > CSI_LAYER_LSTM)||(lh.activation > CSI_ACTIVATION_TANH)||
+       (lh.param[0] > CSI_MODEL_MAX_SIZE)||(lh.param[1] > CSI_MODEL_MAX_SIZE)||(lh.param[2] > CSI_MODEL_MAX_SIZE)){
+      printf("Layer %u: unsupported type or parameters\n", i);
+      return false;
+    }
+
+    layer* l = &layers[i];
+    l->type = (CSIModelLayerType) lh.type;
+    l->activation = (CSIModelActivation) lh.activation;
+    l->units = 0;
+    l->kernelSize = 0;
+    l->stride = 0;
+    l->returnSequences = false;
+    l->inSteps = steps;
+    l->inFeatures = features;
+    uint64_t nKernel = 0;
+    uint64_t nRecurrent = 0;
+    uint64_t nBias = 0;
+    switch(l->type){
+      case CSI_LAYER_DENSE:
+        l->units = lh.param[0];
+        l->outSteps = steps;
+        l->outFeatures = l->units;
+        nKernel = features * l->units;
+        nBias = l->units;
+        break;
+      case CSI_LAYER_CONV1D:
+      case CSI_LAYER_MAXPOOL1D:
+        l->units = (l->type == CSI_LAYER_CONV1D) ? lh.param[0] : features;
+        l->kernelSize = (l->type == CSI_LAYER_CONV1D) ? lh.param[1] : lh.param[0];
+        l->stride = (l->type == CSI_LAYER_CONV1D) ? lh.param[2] : lh.param[1];
+        if((l->kernelSize == 0)||(l->kernelSize > steps)||(l->stride == 0)){
+          printf("Layer %u: invalid kernel size or stride\n", i);
+          return false;
+        }
+        l->outSteps = (steps - l->kernelSize) / l->stride + 1;
+        l->outFeatures = l->units;
+        if(l->type == CSI_LAYER_CONV1D){
+          nKernel = l->kernelSize * features * l->units;
+          nBias = l->units;
+        }
+        break;
+      case CSI_LAYER_FLATTEN:
+        l->outSteps = 1;
+        l->outFeatures = steps * features;
+        break;
+      case CSI_LAYER_LSTM:
+        l->units = lh.param[0];
+        l->returnSequences = (lh.param[1] != 0);
+        l->outSteps = l->returnSequences ? steps : 1;
+        l->outFeatures = l->units;
+        nKernel = features * 4 * l->units;
+        nRecurrent = (uint64_t) l->units * 4 * l->units;
+        nBias = 4 * l->units;
+        if(6 * l->units > maxState){
+          maxState = 6 * l->units;
+        }
+        break;
+    }
+    if((l->outFeatures == 0)||((uint64_t) l->outSteps * l->outFeatures > CSI_MODEL_MAX_SIZE)){
+      printf("Layer %u: invalid number of outputs\n", i);
+      return false;
+    }
+    if(pos + (nKernel + nRecurrent + nBias) * sizeof(float) > len){
+      printf("Layer %u: truncated\n", i);
+      return false;
+    }
+    l->kernel = (const float*) (data + pos);
+    l->recurrent = l->kernel + nKernel;
+    l->bias = l->recurrent + nRecurrent;
+    pos += (nKernel + nRecurrent + nBias) * sizeof(float);
+
+    steps = l->outSteps;
+    features = l->outFeatures;
+    if(steps * features > maxValues){
+      maxValues = steps * features;
+    }
+  }
+  if(steps * features != h.nOutputs){
+    printf("The model has %" PRIu64 " outputs instead of %u\n", steps * features, h.nOutputs);
+    return false;
+  }
+
+  testInput = NULL;
+  testOutput = NULL;
+  if(h.hasTest){
+    if(pos + ((uint64_t) h.inSteps * h.inFeatures + h.nOutputs) * sizeof(float) > len){
+      printf("Test input truncated\n");
+      return false;
+    }
+    testInput = (const float*) (data + pos);
+    testOutput = testInput + (uint64_t) h.inSteps * h.inFeatures;
+  }
+
+  buf[0] = (float*) malloc(maxValues * sizeof(float));
+  buf[1] = (float*) malloc(maxValues * sizeof(float));
+  state = (float*) malloc((maxState > 0) ? maxState * sizeof(float) : 1);
+  if((buf[0] == NULL)||(buf[1] == NULL)||(state == NULL)){
+    printf("Cannot allocate memory for the model\n");
+    return false;
+  }
+  nLayers = h.nLayers;
+  inSteps = h.inSteps;
+  inFeatures = h.inFeatures;
+  nOutputs = h.nOutputs;
+  return true;
+}
+
+void CSIInferenceModel::matVecAdd(const float* __restrict x, uint32_t nIn, const float* __restrict kernel, uint32_t nOut, float* __restrict y){
+  for(uint32_t i = 0; i < nIn; i++){
+    float xi = x[i];
+    //after ReLU, many inputs are zero
+    if(xi == 0){
+      continue;
+    }
+    const float* __restrict w = kernel + (uint64_t) i * nOut;
+    for(uint32_t o = 0; o < nOut; o++){
+      y[o] += xi * w[o];
+    }
+  }
+}
+
+void CSIInferenceModel::activate(float* y, uint32_t nSteps, uint32_t n, CSIModelActivation activation){
+  uint64_t nValues = (uint64_t) nSteps * n;
+  switch(activation){
+    case CSI_ACTIVATION_LINEAR:
+      break;
+    case CSI_ACTIVATION_RELU:
+      for(uint64_t i = 0; i < nValues; i++){
+        y[i] = (y[i] > 0) ? y[i] : 0;
+      }
+      break;
+    case CSI_ACTIVATION_SIGMOID:
+      for(uint64_t i = 0; i < nValues; i++){
+        y[i] = sigmoid(y[i]);
+      }
+      break;
+    case CSI_ACTIVATION_TANH:
+      for(uint64_t i = 0; i < nValues; i++){
+        y[i] = tanhf(y[i]);
+      }
+      break;
+    case CSI_ACTIVATION_SOFTMAX:
+      //over the features of each step, like Keras
+      for(uint32_t t = 0; t < nSteps; t++){
+        float* yt = y + (uint64_t) t * n;
+        float max = yt[0];
+        for(uint32_t i = 1; i < n; i++){
+          max = (yt[i] > max) ? yt[i] : max;
+        }
+        float sum = 0;
+        for(uint32_t i = 0; i < n; i++){
+          yt[i] = expf(yt[i] - max);
+          sum += yt[i];
+        }
+        for(uint32_t i = 0; i < n; i++){
+          yt[i] /= sum;
+        }
+      }
+      break;
+  }
+}
+
+void CSIInferenceModel::runLayer(const layer* l, const float* x, float* y){
+  switch(l->type){
+    case CSI_LAYER_DENSE:
+      for(uint32_t t = 0; t < l->inSteps; t++){
+        float* yt = y + (uint64_t) t * l->units;
+        memcpy(yt, l->bias, l->units * sizeof(float));
+        matVecAdd(x + (uint64_t) t * l->inFeatures, l->inFeatures, l->kernel, l->units, yt);
+      }
+      break;
+    case CSI_LAYER_CONV1D:
+      //the kernelSize input steps of each output step are contiguous, so each output step is a dense layer
+      for(uint32_t t = 0; t < l->outSteps; t++){
+        float* yt = y + (uint64_t) t * l->units;
+        memcpy(yt, l->bias, l->units * sizeof(float));
+        matVecAdd(x + (uint64_t) t * l->stride * l->inFeatures, l->kernelSize * l->inFeatures, l->kernel, l->units, yt);
+      }
+      break;
+    case CSI_LAYER_MAXPOOL1D:
+      for(uint32_t t = 0; t < l->outSteps; t++){
+        float* __restrict yt = y + (uint64_t) t * l->inFeatures;
+        memcpy(yt, x + (uint64_t) t * l->stride * l->inFeatures, l->inFeatures * sizeof(float));
+        for(uint32_t j = 1; j < l->kernelSize; j++){
+          const float* __restrict xj = x + ((uint64_t) t * l->stride + j) * l->inFeatures;
+          for(uint32_t c = 0; c < l->inFeatures; c++){
+            yt[c] = (xj[c] > yt[c]) ? xj[c] : yt[c];
+          }
+        }
+      }
+      break;
+    case CSI_LAYER_FLATTEN:
+      memcpy(y, x, (uint64_t) l->inSteps * l->inFeatures * sizeof(float));
+      break;
+    case CSI_LAYER_LSTM:{
+      uint32_t u = l->units;
+      float* h = state;
+      float* c = state + u;
+      float* z = state + 2 * u;
+      memset(h, 0, 2 * u * sizeof(float));
+      for(uint32_t t = 0; t < l->inSteps; t++){
+        memcpy(z, l->bias, 4 * u * sizeof(float));
+        matVecAdd(x + (uint64_t) t * l->inFeatures, l->inFeatures, l->kernel, 4 * u, z);
+        matVecAdd(h, u, l->recurrent, 4 * u, z);
+        for(uint32_t j = 0; j < u; j++){
+          c[j] = sigmoid(z[u + j]) * c[j] + sigmoid(z[j]) * tanhf(z[2 * u + j]);
+          h[j] = sigmoid(z[3 * u + j]) * tanhf(c[j]);
+        }
+        if(l->returnSequences){
+          memcpy(y + (uint64_t) t * u, h, u * sizeof(float));
+        }
+      }
+      if(!l->returnSequences){
+        memcpy(y, h, u * sizeof(float));
+      }
+      break;
+    }
+  }
+  activate(y, l->outSteps, l->outFeatures, l->activation);
+}
+
+const float* CSIInferenceModel::run(const float* input){
+  const float* x = input;
+  for(uint32_t i = 0; i < nLayers; i++){
+    float* y = buf[i % 2];
+    runLayer(&layers[i], x, y);
+    x = y;
+  }
+  return x;
+}
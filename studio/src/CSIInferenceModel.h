@@ -0,0 +1,175 @@
+/*
+ * CSIInferenceModel.h
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIINFERENCEMODEL_H_
+#define CSIINFERENCEMODEL_H_
+
+#include <inttypes.h>
+
+#define CSI_MODEL_MAGIC "WEMD"                  ///Magic value at the beginning of a model file
+#define CSI_MODEL_EXTENSION ".wem"              ///File extension of model files
+#define CSI_MODEL_VERSION 1                     ///Version of the model file format
+#define CSI_MODEL_MAX_LAYERS 64                 ///Maximum number of layers of a model
+#define CSI_MODEL_TOLERANCE 1e-4                ///Maximum deviation from the outputs of the original model stored in the model file
+#define CSI_MODEL_MAX_SIZE (1 << 24)            ///Maximum number of units, filters, steps and features as well as values between two layers
+
+/**
+ * Types of layers. Dropout layers are not exported, since they have no effect during inference.
+ */
+enum CSIModelLayerType{
+  CSI_LAYER_DENSE = 0,                          ///Fully connected layer, applied to each step. param: units
+  CSI_LAYER_CONV1D = 1,                         ///1D convolution without padding. param: filters, kernel size, stride
+  CSI_LAYER_MAXPOOL1D = 2,                      ///1D max. pooling without padding. param: pool size, stride
+  CSI_LAYER_FLATTEN = 3,                        ///Flatten all steps into one
+  CSI_LAYER_LSTM = 4                            ///LSTM with tanh and sigmoid activations. param: units, 1 => return sequences
+};
+
+/**
+ * Activation functions applied to the outputs of a layer
+ */
+enum CSIModelActivation{
+  CSI_ACTIVATION_LINEAR = 0,
+  CSI_ACTIVATION_RELU = 1,
+  CSI_ACTIVATION_SOFTMAX = 2,
+  CSI_ACTIVATION_SIGMOID = 3,
+  CSI_ACTIVATION_TANH = 4
+};
+
+/**
+ * Header of a model file. It is followed by nLayers layers, each consisting of a CSIModelLayerHeader and the weights of the layer.
+ * If hasTest is 1, the layers are followed by an input of inSteps x inFeatures values and the nOutputs outputs the original model computes for it.
+ * All values are little endian, all weights single precision floating point values.
+ */
+struct CSIModelHeader{
+  char magic[4];                                ///CSI_MODEL_MAGIC without the terminating 0
+  uint32_t version;                             ///CSI_MODEL_VERSION
+  uint32_t headerLen;                           ///Size of this header, i.e., offset of the first layer
+  uint32_t nLayers;                             ///Number of layers
+  uint32_t inSteps;                             ///Number of steps of the input, i.e., frames
+  uint32_t inFeatures;                          ///Number of features per step, i.e., subcarriers
+  uint32_t nOutputs;                            ///Number of outputs of the last layer
+  uint32_t hasTest;                             ///1 => a test input and its outputs follow the layers
+};
+
+/**
+ * Header of each layer. It is followed by the weights in the layout of Keras:
+ * - Dense: kernel (inputs x units), bias (units)
+ * - Conv1D: kernel (kernel size x input features x filters), bias (filters)
+ * - LSTM: kernel (input features x 4 units), recurrent kernel (units x 4 units), bias (4 units), gates in the order input, forget, cell, output
+ */
+struct CSIModelLayerHeader{
+  uint32_t type;                                ///CSIModelLayerType
+  uint32_t activation;                          ///CSIModelActivation
+  uint32_t param[3];                            ///Parameters, depending on the type
+  uint32_t reserved;
+};
+
+/**
+ * \brief Built-in inference runtime for small neural networks
+ *
+ * Runs models trained by scripts/model_generation.py, which are exported to a model file by scripts/wirelesseye_model.py, without depending on a machine learning framework.
+ * The input is one window of inSteps x inFeatures values in row-major order, i.e., as passed to the Keras model.
+ * All computations are done in single precision. The inner loops run over contiguous outputs, such that the compiler can vectorize them.
+ */
+class CSIInferenceModel{
+private:
+  /**
+   * One layer and the shapes of its input and output
+   */
+  struct layer{
+    CSIModelLayerType type;
+    CSIModelActivation activation;
+    uint32_t units;                             ///Units of dense and LSTM layers, filters of convolutions
+    uint32_t kernelSize;                        ///Kernel size of convolutions, pool size of pooling layers
+    uint32_t stride;                            ///Stride of convolutions and pooling layers
+    bool returnSequences;                       ///LSTM: true => output all steps, false => only the last one
+    uint32_t inSteps;
+    uint32_t inFeatures;
+    uint32_t outSteps;
+    uint32_t outFeatures;
+    const float* kernel;                        ///Points into data
+    const float* recurrent;                     ///Recurrent kernel of LSTM layers
+    const float* bias;
+  };
+
+  char* data;                                   ///Contents of the model file. The weights of the layers point into it.
+  layer layers[CSI_MODEL_MAX_LAYERS];           ///The layers
+  uint32_t nLayers;                             ///Number of entries in layers. 0 => no model loaded
+  uint32_t inSteps;                             ///Number of steps of the input
+  uint32_t inFeatures;                          ///Number of features per step
+  uint32_t nOutputs;                            ///Number of outputs
+  float* buf[2];                                ///Outputs of the layers, used alternately
+  float* state;                                 ///State and gates of LSTM layers
+  const float* testInput;                       ///Test input stored in the model file, NULL if there is none
+  const float* testOutput;                      ///Outputs of the original model for testInput
+
+  /**
+   * Add the product of the row vector x with nIn elements and the nIn x nOut matrix kernel to y
+   */
+  static void matVecAdd(const float* x, uint32_t nIn, const float* kernel, uint32_t nOut, float* y);
+
+  /**
+   * Apply the activation function to n values per step of y
+   */
+  static void activate(float* y, uint32_t nSteps, uint32_t n, CSIModelActivation activation);
+
+  /**
+   * Compute the output y of layer l for input x
+   */
+  void runLayer(const layer* l, const float* x, float* y);
+
+  /**
+   * Parse the contents of a model file of len bytes. Returns false if it is invalid.
+   */
+  bool parse(uint64_t len);
+
+public:
+  CSIInferenceModel();
+  ~CSIInferenceModel();
+
+  /**
+   * Load a model file. If it contains a test input, the outputs are compared to those of the original model. Returns false on failure.
+   */
+  bool load(const char* fileName);
+
+  /**
+   * Free the model
+   */
+  void unload();
+
+  /**
+   * Returns true, if a model is loaded
+   */
+  bool isLoaded();
+
+  /**
+   * Number of steps of the input, i.e., frames per window
+   */
+  uint32_t getInputSteps();
+
+  /**
+   * Number of features per step, i.e., subcarriers
+   */
+  uint32_t getInputFeatures();
+
+  /**
+   * Number of outputs
+   */
+  uint32_t getNOutputs();
+
+  /**
+   * Run the model on inSteps x inFeatures values. Returns the nOutputs outputs, which are valid until the next call.
+   */
+  const float* run(const float* input);
+};
+
+#endif /* CSIINFERENCEMODEL_H_ */
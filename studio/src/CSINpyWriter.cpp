@@ -0,0 +1,422 @@
+/*
+ * CSINpyWriter.cpp
+ * Records CSI data as NumPy (.npy) arrays, such that it can be loaded by Python without parsing (see doc/fileFormats.pdf).
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSINpyWriter.h"
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//The arrays written per MAC. The data is written in the byte order of the host, which is little endian on all platforms WirelessEye runs on.
+static const char* columnNames[NPY_NCOLUMNS] = {"amplitude", "phase", "timestamp", "rssi", "seqNr"};
+static const char* columnDescr[NPY_NCOLUMNS] = {"<f4", "<f4", "<i8", "<f4", "<u2"};
+static const uint32_t columnSize[NPY_NCOLUMNS] = {4, 4, 8, 4, 2};
+static const bool columnPerSubCarrier[NPY_NCOLUMNS] = {true, true, false, false, false};
+
+CSINpyWriter::CSINpyWriter(){
+  strcpy(dirName, "");
+  strcpy(errorMsg, "");
+  nSubCarriers = 0;
+  hasIndices = false;
+  nMACs = 0;
+  opened = false;
+}
+
+CSINpyWriter::~CSINpyWriter(){
+  close();
+}
+
+/**
+ * Print a path into path, which has NPY_PATH_STLEN bytes. Returns false if the path does not fit.
+ */
+static bool makePath(char* path, const char* fmt, ...){
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(path, NPY_PATH_STLEN, fmt, args);
+  va_end(args);
+  return (n >= 0)&&(n < NPY_PATH_STLEN);
+}
+
+void CSINpyWriter::setError(const char* fmt, ...){
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(errorMsg, NPY_ERROR_STLEN, fmt, args);
+  va_end(args);
+}
+
+void CSINpyWriter::encodeHeader(char* buf, const char* descr, uint64_t nRows, uint32_t nCols){
+  char dict[NPY_HEADER_LEN];
+  uint16_t len = NPY_HEADER_LEN - 10;
+  int n;
+  if(nCols > 0){
+    n = snprintf(dict, sizeof(dict), "{'descr': '%s', 'fortran_order': False, 'shape': (%" PRIu64 ", %u), }", descr, nRows, nCols);
+  }else{
+    n = snprintf(dict, sizeof(dict), "{'descr': '%s', 'fortran_order': False, 'shape': (%" PRIu64 ",), }", descr, nRows);
+  }
+
+  //magic, version 1.0, header length, then the dictionary padded with spaces and terminated by a newline
+  memcpy(buf, "\x93NUMPY\x01\x00", 8);
+  buf[8] = len & 0xff;
+  buf[9] = len >> 8;
+  memset(buf + 10, ' ', len);
+  memcpy(buf + 10, dict, n);
+  buf[NPY_HEADER_LEN - 1] = '\n';
+}
+
+bool CSINpyWriter::open(const char* dirName, uint32_t nSubCarriers, const uint16_t* subCarriers){
+  close();
+  if((nSubCarriers == 0)||(nSubCarriers > NPY_MAX_SUBCARRIERS)){
+    setError("invalid number of subcarriers (%u)", nSubCarriers);
+    return false;
+  }
+  if(!makePath(this->dirName, "%s", dirName)){
+    setError("path too long: '%s'", dirName);
+    return false;
+  }
+  if((mkdir(dirName, 0755) != 0)&&(errno != EEXIST)){
+    setError("cannot create directory '%s': %s", dirName, strerror(errno));
+    return false;
+  }
+  this->nSubCarriers = nSubCarriers;
+  hasIndices = (subCarriers != NULL);
+  if(hasIndices){
+    memcpy(this->subCarriers, subCarriers, nSubCarriers * sizeof(subCarriers[0]));
+  }
+  nMACs = 0;
+  opened = true;
+  return true;
+}
+
+CSINpyWriter::npyMAC* CSINpyWriter::getMAC(const uint8_t* MAC){
+  char dir[NPY_PATH_STLEN];
+  char path[NPY_PATH_STLEN];
+  char header[NPY_HEADER_LEN];
+
+  for(uint32_t i = 0; i < nMACs; i++){
+    if(memcmp(MACs[i]->MAC, MAC, 6) == 0){
+      return MACs[i];
+    }
+  }
+  if(nMACs >= NPY_MAX_MACS){
+    setError("more than %u MAC addresses", NPY_MAX_MACS);
+    return NULL;
+  }
+
+  //first frame of this MAC -> create its directory and files
+  //the longest file name is checked here, so the paths of the files below fit, too
+  if((!makePath(dir, "%s/%x-%x-%x-%x-%x-%x", dirName, MAC[0], MAC[1], MAC[2], MAC[3], MAC[4], MAC[5]))||(!makePath(path, "%s/subcarriers.npy", dir))){
+    setError("path too long in '%s'", dirName);
+    return NULL;
+  }
+  if((mkdir(dir, 0755) != 0)&&(errno != EEXIST)){
+    setError("cannot create directory '%s': %s", dir, strerror(errno));
+    return NULL;
+  }
+  npyMAC* m = new npyMAC;
+  memcpy(m->MAC, MAC, 6);
+  m->nFrames = 0;
+  for(uint32_t c = 0; c < NPY_NCOLUMNS; c++){
+    makePath(path, "%s/%s.npy", dir, columnNames[c]);
+    m->files[c] = fopen(path, "wb");
+    m->buffers[c] = NULL;
+    if(m->files[c] == NULL){
+      setError("cannot create '%s': %s", path, strerror(errno));
+      for(uint32_t i = 0; i < c; i++){
+        fclose(m->files[i]);
+        free(m->buffers[i]);
+      }
+      delete m;
+      return NULL;
+    }
+    m->buffers[c] = (char*) malloc(NPY_FILEBUF_LEN);
+    setvbuf(m->files[c], m->buffers[c], _IOFBF, NPY_FILEBUF_LEN);
+    encodeHeader(header, columnDescr[c], 0, columnPerSubCarrier[c] ? nSubCarriers : 0);
+    fwrite(header, 1, NPY_HEADER_LEN, m->files[c]);
+  }
+
+  //the indices of the subcarriers are complete right away
+  if(hasIndices){
+    makePath(path, "%s/subcarriers.npy", dir);
+    FILE* f = fopen(path, "wb");
+    encodeHeader(header, "<u2", nSubCarriers, 0);
+    if((f == NULL)||(fwrite(header, 1, NPY_HEADER_LEN, f) != NPY_HEADER_LEN)||(fwrite(subCarriers, sizeof(subCarriers[0]), nSubCarriers, f) != nSubCarriers)){
+      printf("Cannot write '%s'\n", path);
+    }
+    if(f != NULL){
+      fclose(f);
+    }
+  }
+  MACs[nMACs++] = m;
+  return m;
+}
+
+bool CSINpyWriter::writeFrame(const CSIData* data, const struct timespec_16bytes* t){
+  float amplitude[NPY_MAX_SUBCARRIERS];
+  float phase[NPY_MAX_SUBCARRIERS];
+  int64_t timestamp = ((int64_t) t->tv_sec)*1000000000 + (int64_t) t->tv_nsec;
+  float rssi = data->RSSI;
+  uint16_t seqNr = data->seqNr;
+  bool success = true;
+
+  if(!opened){
+    return false;
+  }
+  npyMAC* m = getMAC(data->senderMAC);
+  if(m == NULL){
+    return false;
+  }
+
+  //all rows have the same length. Missing subcarriers are filled with zeros.
+  for(uint32_t i = 0; i < nSubCarriers; i++){
+    amplitude[i] = (i < data->nSubCarriers) ? data->amplitude[i] : 0;
+    phase[i] = (i < data->nSubCarriers) ? data->phase[i] : 0;
+  }
+  success = success && (fwrite(amplitude, sizeof(float), nSubCarriers, m->files[0]) == nSubCarriers);
+  success = success && (fwrite(phase, sizeof(float), nSubCarriers, m->files[1]) == nSubCarriers);
+  success = success && (fwrite(&timestamp, sizeof(timestamp), 1, m->files[2]) == 1);
+  success = success && (fwrite(&rssi, sizeof(rssi), 1, m->files[3]) == 1);
+  success = success && (fwrite(&seqNr, sizeof(seqNr), 1, m->files[4]) == 1);
+  if(!success){
+    setError("cannot write to '%s': %s", dirName, strerror(errno));
+    return false;
+  }
+  m->nFrames++;
+  return true;
+}
+
+bool CSINpyWriter::closeMAC(npyMAC* m){
+  char header[NPY_HEADER_LEN];
+  bool success = true;
+  for(uint32_t c = 0; c < NPY_NCOLUMNS; c++){
+    //a partially written frame at the end (e.g., disk full) is ignored, since the header only counts complete frames
+    encodeHeader(header, columnDescr[c], m->nFrames, columnPerSubCarrier[c] ? nSubCarriers : 0);
+    success = success && (fflush(m->files[c]) == 0);
+    success = success && (fseek(m->files[c], 0, SEEK_SET) == 0);
+    success = success && (fwrite(header, 1, NPY_HEADER_LEN, m->files[c]) == NPY_HEADER_LEN);
+    success = (fclose(m->files[c]) == 0) && success;
+    free(m->buffers[c]);
+  }
+  return success;
+}
+
+bool CSINpyWriter::close(){
+  bool success = true;
+  if(!opened){
+    return true;
+  }
+  for(uint32_t i = 0; i < nMACs; i++){
+    if(!closeMAC(MACs[i])){
+      setError("cannot finalize '%s'", dirName);
+      success = false;
+    }
+    delete MACs[i];
+  }
+  nMACs = 0;
+  opened = false;
+  return success;
+}
+
+bool CSINpyWriter::isOpen() const{
+  return opened;
+}
+
+const char* CSINpyWriter::getError() const{
+  return errorMsg;
+}
+
+/**
+ * Read number of rows and columns from the header of the .npy file f (as written by CSINpyWriter). Returns false on failure.
+ */
+static bool readShape(FILE* f, uint64_t* nRows, uint32_t* nCols){
+  char header[NPY_HEADER_LEN + 1];
+  const char* shape;
+  if(fread(header, 1, NPY_HEADER_LEN, f) != NPY_HEADER_LEN){
+    return false;
+  }
+  header[NPY_HEADER_LEN] = '\0';
+  shape = strstr(header + 10, "'shape': (");
+  if(shape == NULL){
+    return false;
+  }
+  *nCols = 0;
+  return sscanf(shape, "'shape': (%" SCNu64 ", %u", nRows, nCols) >= 1;
+}
+
+bool CSINpyWriter::merge(const char* dirName, const char* const* partDirs, uint32_t nParts){
+  static char names[NPY_MAX_MACS][32];
+  char path[NPY_PATH_STLEN];
+  char header[NPY_HEADER_LEN];
+  uint32_t nNames = 0;
+  uint32_t nPartsWithMAC;
+  uint32_t lastPart = 0;
+  struct dirent* entry;
+  struct stat st;
+  bool success = true;
+
+  //collect the MACs of all parts
+  for(uint32_t p = 0; p < nParts; p++){
+    DIR* dir = opendir(partDirs[p]);
+    if(dir == NULL){
+      continue;
+    }
+    while((entry = readdir(dir)) != NULL){
+      if((entry->d_name[0] == '.')||(strlen(entry->d_name) >= sizeof(names[0]))){
+        continue;
+      }
+      uint32_t i;
+      for(i = 0; (i < nNames)&&(strcmp(names[i], entry->d_name) != 0); i++);
+      if(i < nNames){
+        continue;
+      }
+      if(nNames >= NPY_MAX_MACS){
+        printf("Cannot merge into '%s': more than %u MAC addresses\n", dirName, NPY_MAX_MACS);
+        closedir(dir);
+        return false;
+      }
+      strcpy(names[nNames++], entry->d_name);
+    }
+    closedir(dir);
+  }
+  if((mkdir(dirName, 0755) != 0)&&(errno != EEXIST)){
+    return false;
+  }
+
+  for(uint32_t i = 0; i < nNames; i++){
+    nPartsWithMAC = 0;
+    for(uint32_t p = 0; p < nParts; p++){
+      if(!makePath(path, "%s/%s", partDirs[p], names[i])){
+        success = false;
+        continue;
+      }
+      if(stat(path, &st) == 0){
+        nPartsWithMAC++;
+        lastPart = p;
+      }
+    }
+
+    //only in one part -> just move it
+    if(nPartsWithMAC == 1){
+      char target[NPY_PATH_STLEN];
+      if((!makePath(path, "%s/%s", partDirs[lastPart], names[i]))||(!makePath(target, "%s/%s", dirName, names[i]))||(rename(path, target) != 0)){
+        success = false;
+      }
+      continue;
+    }
+
+    //otherwise, concatenate all parts for each array
+    //the longest file name is checked here, so the paths of the arrays fit, too
+    if((!makePath(path, "%s/%s/subcarriers.npy", dirName, names[i]))||(!makePath(path, "%s/%s", dirName, names[i]))){
+      success = false;
+      continue;
+    }
+    mkdir(path, 0755);
+    for(uint32_t c = 0; c < NPY_NCOLUMNS; c++){
+      uint64_t totalRows = 0, nRows;
+      uint32_t nCols = 0;
+      makePath(path, "%s/%s/%s.npy", dirName, names[i], columnNames[c]);
+      FILE* out = fopen(path, "wb");
+      if(out == NULL){
+        success = false;
+        continue;
+      }
+      encodeHeader(header, columnDescr[c], 0, 0);
+      fwrite(header, 1, NPY_HEADER_LEN, out);           //placeholder, updated below
+      for(uint32_t p = 0; p < nParts; p++){
+        if(!makePath(path, "%s/%s/%s.npy", partDirs[p], names[i], columnNames[c])){
+          success = false;
+          continue;
+        }
+        FILE* in = fopen(path, "rb");
+        if(in == NULL){
+          continue;
+        }
+        if(!readShape(in, &nRows, &nCols)){
+          success = false;
+          fclose(in);
+          continue;
+        }
+        uint64_t bytes = nRows * columnSize[c] * (nCols > 0 ? nCols : 1);
+        char buf[64*1024];
+        size_t n;
+        while((bytes > 0)&&((n = fread(buf, 1, (bytes < sizeof(buf)) ? bytes : sizeof(buf), in)) > 0)){
+          if(fwrite(buf, 1, n, out) != n){
+            success = false;
+            break;
+          }
+          bytes -= n;
+        }
+        totalRows += nRows;
+        fclose(in);
+        unlink(path);
+      }
+      encodeHeader(header, columnDescr[c], totalRows, nCols);
+      fseek(out, 0, SEEK_SET);
+      success = (fwrite(header, 1, NPY_HEADER_LEN, out) == NPY_HEADER_LEN) && success;
+      success = (fclose(out) == 0) && success;
+    }
+    //the indices of the subcarriers are the same in all parts. A part without them is fine, any other failure is not.
+    for(uint32_t p = 0; p < nParts; p++){
+      char target[NPY_PATH_STLEN];
+      if((!makePath(path, "%s/%s/subcarriers.npy", partDirs[p], names[i]))||(!makePath(target, "%s/%s/subcarriers.npy", dirName, names[i]))){
+        success = false;
+        continue;
+      }
+      if((rename(path, target) != 0)&&(errno != ENOENT)){
+        success = false;
+        unlink(path);
+      }
+    }
+    for(uint32_t p = 0; p < nParts; p++){
+      if(makePath(path, "%s/%s", partDirs[p], names[i])){
+        rmdir(path);
+      }
+    }
+  }
+  for(uint32_t p = 0; p < nParts; p++){
+    rmdir(partDirs[p]);
+  }
+  return success;
+}
+
+void CSINpyWriter::remove(const char* dirName){
+  char path[NPY_PATH_STLEN];
+  char file[NPY_PATH_STLEN];
+  struct dirent* entry;
+  struct dirent* fileEntry;
+  DIR* dir = opendir(dirName);
+  if(dir == NULL){
+    return;
+  }
+  while((entry = readdir(dir)) != NULL){
+    if((entry->d_name[0] == '.')||(!makePath(path, "%s/%s", dirName, entry->d_name))){
+      continue;
+    }
+    DIR* macDir = opendir(path);
+    if(macDir == NULL){
+      unlink(path);
+      continue;
+    }
+    while((fileEntry = readdir(macDir)) != NULL){
+      if((fileEntry->d_name[0] != '.')&&(makePath(file, "%s/%s", path, fileEntry->d_name))){
+        unlink(file);
+      }
+    }
+    closedir(macDir);
+    rmdir(path);
+  }
+  closedir(dir);
+  rmdir(dirName);
+}
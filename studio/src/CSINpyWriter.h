@@ -0,0 +1,130 @@
+/*
+ * CSINpyWriter.h
+ * Records CSI data as NumPy (.npy) arrays, such that it can be loaded by Python without parsing (see doc/fileFormats.pdf).
+ * This code does not depend on QT, such that it can be shared between WirelessEye Studio and the command line tools.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSINPYWRITER_H_
+#define CSINPYWRITER_H_
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <limits.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+
+#define NPY_HEADER_LEN 128                      ///Every .npy file written has a header of this length, such that the shape can be updated in place
+#define NPY_MAX_MACS 256                        ///Maximum number of different MAC addresses in one recording
+#define NPY_MAX_SUBCARRIERS 512                 ///Maximum number of subcarriers per frame, same limit as CSIData::amplitude[]
+#define NPY_NCOLUMNS 5                          ///Number of arrays per MAC: amplitude, phase, timestamp, rssi, seqNr
+#define NPY_PATH_STLEN PATH_MAX                 ///Maximum length of a path, including the terminating 0. Longer paths are rejected
+#define NPY_ERROR_STLEN 256                     ///Maximum length of an error message
+#define NPY_FILEBUF_LEN (256*1024)              ///Buffer size of each .npy file
+
+/**
+ * \brief Writes CSI data into one directory of .npy files per MAC address.
+ *
+ * For each MAC address, a subdirectory named after the MAC (e.g., "ca-ff-ee-0-0-1") is created in the recording directory. It contains
+ *  - amplitude.npy: float32, shape (frames, subcarriers)
+ *  - phase.npy:     float32, shape (frames, subcarriers)
+ *  - timestamp.npy: int64, shape (frames,), nanoseconds since 1970-01-01 UTC. Use .astype('datetime64[ns]') to convert.
+ *  - rssi.npy:      float32, shape (frames,)
+ *  - seqNr.npy:     uint16, shape (frames,)
+ *  - subcarriers.npy: uint16, shape (subcarriers,), the index of each subcarrier in the frames as received. Only written if the indices are given to open().
+ * The number of frames in the header of each file is updated when the recording is closed. In Python, np.load(..., mmap_mode='r') maps the data
+ * into memory without reading it.
+ */
+class CSINpyWriter{
+private:
+  /**
+   * The files belonging to one MAC address
+   */
+  struct npyMAC{
+    uint8_t MAC[6];                             ///The MAC address
+    FILE* files[NPY_NCOLUMNS];                  ///One file per array
+    char* buffers[NPY_NCOLUMNS];                ///Buffers of these files
+    uint64_t nFrames;                           ///Number of frames written
+  };
+
+  char dirName[NPY_PATH_STLEN];                 ///The recording directory
+  uint32_t nSubCarriers;                        ///Number of subcarriers per frame
+  uint16_t subCarriers[NPY_MAX_SUBCARRIERS];    ///Index of each subcarrier in the frames as received
+  bool hasIndices;                              ///true => subCarriers is valid and written to each subdirectory
+  npyMAC* MACs[NPY_MAX_MACS];                   ///All MAC addresses seen so far
+  uint32_t nMACs;                               ///Number of entries in MACs
+  bool opened;                                  ///true => a recording is in progress
+  char errorMsg[NPY_ERROR_STLEN];               ///Last error message
+
+  /**
+   * Store an error message that can be obtained via getError()
+   */
+  void setError(const char* fmt, ...);
+
+  /**
+   * Returns the files of the given MAC. They are created if the MAC has not been seen before. Returns NULL on failure.
+   */
+  npyMAC* getMAC(const uint8_t* MAC);
+
+  /**
+   * Update the headers of all files of m and close them. Returns false on failure.
+   */
+  bool closeMAC(npyMAC* m);
+
+public:
+  CSINpyWriter();
+  ~CSINpyWriter();
+
+  /**
+   * Start a recording into the directory dirName, which is created if needed. Each frame has nSubCarriers subcarriers.
+   * If subCarriers != NULL, it holds the index of each subcarrier, which is stored along with the arrays. Returns false on failure.
+   */
+  bool open(const char* dirName, uint32_t nSubCarriers, const uint16_t* subCarriers);
+
+  /**
+   * Append one frame. t is the time of reception. Returns false on failure.
+   */
+  bool writeFrame(const CSIData* data, const struct timespec_16bytes* t);
+
+  /**
+   * Finish the recording. Returns false if any file could not be written completely.
+   */
+  bool close();
+
+  /**
+   * Returns true, if a recording is in progress
+   */
+  bool isOpen() const;
+
+  /**
+   * Returns the last error message
+   */
+  const char* getError() const;
+
+  /**
+   * Write the .npy header for an array of nRows x nCols elements of type descr (e.g., "<f4") into buf, which needs to hold NPY_HEADER_LEN bytes.
+   * If nCols is 0, the array is one-dimensional.
+   */
+  static void encodeHeader(char* buf, const char* descr, uint64_t nRows, uint32_t nCols);
+
+  /**
+   * Merge several recordings (e.g., written by different processes) into the directory dirName. The frames of each MAC
+   * are concatenated in the order of partDirs. The parts are removed afterwards. Returns false on failure.
+   * If the parts contain more than NPY_MAX_MACS MAC addresses together, nothing is merged and the parts are kept.
+   */
+  static bool merge(const char* dirName, const char* const* partDirs, uint32_t nParts);
+
+  /**
+   * Remove the recording in the directory dirName, i.e., the directory, its subdirectories of MAC addresses and their arrays.
+   */
+  static void remove(const char* dirName);
+};
+
+#endif /* CSINPYWRITER_H_ */
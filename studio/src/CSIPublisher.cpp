@@ -0,0 +1,421 @@
+/*
+ * CSIPublisher.cpp
+ * Publishes raw frames, filtered frames and features on a Unix domain socket to any number of local subscribers.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIPublisher.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+
+#define PUB_MAX_FRAME_LEN (sizeof(CSIShmFrame) + 2 * CSI_SHM_MAX_SUBCARRIERS * sizeof(float))       ///Size of the largest frame
+#define PUB_MAX_FEATURES_LEN (sizeof(CSIFeatureHeader) + CSI_SHM_MAX_SUBCARRIERS * (CSI_FEATURE_N_STATS + PUB_FEATURE_BINS) * sizeof(float))    ///Size of the largest feature message
+#define PUB_MAX_MSG_LEN (sizeof(CSIPubHeader) + ((PUB_MAX_FRAME_LEN > PUB_MAX_FEATURES_LEN) ? PUB_MAX_FRAME_LEN : PUB_MAX_FEATURES_LEN))   ///Size of the largest message
+
+static const char* topicNames[CSI_N_TOPICS] = {"raw", "filtered", "features"};
+
+CSIPublisher::CSIPublisher(){
+  for(uint32_t i = 0; i < PUB_MAX_SUBSCRIBERS; i++){
+    subscribers[i].fd = -1;
+    subscribers[i].queue = NULL;
+  }
+  memset(nTopicSubscribers, 0, sizeof(nTopicSubscribers));
+  memset(topicCounter, 0, sizeof(topicCounter));
+  listenFd = -1;
+  wakeFd = -1;
+  running = false;
+  msg = (char*) malloc(PUB_MAX_MSG_LEN);
+  features.configure(PUB_FEATURE_FRAMES, PUB_FEATURE_HOP, PUB_FEATURE_BINS, false);
+  features.setCallback(featuresReady, this);
+}
+
+CSIPublisher::~CSIPublisher(){
+  close();
+  free(msg);
+}
+
+bool CSIPublisher::open(const char* path){
+  close();
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if(strlen(path) >= sizeof(addr.sun_path)){
+    printf("Socket path too long: %s\n", path);
+    return false;
+  }
+  strcpy(addr.sun_path, path);
+
+  if(msg == NULL){
+    return false;
+  }
+  listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if((listenFd < 0)||(wakeFd < 0)){
+    perror("socket()");
+    close();
+    return false;
+  }
+  //a socket left behind by a previous run is replaced, anything else is not
+  struct stat st;
+  if((lstat(path, &st) == 0)&&(S_ISSOCK(st.st_mode))){
+    unlink(path);
+  }
+  if((bind(listenFd, (struct sockaddr*) &addr, sizeof(addr)) != 0)||(listen(listenFd, PUB_MAX_SUBSCRIBERS) != 0)){
+    printf("Cannot create socket %s: %s\n", path, strerror(errno));
+    close();
+    return false;
+  }
+  this->path = QByteArray(path);
+  memset(topicCounter, 0, sizeof(topicCounter));
+  running = true;
+  start();
+  printf("Publishing on %s\n", path);
+  return true;
+}
+
+void CSIPublisher::close(){
+  if(running){
+    mutex.lock();
+    running = false;
+    mutex.unlock();
+    wake();
+    wait();
+    unlink(path.constData());
+  }
+  mutex.lock();
+  for(uint32_t i = 0; i < PUB_MAX_SUBSCRIBERS; i++){
+    if(subscribers[i].fd >= 0){
+      removeSubscriber(&subscribers[i]);
+    }
+  }
+  mutex.unlock();
+  if(listenFd >= 0){
+    ::close(listenFd);
+    listenFd = -1;
+  }
+  if(wakeFd >= 0){
+    ::close(wakeFd);
+    wakeFd = -1;
+  }
+}
+
+bool CSIPublisher::isOpen(){
+  return running;
+}
+
+void CSIPublisher::wake(){
+  uint64_t one = 1;
+  if(write(wakeFd, &one, sizeof(one)) != sizeof(one)){
+    //the counter is already non-zero, so the thread wakes up anyway
+  }
+}
+
+void CSIPublisher::removeSubscriber(subscriber* s){
+  ::close(s->fd);
+  s->fd = -1;
+  for(uint32_t t = 0; t < CSI_N_TOPICS; t++){
+    if(s->topics & (1 << t)){
+      nTopicSubscribers[t]--;
+    }
+  }
+  s->topics = 0;
+  free(s->queue);
+  s->queue = NULL;
+}
+
+void CSIPublisher::acceptSubscriber(){
+  int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if(fd < 0){
+    return;
+  }
+  mutex.lock();
+  subscriber* s = NULL;
+  for(uint32_t i = 0; (i < PUB_MAX_SUBSCRIBERS)&&(s == NULL); i++){
+    if(subscribers[i].fd < 0){
+      s = &subscribers[i];
+    }
+  }
+  char* queue = (s != NULL) ? (char*) malloc(PUB_QUEUE_LEN) : NULL;
+  if(queue == NULL){
+    mutex.unlock();
+    printf("Rejecting subscriber: too many subscribers\n");
+    ::close(fd);
+    return;
+  }
+  s->fd = fd;
+  s->queue = queue;
+  s->head = 0;
+  s->tail = 0;
+  s->lagging = false;
+  s->sent = 0;
+  s->dropped = 0;
+  s->lineLen = 0;
+  s->nMACs = 0;
+  s->topics = 1 << CSI_TOPIC_FILTERED;
+  nTopicSubscribers[CSI_TOPIC_FILTERED]++;
+  mutex.unlock();
+}
+
+void CSIPublisher::parseSubscription(subscriber* s, char* line){
+  uint32_t topics = 0;
+  uint32_t nMACs = 0;
+  char* save;
+  char* MACs = strchr(line, ' ');
+  if(MACs != NULL){
+    *MACs = '\0';
+    MACs++;
+  }
+  for(char* name = strtok_r(line, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save)){
+    for(uint32_t t = 0; t < CSI_N_TOPICS; t++){
+      if(strcmp(name, topicNames[t]) == 0){
+        topics |= 1 << t;
+      }
+    }
+  }
+  for(char* MAC = (MACs != NULL) ? strtok_r(MACs, ", \r", &save) : NULL; (MAC != NULL)&&(nMACs < PUB_MAX_MACS); MAC = strtok_r(NULL, ", \r", &save)){
+    unsigned int b[6];
+    char end;
+    if(sscanf(MAC, "%x:%x:%x:%x:%x:%x%c", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5], &end) == 6){
+      for(uint32_t j = 0; j < 6; j++){
+        s->MACs[nMACs][j] = b[j];
+      }
+      nMACs++;
+    }
+  }
+
+  for(uint32_t t = 0; t < CSI_N_TOPICS; t++){
+    nTopicSubscribers[t] += ((topics >> t) & 1) - ((s->topics >> t) & 1);
+  }
+  s->topics = topics;
+  s->nMACs = nMACs;
+}
+
+bool CSIPublisher::readSubscription(subscriber* s){
+  while(1){
+    ssize_t n = read(s->fd, s->line + s->lineLen, PUB_LINE_LEN - 1 - s->lineLen);
+    if(n == 0){
+      return false;
+    }
+    if(n < 0){
+      return (errno == EAGAIN)||(errno == EINTR);
+    }
+    s->lineLen += n;
+    s->line[s->lineLen] = '\0';
+    //only complete lines count. A line that does not fit is discarded.
+    char* line = s->line;
+    char* end;
+    while((end = strchr(line, '\n')) != NULL){
+      *end = '\0';
+      mutex.lock();
+      parseSubscription(s, line);
+      mutex.unlock();
+      line = end + 1;
+    }
+    s->lineLen = (line == s->line)&&(s->lineLen == PUB_LINE_LEN - 1) ? 0 : s->line + s->lineLen - line;
+    memmove(s->line, line, s->lineLen);
+  }
+}
+
+bool CSIPublisher::sendQueue(subscriber* s){
+  while(1){
+    mutex.lock();
+    uint64_t head = s->head;
+    uint64_t tail = s->tail;
+    mutex.unlock();
+    if(head == tail){
+      return true;
+    }
+    //the bytes between tail and head are not modified by deliver()
+    uint64_t pos = tail % PUB_QUEUE_LEN;
+    uint64_t len = (head - tail < PUB_QUEUE_LEN - pos) ? head - tail : PUB_QUEUE_LEN - pos;
+    ssize_t n = send(s->fd, s->queue + pos, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if(n < 0){
+      return (errno == EAGAIN)||(errno == EINTR);
+    }
+    mutex.lock();
+    s->tail += n;
+    if((s->lagging)&&(s->head - s->tail <= PUB_QUEUE_LEN / 2)){
+      s->lagging = false;
+    }
+    mutex.unlock();
+  }
+}
+
+void CSIPublisher::deliver(CSIPubTopic topic, const uint8_t* MAC, const char* msg, uint32_t len){
+  bool wakeUp = false;
+  mutex.lock();
+  for(uint32_t i = 0; i < PUB_MAX_SUBSCRIBERS; i++){
+    subscriber* s = &subscribers[i];
+    if((s->fd < 0)||(!(s->topics & (1 << topic)))){
+      continue;
+    }
+    if(s->nMACs > 0){
+      uint32_t j = 0;
+      while((j < s->nMACs)&&(memcmp(s->MACs[j], MAC, 6) != 0)){
+        j++;
+      }
+      if(j == s->nMACs){
+        continue;
+      }
+    }
+    if((s->lagging)||(s->head - s->tail + len > PUB_QUEUE_LEN)){
+      s->lagging = true;
+      s->dropped++;
+      continue;
+    }
+    uint64_t pos = s->head % PUB_QUEUE_LEN;
+    uint64_t first = (len < PUB_QUEUE_LEN - pos) ? len : PUB_QUEUE_LEN - pos;
+    memcpy(s->queue + pos, msg, first);
+    memcpy(s->queue, msg + first, len - first);
+    //the thread only waits for the queues that were not empty
+    wakeUp = wakeUp || (s->head == s->tail);
+    s->head += len;
+    s->sent++;
+  }
+  mutex.unlock();
+  if(wakeUp){
+    wake();
+  }
+}
+
+void CSIPublisher::featuresReady(void* context, const char* msg, uint32_t len){
+  CSIPublisher* p = (CSIPublisher*) context;
+  CSIPubHeader* h = (CSIPubHeader*) p->msg;
+  memcpy(h->magic, PUB_MAGIC, 4);
+  h->len = sizeof(CSIPubHeader) + len;
+  h->topic = CSI_TOPIC_FEATURES;
+  h->reserved = 0;
+  memcpy(p->msg + sizeof(CSIPubHeader), msg, len);
+  p->topicCounter[CSI_TOPIC_FEATURES]++;
+  p->deliver(CSI_TOPIC_FEATURES, ((const CSIFeatureHeader*) msg)->MAC, p->msg, h->len);
+}
+
+void CSIPublisher::publish(CSIPubTopic topic, const CSIData* data, const struct timespec_16bytes* t){
+  if((!running)||(msg == NULL)){
+    return;
+  }
+  if((topic == CSI_TOPIC_FILTERED)&&(nTopicSubscribers[CSI_TOPIC_FEATURES] > 0)){
+    features.addFrame(data, t);
+  }
+  if(nTopicSubscribers[topic] == 0){
+    return;
+  }
+
+  uint32_t n = (data->nSubCarriers < CSI_SHM_MAX_SUBCARRIERS) ? data->nSubCarriers : CSI_SHM_MAX_SUBCARRIERS;
+  CSIPubHeader* h = (CSIPubHeader*) msg;
+  CSIShmFrame* f = (CSIShmFrame*) (msg + sizeof(CSIPubHeader));
+  float* values = (float*) (msg + sizeof(CSIPubHeader) + sizeof(CSIShmFrame));
+  memcpy(h->magic, PUB_MAGIC, 4);
+  h->len = sizeof(CSIPubHeader) + sizeof(CSIShmFrame) + 2 * n * sizeof(float);
+  h->topic = topic;
+  h->reserved = 0;
+  memset(f, 0, sizeof(CSIShmFrame));
+  topicCounter[topic]++;
+  f->counter = topicCounter[topic];
+  f->tv_sec = t->tv_sec;
+  f->tv_nsec = t->tv_nsec;
+  memcpy(f->MAC, data->senderMAC, 6);
+  f->seqNr = data->seqNr;
+  f->RSSI = data->RSSI;
+  f->frame_control = data->frame_control;
+  f->nSubCarriers = n;
+  for(uint32_t i = 0; i < n; i++){
+    values[i] = data->amplitude[i];
+  }
+  for(uint32_t i = 0; i < n; i++){
+    values[n + i] = data->phase[i];
+  }
+  deliver(topic, data->senderMAC, msg, h->len);
+}
+
+uint32_t CSIPublisher::getStats(CSIPubSubscriberStats* stats, uint32_t max){
+  uint32_t n = 0;
+  mutex.lock();
+  for(uint32_t i = 0; (i < PUB_MAX_SUBSCRIBERS)&&(n < max); i++){
+    const subscriber* s = &subscribers[i];
+    if(s->fd < 0){
+      continue;
+    }
+    stats[n].topics = s->topics;
+    stats[n].nMACs = s->nMACs;
+    stats[n].queued = s->head - s->tail;
+    stats[n].sent = s->sent;
+    stats[n].dropped = s->dropped;
+    n++;
+  }
+  mutex.unlock();
+  return n;
+}
+
+void CSIPublisher::run(){
+  struct pollfd fds[PUB_MAX_SUBSCRIBERS + 2];
+  subscriber* polled[PUB_MAX_SUBSCRIBERS];
+  printf("Publisher thread starting...\n");
+  while(1){
+    mutex.lock();
+    if(!running){
+      mutex.unlock();
+      break;
+    }
+    fds[0].fd = listenFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFd;
+    fds[1].events = POLLIN;
+    uint32_t nFds = 2;
+    for(uint32_t i = 0; i < PUB_MAX_SUBSCRIBERS; i++){
+      subscriber* s = &subscribers[i];
+      if(s->fd >= 0){
+        fds[nFds].fd = s->fd;
+        fds[nFds].events = POLLIN | ((s->head != s->tail) ? POLLOUT : 0);
+        polled[nFds - 2] = s;
+        nFds++;
+      }
+    }
+    mutex.unlock();
+
+    if(poll(fds, nFds, -1) < 0){
+      continue;
+    }
+    if(fds[1].revents & POLLIN){
+      uint64_t count;
+      if(read(wakeFd, &count, sizeof(count)) != sizeof(count)){
+        //another wake-up is pending
+      }
+    }
+    //only this thread removes subscribers, so the polled ones are still valid
+    for(uint32_t i = 2; i < nFds; i++){
+      subscriber* s = polled[i - 2];
+      bool ok = true;
+      if(fds[i].revents & POLLIN){
+        ok = readSubscription(s);
+      }
+      if((ok)&&(fds[i].revents & POLLOUT)){
+        ok = sendQueue(s);
+      }
+      if((!ok)||(fds[i].revents & (POLLERR | POLLHUP | POLLNVAL))){
+        mutex.lock();
+        removeSubscriber(s);
+        mutex.unlock();
+      }
+    }
+    if(fds[0].revents & POLLIN){
+      acceptSubscriber();
+    }
+  }
+  printf("Publisher thread terminating\n");
+}
@@ -0,0 +1,188 @@
+/*
+ * CSIPublisher.h
+ * Publishes raw frames, filtered frames and features on a Unix domain socket to any number of local subscribers.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIPUBLISHER_H_
+#define CSIPUBLISHER_H_
+
+#include <QThread>
+#include <QMutex>
+#include <QByteArray>
+#include <inttypes.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+#include "CSIShmExport.h"
+#include "CSIFeatureExtractor.h"
+
+#define PUB_DEFAULT_PATH "/tmp/wirelesseye.sock"        ///Default path of the socket
+#define PUB_MAGIC "WEPB"                        ///Magic value at the beginning of each message
+#define PUB_MAX_SUBSCRIBERS 16                  ///Maximum number of subscribers connected at the same time
+#define PUB_MAX_MACS 64                         ///Maximum number of MAC addresses a subscriber can restrict its subscription to
+#define PUB_QUEUE_LEN (4 * 1024 * 1024)         ///Size of the queue of each subscriber in bytes
+#define PUB_LINE_LEN 2048                       ///Maximum length of a subscription
+#define PUB_FEATURE_FRAMES 32                   ///Window length of the published features
+#define PUB_FEATURE_HOP 8                       ///Frames between two feature messages of a MAC address
+#define PUB_FEATURE_BINS 4                      ///Frequency bins of the published features
+
+/**
+ * Topics a subscriber can subscribe to
+ */
+enum CSIPubTopic{
+  CSI_TOPIC_RAW = 0,                            ///Frames before the filter pipeline
+  CSI_TOPIC_FILTERED = 1,                       ///Frames after the filter pipeline, as recorded and exported
+  CSI_TOPIC_FEATURES = 2,                       ///Features of the filtered frames (see CSIFeatureExtractor)
+  CSI_N_TOPICS = 3
+};
+
+/**
+ * Header of each message. All values are little endian.
+ * Frames are followed by a CSIShmFrame, whose counter is the number of the frame within the topic, and nSubCarriers amplitudes and phases as float32.
+ * Features are followed by a feature message as written to a classifier (see CSIFeatureHeader).
+ */
+struct CSIPubHeader{
+  char magic[4];                                ///PUB_MAGIC without the terminating 0
+  uint32_t len;                                 ///Size of the message including this header
+  uint32_t topic;                               ///CSIPubTopic
+  uint32_t reserved;
+};
+
+/**
+ * State of a subscriber as shown in the GUI
+ */
+struct CSIPubSubscriberStats{
+  uint32_t topics;                              ///Bit i set => subscribed to topic i
+  uint32_t nMACs;                               ///Number of MAC addresses the subscription is restricted to. 0 => all
+  uint64_t queued;                              ///Bytes waiting to be sent, i.e., how far the subscriber lags behind
+  uint64_t sent;                                ///Messages passed to the subscriber
+  uint64_t dropped;                             ///Messages dropped because the queue of the subscriber was full
+};
+
+/**
+ * \brief Local publish/subscribe output of processed frames.
+ *
+ * Subscribers connect to a Unix domain socket and write a subscription line: the topics ("raw", "filtered", "features") separated by commas, optionally
+ * followed by a space and a comma-separated list of MAC addresses. Until then, they get the filtered frames of all MAC addresses. A new line replaces the subscription.
+ *
+ * The network thread encodes each frame once and copies it into the queue of every matching subscriber. It never waits for a subscriber: if the queue of a
+ * subscriber is full, its messages are dropped until half of the queue has been sent. This thread sends the queues with non-blocking writes, accepts new
+ * subscribers and reads their subscriptions, so a slow subscriber only delays itself.
+ */
+class CSIPublisher: public QThread{
+  Q_OBJECT
+
+  private:
+  /**
+   * A connected subscriber
+   */
+  struct subscriber{
+    int fd;                                     ///The connection
+    uint32_t topics;                            ///Bit i set => subscribed to topic i
+    uint8_t MACs[PUB_MAX_MACS][6];              ///MAC addresses the subscription is restricted to
+    uint32_t nMACs;                             ///Number of entries in MACs. 0 => all
+    char* queue;                                ///Ring of PUB_QUEUE_LEN bytes waiting to be sent
+    uint64_t head;                              ///Bytes added to the queue
+    uint64_t tail;                              ///Bytes sent
+    bool lagging;                               ///true => messages are dropped until half of the queue has been sent
+    uint64_t sent;                              ///Messages added to the queue
+    uint64_t dropped;                           ///Messages dropped
+    char line[PUB_LINE_LEN];                    ///Subscription line received so far
+    uint32_t lineLen;                           ///Length of line
+  };
+
+  subscriber subscribers[PUB_MAX_SUBSCRIBERS];  ///The subscribers. fd < 0 => unused
+  uint32_t nTopicSubscribers[CSI_N_TOPICS];     ///Number of subscribers per topic
+  uint64_t topicCounter[CSI_N_TOPICS];          ///Number of messages published per topic
+  int listenFd;                                 ///The listening socket
+  int wakeFd;                                   ///eventfd that wakes up the thread if a queue is no longer empty or the publisher is closed
+  QByteArray path;                              ///Path of the socket
+  bool running;                                 ///true => the socket is open
+  char* msg;                                    ///Buffer for encoding a frame
+  CSIFeatureExtractor features;                 ///Computes the published features
+  QMutex mutex;                                 ///Protects the subscribers
+
+  /**
+   * Add a message to the queues of all subscribers of the topic whose subscription includes the MAC address
+   */
+  void deliver(CSIPubTopic topic, const uint8_t* MAC, const char* msg, uint32_t len);
+
+  /**
+   * Callback of the feature extractor
+   */
+  static void featuresReady(void* context, const char* msg, uint32_t len);
+
+  /**
+   * Accept a new subscriber
+   */
+  void acceptSubscriber();
+
+  /**
+   * Read the subscription lines of subscriber s. Returns false if the connection is closed.
+   */
+  bool readSubscription(subscriber* s);
+
+  /**
+   * Parse a subscription line. The mutex must be locked by the caller.
+   */
+  void parseSubscription(subscriber* s, char* line);
+
+  /**
+   * Send the queue of subscriber s as far as possible without blocking. Returns false if the connection is broken.
+   */
+  bool sendQueue(subscriber* s);
+
+  /**
+   * Close the connection to subscriber s and free its queue
+   */
+  void removeSubscriber(subscriber* s);
+
+  /**
+   * Wake up the thread
+   */
+  void wake();
+
+  protected:
+  /**
+   * Sends the queues and handles the subscribers until the publisher is closed
+   */
+  void run();
+
+  public:
+  CSIPublisher();
+  ~CSIPublisher();
+
+  /**
+   * Create the socket at the given path, replacing a socket left behind at this path, and start the thread. Returns false on failure.
+   */
+  bool open(const char* path);
+
+  /**
+   * Disconnect all subscribers and remove the socket
+   */
+  void close();
+
+  /**
+   * Returns true, if the socket is open
+   */
+  bool isOpen();
+
+  /**
+   * Publish a frame received at time t on the topic CSI_TOPIC_RAW or CSI_TOPIC_FILTERED. Filtered frames are passed to the feature extractor, too, if features are subscribed.
+   */
+  void publish(CSIPubTopic topic, const CSIData* data, const struct timespec_16bytes* t);
+
+  /**
+   * Copy the state of up to max subscribers into stats. Returns the number of subscribers.
+   */
+  uint32_t getStats(CSIPubSubscriberStats* stats, uint32_t max);
+};
+
+#endif /* CSIPUBLISHER_H_ */
@@ -0,0 +1,151 @@
+/*
+ * CSIQuantileSketch.cpp
+ * Streaming estimate of a lower and an upper quantile over a sliding window, used for scaling the displays.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIQuantileSketch.h"
+#include <string.h>
+#include <math.h>
+
+/**
+ * Bucket of a finite value. The bit patterns of positive floats are ordered like their values, so their upper bits are ordered buckets.
+ * Negative values are mirrored below the positive ones.
+ */
+static inline uint32_t bucketOf(double value){
+  float f = (float) fabs(value);
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  uint32_t b = bits >> (23 - QS_MANTISSA_BITS);
+  if(b >= QS_HALF_BUCKETS){
+    //beyond the range of a float
+    b = QS_HALF_BUCKETS - 1;
+  }
+  return (value < 0) ? QS_HALF_BUCKETS - 1 - b : QS_HALF_BUCKETS + b;
+}
+
+/**
+ * Value at the middle of a bucket
+ */
+static inline double valueOf(uint32_t bucket){
+  bool negative = (bucket < QS_HALF_BUCKETS);
+  uint32_t b = negative ? QS_HALF_BUCKETS - 1 - bucket : bucket - QS_HALF_BUCKETS;
+  uint32_t bits = (b << (23 - QS_MANTISSA_BITS)) | (1u << (22 - QS_MANTISSA_BITS));
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return negative ? -f : f;
+}
+
+CSIQuantileSketch::CSIQuantileSketch(){
+  configure(1024, 0.01, 0.99);
+}
+
+void CSIQuantileSketch::configure(uint32_t window, double lowerQuantile, double upperQuantile){
+  this->window = (window >= 2) ? window : 2;
+  this->lowerQuantile = lowerQuantile;
+  this->upperQuantile = upperQuantile;
+  clear();
+}
+
+void CSIQuantileSketch::clearHalf(uint32_t h){
+  if(n[h] > 0){
+    memset(&counts[h][first[h]], 0, (last[h] - first[h] + 1) * sizeof(uint32_t));
+  }
+  n[h] = 0;
+  first[h] = QS_BUCKETS;
+  last[h] = 0;
+}
+
+void CSIQuantileSketch::clear(){
+  memset(counts, 0, sizeof(counts));
+  for(uint32_t h = 0; h < 2; h++){
+    n[h] = 0;
+    first[h] = QS_BUCKETS;
+    last[h] = 0;
+  }
+  cur = 0;
+  valid = false;
+  lower = 0;
+  upper = 0;
+  sinceUpdate = 0;
+  updateInterval = 1;
+}
+
+void CSIQuantileSketch::add(double value){
+  if(!isfinite(value)){
+    return;
+  }
+  uint32_t b = bucketOf(value);
+  counts[cur][b]++;
+  n[cur]++;
+  if(b < first[cur]){
+    first[cur] = b;
+  }
+  if(b > last[cur]){
+    last[cur] = b;
+  }
+  sinceUpdate++;
+  if(sinceUpdate >= updateInterval){
+    update();
+    sinceUpdate = 0;
+    if(updateInterval < QS_MAX_UPDATE_INTERVAL){
+      updateInterval *= 2;
+    }
+  }
+  //the older half is dropped once the current half is full
+  if(n[cur] >= window / 2){
+    cur ^= 1;
+    clearHalf(cur);
+  }
+}
+
+void CSIQuantileSketch::update(){
+  uint32_t total = n[0] + n[1];
+  if(total == 0){
+    return;
+  }
+  uint32_t from = (first[0] < first[1]) ? first[0] : first[1];
+  uint32_t to = (last[0] > last[1]) ? last[0] : last[1];
+  //ranks of the quantiles, counted from 1
+  uint64_t rankLower = (uint64_t) ceil(lowerQuantile * total);
+  uint64_t rankUpper = (uint64_t) ceil(upperQuantile * total);
+  if(rankLower < 1){
+    rankLower = 1;
+  }
+  if(rankUpper < rankLower){
+    rankUpper = rankLower;
+  }
+  uint64_t cum = 0;
+  bool foundLower = false;
+  for(uint32_t b = from; b <= to; b++){
+    cum += counts[0][b] + counts[1][b];
+    if((!foundLower)&&(cum >= rankLower)){
+      lower = valueOf(b);
+      foundLower = true;
+    }
+    if(cum >= rankUpper){
+      upper = valueOf(b);
+      break;
+    }
+  }
+  valid = true;
+}
+
+bool CSIQuantileSketch::isValid(){
+  return valid;
+}
+
+double CSIQuantileSketch::getLower(){
+  return lower;
+}
+
+double CSIQuantileSketch::getUpper(){
+  return upper;
+}
@@ -0,0 +1,94 @@
+/*
+ * CSIQuantileSketch.h
+ * Streaming estimate of a lower and an upper quantile over a sliding window, used for scaling the displays.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIQUANTILESKETCH_H_
+#define CSIQUANTILESKETCH_H_
+
+#include <inttypes.h>
+
+#define QS_MANTISSA_BITS 4                      ///Mantissa bits per bucket, i.e., the relative width of a bucket is at most 2^-QS_MANTISSA_BITS
+#define QS_HALF_BUCKETS (1 << (8 + QS_MANTISSA_BITS)) ///Buckets for each sign: all exponents of a float times the mantissa steps
+#define QS_BUCKETS (2 * QS_HALF_BUCKETS)       ///Total number of buckets
+#define QS_MAX_UPDATE_INTERVAL 4096             ///Maximum number of samples between two updates of the quantiles
+
+/**
+ * \brief Tracks a lower and an upper quantile of the most recent samples.
+ *
+ * The samples are counted in logarithmic buckets: the bucket of a value is given by the sign, the exponent and the upper QS_MANTISSA_BITS of the
+ * mantissa of the value as a float, so adding a sample takes a few integer operations. The window consists of two halves: once the current half
+ * holds window / 2 samples, it replaces the previous one, so the quantiles cover the last window / 2 ... window samples.
+ * The quantiles are found by a scan over the occupied buckets. It runs after 1, 2, 4, ... samples at first, then every QS_MAX_UPDATE_INTERVAL
+ * samples, which keeps the cost per sample constant on average.
+ */
+class CSIQuantileSketch{
+  private:
+  uint32_t counts[2][QS_BUCKETS];               ///Samples per bucket of each half of the window
+  uint32_t n[2];                                ///Number of samples of each half
+  uint32_t first[2];                            ///Lowest occupied bucket of each half
+  uint32_t last[2];                             ///Highest occupied bucket of each half
+  uint32_t cur;                                 ///The half samples are added to
+  uint32_t window;                              ///Number of samples of the window
+  double lowerQuantile;                         ///Lower quantile, e.g., 0.01
+  double upperQuantile;                         ///Upper quantile, e.g., 0.99
+  double lower;                                 ///Current estimate of the lower quantile
+  double upper;                                 ///Current estimate of the upper quantile
+  bool valid;                                   ///true => lower and upper have been estimated
+  uint32_t sinceUpdate;                         ///Samples added since the last update of the estimates
+  uint32_t updateInterval;                      ///Samples between two updates of the estimates
+
+  /**
+   * Scan the buckets for the quantiles
+   */
+  void update();
+
+  /**
+   * Empty a half of the window
+   */
+  void clearHalf(uint32_t h);
+
+  public:
+  CSIQuantileSketch();
+
+  /**
+   * Set the number of samples of the window (at least 2) and the quantiles (0...1), and discard all samples
+   */
+  void configure(uint32_t window, double lowerQuantile, double upperQuantile);
+
+  /**
+   * Discard all samples
+   */
+  void clear();
+
+  /**
+   * Add a sample. Samples that are not finite are ignored.
+   */
+  void add(double value);
+
+  /**
+   * Returns true, if the quantiles have been estimated, i.e., at least one sample has been added
+   */
+  bool isValid();
+
+  /**
+   * Returns the estimate of the lower quantile
+   */
+  double getLower();
+
+  /**
+   * Returns the estimate of the upper quantile
+   */
+  double getUpper();
+};
+
+#endif /* CSIQUANTILESKETCH_H_ */
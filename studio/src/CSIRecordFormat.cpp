@@ -0,0 +1,161 @@
+/*
+ * CSIRecordFormat.cpp
+ * Encoding of CSI data into the recording and export formats of WirelessEye (see doc/fileFormats.pdf).
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIRecordFormat.h"
+#include <stdio.h>
+#include <string.h>
+
+void CSIFormatTimestamp(const struct timespec_16bytes* t, char* buf){
+  struct tm timeLocal;
+  time_t sec = (time_t) t->tv_sec;
+  gmtime_r(&sec, &timeLocal);
+  snprintf(buf, CSI_TIMESTAMP_STLEN, "%04u-%02u-%02u %02u:%02u:%02u:%06u"             //format specified by Florenc
+           ,timeLocal.tm_year + 1900
+           ,timeLocal.tm_mon+1
+           ,timeLocal.tm_mday
+           ,timeLocal.tm_hour+1
+           ,timeLocal.tm_min
+           ,timeLocal.tm_sec
+           ,(uint32_t) (t->tv_nsec/1000));
+}
+
+void CSIFormatMAC(const uint8_t* MAC, char* buf){
+  snprintf(buf, CSI_MAC_STLEN, "%x:%x:%x:%x:%x:%x", MAC[0], MAC[1], MAC[2], MAC[3], MAC[4], MAC[5]);
+}
+
+const char* CSIRecordFormatExtension(CSIRecordFormat format){
+  if(format == CSI_FORMAT_BINARY){
+    return ".wbin";
+  }else if(format == CSI_FORMAT_NPY){
+    return "_npy";
+  }
+  return ".csv";
+}
+
+uint32_t CSIEncodeHeader(CSIRecordFormat format, uint32_t nSubCarriers, const uint16_t* subCarriers, char* buf, uint32_t bufLen){
+  uint32_t pos = 0;
+  int n;
+
+  if(format == CSI_FORMAT_CSV_SIMPLE){
+    n = snprintf(buf, bufLen, "timestamp;MAC;subcarrier;amplitude;phase;RSSI;frame_control\n");
+    if((n < 0)||((uint32_t) n >= bufLen)){
+      return 0;
+    }
+    return n;
+  }else if(format == CSI_FORMAT_CSV_COMPACT){
+    n = snprintf(buf, bufLen, "timestamp;MAC;RSSI;frame_control");
+    if((n < 0)||((uint32_t) n >= bufLen)){
+      return 0;
+    }
+    pos = n;
+    for(uint32_t cnt = 0; cnt < nSubCarriers; cnt++){
+      uint32_t idx = (subCarriers != NULL) ? subCarriers[cnt] : cnt;
+      n = snprintf(buf + pos, bufLen - pos, ";a%u;p%u", idx, idx);
+      if((n < 0)||(pos + n >= bufLen)){
+        return 0;
+      }
+      pos += n;
+    }
+    if(pos + 2 > bufLen){
+      return 0;
+    }
+    buf[pos++] = '\n';
+    buf[pos] = '\0';
+    return pos;
+  }else if(format == CSI_FORMAT_NPY){
+    return 0;
+  }else{
+    //the indices follow the number of subcarriers, which is flagged accordingly
+    uint32_t len = 12 + sizeof(nSubCarriers) + ((subCarriers != NULL) ? nSubCarriers * sizeof(subCarriers[0]) : 0);
+    uint32_t flaggedN = (subCarriers != NULL) ? (nSubCarriers | CSI_BINARY_INDEX_FLAG) : nSubCarriers;
+    if(bufLen < len){
+      return 0;
+    }
+    memcpy(buf, "WifEyeBinary", 12);
+    memcpy(buf + 12, (char*) &flaggedN, sizeof(flaggedN));
+    if(subCarriers != NULL){
+      memcpy(buf + 12 + sizeof(flaggedN), (char*) subCarriers, nSubCarriers * sizeof(subCarriers[0]));
+    }
+    return len;
+  }
+}
+
+uint32_t CSIEncodeFrame(CSIRecordFormat format, const CSIData* data, const struct timespec_16bytes* t, const char* timestamp, const char* MAC, const uint16_t* subCarriers, char* buf, uint32_t bufLen){
+  uint32_t pos = 0;
+  int n;
+
+  if(format == CSI_FORMAT_CSV_SIMPLE){
+    //One line per subcarrier. The part common to all lines is formatted only once.
+    char prefix[CSI_TIMESTAMP_STLEN + CSI_MAC_STLEN + 2];
+    uint32_t prefixLen = snprintf(prefix, sizeof(prefix), "%s;%s;", timestamp, MAC);
+    for(uint32_t cnt = 0; cnt < data->nSubCarriers; cnt++){
+      if(pos + prefixLen >= bufLen){
+        return 0;
+      }
+      memcpy(buf + pos, prefix, prefixLen);
+      pos += prefixLen;
+      n = snprintf(buf + pos, bufLen - pos, "%u;%.10f;%.10f;%.10f;%u\n", (subCarriers != NULL) ? subCarriers[cnt] : cnt, data->amplitude[cnt], data->phase[cnt], data->RSSI, data->frame_control);
+      if((n < 0)||(pos + n >= bufLen)){
+        return 0;
+      }
+      pos += n;
+    }
+    return pos;
+
+  }else if(format == CSI_FORMAT_CSV_COMPACT){
+    //Only add the data unique per frame first, then all subcarriers
+    n = snprintf(buf, bufLen, "%s;%s;%.10f;%u", timestamp, MAC, data->RSSI, data->frame_control);
+    if((n < 0)||((uint32_t) n >= bufLen)){
+      return 0;
+    }
+    pos = n;
+    for(uint32_t cnt = 0; cnt < data->nSubCarriers; cnt++){
+      n = snprintf(buf + pos, bufLen - pos, ";%.10f;%.10f", data->amplitude[cnt], data->phase[cnt]);
+      if((n < 0)||(pos + n >= bufLen)){
+        return 0;
+      }
+      pos += n;
+    }
+    if(pos + 2 > bufLen){
+      return 0;
+    }
+    buf[pos++] = '\n';
+    buf[pos] = '\0';
+    return pos;
+
+  }else if(format == CSI_FORMAT_NPY){
+    return 0;
+
+  }else{
+    //Binary format
+    uint32_t len = sizeof(struct timespec_16bytes) + 6 + sizeof(data->RSSI) + sizeof(data->frame_control) + data->nSubCarriers*(sizeof(data->amplitude[0]) + sizeof(data->phase[0]));
+    if(len > bufLen){
+      return 0;
+    }
+    memcpy(buf + pos, (char*) t, sizeof(struct timespec_16bytes));
+    pos += sizeof(struct timespec_16bytes);
+    memcpy(buf + pos, (char*) data->senderMAC, 6);     //6 bytes are the actual MAC, senderMAC contains an additional byte to distinguish between export and displaying
+    pos += 6;
+    memcpy(buf + pos, (char*) &(data->RSSI), sizeof(data->RSSI));
+    pos += sizeof(data->RSSI);
+    memcpy(buf + pos, (char*) &(data->frame_control), sizeof(data->frame_control));
+    pos += sizeof(data->frame_control);
+    for(uint32_t cnt = 0; cnt < data->nSubCarriers; cnt++){
+      memcpy(buf + pos, (char*) &(data->amplitude[cnt]), sizeof(data->amplitude[cnt]));
+      pos += sizeof(data->amplitude[cnt]);
+      memcpy(buf + pos, (char*) &(data->phase[cnt]), sizeof(data->phase[cnt]));
+      pos += sizeof(data->phase[cnt]);
+    }
+    return pos;
+  }
+}
@@ -0,0 +1,77 @@
+/*
+ * CSIRecordFormat.h
+ * Encoding of CSI data into the recording and export formats of WirelessEye (see doc/fileFormats.pdf).
+ * This code does not depend on QT, such that it can be shared between WirelessEye Studio and the command line tools.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIRECORDFORMAT_H_
+#define CSIRECORDFORMAT_H_
+
+#include <inttypes.h>
+#include <time.h>
+#include "CSIData.h"
+
+#define CSI_TIMESTAMP_STLEN 100                 ///Buffer length for a timestamp string created by CSIFormatTimestamp()
+#define CSI_MAC_STLEN 50                        ///Buffer length for a MAC string created by CSIFormatMAC()
+#define CSI_HEADER_LEN 16384                    ///Buffer length sufficient for the header of any format (the compact CSV header of 512 subcarriers is the longest one)
+#define CSI_BINARY_INDEX_FLAG 0x80000000        ///Set in the number of subcarriers in the header of a .wbin file if the indices of the subcarriers follow
+
+/**
+ * Struct timespec has a platform-dependent length. We always use the 16-byte-version and hence define it explicitly here.
+ */
+struct timespec_16bytes{
+  uint64_t tv_sec;
+  uint64_t tv_nsec;
+};
+
+/**
+ * The formats WirelessEye can record to
+ */
+enum CSIRecordFormat{
+  CSI_FORMAT_CSV_SIMPLE = 0,                    ///One line per subcarrier. Also used for live export.
+  CSI_FORMAT_CSV_COMPACT = 1,                   ///One line per frame
+  CSI_FORMAT_BINARY = 2,                        ///WifEyeBinary (.wbin)
+  CSI_FORMAT_NPY = 3                            ///A directory of NumPy arrays per MAC. Written by CSINpyWriter, not by CSIEncodeHeader()/CSIEncodeFrame().
+};
+
+/**
+ * Create the timestamp string used in both CSV formats from the time t. buf needs to be at least CSI_TIMESTAMP_STLEN bytes long.
+ */
+void CSIFormatTimestamp(const struct timespec_16bytes* t, char* buf);
+
+/**
+ * Create the MAC string used in both CSV formats from the 6 bytes in MAC. buf needs to be at least CSI_MAC_STLEN bytes long.
+ */
+void CSIFormatMAC(const uint8_t* MAC, char* buf);
+
+/**
+ * Returns the file name extension (including the dot) for the given format. For CSI_FORMAT_NPY, this is the suffix of the directory name.
+ */
+const char* CSIRecordFormatExtension(CSIRecordFormat format);
+
+/**
+ * Write the file header of the given format for nSubCarriers subcarriers into buf.
+ * If subCarriers != NULL, it holds the index of each subcarrier in the frames as received, which is stored in the header. Otherwise, the subcarriers are numbered from 0.
+ * Returns the number of bytes written, or 0 if bufLen is too small or the format is CSI_FORMAT_NPY.
+ */
+uint32_t CSIEncodeHeader(CSIRecordFormat format, uint32_t nSubCarriers, const uint16_t* subCarriers, char* buf, uint32_t bufLen);
+
+/**
+ * Encode the frame data in the given format and write it into buf.
+ * - t is the time of reception
+ * - timestamp and MAC are the strings created by CSIFormatTimestamp() and CSIFormatMAC(). They are passed by the caller, since
+ *   they are usually needed several times per frame.
+ * - subCarriers are the indices of the subcarriers as passed to CSIEncodeHeader(). The simple CSV format writes them into the subcarrier column.
+ * Returns the number of bytes written, or 0 if bufLen is too small or the format is CSI_FORMAT_NPY.
+ */
+uint32_t CSIEncodeFrame(CSIRecordFormat format, const CSIData* data, const struct timespec_16bytes* t, const char* timestamp, const char* MAC, const uint16_t* subCarriers, char* buf, uint32_t bufLen);
+
+#endif /* CSIRECORDFORMAT_H_ */
@@ -0,0 +1,276 @@
+/*
+ * CSIRecordingWriter.cpp
+ * Writes recordings asynchronously, either into one file or into one file per MAC address.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIRecordingWriter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+CSIRecordingWriter::CSIRecordingWriter(){
+  fileName[0] = '\0';
+  format = CSI_FORMAT_CSV_SIMPLE;
+  nSubCarriers = 0;
+  hasIndices = false;
+  split = false;
+  nStreams = 0;
+  nOpen = 0;
+  useCounter = 0;
+  nFree = 0;
+  nBuffers = 0;
+  running = false;
+  failed = false;
+  opened = false;
+}
+
+CSIRecordingWriter::~CSIRecordingWriter(){
+  close();
+}
+
+bool CSIRecordingWriter::open(const char* fileName, CSIRecordFormat format, uint32_t nSubCarriers, const uint16_t* subCarriers, bool split){
+  if(opened){
+    close();
+  }
+  strncpy(this->fileName, fileName, REC_PATH_STLEN - 1);
+  this->fileName[REC_PATH_STLEN - 1] = '\0';
+  this->format = format;
+  this->nSubCarriers = nSubCarriers;
+  hasIndices = (subCarriers != NULL);
+  if(hasIndices){
+    memcpy(this->subCarriers, subCarriers, nSubCarriers * sizeof(subCarriers[0]));
+  }
+  this->split = split;
+  nStreams = 0;
+  nOpen = 0;
+  useCounter = 0;
+  failed = false;
+
+  //without splitting, the file is created right away, such that errors are reported immediately
+  if(!split){
+    uint8_t noMAC[6] = {0, 0, 0, 0, 0, 0};
+    recStream* s = getStream(noMAC);
+    if(!openStream(s)){
+      free(s->buffer->data);
+      delete s->buffer;
+      delete s;
+      nStreams = 0;
+      nBuffers = 0;
+      return false;
+    }
+  }
+  running = true;
+  opened = true;
+  start();
+  return true;
+}
+
+CSIRecordingWriter::recBuffer* CSIRecordingWriter::getBuffer(){
+  while((queue.length() >= REC_MAX_QUEUED)&&(!__atomic_load_n(&failed, __ATOMIC_RELAXED))){
+    wqFree.wait(&mutex);
+  }
+  if(nFree > 0){
+    nFree--;
+    return freeBuffers[nFree];
+  }
+  recBuffer* b = new recBuffer;
+  b->data = (char*) malloc(REC_BUFFER_LEN);
+  b->len = 0;
+  b->stream = NULL;
+  nBuffers++;
+  return b;
+}
+
+CSIRecordingWriter::recStream* CSIRecordingWriter::getStream(const uint8_t* MAC){
+  for(uint32_t i = 0; i < nStreams; i++){
+    if(memcmp(streams[i]->MAC, MAC, 6) == 0){
+      return streams[i];
+    }
+  }
+  if(nStreams >= REC_MAX_STREAMS){
+    return NULL;
+  }
+
+  recStream* s = new recStream;
+  memcpy(s->MAC, MAC, 6);
+  s->fd = -1;
+  s->created = false;
+  s->lastUse = 0;
+  if(split){
+    //insert the MAC address before the extension
+    const char* ext = strrchr(fileName, '.');
+    const char* slash = strrchr(fileName, '/');
+    if((ext == NULL)||((slash != NULL)&&(slash > ext))){
+      ext = fileName + strlen(fileName);
+    }
+    snprintf(s->fileName, REC_PATH_STLEN, "%.*s_%x-%x-%x-%x-%x-%x%s", (int) (ext - fileName), fileName, MAC[0], MAC[1], MAC[2], MAC[3], MAC[4], MAC[5], ext);
+  }else{
+    strcpy(s->fileName, fileName);
+  }
+
+  mutex.lock();
+  s->buffer = getBuffer();
+  s->buffer->stream = s;
+  s->buffer->len = CSIEncodeHeader(format, nSubCarriers, hasIndices ? subCarriers : NULL, s->buffer->data, REC_BUFFER_LEN);
+  streams[nStreams] = s;
+  nStreams++;
+  mutex.unlock();
+  return s;
+}
+
+bool CSIRecordingWriter::openStream(recStream* s){
+  //close the least recently used file if too many are open
+  if(nOpen >= REC_MAX_OPEN_FILES){
+    mutex.lock();
+    uint32_t n = nStreams;
+    mutex.unlock();
+    recStream* lru = NULL;
+    for(uint32_t i = 0; i < n; i++){
+      if((streams[i]->fd >= 0)&&((lru == NULL)||(streams[i]->lastUse < lru->lastUse))){
+        lru = streams[i];
+      }
+    }
+    if(lru != NULL){
+      ::close(lru->fd);
+      lru->fd = -1;
+      nOpen--;
+    }
+  }
+
+  if(s->created){
+    s->fd = ::open(s->fileName, O_WRONLY|O_APPEND);
+  }else{
+    s->fd = ::open(s->fileName, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  }
+  if(s->fd < 0){
+    printf("Could not open '%s': %s\n", s->fileName, strerror(errno));
+    return false;
+  }
+  if(!s->created){
+    printf("Recording to file '%s'\n", s->fileName);
+  }
+  s->created = true;
+  nOpen++;
+  return true;
+}
+
+bool CSIRecordingWriter::write(const uint8_t* MAC, const char* data, uint32_t len){
+  if(__atomic_load_n(&failed, __ATOMIC_RELAXED)){
+    return false;
+  }
+  recStream* s = split ? getStream(MAC) : streams[0];
+  if(s == NULL){
+    printf("Too many MAC addresses - at most %u files can be recorded at the same time\n", REC_MAX_STREAMS);
+    return false;
+  }
+  if(s->buffer->len + len > REC_BUFFER_LEN){
+    mutex.lock();
+    queue.enqueue(s->buffer);
+    s->buffer = getBuffer();
+    s->buffer->stream = s;
+    mutex.unlock();
+    wqWriter.wakeAll();
+  }
+  memcpy(s->buffer->data + s->buffer->len, data, len);
+  s->buffer->len += len;
+  return true;
+}
+
+void CSIRecordingWriter::run(){
+  recBuffer* b;
+  ssize_t n;
+  while(1){
+    mutex.lock();
+    while((queue.isEmpty())&&(running)){
+      wqWriter.wait(&mutex);
+    }
+    if(queue.isEmpty()){
+      mutex.unlock();
+      break;
+    }
+    b = queue.dequeue();
+    mutex.unlock();
+
+    recStream* s = b->stream;
+    if((!__atomic_load_n(&failed, __ATOMIC_RELAXED))&&(s->fd < 0)&&(!openStream(s))){
+      __atomic_store_n(&failed, true, __ATOMIC_RELAXED);
+    }
+    for(uint32_t written = 0; (!__atomic_load_n(&failed, __ATOMIC_RELAXED))&&(written < b->len); written += n){
+      n = ::write(s->fd, b->data + written, b->len - written);
+      if(n < 0){
+        if(errno == EINTR){
+          n = 0;
+          continue;
+        }
+        printf("Error writing '%s': %s\n", s->fileName, strerror(errno));
+        __atomic_store_n(&failed, true, __ATOMIC_RELAXED);
+      }
+    }
+    useCounter++;
+    s->lastUse = useCounter;
+
+    mutex.lock();
+    b->len = 0;
+    freeBuffers[nFree] = b;
+    nFree++;
+    mutex.unlock();
+    wqFree.wakeAll();
+  }
+
+  for(uint32_t i = 0; i < nStreams; i++){
+    if(streams[i]->fd >= 0){
+      ::close(streams[i]->fd);
+      streams[i]->fd = -1;
+    }
+  }
+  nOpen = 0;
+}
+
+bool CSIRecordingWriter::close(){
+  if(!opened){
+    return true;
+  }
+  //queue all remaining data and let the thread terminate once it has been written
+  mutex.lock();
+  for(uint32_t i = 0; i < nStreams; i++){
+    if(streams[i]->buffer->len > 0){
+      queue.enqueue(streams[i]->buffer);
+    }else{
+      freeBuffers[nFree] = streams[i]->buffer;
+      nFree++;
+    }
+    streams[i]->buffer = NULL;
+  }
+  running = false;
+  mutex.unlock();
+  wqWriter.wakeAll();
+  wait();
+
+  for(uint32_t i = 0; i < nFree; i++){
+    free(freeBuffers[i]->data);
+    delete freeBuffers[i];
+  }
+  nFree = 0;
+  nBuffers = 0;
+  for(uint32_t i = 0; i < nStreams; i++){
+    delete streams[i];
+  }
+  nStreams = 0;
+  opened = false;
+  return !__atomic_load_n(&failed, __ATOMIC_RELAXED);
+}
+
+bool CSIRecordingWriter::isOpen() const{
+  return opened;
+}
@@ -0,0 +1,134 @@
+/*
+ * CSIRecordingWriter.h
+ * Writes recordings asynchronously, either into one file or into one file per MAC address.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIRECORDINGWRITER_H_
+#define CSIRECORDINGWRITER_H_
+
+#include <QThread>
+#include <QString>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <inttypes.h>
+#include "CSIRecordFormat.h"
+
+#define REC_MAX_STREAMS 256                     ///Maximum number of output files (i.e., MAC addresses) of one recording
+#define REC_MAX_OPEN_FILES 32                   ///Maximum number of files kept open at the same time. The least recently used file is closed if more are needed.
+#define REC_BUFFER_LEN (256*1024)               ///Size of each write buffer
+#define REC_MAX_QUEUED 64                       ///Maximum number of full buffers waiting to be written. If reached, write() blocks until one has been written.
+#define REC_PATH_STLEN 1024                     ///Maximum length of a file name
+
+/**
+ * \brief Writes recordings to disk in a separate thread, such that the network thread is never delayed by the disk.
+ *
+ * The encoded frames passed to write() are collected in buffers of REC_BUFFER_LEN bytes. Full buffers are written by the thread.
+ * Buffers are reused, so there is no allocation per frame.
+ * In split mode, there is one output file per MAC address, which is created when the MAC address appears for the first time.
+ * Its name is the file name of the recording with the MAC address inserted before the extension, e.g., "CSICapture_ca-ff-ee-0-0-1.csv".
+ * At most REC_MAX_OPEN_FILES files are open at the same time. Files that have been closed to make room for others are reopened for appending.
+ */
+class CSIRecordingWriter: public QThread{
+  Q_OBJECT
+
+  private:
+  struct recStream;
+
+  /**
+   * A buffer of data to be written to a stream
+   */
+  struct recBuffer{
+    char* data;                                 ///The data
+    uint32_t len;                               ///Number of bytes used
+    recStream* stream;                          ///The stream the data belongs to
+  };
+
+  /**
+   * One output file
+   */
+  struct recStream{
+    uint8_t MAC[6];                             ///The MAC address. Unused if not in split mode.
+    char fileName[REC_PATH_STLEN];              ///Name of the file
+    int fd;                                     ///File descriptor, or -1 if the file is currently closed
+    bool created;                               ///true => the file has been created, i.e., it needs to be reopened for appending
+    uint64_t lastUse;                           ///Value of useCounter when the file was written most recently
+    recBuffer* buffer;                          ///The buffer frames are currently added to
+  };
+
+  char fileName[REC_PATH_STLEN];                ///File name of the recording
+  CSIRecordFormat format;                       ///Format of the recording
+  uint32_t nSubCarriers;                        ///Number of subcarriers, needed for the header of each file
+  uint16_t subCarriers[512];                    ///Indices of the subcarriers, stored in the header of each file if hasIndices is true
+  bool hasIndices;                              ///true => subCarriers is valid
+  bool split;                                   ///true => one file per MAC address
+  recStream* streams[REC_MAX_STREAMS];          ///All output files
+  uint32_t nStreams;                            ///Number of entries in streams
+  uint32_t nOpen;                               ///Number of open files
+  uint64_t useCounter;                          ///Incremented for every buffer written. Used to find the least recently used file.
+  recBuffer* freeBuffers[REC_MAX_STREAMS + REC_MAX_QUEUED + 1];        ///Buffers that are not in use
+  uint32_t nFree;                               ///Number of entries in freeBuffers
+  uint32_t nBuffers;                            ///Number of buffers allocated
+  QQueue<recBuffer*> queue;                     ///Full buffers waiting to be written
+  QMutex mutex;                                 ///Protects the queue and the free buffers
+  QWaitCondition wqWriter;                      ///Wakes up the thread when buffers are queued
+  QWaitCondition wqFree;                        ///Wakes up write() and close() when a buffer has been written
+  bool running;                                 ///false => the thread shall terminate when the queue is empty
+  bool failed;                                  ///true => writing has failed. Set by the thread and read by write() and close(), hence accessed atomically
+  bool opened;                                  ///true => a recording is in progress
+
+  /**
+   * Returns a free buffer, which is allocated if needed. Waits while REC_MAX_QUEUED buffers are waiting to be written. The mutex must be locked by the caller.
+   */
+  recBuffer* getBuffer();
+
+  /**
+   * Returns the stream for the given MAC address, which is created if needed. Returns NULL if there are too many streams.
+   */
+  recStream* getStream(const uint8_t* MAC);
+
+  /**
+   * Open the file of stream s, closing the least recently used file if too many are open. Returns false on failure.
+   */
+  bool openStream(recStream* s);
+
+  public:
+  CSIRecordingWriter();
+  ~CSIRecordingWriter();
+
+  /**
+   * Start a recording to fileName in the given format. If split is true, there is one file per MAC address.
+   * If subCarriers != NULL, it holds the index of each subcarrier, which is stored in the header (see CSIEncodeHeader()). Returns false on failure.
+   */
+  bool open(const char* fileName, CSIRecordFormat format, uint32_t nSubCarriers, const uint16_t* subCarriers, bool split);
+
+  /**
+   * Append len bytes of encoded data of a frame sent by MAC. Returns false if writing has failed.
+   */
+  bool write(const uint8_t* MAC, const char* data, uint32_t len);
+
+  /**
+   * Write all data still buffered and close all files. Returns false if writing has failed.
+   */
+  bool close();
+
+  /**
+   * Returns true, if a recording is in progress
+   */
+  bool isOpen() const;
+
+  /**
+   * Run the writer thread
+   */
+  void run() override;
+};
+
+#endif /* CSIRECORDINGWRITER_H_ */
@@ -0,0 +1,89 @@
+/*
+ * CSIResultLog.cpp
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIResultLog.h"
+#include <QByteArray>
+#include <time.h>
+
+CSIResultLog::CSIResultLog(){
+  file = NULL;
+}
+
+CSIResultLog::~CSIResultLog(){
+  close(NULL, 0);
+}
+
+bool CSIResultLog::open(const QString& recordingName, CSIDecisionLatency* const* latencies, uint32_t n){
+  close(NULL, 0);
+  for(uint32_t i = 0; i < n; i++){
+    latencies[i]->startRecording();
+  }
+  mutex.lock();
+  fileName = recordingName;
+  QString name = recordingName + RESULTLOG_SUFFIX;
+  file = fopen(name.toLocal8Bit().data(), "w");
+  if(file == NULL){
+    printf("Cannot create %s\n", name.toLocal8Bit().data());
+    mutex.unlock();
+    return false;
+  }
+  fprintf(file, "time;sink;classifier;class;certainty;frame_time;latency_ms\n");
+  mutex.unlock();
+  return true;
+}
+
+void CSIResultLog::close(CSIDecisionLatency* const* latencies, uint32_t n){
+  mutex.lock();
+  if(file == NULL){
+    mutex.unlock();
+    return;
+  }
+  fclose(file);
+  file = NULL;
+
+  //only the buckets that are used
+  QString name = fileName + RESULTLOG_LATENCY_SUFFIX;
+  FILE* f = (n > 0) ? fopen(name.toLocal8Bit().data(), "w") : NULL;
+  if(f != NULL){
+    uint64_t counts[LATENCY_N_BUCKETS];
+    fprintf(f, "sink;latency_below_ms;count\n");
+    for(uint32_t i = 0; i < n; i++){
+      latencies[i]->getRecordingHistogram(counts);
+      for(uint32_t j = 0; j < LATENCY_N_BUCKETS; j++){
+        if(counts[j] > 0){
+          fprintf(f, "%u;%s;%" PRIu64 "\n", i, QByteArray::number(CSIDecisionLatency::bucketLimit(j), 'f', 3).constData(), counts[j]);
+        }
+      }
+    }
+    fclose(f);
+  }
+  mutex.unlock();
+}
+
+void CSIResultLog::write(uint32_t sink, uint32_t classifID, uint32_t classNo, float certainty, uint64_t frameTime, double latency){
+  if(file == NULL){
+    return;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  mutex.lock();
+  if(file != NULL){
+    //QByteArray::number() always uses a dot as decimal separator, unlike printf() in the locale of the GUI
+    fprintf(file, "%" PRIu64 ";%u;%u;%u;%s;%" PRIu64 ";", (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec, sink, classifID, classNo,
+            QByteArray::number(certainty, 'f', 4).constData(), frameTime);
+    if(latency >= 0){
+      fprintf(file, "%s", QByteArray::number(latency, 'f', 3).constData());
+    }
+    fprintf(file, "\n");
+  }
+  mutex.unlock();
+}
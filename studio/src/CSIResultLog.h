@@ -0,0 +1,66 @@
+/*
+ * CSIResultLog.h
+ * Stores the results of the classifiers alongside a recording.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIRESULTLOG_H_
+#define CSIRESULTLOG_H_
+
+#include <QMutex>
+#include <QString>
+#include <stdio.h>
+#include <inttypes.h>
+#include "CSIDecisionLatency.h"
+
+#define RESULTLOG_SUFFIX ".results.csv"         ///Appended to the file name of the recording to obtain the file name of the results
+#define RESULTLOG_LATENCY_SUFFIX ".latency.csv" ///Appended to the file name of the recording to obtain the file name of the latency histograms
+
+/**
+ * \brief Writes the results of all classifiers into a CSV file next to the recording
+ *
+ * Each line contains the time the result arrived, the classifier, the class, the certainty, the time of the last frame the result is based on (if reported by the classifier) and the frame-to-decision latency.
+ * When the recording stops, the latency histograms of the classifiers during the recording are written into a second file.
+ * Results arrive only a few times per second, so they are written directly by the classifier threads.
+ */
+class CSIResultLog{
+private:
+  FILE* file;                                   ///The results file, NULL if no recording is running
+  QString fileName;                             ///File name of the recording
+  QMutex mutex;                                 ///Serializes the classifier threads
+
+public:
+  CSIResultLog();
+  ~CSIResultLog();
+
+  /**
+   * Create the results file for the recording with the given file name and start new latency histograms for the n classifiers. Returns false on failure.
+   */
+  bool open(const QString& recordingName, CSIDecisionLatency* const* latencies, uint32_t n);
+
+  /**
+   * Write the latency histograms of n classifiers since open() and close the results file
+   */
+  void close(CSIDecisionLatency* const* latencies, uint32_t n);
+
+  /**
+   * Add a result if a recording is running.
+   * Params:
+   * sink: Counting number of the classifier thread
+   * classifID: Counting number of the classifier
+   * classNo: Class it has identified
+   * certainty: The certainty of this classification
+   * frameTime: Time of the last frame the result is based on in ns since 1970, 0 if unknown
+   * latency: Frame-to-decision latency in ms, negative if unknown
+   */
+  void write(uint32_t sink, uint32_t classifID, uint32_t classNo, float certainty, uint64_t frameTime, double latency);
+};
+
+#endif /* CSIRESULTLOG_H_ */
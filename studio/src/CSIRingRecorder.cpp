@@ -0,0 +1,417 @@
+/*
+ * CSIRingRecorder.cpp
+ * Pre-trigger recording: The most recent frames are kept in a fixed-size ring in memory. When a trigger occurs, the frames
+ * before the trigger and those received afterwards are written to a file by a separate thread.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIRingRecorder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <QDate>
+#include <QTime>
+
+#define RING_FRAMEBUF_LEN (128*1024)            ///Buffer for one encoded frame. The simple CSV format of 512 subcarriers needs the most space.
+#define RING_MAX_SLOT_LEN (sizeof(ringFrame) + 2*512*sizeof(double))
+
+volatile sig_atomic_t CSIRingRecorder::signalTriggered = 0;
+
+/**
+ * Returns the time of a frame in ns
+ */
+static inline uint64_t frameTime(const struct timespec_16bytes* t){
+  return t->tv_sec * 1000000000ULL + t->tv_nsec;
+}
+
+CSIRingRecorder::CSIRingRecorder(){
+  ring = NULL;
+  ringLen = 0;
+  slotLen = 0;
+  nSlots = 0;
+  nSubCarriers = 0;
+  hasIndices = false;
+  dumpHasIndices = false;
+  head = 0;
+  tail = 0;
+  lastTime = 0;
+  armed = false;
+  running = true;
+  dumping = false;
+  triggerPending = false;
+  triggerTime = 0;
+  dumpEnd = 0;
+  nLost = 0;
+  reason[0] = '\0';
+  preSeconds = 0;
+  postSeconds = 0;
+  format = CSI_FORMAT_CSV_SIMPLE;
+  triggerOnClassChange = false;
+  memset(lastClass, 0xff, sizeof(lastClass));
+  file = NULL;
+
+  //SIGUSR1 triggers a dump, e.g., "kill -USR1 <pid of WirelessEye>"
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handleSignal;
+  sa.sa_flags = SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGUSR1, &sa, NULL);
+}
+
+CSIRingRecorder::~CSIRingRecorder(){
+  stop();
+  wait();
+  closeDump();
+  free(ring);
+}
+
+void CSIRingRecorder::handleSignal(int sig){
+  signalTriggered = 1;
+}
+
+bool CSIRingRecorder::arm(double preSeconds, double postSeconds, uint32_t memoryMB, CSIRecordFormat format){
+  disarm();
+  mutex.lock();
+  ringLen = ((uint64_t) memoryMB) * 1024 * 1024;
+  ring = (char*) malloc(ringLen);
+  if(ring == NULL){
+    mutex.unlock();
+    printf("Cannot allocate %u MB for the pre-trigger ring\n", memoryMB);
+    return false;
+  }
+  this->preSeconds = preSeconds;
+  this->postSeconds = postSeconds;
+  this->format = format;
+  nSubCarriers = 0;
+  hasIndices = false;
+  slotLen = 0;
+  nSlots = 0;
+  head = 0;
+  tail = 0;
+  lastTime = 0;
+  memset(lastClass, 0xff, sizeof(lastClass));
+  armed = true;
+  mutex.unlock();
+  printf("Pre-trigger recording armed: %.1f s before and %.1f s after each trigger, %u MB of memory\n", preSeconds, postSeconds, memoryMB);
+  return true;
+}
+
+void CSIRingRecorder::disarm(){
+  mutex.lock();
+  if(!armed){
+    mutex.unlock();
+    return;
+  }
+  armed = false;
+  triggerPending = false;
+  //an ongoing dump ends with the frames already copied out of the ring
+  dumpEnd = 0;
+  head = 0;
+  tail = 0;
+  nSlots = 0;
+  free(ring);
+  ring = NULL;
+  mutex.unlock();
+  wq.wakeAll();
+  printf("Pre-trigger recording disarmed\n");
+}
+
+bool CSIRingRecorder::isArmed(){
+  return armed;
+}
+
+void CSIRingRecorder::addFrame(const CSIData* data, const struct timespec_16bytes* t, const uint16_t* subCarriers){
+  if(!armed){
+    return;
+  }
+  mutex.lock();
+  if(!armed){
+    mutex.unlock();
+    return;
+  }
+  if((data->nSubCarriers != nSubCarriers)||(hasIndices != (subCarriers != NULL))||((hasIndices)&&(memcmp(subCarriers, this->subCarriers, nSubCarriers * sizeof(subCarriers[0])) != 0))){
+    //the subcarriers have changed: slots are resized and the frames kept so far are dropped.
+    //An ongoing dump ends, since a file cannot contain frames with different subcarriers.
+    if(dumping){
+      nLost += head - tail;
+      dumpEnd = 0;
+    }
+    nSubCarriers = data->nSubCarriers;
+    hasIndices = (subCarriers != NULL);
+    if(hasIndices){
+      memcpy(this->subCarriers, subCarriers, nSubCarriers * sizeof(subCarriers[0]));
+    }
+    slotLen = sizeof(ringFrame) + 2*nSubCarriers*sizeof(double);
+    nSlots = ringLen / slotLen;
+    head = 0;
+    tail = 0;
+    printf("Pre-trigger ring holds %" PRIu64 " frames of %u subcarriers\n", nSlots, nSubCarriers);
+  }
+
+  char* slot = ring + (head % nSlots) * slotLen;
+  ringFrame* f = (ringFrame*) slot;
+  f->t = *t;
+  memcpy(f->MAC, data->senderMAC, 6);
+  f->seqNr = data->seqNr;
+  f->RSSI = data->RSSI;
+  f->frame_control = data->frame_control;
+  f->nSubCarriers = nSubCarriers;
+  memcpy(slot + sizeof(ringFrame), data->amplitude, nSubCarriers*sizeof(double));
+  memcpy(slot + sizeof(ringFrame) + nSubCarriers*sizeof(double), data->phase, nSubCarriers*sizeof(double));
+  head++;
+  lastTime = frameTime(t);
+
+  if(signalTriggered){
+    signalTriggered = 0;
+    triggerLocked("signal");
+  }
+  bool wake = dumping || triggerPending;
+  mutex.unlock();
+  if(wake){
+    wq.wakeAll();
+  }
+}
+
+void CSIRingRecorder::triggerLocked(const char* reason){
+  if((!armed)||(head == 0)){
+    printf("Trigger (%s) ignored - no frames in memory\n", reason);
+    return;
+  }
+  printf("Trigger: %s\n", reason);
+  triggerTime = lastTime;
+  triggerPending = true;
+  strncpy(this->reason, reason, RING_REASON_STLEN - 1);
+  this->reason[RING_REASON_STLEN - 1] = '\0';
+}
+
+void CSIRingRecorder::trigger(){
+  mutex.lock();
+  triggerLocked("manual");
+  mutex.unlock();
+  wq.wakeAll();
+}
+
+void CSIRingRecorder::classifierOutput(unsigned int sink, unsigned int classifID, unsigned int classNo){
+  if((sink >= RING_MAX_SINKS)||(classifID >= RING_MAX_CLASSIFIERS)){
+    return;
+  }
+  char reason[RING_REASON_STLEN];
+  mutex.lock();
+  if((triggerOnClassChange)&&(lastClass[sink][classifID] != 0xffffffff)&&(lastClass[sink][classifID] != classNo)){
+    snprintf(reason, RING_REASON_STLEN, "sink%u_classifier%u_class%u", sink, classifID, classNo);
+    triggerLocked(reason);
+  }
+  lastClass[sink][classifID] = classNo;
+  mutex.unlock();
+  wq.wakeAll();
+}
+
+void CSIRingRecorder::setTriggerOnClassChange(bool active){
+  mutex.lock();
+  triggerOnClassChange = active;
+  memset(lastClass, 0xff, sizeof(lastClass));
+  mutex.unlock();
+}
+
+bool CSIRingRecorder::openDump(QString &filename, uint32_t nSubCarriers){
+  static char header[CSI_HEADER_LEN];
+  filename = "CSI_trigger_";
+  filename.append(QDate::currentDate().toString("MMMM_d_yy"));
+  filename.append("_");
+  filename.append(QTime::currentTime().toString());
+  filename.append("_");
+  filename.append(reason);
+  filename.append(CSIRecordFormatExtension(format));
+
+  if(format == CSI_FORMAT_NPY){
+    if(!npyWriter.open(filename.toLocal8Bit().data(), nSubCarriers, dumpHasIndices ? dumpSubCarriers : NULL)){
+      printf("Could not create directory: %s\n", npyWriter.getError());
+      return false;
+    }
+    return true;
+  }
+
+  uint32_t headerLen = CSIEncodeHeader(format, nSubCarriers, dumpHasIndices ? dumpSubCarriers : NULL, header, CSI_HEADER_LEN);
+  file = new QFile(filename);
+  if((!file->open(QIODevice::WriteOnly))||(headerLen == 0)||(file->write(header, headerLen) <= 0)){
+    printf("Could not create file '%s'\n", filename.toUtf8().data());
+    delete file;
+    file = NULL;
+    return false;
+  }
+  return true;
+}
+
+bool CSIRingRecorder::writeFrames(const char* frames, uint32_t n, uint32_t frameLen){
+  static CSIData data;
+  static char buf[RING_FRAMEBUF_LEN];
+  char timestamp[CSI_TIMESTAMP_STLEN];
+  char MACBuf[CSI_MAC_STLEN];
+  uint32_t len;
+
+  for(uint32_t i = 0; i < n; i++){
+    const ringFrame* f = (const ringFrame*) (frames + i*frameLen);
+    const double* values = (const double*) (frames + i*frameLen + sizeof(ringFrame));
+    memcpy(data.senderMAC, f->MAC, 6);
+    data.senderMAC[6] = 1;
+    data.seqNr = f->seqNr;
+    data.RSSI = f->RSSI;
+    data.frame_control = f->frame_control;
+    data.nSubCarriers = f->nSubCarriers;
+    memcpy(data.amplitude, values, f->nSubCarriers*sizeof(double));
+    memcpy(data.phase, values + f->nSubCarriers, f->nSubCarriers*sizeof(double));
+
+    if(format == CSI_FORMAT_NPY){
+      if(!npyWriter.writeFrame(&data, &f->t)){
+        printf("Error writing pre-trigger recording: %s\n", npyWriter.getError());
+        return false;
+      }
+      continue;
+    }
+    if(format != CSI_FORMAT_BINARY){
+      CSIFormatTimestamp(&f->t, timestamp);
+      CSIFormatMAC(f->MAC, MACBuf);
+    }
+    len = CSIEncodeFrame(format, &data, &f->t, timestamp, MACBuf, dumpHasIndices ? dumpSubCarriers : NULL, buf, RING_FRAMEBUF_LEN);
+    if((len == 0)||(file->write(buf, len) != len)){
+      printf("Error writing pre-trigger recording\n");
+      return false;
+    }
+  }
+  return true;
+}
+
+void CSIRingRecorder::closeDump(){
+  if(npyWriter.isOpen()){
+    if(!npyWriter.close()){
+      printf("Error finalizing pre-trigger recording: %s\n", npyWriter.getError());
+    }
+  }
+  if(file != NULL){
+    file->close();
+    delete file;
+    file = NULL;
+  }
+}
+
+void CSIRingRecorder::run(){
+  char* batch = (char*) malloc(RING_BATCH_LEN * RING_MAX_SLOT_LEN);
+  QString filename;
+  uint32_t n;
+  uint32_t len;
+  uint32_t nSub;
+  uint64_t end;
+  bool startDump;
+  bool endOfDump;
+
+  printf("Pre-trigger writer thread starting...\n");
+  while(1){
+    mutex.lock();
+    while((running)&&(!triggerPending)&&(!((dumping)&&((tail < head)||(lastTime > dumpEnd))))){
+      wq.wait(&mutex);
+    }
+    if(!running){
+      mutex.unlock();
+      break;
+    }
+
+    startDump = false;
+    if(triggerPending){
+      triggerPending = false;
+      if(!dumping){
+        //search backwards for the oldest frame in the ring that is at most preSeconds older than the trigger
+        uint64_t oldest = (head > nSlots) ? head - nSlots : 0;
+        uint64_t pre = (uint64_t) (preSeconds * 1e9);
+        uint64_t begin = head;
+        while((begin > oldest)&&(frameTime(&((ringFrame*) (ring + ((begin - 1) % nSlots) * slotLen))->t) + pre >= triggerTime)){
+          begin--;
+        }
+        if((begin == oldest)&&(head > nSlots)){
+          printf("Warning: The pre-trigger ring holds less than %.1f s. Increase its memory.\n", preSeconds);
+        }
+        tail = begin;
+        nLost = 0;
+        dumping = true;
+        startDump = true;
+      }
+      //a trigger during an ongoing dump extends it
+      dumpEnd = triggerTime + (uint64_t) (postSeconds * 1e9);
+    }
+
+    //frames that have been overwritten before they could be written are lost
+    if(head - tail > nSlots){
+      nLost += head - nSlots - tail;
+      tail = head - nSlots;
+    }
+    //the layout of the slots might change as soon as the mutex is unlocked
+    len = slotLen;
+    nSub = nSubCarriers;
+    if(startDump){
+      dumpHasIndices = hasIndices;
+      memcpy(dumpSubCarriers, subCarriers, nSubCarriers * sizeof(subCarriers[0]));
+    }
+    n = 0;
+    while((tail < head)&&(n < RING_BATCH_LEN)){
+      memcpy(batch + n*len, ring + (tail % nSlots) * len, len);
+      tail++;
+      n++;
+    }
+    end = dumpEnd;
+    endOfDump = (tail >= head)&&(lastTime > dumpEnd);
+    mutex.unlock();
+
+    if(startDump){
+      if(!openDump(filename, nSub)){
+        mutex.lock();
+        dumping = false;
+        mutex.unlock();
+        continue;
+      }
+      printf("Writing pre-trigger recording to '%s'\n", filename.toUtf8().data());
+      emit dumpStartedStopped(filename, true);
+    }
+
+    //only write the frames up to the end of the dump
+    for(uint32_t i = 0; i < n; i++){
+      if(frameTime(&((ringFrame*) (batch + i*len))->t) > end){
+        n = i;
+        endOfDump = true;
+        break;
+      }
+    }
+    if(!writeFrames(batch, n, len)){
+      endOfDump = true;
+    }
+
+    if(endOfDump){
+      closeDump();
+      mutex.lock();
+      dumping = false;
+      mutex.unlock();
+      if(nLost > 0){
+        printf("Pre-trigger recording '%s' completed. %" PRIu64 " frames could not be written in time and are missing.\n", filename.toUtf8().data(), nLost);
+      }else{
+        printf("Pre-trigger recording '%s' completed.\n", filename.toUtf8().data());
+      }
+      emit dumpStartedStopped(filename, false);
+    }
+  }
+  closeDump();
+  free(batch);
+  printf("Pre-trigger writer thread stopped\n");
+}
+
+void CSIRingRecorder::stop(){
+  mutex.lock();
+  running = false;
+  mutex.unlock();
+  wq.wakeAll();
+}
@@ -0,0 +1,177 @@
+/*
+ * CSIRingRecorder.h
+ * Pre-trigger recording: The most recent frames are kept in a fixed-size ring in memory. When a trigger occurs, the frames
+ * before the trigger and those received afterwards are written to a file by a separate thread.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIRINGRECORDER_H_
+#define CSIRINGRECORDER_H_
+
+#include <QThread>
+#include <QString>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <inttypes.h>
+#include <signal.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+#include "CSINpyWriter.h"
+
+#define RING_BATCH_LEN 64                       ///Number of frames the writer thread copies out of the ring at once
+#define RING_REASON_STLEN 48                    ///Maximum length of the reason of a trigger, which becomes part of the file name
+#define RING_MAX_CLASSIFIERS 256                ///Number of classifiers per classifier process whose outputs are observed for class changes
+#define RING_MAX_SINKS 8                        ///Number of classifier processes whose outputs are observed for class changes
+
+/**
+ * \brief Keeps the most recent frames in memory and writes them to a file when a trigger occurs.
+ *
+ * The network thread hands every frame that would be recorded to addFrame(), which copies it into a ring of fixed-size slots.
+ * The memory of the ring is allocated once when the recorder is armed, so there is no allocation per frame.
+ * A trigger (from the GUI, a class change of a classifier, or SIGUSR1) makes the thread write all frames of the last preSeconds
+ * seconds plus all frames of the following postSeconds seconds into a new file. A trigger during an ongoing dump extends it.
+ * All times refer to the timestamps of the frames, not to the clock of this machine.
+ */
+class CSIRingRecorder: public QThread{
+  Q_OBJECT
+
+  private:
+  /**
+   * Header of a slot of the ring. nSubCarriers amplitudes and phases follow as doubles.
+   */
+  struct ringFrame{
+    struct timespec_16bytes t;                  ///Time of reception
+    uint8_t MAC[6];                             ///MAC address of the sender
+    uint16_t seqNr;                             ///Sequence number
+    double RSSI;                                ///RSSI
+    uint8_t frame_control;                      ///Frame control field
+    uint32_t nSubCarriers;                      ///Number of subcarriers stored in this slot
+  };
+
+  char* ring;                                   ///Memory of the ring
+  uint64_t ringLen;                             ///Size of the ring in bytes
+  uint32_t slotLen;                             ///Size of one slot in bytes
+  uint64_t nSlots;                              ///Number of slots in the ring
+  uint32_t nSubCarriers;                        ///Number of subcarriers per slot. Frames with a different number reinitialize the ring.
+  uint16_t subCarriers[512];                    ///Indices of the subcarriers of the frames in the ring. Frames with other indices reinitialize the ring, too.
+  bool hasIndices;                              ///true => subCarriers is valid
+  uint16_t dumpSubCarriers[512];                ///Indices of the subcarriers of the current dump, owned by the writer thread
+  bool dumpHasIndices;                          ///true => dumpSubCarriers is valid
+  uint64_t head;                                ///Number of frames written to the ring since it has been (re)initialized. The next frame goes to slot head % nSlots
+  uint64_t tail;                                ///Next frame the writer thread will write to the file
+  uint64_t lastTime;                            ///Time of the most recent frame in ns
+  bool armed;                                   ///true => frames are kept in the ring
+  bool running;                                 ///false => the thread shall terminate
+  bool dumping;                                 ///true => frames are currently written to a file
+  bool triggerPending;                          ///true => a trigger has occurred that the writer thread has not handled yet
+  uint64_t triggerTime;                         ///Time of the most recent trigger in ns
+  uint64_t dumpEnd;                             ///Frames received after this time (in ns) are no longer part of the current dump
+  uint64_t nLost;                               ///Frames of the current dump that were overwritten before they could be written
+  char reason[RING_REASON_STLEN];               ///Reason of the most recent trigger
+  double preSeconds;                            ///Time to write before the trigger
+  double postSeconds;                           ///Time to write after the trigger
+  CSIRecordFormat format;                       ///Format of the files written
+  bool triggerOnClassChange;                    ///true => a change of the class of any classifier triggers a dump
+  uint32_t lastClass[RING_MAX_SINKS][RING_MAX_CLASSIFIERS];     ///Most recent class of each classifier of each classifier process. 0xffffffff => no output yet
+  QMutex mutex;                                 ///Protects the ring and the state of the dump
+  QWaitCondition wq;                            ///Wakes up the writer thread on a trigger or when new frames for an ongoing dump arrive
+  QFile* file;                                  ///The file of the current dump
+  CSINpyWriter npyWriter;                       ///Writes the current dump if the format is CSI_FORMAT_NPY
+  static volatile sig_atomic_t signalTriggered; ///Set by the SIGUSR1 handler, evaluated with the next frame
+
+  /**
+   * Signal handler for SIGUSR1
+   */
+  static void handleSignal(int sig);
+
+  /**
+   * Trigger a dump. The mutex must be locked by the caller.
+   */
+  void triggerLocked(const char* reason);
+
+  /**
+   * Create the file of a new dump for frames of nSubCarriers subcarriers. The name of the file is returned in filename. Returns false on failure.
+   */
+  bool openDump(QString &filename, uint32_t nSubCarriers);
+
+  /**
+   * Write n frames copied from the ring into the file of the current dump. Each frame occupies frameLen bytes. Returns false on failure.
+   */
+  bool writeFrames(const char* frames, uint32_t n, uint32_t frameLen);
+
+  /**
+   * Close the file of the current dump
+   */
+  void closeDump();
+
+  public:
+  CSIRingRecorder();
+  ~CSIRingRecorder();
+
+  /**
+   * Start keeping frames in memory. The ring occupies memoryMB megabytes. Dumps contain preSeconds seconds before and postSeconds seconds
+   * after the trigger and are written in the given format.
+   * Returns false if the memory cannot be allocated.
+   */
+  bool arm(double preSeconds, double postSeconds, uint32_t memoryMB, CSIRecordFormat format);
+
+  /**
+   * Stop keeping frames in memory and free the ring. An ongoing dump is finished with the frames received so far.
+   */
+  void disarm();
+
+  /**
+   * Returns true, if frames are kept in memory
+   */
+  bool isArmed();
+
+  /**
+   * Copy a frame into the ring. Called by the network thread for every frame that would be recorded. t is the time of reception.
+   * subCarriers are the indices of the subcarriers of the frame, which are stored in the header of a dump, or NULL (see CSIEncodeHeader()).
+   */
+  void addFrame(const CSIData* data, const struct timespec_16bytes* t, const uint16_t* subCarriers);
+
+  /**
+   * Observe the output of classifier classifID of the classifier process sink. If the class differs from its previous output, a dump is triggered, if activated by setTriggerOnClassChange().
+   */
+  void classifierOutput(unsigned int sink, unsigned int classifID, unsigned int classNo);
+
+  /**
+   * Run the writer thread
+   */
+  void run() override;
+
+  /**
+   * Stop the writer thread
+   */
+  void stop();
+
+  signals:
+
+  /**
+   * A dump to the file filename has started (started == true) or has been completed (started == false)
+   */
+  void dumpStartedStopped(const QString& filename, bool started);
+
+  public slots:
+
+  /**
+   * Trigger a dump from the GUI
+   */
+  void trigger();
+
+  /**
+   * Activate/deactivate triggering on class changes of the classifier outputs
+   */
+  void setTriggerOnClassChange(bool active);
+};
+
+#endif /* CSIRINGRECORDER_H_ */
@@ -0,0 +1,139 @@
+/*
+ * CSIShmExport.cpp
+ * Binary live export: Frames are written into a ring in shared memory, from which the classifier can read them without parsing (see doc/fileFormats.pdf).
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIShmExport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+
+CSIShmExport::CSIShmExport(){
+  fd = -1;
+  efd = -1;
+  header = NULL;
+  len = 0;
+  active = false;
+}
+
+CSIShmExport::~CSIShmExport(){
+  active = false;
+  if(header != NULL){
+    munmap(header, len);
+  }
+  if(fd >= 0){
+    close(fd);
+  }
+  if(efd >= 0){
+    close(efd);
+  }
+}
+
+bool CSIShmExport::create(){
+  if(header != NULL){
+    return true;
+  }
+  uint32_t slotLen = sizeof(CSIShmFrame) + 2*CSI_SHM_MAX_SUBCARRIERS*sizeof(float);
+  len = sizeof(CSIShmHeader) + ((uint64_t) slotLen) * CSI_SHM_NSLOTS;
+
+  //no close-on-exec flags: the classifier inherits both file descriptors
+  fd = memfd_create("wirelesseye", 0);
+  if(fd < 0){
+    printf("memfd_create failed: %s\n", strerror(errno));
+    return false;
+  }
+  if(ftruncate(fd, len) != 0){
+    printf("Cannot resize shared memory: %s\n", strerror(errno));
+    close(fd);
+    fd = -1;
+    return false;
+  }
+  efd = eventfd(0, 0);
+  if(efd < 0){
+    printf("eventfd failed: %s\n", strerror(errno));
+    close(fd);
+    fd = -1;
+    return false;
+  }
+  void* mem = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  if(mem == MAP_FAILED){
+    printf("Cannot map shared memory: %s\n", strerror(errno));
+    close(fd);
+    close(efd);
+    fd = -1;
+    efd = -1;
+    return false;
+  }
+  header = (CSIShmHeader*) mem;
+  memcpy(header->magic, CSI_SHM_MAGIC, 8);
+  header->version = CSI_SHM_VERSION;
+  header->headerLen = sizeof(CSIShmHeader);
+  header->slotLen = slotLen;
+  header->nSlots = CSI_SHM_NSLOTS;
+  header->maxSubCarriers = CSI_SHM_MAX_SUBCARRIERS;
+  header->writeCounter = 0;
+  printf("Shared memory for binary live export created (%" PRIu64 " bytes)\n", len);
+  return true;
+}
+
+void CSIShmExport::setEnvironment(){
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%d", fd);
+  setenv(CSI_SHM_ENV_FD, buf, 1);
+  snprintf(buf, sizeof(buf), "%d", efd);
+  setenv(CSI_SHM_ENV_EVENTFD, buf, 1);
+}
+
+void CSIShmExport::setActive(bool active){
+  this->active = active && (header != NULL);
+}
+
+bool CSIShmExport::isActive() const{
+  return active;
+}
+
+void CSIShmExport::writeFrame(const CSIData* data, const struct timespec_16bytes* t){
+  uint64_t i = header->writeCounter;
+  CSIShmFrame* f = (CSIShmFrame*) (((char*) header) + header->headerLen + (i % CSI_SHM_NSLOTS) * header->slotLen);
+  float* amplitude = (float*) (f + 1);
+  float* phase = amplitude + CSI_SHM_MAX_SUBCARRIERS;
+  uint32_t n = data->nSubCarriers;
+  if(n > CSI_SHM_MAX_SUBCARRIERS){
+    n = CSI_SHM_MAX_SUBCARRIERS;
+  }
+
+  //mark the slot as being written before changing it
+  __atomic_store_n(&f->counter, 0, __ATOMIC_RELEASE);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  f->tv_sec = t->tv_sec;
+  f->tv_nsec = t->tv_nsec;
+  memcpy(f->MAC, data->senderMAC, 6);
+  f->seqNr = data->seqNr;
+  f->RSSI = data->RSSI;
+  f->frame_control = data->frame_control;
+  f->nSubCarriers = n;
+  for(uint32_t k = 0; k < n; k++){
+    amplitude[k] = data->amplitude[k];
+    phase[k] = data->phase[k];
+  }
+  __atomic_store_n(&f->counter, i + 1, __ATOMIC_RELEASE);
+  __atomic_store_n(&header->writeCounter, i + 1, __ATOMIC_RELEASE);
+
+  uint64_t one = 1;
+  if(write(efd, &one, sizeof(one)) != sizeof(one)){
+    printf("Cannot ring the doorbell of the binary live export: %s\n", strerror(errno));
+  }
+}
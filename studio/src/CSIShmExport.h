@@ -0,0 +1,106 @@
+/*
+ * CSIShmExport.h
+ * Binary live export: Frames are written into a ring in shared memory, from which the classifier can read them without parsing (see doc/fileFormats.pdf).
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSISHMEXPORT_H_
+#define CSISHMEXPORT_H_
+
+#include <inttypes.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+
+#define CSI_SHM_MAGIC "WifEyShm"                ///Magic value at the beginning of the shared memory
+#define CSI_SHM_VERSION 1                       ///Version of the layout
+#define CSI_SHM_MAX_SUBCARRIERS 512             ///Maximum number of subcarriers per frame, as in CSIData
+#define CSI_SHM_NSLOTS 4096                     ///Number of frames in the ring
+#define CSI_SHM_ENV_FD "WIRELESSEYE_SHM_FD"     ///Environment variable that passes the file descriptor of the shared memory to the classifier
+#define CSI_SHM_ENV_EVENTFD "WIRELESSEYE_EVENTFD"       ///Environment variable that passes the file descriptor of the doorbell to the classifier
+
+/**
+ * Header at the beginning of the shared memory. All values are little endian.
+ */
+struct CSIShmHeader{
+  char magic[8];                                ///CSI_SHM_MAGIC without the terminating 0
+  uint32_t version;                             ///CSI_SHM_VERSION
+  uint32_t headerLen;                           ///Offset of the first slot
+  uint32_t slotLen;                             ///Size of each slot
+  uint32_t nSlots;                              ///Number of slots
+  uint32_t maxSubCarriers;                      ///Number of amplitudes and phases each slot has space for
+  uint32_t reserved;
+  uint64_t writeCounter;                        ///Number of frames written so far. Frame i is in slot i % nSlots.
+  uint8_t reserved2[24];
+};
+
+/**
+ * Header of each slot, followed by maxSubCarriers amplitudes and maxSubCarriers phases as float32.
+ */
+struct CSIShmFrame{
+  uint64_t counter;                             ///i+1 for frame i. 0 while the slot is being written.
+  uint64_t tv_sec;                              ///Time of reception, seconds
+  uint64_t tv_nsec;                             ///Time of reception, nanoseconds
+  uint8_t MAC[6];                               ///MAC address of the sender
+  uint16_t seqNr;                               ///Sequence number
+  float RSSI;                                   ///RSSI
+  uint8_t frame_control;                        ///Frame control field
+  uint8_t reserved[3];
+  uint32_t nSubCarriers;                        ///Number of valid amplitudes and phases
+  uint32_t reserved2;
+};
+
+/**
+ * \brief Writes frames into a ring in shared memory and rings a doorbell (eventfd) for each frame.
+ *
+ * The shared memory is created by memfd_create(), so it has no name. Its file descriptor and that of the eventfd are inherited by child processes
+ * (e.g., the classifier), which find them in the environment variables CSI_SHM_ENV_FD and CSI_SHM_ENV_EVENTFD.
+ * A reader checks the counter of a slot before and after copying it. If it is not i+1 for frame i both times, the frame has been overwritten.
+ * The memory stays mapped until this object is destroyed, such that writeFrame() never accesses unmapped memory.
+ */
+class CSIShmExport{
+  private:
+  int fd;                                       ///File descriptor of the shared memory
+  int efd;                                      ///File descriptor of the eventfd
+  CSIShmHeader* header;                         ///The mapped shared memory
+  uint64_t len;                                 ///Size of the shared memory
+  bool active;                                  ///true => writeFrame() writes frames
+
+  public:
+  CSIShmExport();
+  ~CSIShmExport();
+
+  /**
+   * Create the shared memory and the eventfd, if not done before. Returns false on failure.
+   */
+  bool create();
+
+  /**
+   * Set the environment variables that pass the file descriptors to a child process. Call after fork() in the child.
+   */
+  void setEnvironment();
+
+  /**
+   * Activate or deactivate writing frames
+   */
+  void setActive(bool active);
+
+  /**
+   * Returns true, if frames are written
+   */
+  bool isActive() const;
+
+  /**
+   * Write a frame into the ring and ring the doorbell. t is the time of reception.
+   */
+  void writeFrame(const CSIData* data, const struct timespec_16bytes* t);
+};
+
+#endif /* CSISHMEXPORT_H_ */
@@ -0,0 +1,87 @@
+/*
+ * CSISlidingDFT.cpp
+ * Sliding DFT of many values over a window of frames, with a Hann window applied in the frequency domain.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSISlidingDFT.h"
+#include <stdlib.h>
+#include <math.h>
+
+CSISlidingDFT::CSISlidingDFT(){
+  nFrames = 0;
+  nBins = 0;
+  rotRe = NULL;
+  rotIm = NULL;
+}
+
+CSISlidingDFT::~CSISlidingDFT(){
+  free(rotRe);
+  free(rotIm);
+}
+
+bool CSISlidingDFT::configure(uint32_t nFrames, uint32_t nBins){
+  if((nFrames < 2)||((nBins > 0)&&(2 * (nBins + 1) > nFrames))){
+    return false;
+  }
+  double* re = (double*) malloc((nBins + 2) * sizeof(double));
+  double* im = (double*) malloc((nBins + 2) * sizeof(double));
+  if((re == NULL)||(im == NULL)){
+    free(re);
+    free(im);
+    return false;
+  }
+  free(rotRe);
+  free(rotIm);
+  rotRe = re;
+  rotIm = im;
+  this->nFrames = nFrames;
+  this->nBins = nBins;
+  for(uint32_t k = 0; k < nBins + 2; k++){
+    rotRe[k] = cos(2 * M_PI * k / nFrames);
+    rotIm[k] = sin(2 * M_PI * k / nFrames);
+  }
+  return true;
+}
+
+uint32_t CSISlidingDFT::getNDFTBins(){
+  return (nBins > 0) ? nBins + 2 : 0;
+}
+
+void CSISlidingDFT::update(double* dftRe, double* dftIm, const double* delta, uint32_t nValues){
+  uint32_t nDFTBins = getNDFTBins();
+  for(uint32_t k = 0; k < nDFTBins; k++){
+    double* re = dftRe + k * nValues;
+    double* im = dftIm + k * nValues;
+    double c = rotRe[k];
+    double si = rotIm[k];
+    for(uint32_t v = 0; v < nValues; v++){
+      double r = re[v] + delta[v];
+      re[v] = r * c - im[v] * si;
+      im[v] = r * si + im[v] * c;
+    }
+  }
+}
+
+void CSISlidingDFT::getMagnitudes(const double* dftRe, const double* dftIm, uint32_t nValues, uint32_t k, bool withoutMean, double* magnitude){
+  const double* re = dftRe + k * nValues;
+  const double* im = dftIm + k * nValues;
+  const double* rePrev = re - nValues;
+  const double* imPrev = im - nValues;
+  const double* reNext = re + nValues;
+  const double* imNext = im + nValues;
+  double prevFactor = ((withoutMean)&&(k == 1)) ? 0.0 : 0.25;
+  for(uint32_t v = 0; v < nValues; v++){
+    double yRe = 0.5 * re[v] - prevFactor * rePrev[v] - 0.25 * reNext[v];
+    double yIm = 0.5 * im[v] - prevFactor * imPrev[v] - 0.25 * imNext[v];
+    magnitude[v] = sqrt(yRe * yRe + yIm * yIm) / nFrames;
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * CSISlidingDFT.h
+ * Sliding DFT of many values over a window of frames, with a Hann window applied in the frequency domain.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSISLIDINGDFT_H_
+#define CSISLIDINGDFT_H_
+
+#include <inttypes.h>
+
+/**
+ * \brief Updates the DFT bins of nValues values over a window of nFrames frames with every frame, and returns the magnitudes of the Hann-windowed bins 1...nBins.
+ *
+ * The bins are kept by the caller in two arrays (real and imaginary parts) of getNDFTBins() x nValues doubles, bin-major, which start with zeros.
+ * A frame is added by update() with the difference between its values and those of the frame leaving the window (or its values while the window is not full yet),
+ * in O(nValues * nBins) operations: X'(k) = (X(k) + new value - oldest value) * e^(2 pi i k / nFrames).
+ * The Hann window is applied in the frequency domain, Y(k) = X(k) / 2 - (X(k - 1) + X(k + 1)) / 4, so bins 0...nBins + 1 are kept.
+ * The loops run over the contiguous values of a bin, such that the compiler can vectorize them.
+ * The bins are kept in double precision, so the rounding errors of the updates do not accumulate to a visible level.
+ */
+class CSISlidingDFT{
+  private:
+  uint32_t nFrames;                             ///Frames per window
+  uint32_t nBins;                               ///Number of windowed bins returned, i.e., bins 1...nBins
+  double* rotRe;                                ///Real parts of the rotation of DFT bin k per frame, e^(2 pi i k / nFrames)
+  double* rotIm;                                ///Imaginary parts of the rotations
+
+  public:
+  CSISlidingDFT();
+  ~CSISlidingDFT();
+
+  /**
+   * Set the window length and the number of windowed bins. Bin nBins + 1 must not exceed the Nyquist frequency, i.e., 2 * (nBins + 1) <= nFrames.
+   * nBins == 0 => no bins are kept. Returns false if the parameters are invalid or the memory cannot be allocated.
+   */
+  bool configure(uint32_t nFrames, uint32_t nBins);
+
+  /**
+   * Number of DFT bins kept per value, i.e., nBins + 2, or 0 if nBins == 0
+   */
+  uint32_t getNDFTBins();
+
+  /**
+   * Add a frame to the bins of nValues values. delta holds the new values minus the values leaving the window.
+   */
+  void update(double* dftRe, double* dftIm, const double* delta, uint32_t nValues);
+
+  /**
+   * Write the magnitude of the windowed bin k (1...nBins) of each of the nValues values, divided by nFrames, to magnitude.
+   * withoutMean == true => X(0) is taken as 0, i.e., the mean of the window is removed before windowing.
+   */
+  void getMagnitudes(const double* dftRe, const double* dftIm, uint32_t nValues, uint32_t k, bool withoutMean, double* magnitude);
+};
+
+#endif /* CSISLIDINGDFT_H_ */
@@ -0,0 +1,185 @@
+/*
+ * CSISnapshotWriter.cpp
+ * Saves snapshots of the displays as PNG files in a background thread.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSISnapshotWriter.h"
+#include <QBuffer>
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <stdio.h>
+#include <string.h>
+
+volatile sig_atomic_t CSISnapshotWriter::signalRequested = 0;
+
+CSISnapshotWriter::CSISnapshotWriter(){
+  head = 0;
+  tail = 0;
+  written = 0;
+  dropped = 0;
+  directory = "/tmp";
+  keep = 0;
+  running = true;
+
+  //SIGUSR2 requests a snapshot, e.g., "kill -USR2 <pid of WirelessEye>"
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handleSignal;
+  sa.sa_flags = SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGUSR2, &sa, NULL);
+}
+
+CSISnapshotWriter::~CSISnapshotWriter(){
+  stop();
+  wait();
+}
+
+void CSISnapshotWriter::handleSignal(int sig){
+  signalRequested = 1;
+}
+
+bool CSISnapshotWriter::isRequested(){
+  if(signalRequested){
+    signalRequested = 0;
+    return true;
+  }
+  return false;
+}
+
+void CSISnapshotWriter::setDirectory(const QString& directory){
+  mutex.lock();
+  this->directory = directory;
+  mutex.unlock();
+}
+
+void CSISnapshotWriter::setKeep(uint32_t keep){
+  mutex.lock();
+  this->keep = keep;
+  mutex.unlock();
+}
+
+bool CSISnapshotWriter::add(const QImage& image, const QString& name){
+  if(image.isNull()){
+    return false;
+  }
+  mutex.lock();
+  if((!running)||(head - tail >= SNAPSHOT_QUEUE_LEN)){
+    dropped++;
+    mutex.unlock();
+    return false;
+  }
+  snapshot* s = &queue[head % SNAPSHOT_QUEUE_LEN];
+  s->image = image;
+  s->name = name;
+  s->time = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz");
+  head++;
+  mutex.unlock();
+  wq.wakeAll();
+  return true;
+}
+
+uint64_t CSISnapshotWriter::getWritten(){
+  return written;
+}
+
+uint64_t CSISnapshotWriter::getDropped(){
+  return dropped;
+}
+
+void CSISnapshotWriter::stop(){
+  mutex.lock();
+  running = false;
+  mutex.unlock();
+  wq.wakeAll();
+}
+
+void CSISnapshotWriter::removeOldest(const QString& directory, const QString& name, uint32_t keep){
+  //the time in the names sorts like the time itself. Only names exactly as written by save() match.
+  QStringList files = QDir(directory).entryList(QStringList(name + "_????????_??????_???.png"), QDir::Files, QDir::Name);
+  for(int i = 0; i + (int) keep < files.size(); i++){
+    if(!QFile::remove(directory + "/" + files[i])){
+      printf("Cannot delete the snapshot %s\n", files[i].toLocal8Bit().constData());
+    }
+  }
+}
+
+bool CSISnapshotWriter::save(const snapshot& s, const QString& directory, uint32_t keep){
+  //encode once, write the file of the snapshot if requested and replace the newest one
+  QByteArray png;
+  QBuffer buffer(&png);
+  buffer.open(QIODevice::WriteOnly);
+  if(!s.image.save(&buffer, "PNG")){
+    printf("Cannot encode the snapshot of %s\n", s.name.toLocal8Bit().constData());
+    return false;
+  }
+  if(keep > 0){
+    QString filename = directory + "/" + s.name + "_" + s.time + ".png";
+    QFile file(filename);
+    if((!file.open(QIODevice::WriteOnly))||(file.write(png) != png.size())){
+      printf("Cannot write the snapshot %s\n", filename.toLocal8Bit().constData());
+      return false;
+    }
+    file.close();
+    removeOldest(directory, s.name, keep);
+  }
+
+  QString newest = directory + "/" + s.name + ".png";
+  QString temp = directory + "/." + s.name + ".png.tmp";
+  QFile tempFile(temp);
+  if((!tempFile.open(QIODevice::WriteOnly))||(tempFile.write(png) != png.size())){
+    printf("Cannot write the snapshot %s\n", temp.toLocal8Bit().constData());
+    return false;
+  }
+  tempFile.close();
+  //rename() replaces the file atomically, unlike QFile::rename()
+  if(rename(temp.toLocal8Bit().constData(), newest.toLocal8Bit().constData()) != 0){
+    printf("Cannot replace the snapshot %s\n", newest.toLocal8Bit().constData());
+    return false;
+  }
+  return true;
+}
+
+void CSISnapshotWriter::run(){
+  snapshot s;
+  QString dir;
+  uint32_t nKeep;
+
+  printf("Snapshot writer thread starting...\n");
+  while(1){
+    mutex.lock();
+    while((running)&&(tail == head)){
+      wq.wait(&mutex);
+    }
+    //the queued snapshots are written before terminating
+    if(tail == head){
+      mutex.unlock();
+      break;
+    }
+    s = queue[tail % SNAPSHOT_QUEUE_LEN];
+    //release the image in the queue, so it is freed once it has been written
+    queue[tail % SNAPSHOT_QUEUE_LEN].image = QImage();
+    tail++;
+    dir = directory;
+    nKeep = keep;
+    mutex.unlock();
+
+    if(save(s, dir, nKeep)){
+      mutex.lock();
+      written++;
+      mutex.unlock();
+    }
+    s.image = QImage();
+  }
+  printf("Snapshot writer thread terminating...\n");
+}
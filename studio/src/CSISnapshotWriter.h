@@ -0,0 +1,123 @@
+/*
+ * CSISnapshotWriter.h
+ * Saves snapshots of the displays as PNG files in a background thread.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSISNAPSHOTWRITER_H_
+#define CSISNAPSHOTWRITER_H_
+
+#include <QThread>
+#include <QString>
+#include <QImage>
+#include <QMutex>
+#include <QWaitCondition>
+#include <inttypes.h>
+#include <signal.h>
+
+#define SNAPSHOT_QUEUE_LEN 8                    ///Snapshots waiting to be encoded. Further snapshots are dropped while the queue is full
+
+/**
+ * \brief Encodes snapshots of the displays to PNG files.
+ *
+ * The GUI thread only copies the image of a display (see CSIHeatmapRenderer::snapshot()) and adds it. This thread encodes it and replaces <directory>/<name>.png
+ * by an atomic rename, so a dashboard always finds a complete file of the newest snapshot. If keep > 0, it also writes <directory>/<name>_<date>_<time>.png and deletes
+ * the oldest of these files, such that keep of them remain per display.
+ * If the thread falls behind, further snapshots are dropped instead of piling up in memory.
+ *
+ * Sending SIGUSR2 to WirelessEye requests a snapshot, e.g., from a cron job on a machine without a display.
+ */
+class CSISnapshotWriter: public QThread{
+  Q_OBJECT
+
+  private:
+  /**
+   * A snapshot waiting to be encoded
+   */
+  struct snapshot{
+    QImage image;                               ///The image. It is not shared with the display
+    QString name;                               ///Name of the display, the first part of the file names
+    QString time;                               ///Time the snapshot was taken, part of the file name
+  };
+
+  snapshot queue[SNAPSHOT_QUEUE_LEN];           ///Ring of snapshots waiting to be encoded
+  uint64_t head;                                ///Number of snapshots added to the queue
+  uint64_t tail;                                ///Number of snapshots taken out of the queue
+  uint64_t written;                             ///Number of files written
+  uint64_t dropped;                             ///Number of snapshots dropped because the queue was full
+  QString directory;                            ///Directory the files are written to
+  uint32_t keep;                                ///Number of timestamped files kept per display. 0 => only <name>.png is written
+  bool running;                                 ///false => the thread shall terminate
+  QMutex mutex;                                 ///Protects the queue and the counters
+  QWaitCondition wq;                            ///Wakes up the thread if a snapshot has been added or the writer is stopped
+  static volatile sig_atomic_t signalRequested; ///Set by the SIGUSR2 handler, evaluated by isRequested()
+
+  /**
+   * Signal handler for SIGUSR2
+   */
+  static void handleSignal(int sig);
+
+  /**
+   * Encode a snapshot and write its files, keeping keep timestamped files of the display. Returns false on failure.
+   */
+  bool save(const snapshot& s, const QString& directory, uint32_t keep);
+
+  /**
+   * Delete the oldest timestamped files of the display name in directory, such that keep of them remain
+   */
+  static void removeOldest(const QString& directory, const QString& name, uint32_t keep);
+
+  protected:
+  /**
+   * Encodes the snapshots until the writer is stopped
+   */
+  void run();
+
+  public:
+  CSISnapshotWriter();
+  ~CSISnapshotWriter();
+
+  /**
+   * Set the directory the files are written to
+   */
+  void setDirectory(const QString& directory);
+
+  /**
+   * Set the number of timestamped files kept per display. 0 => only the newest snapshot is written, as <name>.png
+   */
+  void setKeep(uint32_t keep);
+
+  /**
+   * Queue a snapshot of the display with the given name, e.g., "amplitude". Returns false if it is dropped, i.e., the image is null or the queue is full.
+   */
+  bool add(const QImage& image, const QString& name);
+
+  /**
+   * Returns true once after SIGUSR2 has been received
+   */
+  bool isRequested();
+
+  /**
+   * Number of files written
+   */
+  uint64_t getWritten();
+
+  /**
+   * Number of snapshots dropped
+   */
+  uint64_t getDropped();
+
+  /**
+   * Stop the thread after the queued snapshots have been written
+   */
+  void stop();
+};
+
+#endif /* CSISNAPSHOTWRITER_H_ */
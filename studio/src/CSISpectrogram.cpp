@@ -0,0 +1,138 @@
+/*
+ * CSISpectrogram.cpp
+ * Short-time spectrum of the amplitudes of groups of subcarriers over time, i.e., the Doppler spectrogram of each sender.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSISpectrogram.h"
+#include <string.h>
+
+CSISpectrogram::CSISpectrogram(){
+  nStates = 0;
+  nLanes = 1;
+  nFrames = 0;
+  nGroups = 0;
+  nBins = 0;
+  decimation = 1;
+  configure(64, 4);
+}
+
+bool CSISpectrogram::configure(uint32_t nFrames, uint32_t nGroups){
+  if((nFrames < SPECTROGRAM_MIN_WINDOW)||(nFrames > SPECTROGRAM_MAX_WINDOW)||(nGroups < 1)||(nGroups > SPECTROGRAM_MAX_GROUPS)){
+    return false;
+  }
+  if(!dft.configure(nFrames, nFrames / 2 - 1)){
+    return false;
+  }
+  this->nFrames = nFrames;
+  this->nGroups = nGroups;
+  nBins = nFrames / 2 - 1;
+  clear();
+  return true;
+}
+
+void CSISpectrogram::setNLanes(uint32_t nLanes){
+  if((nLanes < 1)||(nLanes > DISPLAY_MAX_LANES)){
+    return;
+  }
+  this->nLanes = nLanes;
+  clear();
+}
+
+void CSISpectrogram::clear(){
+  nStates = 0;
+}
+
+uint32_t CSISpectrogram::getNValues(){
+  return nGroups * nBins;
+}
+
+double CSISpectrogram::getMaxFrequency(double frameRate){
+  return frameRate * nBins / (decimation * nFrames);
+}
+
+CSISpectrogram::macState* CSISpectrogram::getState(const uint8_t* MAC, bool create){
+  if((nLanes == 1)&&(nStates > 0)){
+    return &states[0];
+  }
+  for(uint32_t i = 0; i < nStates; i++){
+    if(memcmp(states[i].MAC, MAC, 6) == 0){
+      return &states[i];
+    }
+  }
+  if((!create)||(nStates >= nLanes)){
+    return NULL;
+  }
+  macState* s = &states[nStates];
+  memcpy(s->MAC, MAC, 6);
+  resetState(s, 0, 1);
+  nStates++;
+  return s;
+}
+
+void CSISpectrogram::resetState(macState* s, uint32_t nSubCarriers, uint32_t decimation){
+  s->nSubCarriers = nSubCarriers;
+  s->decimation = decimation;
+  s->count = 0;
+  memset(s->window, 0, nFrames * nGroups * sizeof(double));
+  memset(s->dftRe, 0, dft.getNDFTBins() * nGroups * sizeof(double));
+  memset(s->dftIm, 0, dft.getNDFTBins() * nGroups * sizeof(double));
+}
+
+void CSISpectrogram::add(const CSIDisplayFrame* f){
+  if((!f->hasAmplitude)||(f->nSubCarriers == 0)){
+    return;
+  }
+  macState* s = getState(f->MAC, true);
+  if(s == NULL){
+    return;
+  }
+  uint32_t n = (f->nSubCarriers > DISPLAY_MAX_SUBCARRIERS) ? DISPLAY_MAX_SUBCARRIERS : f->nSubCarriers;
+  //frames spaced differently than those in the window would shift the bins
+  decimation = (f->decimation > 0) ? f->decimation : 1;
+  if((n != s->nSubCarriers)||(decimation != s->decimation)){
+    resetState(s, n, decimation);
+  }
+
+  //mean amplitude of each group. With fewer subcarriers than groups, the empty groups stay 0.
+  double delta[SPECTROGRAM_MAX_GROUPS];
+  double* oldest = s->window + (s->count % nFrames) * nGroups;
+  for(uint32_t g = 0; g < nGroups; g++){
+    uint32_t begin = g * n / nGroups;
+    uint32_t end = (g + 1) * n / nGroups;
+    double sum = 0;
+    for(uint32_t i = begin; i < end; i++){
+      sum += f->amplitude[i];
+    }
+    double value = (end > begin) ? sum / (end - begin) : 0;
+    //the window starts with zeros, so the first frames need no special case
+    delta[g] = value - oldest[g];
+    oldest[g] = value;
+  }
+  dft.update(s->dftRe, s->dftIm, delta, nGroups);
+  s->count++;
+}
+
+double* CSISpectrogram::getColumn(const uint8_t* MAC){
+  macState* s = getState(MAC, false);
+  if((s == NULL)||(s->count < nFrames)){
+    return NULL;
+  }
+  //the mean is removed before windowing. Otherwise, the mean amplitude would leak into bin 1 and dominate the color scale.
+  double magnitude[SPECTROGRAM_MAX_GROUPS];
+  for(uint32_t k = 1; k <= nBins; k++){
+    dft.getMagnitudes(s->dftRe, s->dftIm, nGroups, k, true, magnitude);
+    for(uint32_t g = 0; g < nGroups; g++){
+      column[g * nBins + nBins - k] = magnitude[g];
+    }
+  }
+  return column;
+}
@@ -0,0 +1,120 @@
+/*
+ * CSISpectrogram.h
+ * Short-time spectrum of the amplitudes of groups of subcarriers over time, i.e., the Doppler spectrogram of each sender.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSISPECTROGRAM_H_
+#define CSISPECTROGRAM_H_
+
+#include <inttypes.h>
+#include "CSIDisplayQueue.h"
+#include "CSIDisplayLanes.h"
+#include "CSISlidingDFT.h"
+
+#define SPECTROGRAM_MIN_WINDOW 8                ///Minimum number of frames per window
+#define SPECTROGRAM_MAX_WINDOW 128              ///Maximum number of frames per window
+#define SPECTROGRAM_MAX_GROUPS 8                ///Maximum number of groups of subcarriers
+#define SPECTROGRAM_MAX_DFT_BINS (SPECTROGRAM_MAX_WINDOW / 2 + 1) ///Bins 0...nFrames/2 of the DFT are kept
+
+/**
+ * \brief Computes the spectrum of the amplitude of each group of subcarriers over the last nFrames frames of each sender.
+ *
+ * The subcarriers of a frame are split into nGroups groups of contiguous subcarriers, and the amplitudes of each group are averaged. The DFT of each group over the window
+ * is updated with every frame by a sliding DFT (CSISlidingDFT, like the spectral features of CSIFeatureExtractor), so a frame costs O(nSubCarriers + nGroups * nFrames / 2)
+ * operations, independent of the refresh rate of the display.
+ *
+ * A column holds the magnitudes of bins 1...nFrames/2 - 1 of each group with a Hann window. Bin k is the frequency k * (frame rate) / (decimation * nFrames), e.g., the
+ * Doppler shift caused by motion, where the decimation is that of the display (see CSIDisplayShedder). The window of a sender restarts when the decimation changes,
+ * such that its frames are always evenly spaced.
+ * The column is ordered by group, and the bins of a group from the highest to the lowest frequency, so low frequencies are at the bottom of a group when drawn.
+ *
+ * The senders are told apart like by CSIDisplayLanes: up to nLanes senders in the order they appear, or the frames of all senders in one window if nLanes == 1.
+ */
+class CSISpectrogram{
+  private:
+  /**
+   * The window and the DFT of a sender
+   */
+  struct macState{
+    uint8_t MAC[6];                             ///MAC address of the sender
+    uint32_t nSubCarriers;                      ///Number of subcarriers of the frames. Another number of subcarriers resets the state
+    uint32_t decimation;                        ///Number of frames each frame of the window stands for. Another decimation resets the state
+    uint64_t count;                             ///Frames added since the state has been reset
+    double window[SPECTROGRAM_MAX_WINDOW * SPECTROGRAM_MAX_GROUPS]; ///Mean amplitude of each group for the last nFrames frames, frame-major
+    double dftRe[SPECTROGRAM_MAX_DFT_BINS * SPECTROGRAM_MAX_GROUPS]; ///Real part of bins 0...nFrames/2 of each group, bin-major
+    double dftIm[SPECTROGRAM_MAX_DFT_BINS * SPECTROGRAM_MAX_GROUPS]; ///Imaginary part of bins 0...nFrames/2 of each group, bin-major
+  };
+
+  macState states[DISPLAY_MAX_LANES];           ///States of the senders seen so far
+  uint32_t nStates;                             ///Number of senders seen so far
+  uint32_t nLanes;                              ///Maximum number of senders. 1 => the frames of all senders share one state
+  uint32_t nFrames;                             ///Frames per window
+  uint32_t nGroups;                             ///Groups of subcarriers
+  uint32_t nBins;                               ///Bins per group in a column, i.e., nFrames/2 - 1
+  uint32_t decimation;                          ///Decimation of the frame added most recently
+  CSISlidingDFT dft;                            ///Updates dftRe and dftIm of the states and applies the Hann window
+  double column[DISPLAY_MAX_SUBCARRIERS];       ///The column returned by getColumn()
+
+  /**
+   * Returns the state of the sender, a new one for a new sender, or NULL if nLanes senders have been seen. With a single lane, the state of all senders.
+   * If create == false, NULL is returned for a new sender.
+   */
+  macState* getState(const uint8_t* MAC, bool create);
+
+  /**
+   * Forget the frames of a sender
+   */
+  void resetState(macState* s, uint32_t nSubCarriers, uint32_t decimation);
+
+  public:
+  CSISpectrogram();
+
+  /**
+   * Set the number of frames per window (SPECTROGRAM_MIN_WINDOW...SPECTROGRAM_MAX_WINDOW) and the number of groups (1...SPECTROGRAM_MAX_GROUPS).
+   * All senders are forgotten. Returns false if a value is out of range. Then, nothing is changed.
+   */
+  bool configure(uint32_t nFrames, uint32_t nGroups);
+
+  /**
+   * Set the maximum number of senders (1...DISPLAY_MAX_LANES), as in CSIDisplayLanes. All senders are forgotten.
+   */
+  void setNLanes(uint32_t nLanes);
+
+  /**
+   * Forget all senders
+   */
+  void clear();
+
+  /**
+   * Add the amplitudes of a frame. Frames without amplitude are ignored, and so are further senders once nLanes senders have been seen.
+   */
+  void add(const CSIDisplayFrame* f);
+
+  /**
+   * Number of values per column, i.e., nGroups * (nFrames/2 - 1)
+   */
+  uint32_t getNValues();
+
+  /**
+   * Highest frequency of a column, i.e., that of bin nFrames/2 - 1, given the rate of all frames including those shed, in frames/s.
+   * The decimation of the frame added most recently is assumed.
+   */
+  double getMaxFrequency(double frameRate);
+
+  /**
+   * Returns the current column of the sender (getNValues() values), or NULL if fewer than nFrames of its frames have been added.
+   * With a single lane, the column of all senders is returned. The column is overwritten by the next call.
+   */
+  double* getColumn(const uint8_t* MAC);
+};
+
+#endif /* CSISPECTROGRAM_H_ */
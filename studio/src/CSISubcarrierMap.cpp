@@ -0,0 +1,148 @@
+/*
+ * CSISubcarrierMap.cpp
+ * Selection of the subcarriers each consumer (display, recording, classifiers) gets from a frame, and the gather tables that extract them.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSISubcarrierMap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+void CSIBandwidthMap(uint32_t nNative, uint32_t n, CSISubcarrierMap* map){
+  uint32_t offset = 0;
+  if(nNative > CSI_MAX_SUBCARRIERS){
+    nNative = CSI_MAX_SUBCARRIERS;
+  }
+  if(n > nNative){
+    n = nNative;
+  }
+  if((nNative == 256)&&(n < 256)){
+    offset = 128;
+  }else if((nNative == 128)&&(n < 128)){
+    offset = 64;
+  }
+  map->n = n;
+  map->custom = false;
+  for(uint32_t i = 0; i < n; i++){
+    map->index[i] = offset + i;
+  }
+}
+
+bool CSIParseSubcarrierMap(const char* spec, uint32_t nNative, CSISubcarrierMap* map, char* err){
+  bool selected[CSI_MAX_SUBCARRIERS];
+  const char* s = spec;
+  memset(selected, 0, sizeof(selected));
+  if(nNative > CSI_MAX_SUBCARRIERS){
+    nNative = CSI_MAX_SUBCARRIERS;
+  }
+
+  while(*s != '\0'){
+    char* end;
+    while((*s == ' ')||(*s == ',')){
+      s++;
+    }
+    if(*s == '\0'){
+      break;
+    }
+    long first = strtol(s, &end, 10);
+    long last = first;
+    if((end == s)||(first < 0)){
+      if(err != NULL){
+        snprintf(err, CSI_SUBCARRIER_ERROR_STLEN, "invalid subcarrier list at '%s'", s);
+      }
+      return false;
+    }
+    s = end;
+    while(*s == ' '){
+      s++;
+    }
+    if(*s == '-'){
+      s++;
+      last = strtol(s, &end, 10);
+      if((end == s)||(last < first)){
+        if(err != NULL){
+          snprintf(err, CSI_SUBCARRIER_ERROR_STLEN, "invalid range of subcarriers ending at '%s'", s);
+        }
+        return false;
+      }
+      s = end;
+    }
+    if(last >= (long) nNative){
+      if(err != NULL){
+        snprintf(err, CSI_SUBCARRIER_ERROR_STLEN, "subcarrier %ld does not exist, the frames have %u subcarriers", last, nNative);
+      }
+      return false;
+    }
+    for(long i = first; i <= last; i++){
+      selected[i] = true;
+    }
+    while(*s == ' '){
+      s++;
+    }
+    if((*s != ',')&&(*s != '\0')){
+      if(err != NULL){
+        snprintf(err, CSI_SUBCARRIER_ERROR_STLEN, "invalid subcarrier list at '%s'", s);
+      }
+      return false;
+    }
+  }
+
+  map->n = 0;
+  map->custom = true;
+  for(uint32_t i = 0; i < nNative; i++){
+    if(selected[i]){
+      map->index[map->n++] = i;
+    }
+  }
+  if(map->n == 0){
+    if(err != NULL){
+      snprintf(err, CSI_SUBCARRIER_ERROR_STLEN, "no subcarriers selected");
+    }
+    return false;
+  }
+  return true;
+}
+
+bool CSISameSubcarriers(const CSISubcarrierMap* a, const CSISubcarrierMap* b){
+  return (a->n == b->n)&&(memcmp(a->index, b->index, a->n * sizeof(a->index[0])) == 0);
+}
+
+uint32_t CSICompileGather(const CSISubcarrierMap* source, const CSISubcarrierMap* sub, CSIGatherTable* table){
+  //both lists are sorted, so a single merge pass finds all positions
+  uint32_t n = 0;
+  uint32_t j = 0;
+  for(uint32_t i = 0; i < sub->n; i++){
+    while((j < source->n)&&(source->index[j] < sub->index[i])){
+      j++;
+    }
+    if((j < source->n)&&(source->index[j] == sub->index[i])){
+      table->map.index[n] = sub->index[i];
+      table->positions[n] = j;
+      n++;
+    }
+  }
+  table->map.n = n;
+  table->map.custom = (source->custom)||(sub->custom);
+  table->identity = (n == source->n);
+  return n;
+}
+
+void CSIGather(const CSIData* src, const uint16_t* positions, uint32_t n, CSIData* dest){
+  memcpy(dest, src, offsetof(CSIData, amplitude));
+  dest->nSubCarriers = n;
+  for(uint32_t i = 0; i < n; i++){
+    dest->amplitude[i] = src->amplitude[positions[i]];
+  }
+  for(uint32_t i = 0; i < n; i++){
+    dest->phase[i] = src->phase[positions[i]];
+  }
+}
@@ -0,0 +1,70 @@
+/*
+ * CSISubcarrierMap.h
+ * Selection of the subcarriers each consumer (display, recording, classifiers) gets from a frame, and the gather tables that extract them.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSISUBCARRIERMAP_H_
+#define CSISUBCARRIERMAP_H_
+
+#include <inttypes.h>
+#include "CSIData.h"
+
+#define CSI_MAX_SUBCARRIERS 512                 ///Size of the arrays in CSIData
+#define CSI_SUBCARRIER_ERROR_STLEN 128          ///Buffer length for an error message of CSIParseSubcarrierMap()
+
+/**
+ * The subcarriers selected from a frame as indices into the subcarriers received from Nexmon (native indices), in ascending order
+ */
+struct CSISubcarrierMap{
+  uint32_t n;                                   ///Number of selected subcarriers
+  bool custom;                                  ///true => given as a list of indices, which is stored along with recordings. false => a bandwidth (see CSIBandwidthMap())
+  uint16_t index[CSI_MAX_SUBCARRIERS];          ///Native index of each selected subcarrier
+};
+
+/**
+ * Select n contiguous subcarriers of a frame of nNative subcarriers, i.e., the 20 MHz or 40 MHz channel at the fixed offset used by WirelessEye
+ * (subcarriers 128...191 or 128...255 of 256, 64...127 of 128). n is limited to nNative.
+ */
+void CSIBandwidthMap(uint32_t nNative, uint32_t n, CSISubcarrierMap* map);
+
+/**
+ * Parse a comma-separated list of native indices and ranges (e.g., "4-31,33,36-60") into a custom map. The indices are sorted and duplicates are removed.
+ * Returns false if the list is malformed, empty or contains an index of nNative or above. Then, a description is written to err (CSI_SUBCARRIER_ERROR_STLEN bytes) if err != NULL.
+ */
+bool CSIParseSubcarrierMap(const char* spec, uint32_t nNative, CSISubcarrierMap* map, char* err);
+
+/**
+ * Returns true, if both maps select the same subcarriers
+ */
+bool CSISameSubcarriers(const CSISubcarrierMap* a, const CSISubcarrierMap* b);
+
+/**
+ * Extracts the subcarriers of a consumer from frames that hold the subcarriers of another map
+ */
+struct CSIGatherTable{
+  CSISubcarrierMap map;                         ///The extracted subcarriers
+  uint16_t positions[CSI_MAX_SUBCARRIERS];      ///Position of each extracted subcarrier in the source frames
+  bool identity;                                ///true => all subcarriers of the source in their order, i.e., the source frames can be used as they are
+};
+
+/**
+ * Compile a gather table that extracts the subcarriers of sub from frames holding the subcarriers of source. Subcarriers of sub that source does not contain are left out.
+ * The map of the table is custom if source or sub is. Returns the number of extracted subcarriers.
+ */
+uint32_t CSICompileGather(const CSISubcarrierMap* source, const CSISubcarrierMap* sub, CSIGatherTable* table);
+
+/**
+ * Copy all fields of src into dest, keeping only the n subcarriers at the given positions
+ */
+void CSIGather(const CSIData* src, const uint16_t* positions, uint32_t n, CSIData* dest);
+
+#endif /* CSISUBCARRIERMAP_H_ */
@@ -0,0 +1,247 @@
+/*
+ * CSIWindowAssembler.cpp
+ * Assembles the frames of each MAC address into windows of a fixed number of frames, which are passed to the classifier as one tensor each.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CSIWindowAssembler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define CSI_WINDOW_MAX_SUBCARRIERS 512          ///Size of the arrays in CSIData
+
+/**
+ * Returns the time of a frame in ns
+ */
+static inline uint64_t frameTime(const struct timespec_16bytes* t){
+  return t->tv_sec * 1000000000ULL + t->tv_nsec;
+}
+
+/**
+ * Copy the amplitudes (and the phases if nChannels == 2) of n subcarriers of a frame into a row
+ */
+static inline void copyFrame(float* row, const CSIData* data, uint32_t n, uint32_t nChannels){
+  for(uint32_t s = 0; s < n; s++){
+    row[s] = data->amplitude[s];
+  }
+  if(nChannels == 2){
+    for(uint32_t s = 0; s < n; s++){
+      row[n + s] = data->phase[s];
+    }
+  }
+}
+
+CSIWindowAssembler::CSIWindowAssembler(){
+  nWindows = 0;
+  nFrames = 0;
+  hop = 1;
+  rate = 0;
+  gapFill = CSI_GAP_HOLD;
+  nChannels = 1;
+  msg = NULL;
+  msgLen = 0;
+  callback = NULL;
+  context = NULL;
+}
+
+CSIWindowAssembler::~CSIWindowAssembler(){
+  clear();
+  free(msg);
+}
+
+void CSIWindowAssembler::clear(){
+  for(uint32_t i = 0; i < nWindows; i++){
+    free(windows[i]->rows);
+    free(windows[i]->times);
+    free(windows[i]->filled);
+    delete windows[i];
+  }
+  nWindows = 0;
+}
+
+bool CSIWindowAssembler::configure(uint32_t nFrames, uint32_t hop, double rate, CSIGapFill gapFill, bool withPhase){
+  if((nFrames == 0)||(nFrames > CSI_WINDOW_MAX_FRAMES)||(hop == 0)||(rate < 0)){
+    printf("Invalid window: %u frames, hop %u, rate %f\n", nFrames, hop, rate);
+    return false;
+  }
+  clear();
+  this->nFrames = nFrames;
+  this->hop = hop;
+  this->rate = rate;
+  this->gapFill = gapFill;
+  nChannels = withPhase ? 2 : 1;
+
+  free(msg);
+  msgLen = sizeof(CSIWindowHeader) + nChannels * nFrames * CSI_WINDOW_MAX_SUBCARRIERS * sizeof(float);
+  msg = (char*) malloc(msgLen);
+  if(msg == NULL){
+    printf("Cannot allocate %u bytes for windows\n", msgLen);
+    msgLen = 0;
+    return false;
+  }
+  return true;
+}
+
+void CSIWindowAssembler::setCallback(CSIWindowCallback callback, void* context){
+  this->callback = callback;
+  this->context = context;
+}
+
+CSIWindowAssembler::macWindow* CSIWindowAssembler::getWindow(const uint8_t* MAC){
+  for(uint32_t i = 0; i < nWindows; i++){
+    if(memcmp(windows[i]->MAC, MAC, 6) == 0){
+      return windows[i];
+    }
+  }
+  if(nWindows >= CSI_WINDOW_MAX_MACS){
+    return NULL;
+  }
+  macWindow* w = new macWindow;
+  memcpy(w->MAC, MAC, 6);
+  w->rows = (float*) malloc(nFrames * nChannels * CSI_WINDOW_MAX_SUBCARRIERS * sizeof(float));
+  w->times = (uint64_t*) malloc(nFrames * sizeof(uint64_t));
+  w->filled = (bool*) malloc(nFrames * sizeof(bool));
+  if((w->rows == NULL)||(w->times == NULL)||(w->filled == NULL)){
+    printf("Cannot allocate memory for windows\n");
+    free(w->rows);
+    free(w->times);
+    free(w->filled);
+    delete w;
+    return NULL;
+  }
+  resetWindow(w, 0);
+  windows[nWindows] = w;
+  nWindows++;
+  return w;
+}
+
+void CSIWindowAssembler::resetWindow(macWindow* w, uint32_t nSubCarriers){
+  w->nSubCarriers = nSubCarriers;
+  w->count = 0;
+  w->gridTime = 0;
+}
+
+float* CSIWindowAssembler::beginRow(macWindow* w, uint64_t t, bool filled){
+  uint32_t i = w->count % nFrames;
+  w->times[i] = t;
+  w->filled[i] = filled;
+  return w->rows + i * nChannels * w->nSubCarriers;
+}
+
+void CSIWindowAssembler::endRow(macWindow* w){
+  w->count++;
+  if((w->count >= nFrames)&&((w->count - nFrames) % hop == 0)){
+    emitWindow(w);
+  }
+}
+
+void CSIWindowAssembler::emitWindow(macWindow* w){
+  if(callback == NULL){
+    return;
+  }
+  uint32_t n = w->nSubCarriers;
+  uint32_t rowLen = nChannels * n;
+  uint64_t first = w->count - nFrames;
+  CSIWindowHeader* h = (CSIWindowHeader*) msg;
+  float* tensor = (float*) (msg + sizeof(CSIWindowHeader));
+
+  memcpy(h->magic, CSI_WINDOW_MAGIC, 4);
+  h->headerLen = sizeof(CSIWindowHeader);
+  memcpy(h->MAC, w->MAC, 6);
+  h->nFilled = 0;
+  h->nFrames = nFrames;
+  h->nSubCarriers = n;
+  h->nChannels = nChannels;
+  h->reserved = 0;
+  h->tStart = w->times[first % nFrames];
+  h->tEnd = w->times[(w->count - 1) % nFrames];
+
+  //the rows hold all channels of a frame, the tensor all frames of a channel
+  for(uint32_t f = 0; f < nFrames; f++){
+    uint32_t i = (first + f) % nFrames;
+    const float* row = w->rows + i * rowLen;
+    for(uint32_t c = 0; c < nChannels; c++){
+      memcpy(tensor + (c * nFrames + f) * n, row + c * n, n * sizeof(float));
+    }
+    if(w->filled[i]){
+      h->nFilled++;
+    }
+  }
+  callback(context, msg, sizeof(CSIWindowHeader) + nChannels * nFrames * n * sizeof(float));
+}
+
+void CSIWindowAssembler::addFrame(const CSIData* data, const struct timespec_16bytes* t){
+  uint64_t time = frameTime(t);
+  uint32_t n = data->nSubCarriers;
+  if(n > CSI_WINDOW_MAX_SUBCARRIERS){
+    n = CSI_WINDOW_MAX_SUBCARRIERS;
+  }
+  if((msg == NULL)||(n == 0)){
+    return;
+  }
+  macWindow* w = getWindow(data->senderMAC);
+  if(w == NULL){
+    return;
+  }
+  if(n != w->nSubCarriers){
+    resetWindow(w, n);
+  }
+
+  //number of grid positions since the most recent row
+  int64_t k = 1;
+  double period = 0;
+  if((rate > 0)&&(w->count > 0)){
+    period = 1e9 / rate;
+    k = llround(((double) (int64_t) (time - w->gridTime)) / period);
+    if(k <= 0){
+      //same grid position as the most recent row: keep the latest frame only
+      uint32_t i = (w->count - 1) % nFrames;
+      w->times[i] = time;
+      w->filled[i] = false;
+      copyFrame(w->rows + i * nChannels * n, data, n, nChannels);
+      return;
+    }else if((k - 1 >= nFrames)||((k > 1)&&(gapFill == CSI_GAP_DROP))){
+      resetWindow(w, n);
+      k = 1;
+    }
+  }
+
+  //replace missing frames
+  uint32_t rowLen = nChannels * n;
+  for(int64_t j = 1; j < k; j++){
+    const float* prev = w->rows + ((w->count + nFrames - 1) % nFrames) * rowLen;
+    float* row = beginRow(w, w->gridTime + (uint64_t) llround(j * period), true);
+    if(gapFill == CSI_GAP_ZERO){
+      memset(row, 0, rowLen * sizeof(float));
+    }else if(gapFill == CSI_GAP_LINEAR){
+      //each step covers an equal share of the remaining distance to the new frame
+      double fraction = 1.0 / (k - j + 1);
+      for(uint32_t s = 0; s < n; s++){
+        row[s] = prev[s] + (data->amplitude[s] - prev[s]) * fraction;
+      }
+      if(nChannels == 2){
+        for(uint32_t s = 0; s < n; s++){
+          row[n + s] = prev[n + s] + (data->phase[s] - prev[n + s]) * fraction;
+        }
+      }
+    }else{
+      memmove(row, prev, rowLen * sizeof(float));
+    }
+    endRow(w);
+  }
+
+  copyFrame(beginRow(w, time, false), data, n, nChannels);
+  //the grid starts with the first frame after the frames have been discarded
+  w->gridTime = ((period > 0)&&(w->count > 0)) ? w->gridTime + (uint64_t) llround(k * period) : time;
+  endRow(w);
+}
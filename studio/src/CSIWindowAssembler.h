@@ -0,0 +1,145 @@
+/*
+ * CSIWindowAssembler.h
+ * Assembles the frames of each MAC address into windows of a fixed number of frames, which are passed to the classifier as one tensor each.
+ * This code does not depend on QT.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSIWINDOWASSEMBLER_H_
+#define CSIWINDOWASSEMBLER_H_
+
+#include <inttypes.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+
+#define CSI_WINDOW_MAGIC "WEWN"                 ///Magic value at the beginning of each window message
+#define CSI_WINDOW_MAX_MACS 256                 ///Maximum number of MAC addresses windows are assembled for
+#define CSI_WINDOW_MAX_FRAMES 4096              ///Maximum number of frames per window
+
+/**
+ * How missing frames are replaced if windows are assembled on a fixed time grid
+ */
+enum CSIGapFill{
+  CSI_GAP_HOLD = 0,                             ///Repeat the previous frame
+  CSI_GAP_LINEAR = 1,                           ///Interpolate linearly between the frames before and after the gap
+  CSI_GAP_ZERO = 2,                             ///Insert frames of zeros
+  CSI_GAP_DROP = 3                              ///Discard the frames received so far, i.e., windows never contain gaps
+};
+
+/**
+ * Header of each window message, followed by nChannels x nFrames x nSubCarriers float32 values (amplitudes, then phases if nChannels == 2).
+ * All values are little endian.
+ */
+struct CSIWindowHeader{
+  char magic[4];                                ///CSI_WINDOW_MAGIC without the terminating 0
+  uint32_t headerLen;                           ///Size of this header, i.e., offset of the tensor
+  uint8_t MAC[6];                               ///MAC address of the sender
+  uint16_t nFilled;                             ///Number of frames of the window that replace missing frames
+  uint32_t nFrames;                             ///Number of frames
+  uint32_t nSubCarriers;                        ///Number of subcarriers
+  uint32_t nChannels;                           ///1: amplitudes only, 2: amplitudes and phases
+  uint32_t reserved;
+  uint64_t tStart;                              ///Time of the first frame in ns since 1970
+  uint64_t tEnd;                                ///Time of the last frame in ns since 1970
+};
+
+/**
+ * Called for every complete window. msg points to the header, which is followed by the tensor. len is the size of the entire message.
+ */
+typedef void (*CSIWindowCallback)(void* context, const char* msg, uint32_t len);
+
+/**
+ * \brief Assembles windows of nFrames frames by nSubCarriers subcarriers per MAC address.
+ *
+ * After the first window of a MAC address is complete, a new one is passed to the callback every hop frames.
+ * If rate is greater than 0, the frames are placed on a time grid with rate frames per second. Missing frames are then replaced according to
+ * the gap fill policy, and of several frames in the same grid position only the latest is kept. A gap of an entire window discards all frames
+ * received so far. If rate is 0, windows consist of consecutive frames regardless of their timing.
+ * A change of the number of subcarriers of a MAC address also discards its frames.
+ * The memory of each MAC address is allocated when it appears for the first time, so there is no allocation per frame.
+ */
+class CSIWindowAssembler{
+  private:
+  /**
+   * State of one MAC address
+   */
+  struct macWindow{
+    uint8_t MAC[6];                             ///The MAC address
+    uint32_t nSubCarriers;                      ///Number of subcarriers of the frames in rows
+    float* rows;                                ///Ring of nFrames rows of nChannels*nSubCarriers values
+    uint64_t* times;                            ///Time of each row in ns
+    bool* filled;                               ///true => the row replaces a missing frame
+    uint64_t count;                             ///Number of rows added since the frames have been discarded most recently. Row i is at position i % nFrames
+    uint64_t gridTime;                          ///Grid time of the most recent row in ns
+  };
+
+  macWindow* windows[CSI_WINDOW_MAX_MACS];      ///All MAC addresses
+  uint32_t nWindows;                            ///Number of entries in windows
+  uint32_t nFrames;                             ///Frames per window
+  uint32_t hop;                                 ///Number of frames between the starts of two consecutive windows
+  double rate;                                  ///Frames per second of the time grid. 0 => no time grid
+  CSIGapFill gapFill;                           ///Policy for missing frames
+  uint32_t nChannels;                           ///1: amplitudes only, 2: amplitudes and phases
+  char* msg;                                    ///Buffer for a window message
+  uint32_t msgLen;                              ///Size of msg
+  CSIWindowCallback callback;                   ///Called for every complete window
+  void* context;                                ///Passed to callback
+
+  /**
+   * Returns the state of the given MAC address, which is created if needed. Returns NULL if there are too many MAC addresses.
+   */
+  macWindow* getWindow(const uint8_t* MAC);
+
+  /**
+   * Discard all frames of w and prepare it for frames of nSubCarriers subcarriers
+   */
+  void resetWindow(macWindow* w, uint32_t nSubCarriers);
+
+  /**
+   * Returns the row following the most recent row of w, which gets the time t. The row becomes part of w with endRow().
+   */
+  float* beginRow(macWindow* w, uint64_t t, bool filled);
+
+  /**
+   * Append the row returned by beginRow() to w. Emits a window, if one is complete.
+   */
+  void endRow(macWindow* w);
+
+  /**
+   * Copy the window ending with the most recent row of w into msg and pass it to the callback
+   */
+  void emitWindow(macWindow* w);
+
+  /**
+   * Free the state of all MAC addresses
+   */
+  void clear();
+
+  public:
+  CSIWindowAssembler();
+  ~CSIWindowAssembler();
+
+  /**
+   * Set the shape of the windows and how they are assembled, discarding all frames received so far. Returns false if the parameters are invalid.
+   */
+  bool configure(uint32_t nFrames, uint32_t hop, double rate, CSIGapFill gapFill, bool withPhase);
+
+  /**
+   * Set the function called for every complete window
+   */
+  void setCallback(CSIWindowCallback callback, void* context);
+
+  /**
+   * Add a frame received at time t
+   */
+  void addFrame(const CSIData* data, const struct timespec_16bytes* t);
+};
+
+#endif /* CSIWINDOWASSEMBLER_H_ */
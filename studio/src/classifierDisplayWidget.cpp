@@ -25,12 +25,17 @@ using namespace std;
 #define CLASSIF_MARGIN 10
 classifierDisplayWidget::classifierDisplayWidget(QWidget* parent)
 {
-  binWidth = 0;
+  time = 0;
   nClassifiers = 0;
-  lastOutputs = NULL;
   maxHeight = 0;
-  timeStepsSinceLastData = 0;
   maxValue = 10;
+  clock.start();
+  clockMs = 0;
+  pendingMs = 0;
+  columnMs = CDW_DEFAULT_COLUMN_MS;
+  for(uint32_t i = 0; i < CDW_MAX_LANES; i++){
+    hasOutput[i] = false;
+  }
 dirtyFlag = true;
   printf("Construction @ %x\n",this);
   if (parent != NULL) {
@@ -76,6 +81,23 @@ void classifierDisplayWidget::setNClassifiers(uint32_t nClassifiers){
   this->nClassifiers = nClassifiers;
 }
 
+/*Returns the lane of the given classifier of the given sink, which is assigned if needed.*/
+uint32_t classifierDisplayWidget::getLane(unsigned int sink, unsigned int classifID){
+  for(uint32_t i = 0; i < nClassifiers; i++){
+    if((laneSink[i] == sink)&&(laneClassifID[i] == classifID)){
+      return i;
+    }
+  }
+  if(nClassifiers >= CDW_MAX_LANES){
+    return CDW_MAX_LANES;
+  }
+  laneSink[nClassifiers] = sink;
+  laneClassifID[nClassifiers] = classifID;
+  laneTime[nClassifiers] = time;
+  nClassifiers++;
+  return nClassifiers - 1;
+}
+
 /*Set the maximum class the classifier might deliver.*/
 void classifierDisplayWidget::setMaxValue(int maxValue){
   this->maxValue = maxValue;
@@ -96,40 +118,83 @@ void classifierDisplayWidget::paintEvent(QPaintEvent* ev) {
   if(mutex != NULL){
     mutex->lock();
   }
+  advance();
   QPainter p(this);
-  p.drawImage(0,0,*img);
+  //unwrap the ring: the oldest column is the next one to be written
+  uint32_t pos = (img->width() > 0) ? time % img->width() : 0;
+  p.drawImage(0, 0, *img, pos, 0, img->width() - pos, img->height());
+  if(pos > 0){
+    p.drawImage(img->width() - pos, 0, *img, 0, 0, pos, img->height());
+  }
   p.end();
   if(mutex != NULL){
     mutex->unlock();
   }
 
 }
-void classifierDisplayWidget::addTime(){
-  if(mutex != NULL){
-    mutex->lock();
+/*Advance the time to the clock*/
+void classifierDisplayWidget::advance(){
+  if((img == NULL)||(img->width() == 0)){
+    return;
   }
-  //just add a bit of time
-  binWidth = binWidth + 1;
-  painter->begin(img);
-
-  //scrolle everything by one pixel to the left
-  painter->drawImage(-1,0,*img);
+  qint64 now = clock.elapsed();
+  pendingMs += now - clockMs;
+  clockMs = now;
+  if(pendingMs < columnMs){
+    return;
+  }
+  uint64_t n = pendingMs / columnMs;
+  pendingMs -= n * columnMs;
 
-  //Preview: extend the previously seen result to the most recent point in time until new calssification data arrives.
+  //only the columns that have passed are cleared, all others stay as they are. A long pause clears the whole image once.
+  uint32_t width = img->width();
+  uint32_t imgHeight = img->height();
+  uint32_t nClear = (n < width) ? n : width;
+  uchar* bits = img->bits();
+  uint32_t bytesPerLine = img->bytesPerLine();
+  QRgb gray = QColor(Qt::gray).rgb();
+  for(uint32_t c = 0; c < nClear; c++){
+    uint32_t x = (time + n - nClear + c) % width;
+    uchar* row = bits;
+    for(uint32_t y = 0; y < imgHeight; y++){
+      ((QRgb*) row)[x] = qRgb(0, 0, 0);
+      row += bytesPerLine;
+    }
+    //Preview: extend the previously seen result to the most recent point in time until new calssification data arrives.
 #if PREVIEW
-  if(lastOutputs != NULL){
-    if(timeStepsSinceLastData >= 5){
-      for(uint32_t i = 0; i < nClassifiers; i++){
-        QPen penOld = painter->pen();
-        painter->setPen(QPen(Qt::gray, 1));
-        painter->drawLine(img->width() - 3 , img->height() - CLASSIF_MARGIN - (i)*(maxHeight + CLASSIF_MARGIN)-lastOutputs[i],img->width()-2, img->height() - CLASSIF_MARGIN - (i)*(maxHeight + CLASSIF_MARGIN)-lastOutputs[i]);
-        painter->setPen(penOld);
+    for(uint32_t i = 0; (i < nClassifiers)&&(maxHeight > 0); i++){
+      int32_t y = img->height() - CLASSIF_MARGIN - (i)*(maxHeight + CLASSIF_MARGIN)-lastOutputs[i];
+      if((hasOutput[i])&&(y >= 0)&&(y < (int32_t) imgHeight)){
+        ((QRgb*) (bits + y * bytesPerLine))[x] = gray;
       }
     }
-  }
 #endif
-  painter->end();
-  timeStepsSinceLastData++;
+  }
+  time += n;
+}
+
+/*Draw a rectangle covering the w columns before the next column of the ring*/
+void classifierDisplayWidget::drawRing(uint32_t w, int32_t y, int32_t h, int32_t gap){
+  int32_t width = img->width();
+  int32_t x = (int32_t) ((time + width - w) % width);
+  painter->drawRect(x, y, w - gap, h);
+  //the part beyond the right edge continues at the left edge
+  if(x + (int32_t) w > width){
+    painter->drawRect(x - width, y, w - gap, h);
+  }
+}
+
+/*Set the time covered by one column in ms*/
+void classifierDisplayWidget::setColumnTime(double ms){
+  if(ms <= 0){
+    return;
+  }
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  //the columns passed so far keep their time
+  advance();
+  columnMs = ms;
   if(mutex != NULL){
     mutex->unlock();
   }
@@ -138,41 +203,63 @@ void classifierDisplayWidget::addTime(){
 
 /* Add a new classifier output.
  * Parameters:
- *      - classifID: The ID of the classifier. This is a counting number between 0 and the number of classifiers - 1
+ *      - sink: The counting number of the classifier process
+ *      - classifID: The ID of the classifier within its process. This is a counting number between 0 and the number of classifiers - 1
  *      - classNo: The class number that the classifier has determined based on the CSI data.
  *      - certainty: A value between 0 and 1. 0 means that the classifier is entirely uncertain, 1 means its is fully shure that the determined class is correct.
  * E.g. classifID=0 estimates classNo=1 with a certainty of 0.95.*/
-void classifierDisplayWidget::addClassifierOutput(unsigned int classifID, unsigned int classNo, float certainty){
-  static uint32_t binWidthToUse = 0;
+void classifierDisplayWidget::addClassifierOutput(unsigned int sink, unsigned int classifID, unsigned int classNo, float certainty){
   int32_t color;
   if(mutex != NULL){
     mutex->lock();
   }
 
-  if(classifID == 0){
-    binWidthToUse = binWidth;
+  advance();
+  uint32_t nLanes = nClassifiers;
+  uint32_t lane = getLane(sink, classifID);
+  if(lane == CDW_MAX_LANES){
+    if(mutex != NULL){
+      mutex->unlock();
+    }
+    return;
+  }
+  //the bar covers the time since the previous result of this lane, at least one column and at most the width
+  uint64_t binWidthToUse = time - laneTime[lane];
+  laneTime[lane] = time;
+  if(img->width() == 0){
+    if(mutex != NULL){
+      mutex->unlock();
+    }
+    return;
   }
-  if((classifID+1 > nClassifiers)||(dirtyFlag)){
+  if(binWidthToUse < 1){
+    binWidthToUse = 1;
+  }
+  if(binWidthToUse > (uint64_t) img->width()){
+    binWidthToUse = img->width();
+  }
+
+  //a new lane changes the layout
+  if((nClassifiers > nLanes)||(dirtyFlag)){
     painter->begin(img);
     painter->setBrush(QBrush(QColor(0,0,0)));
     painter->setPen(Qt::black);
     painter->drawRect(0,0,img->width(), img->height());
     painter->end();
-    nClassifiers = classifID+1;
 
-    binWidth = 0;
-    timeStepsSinceLastData = 0;
+    for(uint32_t i = 0; i < nClassifiers; i++){
+      laneTime[i] = time;
+      hasOutput[i] = false;
+    }
     dirtyFlag = false;
-    delete lastOutputs;
-    lastOutputs = NULL;
+    maxHeight = 0;
 
     if(mutex != NULL){
       mutex->unlock();
     }
     return;
   }
-  if(lastOutputs == NULL){
-        lastOutputs = new uint32_t[nClassifiers];
+  if(maxHeight == 0){
         maxHeight = img->height() / nClassifiers - CLASSIF_MARGIN;
         fprintf(stderr, "max height: %d\n",maxHeight);
         printf("new\n");
@@ -192,22 +279,18 @@ void classifierDisplayWidget::addClassifierOutput(unsigned int classifID, unsign
     height = maxHeight;
   }
 
-  if(lastOutputs != NULL){
-    lastOutputs[classifID] = height;
-  }
+  lastOutputs[lane] = height;
+  hasOutput[lane] = true;
   painter->begin(img);
 #if PREVIEW
   painter->setBrush(QBrush(QColor(0,0,0)));
   painter->setPen(Qt::black);
-  painter->drawRect(img->width() - binWidthToUse - 2, img->height() - CLASSIF_MARGIN - (classifID)*(maxHeight + CLASSIF_MARGIN),binWidthToUse,-maxHeight);
+  drawRing(binWidthToUse, img->height() - CLASSIF_MARGIN - (lane)*(maxHeight + CLASSIF_MARGIN), -maxHeight, 0);
 #endif
   painter->setBrush(QBrush(QColor((uint8_t)(255 - color), (uint8_t) (color),0)));
   painter->setPen(Qt::white);
-  painter->drawRect(img->width() - binWidthToUse - 2, img->height() - CLASSIF_MARGIN - (classifID)*(maxHeight + CLASSIF_MARGIN),binWidthToUse-3,-height);
+  drawRing(binWidthToUse, img->height() - CLASSIF_MARGIN - (lane)*(maxHeight + CLASSIF_MARGIN), -height, (binWidthToUse > 3) ? 3 : 0);
   painter->end();
-  if(classifID == nClassifiers-1){
-    binWidth = 0;
-  }
   if(mutex != NULL){
     mutex->unlock();
   }
@@ -227,10 +310,11 @@ delete painter;
 
   painter = new QPainter();
 
-  if(lastOutputs != NULL){
-    delete lastOutputs;
+  //the bars are drawn anew with the next results
+  maxHeight = 0;
+  for(uint32_t i = 0; i < CDW_MAX_LANES; i++){
+    hasOutput[i] = false;
   }
-  lastOutputs = NULL;
   if(this->mutex != NULL){
     this->mutex->unlock();
   }
@@ -246,13 +330,13 @@ void classifierDisplayWidget::reset(){
   if(this->mutex != NULL){
     this->mutex->lock();
   }
-  binWidth = 0;
+  time = 0;
   nClassifiers = 0;
   dirtyFlag = true;
-  delete lastOutputs;
-  lastOutputs = NULL;
   maxHeight = 0;
-  timeStepsSinceLastData = 0;
+  for(uint32_t i = 0; i < CDW_MAX_LANES; i++){
+    hasOutput[i] = false;
+  }
   if(this->mutex != NULL){
     this->mutex->unlock();
   }
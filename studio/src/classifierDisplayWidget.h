@@ -22,10 +22,14 @@
 #include <QSlider>
 #include <inttypes.h>
 #include <QPainter>
+#include <QElapsedTimer>
 #include "CSIData.h"
 #include "ui_mainwindow.h"
 class MainWindow;
 
+#define CDW_MAX_LANES 64                        ///Maximum number of bars, i.e., classifiers of all classifier processes together
+#define CDW_DEFAULT_COLUMN_MS 10.0              ///Time per column until setColumnTime() is called
+
 
 using namespace std;
 /** \brief A widget to paint CSI classification results.
@@ -33,6 +37,11 @@ using namespace std;
  * We assume that the output of a classifier is an integer value within a given range, which represents the actual class.
  * Each classifier will be depicted by a bar. The height of each bar depicts the classification result, which is always an integer.
  * The color of the bar represents certainty of the classification, which is a floating point value between 0 and 1.
+ * Several classifier processes (sinks) can run concurrently, each of them with any number of classifiers. Each classifier of each sink gets its own lane,
+ * in the order of their first output. As the sinks output their results independently, the width of each bar is measured for each lane separately.
+ *
+ * The image is a ring of columns, each of which covers a fixed time. The time is advanced when a result arrives or the widget is painted: only the columns that
+ * have passed since then are cleared, and a result only draws its bar. Hence, the effort depends neither on the frame rate nor on the size of the widget.
  */
 class classifierDisplayWidget : public QWidget{
 
@@ -41,16 +50,33 @@ class classifierDisplayWidget : public QWidget{
 private:
         MainWindow* mw;                         ///Pointer to the main window
         QMutex *mutex;                          ///A mutex to protect this class against access from multiple concurrent threads
-        QImage *img;                            ///QImage to draw into
-        uint32_t nClassifiers;                  ///The number of classifiers that we are supposed to display, which needs to be set via setNClassifiers()
-        uint32_t binWidth;                      ///The width of a bar. It is determined by the difference in time between to subsequent classifier results, and the number of arrived CSI frames in the meantime.
+        QImage *img;                            ///QImage to draw into. It is a ring of columns: column time % width is the next one, and the ring is unwrapped when painting
+        uint32_t nClassifiers;                  ///The number of classifiers (lanes) that we are supposed to display
+        uint64_t time;                          ///The number of columns passed so far. The width of a bar is the time since the previous result of the same lane.
+        QElapsedTimer clock;                    ///Measures the time passed
+        qint64 clockMs;                         ///Time of clock up to which the columns have been advanced
+        double pendingMs;                       ///Time passed since the last completed column
+        double columnMs;                        ///Time covered by one column in ms
+        uint32_t laneSink[CDW_MAX_LANES];       ///The sink of each lane
+        uint32_t laneClassifID[CDW_MAX_LANES];  ///The classifier of each lane within its sink
+        uint64_t laneTime[CDW_MAX_LANES];       ///The time of the most recent result of each lane
         QPainter *painter;                      ///A QPainter to draw
-        uint32_t* lastOutputs;                  ///An array of the previously received classification results. Until new data has received, this data is drawn as a sort of "preview" for the current data.
+        uint32_t lastOutputs[CDW_MAX_LANES];    ///The height of the previous bar of each lane. Until new data has received, it is drawn as a sort of "preview" for the current data.
                                                 ///Once new data has arrived, these "previews" will be redrawn with the actual data
-        uint32_t maxHeight;                     ///The maximum height of a bar. Depends on the window height and the number of classifiers (and hence, bars)
-       uint32_t timeStepsSinceLastData;         ///The number of time-steps since the last classification result has arrived. The time is advanced by "1" whenever a news WiFi frame (and hence, a bunch of CSI data) arrives.
+        bool hasOutput[CDW_MAX_LANES];          ///true => lastOutputs is valid for the lane
+        uint32_t maxHeight;                     ///The maximum height of a bar. Depends on the window height and the number of classifiers (and hence, bars). 0 => to be calculated
        bool dirtyFlag;                          ///When true, the entire image has to be redrawn. Otherwise, we keep whatever has been drawn before and just add to the already positioned pixels.
        int maxValue;                            ///The maximum value the classifier might ouput. To be set using setMaxValue().
+
+        /**
+         * Advance the time to the clock: clear the columns that have passed since the previous call and draw the previews into them. The mutex must be locked by the caller.
+         */
+        void advance();
+
+        /**
+         * Draw a rectangle covering the w columns before the next column of the ring, wrapping around at the right edge. The painter must be active.
+         */
+        void drawRing(uint32_t w, int32_t y, int32_t h, int32_t gap);
 public:
         classifierDisplayWidget(QWidget* parent = 0);
         ~classifierDisplayWidget();
@@ -65,6 +91,12 @@ public:
          * */
         void setNClassifiers(uint32_t nClassifiers);
 
+        /**
+         * Returns the lane of the given classifier of the given sink. A new lane is assigned if it has none. Returns CDW_MAX_LANES if all lanes are in use.
+         * The mutex must be locked by the caller.
+         */
+        uint32_t getLane(unsigned int sink, unsigned int classifID);
+
         /**
          *  Set a pointer to the main window.
          */
@@ -83,18 +115,19 @@ public slots:
         void reset();
 
         /**
-         *  Add one unit of time, i.e., scroll the figure by one pixel to the left. This needs to be called whenever a new WiFi frame and hence new CSI data arrives.
+         * Set the time covered by one column in ms, e.g., to match the amplitude display
          */
-        void addTime();
+        void setColumnTime(double ms);
 
         /** Add a new classifier output.
          * @parameters:
-         *      - classifID: The ID of the classifier. This is a counting number between 0 and the number of classifiers - 1
+         *      - sink: The counting number of the classifier process
+         *      - classifID: The ID of the classifier within its process. This is a counting number between 0 and the number of classifiers - 1
          *      - classNo: The class number that the classifier has determined based on the CSI data.
          *      - certainty: A value between 0 and 1. 0 means that the classifier is entirely uncertain, 1 means its is fully shure that the determined class is correct.
          * E.g. classifID=0 estimates classNo=1 with a certainty of 0.95.
          * */
-        void addClassifierOutput(unsigned int classifID, unsigned int classNo, float certainty);
+        void addClassifierOutput(unsigned int sink, unsigned int classifID, unsigned int classNo, float certainty);
 
         /*
          * Set the maximum class the classifier might deliver.
@@ -22,11 +22,12 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include "networkThread.h"
+#include <stddef.h>
 
 #define USE_WRT true
 
 
-classifierThread::classifierThread(){
+classifierThread::classifierThread(uint32_t sink){
 #if USE_WRT
   wrt = NULL;
 #endif
@@ -38,6 +39,26 @@ classifierThread::classifierThread(){
   running = false;
   buf[0] = '\0';
   pid = 0;
+  this->sink = sink;
+  nScopeMACs = 0;
+  nWindowFollowers = 0;
+  exportMode = LIVE_EXPORT_TEXT;
+  usePlugin = false;
+  config.mode = LIVE_EXPORT_TEXT;
+  config.nSubCarriers = 0;
+  subcarrierMap.n = 0;
+  subcarrierMap.custom = false;
+  gatherEpoch = 0;
+  config.windowFrames = 9;
+  config.windowHop = 9;
+  config.windowRate = 9;
+  config.windowGapFill = CSI_GAP_HOLD;
+  config.windowPhase = false;
+  config.featureBins = 0;
+  config.queueCapacity = 16*1024*1024;
+  config.queuePolicy = CLASSIFIER_DROP_OLDEST;
+  windowAssembler.setCallback(windowReady, this);
+  featureExtractor.setCallback(featuresReady, this);
 }
 classifierThread::~classifierThread(){
  mutex.unlock();
@@ -45,20 +66,97 @@ classifierThread::~classifierThread(){
   if(pid > 0){
     kill(pid,SIGTERM);
   }
-#if USE_WRT
-  if(wrt != NULL){
-    delete wrt;
-    wrt = NULL;
-  }
-#endif
+  deleteWrt();
   printf("CT: Destroyed\n");
 
 }
-void classifierThread::setCommand(const QString &Command){
-  this->Command = Command;
+bool classifierThread::setConfig(const classifierConfig &config){
+  QStringList MACs = config.MACs.split(QLatin1Char(','), QString::SkipEmptyParts);
+  if(MACs.length() > CLASSIFIER_MAX_SCOPE_MACS){
+    printf("Classifier %u: more than %u MAC addresses\n", sink + 1, CLASSIFIER_MAX_SCOPE_MACS);
+    return false;
+  }
+  for(int i = 0; i < MACs.length(); i++){
+    unsigned int b[6];
+    char end;
+    if(sscanf(MACs[i].trimmed().toUtf8().data(), "%x:%x:%x:%x:%x:%x%c", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5], &end) != 6){
+      printf("Classifier %u: invalid MAC address %s\n", sink + 1, MACs[i].trimmed().toUtf8().data());
+      return false;
+    }
+    for(uint32_t j = 0; j < 6; j++){
+      if(b[j] > 0xff){
+        printf("Classifier %u: invalid MAC address %s\n", sink + 1, MACs[i].trimmed().toUtf8().data());
+        return false;
+      }
+      scopeMACs[i][j] = b[j];
+    }
+  }
+  QByteArray subCarriers = config.subCarriers.trimmed().toLocal8Bit();
+  CSISubcarrierMap map;
+  map.n = 0;
+  map.custom = false;
+  char err[CSI_SUBCARRIER_ERROR_STLEN];
+  if((!subCarriers.isEmpty())&&(!CSIParseSubcarrierMap(subCarriers.constData(), CSI_MAX_SUBCARRIERS, &map, err))){
+    printf("Classifier %u: %s\n", sink + 1, err);
+    return false;
+  }
+  nScopeMACs = MACs.length();
+  subcarrierMap = map;
+  gatherEpoch = 0;
+  this->config = config;
+  return true;
+}
+
+const classifierConfig& classifierThread::getConfig(){
+  return config;
+}
+
+uint32_t classifierThread::getSink(){
+  return sink;
+}
+
+bool classifierThread::hasMACScope(){
+  return nScopeMACs > 0;
+}
+
+bool classifierThread::inMACScope(const uint8_t* MAC){
+  for(uint32_t i = 0; i < nScopeMACs; i++){
+    if(memcmp(scopeMACs[i], MAC, 6) == 0){
+      return true;
+    }
+  }
+  return false;
+}
+
+const CSIGatherTable* classifierThread::getGather(uint32_t nNative, const CSISubcarrierMap* exportMap, uint32_t epoch){
+  if(epoch != gatherEpoch){
+    if(subcarrierMap.custom){
+      CSICompileGather(exportMap, &subcarrierMap, &gather);
+    }else if(config.nSubCarriers == 0){
+      CSICompileGather(exportMap, exportMap, &gather);
+    }else{
+      CSISubcarrierMap map;
+      CSIBandwidthMap(nNative, config.nSubCarriers, &map);
+      CSICompileGather(exportMap, &map, &gather);
+    }
+    gatherEpoch = epoch;
+  }
+  return &gather;
+}
+
+bool classifierThread::sharesWindows(classifierThread* other){
+  if((exportMode != LIVE_EXPORT_WINDOWS)||(other->exportMode != LIVE_EXPORT_WINDOWS)){
+    return false;
+  }
+  return (config.nSubCarriers == other->config.nSubCarriers)&&(CSISameSubcarriers(&subcarrierMap, &other->subcarrierMap))&&(config.windowFrames == other->config.windowFrames)&&
+         (config.windowHop == other->config.windowHop)&&(config.windowRate == other->config.windowRate)&&
+         (config.windowGapFill == other->config.windowGapFill)&&(config.windowPhase == other->config.windowPhase)&&
+         (nScopeMACs == other->nScopeMACs)&&(memcmp(scopeMACs, other->scopeMACs, nScopeMACs * 6) == 0);
 }
-void classifierThread::setArguments(const QString &Arguments){
-  this->Arguments = Arguments;
+
+void classifierThread::setWindowFollowers(classifierThread** followers, uint32_t n){
+  memcpy(windowFollowers, followers, n * sizeof(classifierThread*));
+  nWindowFollowers = n;
 }
 
 void classifierThread::setMainWindow(MainWindow* mw){
@@ -71,29 +169,221 @@ void classifierThread::addData(const QString& data){
   }
   ;
 #if USE_WRT
+  wrtLock.lockForRead();
   if(wrt != NULL){
     wrt->addData(data);
   }
+  wrtLock.unlock();
 #else
   write(pipe_fds_parent2Child[1],data.toLocal8Bit().data(),data.length());
 
 #endif
 }
 
+void classifierThread::addData(const char* data, uint32_t len){
+  if(!running){
+    return;
+  }
+#if USE_WRT
+  wrtLock.lockForRead();
+  if(wrt != NULL){
+    wrt->addData(data, len);
+  }
+  wrtLock.unlock();
+#else
+  write(pipe_fds_parent2Child[1],data,len);
+#endif
+}
+
+void classifierThread::windowReady(void* context, const char* msg, uint32_t len){
+  classifierThread* ct = (classifierThread*) context;
+  uint64_t tEnd = ((const CSIWindowHeader*) msg)->tEnd;
+  ct->latency.addInput(tEnd);
+  ct->addData(msg, len);
+  for(uint32_t i = 0; i < ct->nWindowFollowers; i++){
+    ct->windowFollowers[i]->latency.addInput(tEnd);
+    ct->windowFollowers[i]->addData(msg, len);
+  }
+}
+
+void classifierThread::featuresReady(void* context, const char* msg, uint32_t len){
+  classifierThread* ct = (classifierThread*) context;
+  ct->latency.addInput(((const CSIFeatureHeader*) msg)->tEnd);
+  ct->addData(msg, len);
+}
+
+void classifierThread::addFrame(const CSIData* data, const struct timespec_16bytes* t){
+  if(!running){
+    return;
+  }
+  uint64_t time = t->tv_sec * 1000000000ULL + t->tv_nsec;
+  uint32_t n = data->nSubCarriers;
+  latency.addInput(time);
+  memcpy(frameMsg, &time, sizeof(uint64_t));
+  memcpy(frameMsg + sizeof(uint64_t), data, offsetof(CSIData, amplitude));
+  memcpy(frameMsg + sizeof(uint64_t) + offsetof(CSIData, amplitude), data->amplitude, n * sizeof(double));
+  memcpy(frameMsg + sizeof(uint64_t) + offsetof(CSIData, amplitude) + n * sizeof(double), data->phase, n * sizeof(double));
+  addData(frameMsg, sizeof(uint64_t) + offsetof(CSIData, amplitude) + 2 * n * sizeof(double));
+}
+
+void classifierThread::pluginConsume(void* context, const char* msg, uint32_t len){
+  classifierThread* ct = (classifierThread*) context;
+  uint32_t nResults;
+  uint64_t time;
+  if(ct->exportMode == LIVE_EXPORT_WINDOWS){
+    const CSIWindowHeader* h = (const CSIWindowHeader*) msg;
+    CSIClassifierWindow window;
+    memcpy(window.MAC, h->MAC, 6);
+    window.nFilled = h->nFilled;
+    window.nFrames = h->nFrames;
+    window.nSubCarriers = h->nSubCarriers;
+    window.nChannels = h->nChannels;
+    window.tStart = h->tStart;
+    window.tEnd = h->tEnd;
+    window.tensor = (const float*) (msg + h->headerLen);
+    time = h->tEnd;
+    nResults = ct->plugin.runWindow(&window, ct->results, CSI_CLASSIFIER_MAX_RESULTS);
+  }else{
+    uint32_t headerLen = sizeof(uint64_t) + offsetof(CSIData, amplitude);
+    memcpy(&time, msg, sizeof(uint64_t));
+    memcpy(&ct->pluginFrame, msg + sizeof(uint64_t), offsetof(CSIData, amplitude));
+    uint32_t n = ct->pluginFrame.nSubCarriers;
+    if(len != headerLen + 2 * n * sizeof(double)){
+      return;
+    }
+    memcpy(ct->pluginFrame.amplitude, msg + headerLen, n * sizeof(double));
+    memcpy(ct->pluginFrame.phase, msg + headerLen + n * sizeof(double), n * sizeof(double));
+    nResults = ct->plugin.runFrame(&ct->pluginFrame, time, ct->results, CSI_CLASSIFIER_MAX_RESULTS);
+  }
+  ct->processResults(ct->results, nResults, time);
+}
+
+void classifierThread::processResults(const CSIClassifierResult* results, uint32_t n, uint64_t frameTime){
+  if((!running)||(n == 0)){
+    return;
+  }
+  double latencyMs = latency.addDecision(frameTime);
+  //the same format as the output of an external classifier
+  mutex.lock();
+  uint32_t pos = 0;
+  for(uint32_t i = 0; (i < n)&&(pos < CLASSIFIER_RCV_BUF_LEN); i++){
+    pos += snprintf(buf + pos, CLASSIFIER_RCV_BUF_LEN - pos, "%u:%.2f:", results[i].classNo, results[i].certainty);
+  }
+  QString text(buf);
+  mutex.unlock();
+
+  for(uint32_t i = 0; i < n; i++){
+    addResult(results[i].classifID, results[i].classNo, results[i].certainty, frameTime, latencyMs);
+  }
+#if DATA_EXCHANGE_THROUGH_QT_SIGNALS
+  emit dataReady(text);
+#else
+  if(mw->getSelectedSink() == sink){
+    mw->getUI()->lClassifierOutput->setText(text);
+  }
+#endif
+}
+
+void classifierThread::runPlugin(){
+  liveExportMode mode = config.mode;
+  nWindowFollowers = 0;
+  if(!plugin.load(config.command.toUtf8().data())){
+    running = false;
+    return;
+  }
+  if(!plugin.initialize(config.arguments.toUtf8().data())){
+    plugin.unload();
+    running = false;
+    return;
+  }
+
+  //plugins get windows or frames in memory. Frames are the fallback.
+  if((mode == LIVE_EXPORT_WINDOWS)&&((!plugin.canRunWindows())||(!windowAssembler.configure(config.windowFrames, config.windowHop, config.windowRate, config.windowGapFill, config.windowPhase)))){
+    fprintf(stderr,"Windows not available for classifier %s - passing frames\n", plugin.getName());
+    mode = LIVE_EXPORT_FRAMES;
+  }
+  if(mode != LIVE_EXPORT_WINDOWS){
+    mode = LIVE_EXPORT_FRAMES;
+  }
+  if((mode == LIVE_EXPORT_FRAMES)&&(!plugin.canRunFrames())){
+    fprintf(stderr,"Classifier %s cannot classify single frames\n", plugin.getName());
+    plugin.unload();
+    running = false;
+    return;
+  }
+
+#if USE_WRT
+  classifierWrThread* w = new classifierWrThread();
+  w->setMainWindow(mw);
+  w->setConsumer(pluginConsume, this);
+  if(!w->setQueue(config.queueCapacity, config.queuePolicy)){
+    delete w;
+    plugin.unload();
+    running = false;
+    return;
+  }
+  exportMode = mode;
+  w->start();
+  setWrt(w);
+#endif
+  connect(this, SIGNAL(addDataToCDW(unsigned int, unsigned int, unsigned int, float)), this->mw->getCDW(), SLOT(addClassifierOutput(unsigned int, unsigned int, unsigned int, float)), Qt::UniqueConnection);
+  connect(this, SIGNAL(resetCDW()), this->mw->getCDW(), SLOT(reset()), Qt::UniqueConnection);
+  //the outputs of the classifiers already running are kept
+  if(mw->getNClassifiersRunning() == 1){
+    emit resetCDW();
+  }
+  emit startedStopped(true);
+
+  //the plugin runs on the classifier write thread until the classifier is stopped. stopped() deletes it once this thread has finished.
+#if USE_WRT
+  w->wait();
+#endif
+  plugin.unload();
+}
+
 void classifierThread::run(){
   int32_t nBytesRead;
   printf("starting classifier thread\n");
   running = true;
 
+  latency.reset();
+  usePlugin = config.command.endsWith(CSI_CLASSIFIER_EXTENSION)||config.command.endsWith(CSI_MODEL_EXTENSION);
+  if(usePlugin){
+    pid = 0;
+    runPlugin();
+    return;
+  }
+
   pipe2(pipe_fds_child2Parent,O_DIRECT);
   pipe2(pipe_fds_parent2Child,O_DIRECT);
 
+  //in binary export modes, the frames are passed via shared memory or as windows instead of text. Text export is the fallback.
+  liveExportMode mode = config.mode;
+  nWindowFollowers = 0;
+  if((mode == LIVE_EXPORT_SHM)&&(!shmExport.create())){
+    fprintf(stderr,"Binary live export not available - using text export\n");
+    mode = LIVE_EXPORT_TEXT;
+  }
+  if((mode == LIVE_EXPORT_WINDOWS)&&(!windowAssembler.configure(config.windowFrames, config.windowHop, config.windowRate, config.windowGapFill, config.windowPhase))){
+    fprintf(stderr,"Windowed live export not available - using text export\n");
+    mode = LIVE_EXPORT_TEXT;
+  }
+  if((mode == LIVE_EXPORT_FEATURES)&&(!featureExtractor.configure(config.windowFrames, config.windowHop, config.featureBins, config.windowPhase))){
+    fprintf(stderr,"Feature live export not available - using text export\n");
+    mode = LIVE_EXPORT_TEXT;
+  }
+
   pid = fork();
   if(pid == 0){
     /*newly forked child */
+    const char* modeNames[] = {"text", "shm", "windows", "features"};
+    setenv(LIVE_EXPORT_ENV, modeNames[mode], 1);
+    if(mode == LIVE_EXPORT_SHM){
+      shmExport.setEnvironment();
+    }
     //-U - t
-    fprintf(stderr,"executing cmd: %s with args %s\n",Command.toUtf8().data(),Arguments.toUtf8().data());
-    char* cmd[] = {Command.toUtf8().data(),Arguments.toUtf8().data(), NULL};
+    fprintf(stderr,"executing cmd: %s with args %s\n",config.command.toUtf8().data(),config.arguments.toUtf8().data());
+    char* cmd[] = {config.command.toUtf8().data(),config.arguments.toUtf8().data(), NULL};
     dup2(pipe_fds_child2Parent[1],1);
     dup2(pipe_fds_parent2Child[0],0);
 
@@ -129,20 +419,33 @@ void classifierThread::run(){
 
   /*parent - this process!*/
 #if USE_WRT
-  wrt = new classifierWrThread();
-  wrt->setMainWindow(mw);
-  wrt->setFD(pipe_fds_parent2Child[1]);
-    wrt->start();
+  classifierWrThread* w = new classifierWrThread();
+  w->setMainWindow(mw);
+  w->setFD(pipe_fds_parent2Child[1]);
+  if(!w->setQueue(config.queueCapacity, config.queuePolicy)){
+    kill(pid,SIGTERM);
+    delete w;
+    emit hasStopped();
+    return;
+  }
+  w->start();
+  setWrt(w);
 #endif
-  connect(this, SIGNAL(addDataToCDW(unsigned int, unsigned int, float)), this->mw->getCDW(), SLOT(addClassifierOutput(unsigned int, unsigned int, float)));
-  connect(this, SIGNAL(resetCDW()), this->mw->getCDW(), SLOT(reset()));
-  emit resetCDW();
+  connect(this, SIGNAL(addDataToCDW(unsigned int, unsigned int, unsigned int, float)), this->mw->getCDW(), SLOT(addClassifierOutput(unsigned int, unsigned int, unsigned int, float)), Qt::UniqueConnection);
+  connect(this, SIGNAL(resetCDW()), this->mw->getCDW(), SLOT(reset()), Qt::UniqueConnection);
+  //the outputs of the classifiers already running are kept
+  if(mw->getNClassifiersRunning() == 1){
+    emit resetCDW();
+  }
+  exportMode = mode;
+  shmExport.setActive(mode == LIVE_EXPORT_SHM);
 
   fprintf(stderr,"emitting start\n");
   emit startedStopped(true);
+  uint32_t lineLen = 0;
   while(1){
 
-    nBytesRead = read(pipe_fds_child2Parent[0],localBuf,CLASSIFIER_RCV_BUF_LEN-1);
+    nBytesRead = read(pipe_fds_child2Parent[0],localBuf + lineLen,CLASSIFIER_RCV_BUF_LEN - 1 - lineLen);
 
     //    fprintf(stderr,"r:[%s]\n",localBuf);
     if(nBytesRead <= 0){
@@ -151,52 +454,90 @@ void classifierThread::run(){
 
       return;
     }
-    localBuf[nBytesRead] = '\0';
+    lineLen += nBytesRead;
+    localBuf[lineLen] = '\0';
+
+    //each line is one output. An incomplete line is kept until the rest has arrived, unless the buffer is full.
+    char* line = localBuf;
+    char* end;
+    while((end = strchr(line, '\n')) != NULL){
+      *end = '\0';
+      processLine(line);
+      line = end + 1;
+    }
+    if((line == localBuf)&&(lineLen == CLASSIFIER_RCV_BUF_LEN - 1)){
+      processLine(line);
+      line = localBuf + lineLen;
+    }
+    lineLen = localBuf + lineLen - line;
+    memmove(localBuf, line, lineLen);
+  }
+  emit startedStopped(false);
 
-    mutex.lock();
-    memcpy(buf,localBuf,nBytesRead + 1);
+}
 
-    mutex.unlock();
+void classifierThread::processLine(char* line){
+  if(line[0] == '\0'){
+    return;
+  }
+  mutex.lock();
+  strcpy(buf, line);
+  mutex.unlock();
+  QString text(line);
 
-   parseData(buf);
+  parseData(line);
 #if DATA_EXCHANGE_THROUGH_QT_SIGNALS
-    emit dataReady(QString(localBuf));
+  emit dataReady(text);
 #else
-    mw->getUI()->lClassifierOutput->setText(QString(localBuf));
+  if(mw->getSelectedSink() == sink){
+    mw->getUI()->lClassifierOutput->setText(text);
+  }
 #endif
+}
 
+/**
+ * Parse a certainty independently of the locale, accepting both '.' and ',' as decimal separator
+ */
+static float parseCertainty(char* str){
+  for(char* c = str; *c != '\0'; c++){
+    if(*c == ','){
+      *c = '.';
+    }
   }
-  emit startedStopped(false);
-
+  return QByteArray(str).trimmed().toFloat();
 }
 
 void classifierThread::parseData(char* data){
   uint8_t classifID = 0;
   unsigned long peopleCnt;
   float certainty;
+  char* save;
   //    printf("data: %s\n",data);
-  char* ptr = strtok(data,":");
+
+  //structured results start with the time of the last frame they are based on
+  uint64_t frameTime = 0;
+  if((data[0] == CLASSIFIER_RESULT_TAG)&&(data[1] == ' ')){
+    frameTime = strtoull(data + 2, &data, 10);
+  }
+  double latencyMs = (frameTime != 0) ? latency.addDecision(frameTime) : -1;
+
+  char* ptr = strtok_r(data,":",&save);
 
   bool start = true;
   while(1){
     if(!start){
-      ptr = strtok(NULL,":");
+      ptr = strtok_r(NULL,":",&save);
     }
     if(ptr == NULL){
       break;
     }
     //     printf("str1 = %s\n",ptr);
     peopleCnt = strtoul(ptr,NULL,10);
-    ptr = strtok(NULL,":");
+    ptr = strtok_r(NULL,":",&save);
     if(ptr != NULL){
       //        printf("str2 = %s\n",ptr);
-      ptr[2] = ',';             //eventual dot separator => comma separator
-      certainty = atof(ptr);
-#if DATA_EXCHANGE_THROUGH_QT_SIGNALS
-      emit addDataToCDW(classifID,  peopleCnt, certainty);
-#else
-      this->mw->getCDW()->addClassifierOutput(classifID,  peopleCnt, certainty);
-#endif
+      certainty = parseCertainty(ptr);
+      addResult(classifID, peopleCnt, certainty, frameTime, latencyMs);
       classifID++;
       start = false;
     }else{
@@ -205,6 +546,17 @@ void classifierThread::parseData(char* data){
 
   }
 }
+
+void classifierThread::addResult(unsigned int classifID, unsigned int classNo, float certainty, uint64_t frameTime, double latencyMs){
+  this->mw->getResultLog()->write(sink, classifID, classNo, certainty, frameTime, latencyMs);
+  this->mw->getRR()->classifierOutput(sink, classifID, classNo);
+#if DATA_EXCHANGE_THROUGH_QT_SIGNALS
+  emit addDataToCDW(sink, classifID, classNo, certainty);
+#else
+  this->mw->getCDW()->addClassifierOutput(sink, classifID, classNo, certainty);
+#endif
+}
+
 void classifierThread::getData(char* bufDest,uint32_t maxLength){
   mutex.lock();
   uint32_t size = strlen(buf)+1;
@@ -221,7 +573,20 @@ void classifierThread::stopClassifier(){
   if(running){
     fprintf(stderr,"stopping thread\n");
     running = false;
-    if(!kill(pid,9)){
+    shmExport.setActive(false);
+    if(usePlugin){
+      //the plugin finishes the current frame or window, and run() returns after finalizing it
+#if USE_WRT
+      wrtLock.lockForRead();
+      if(wrt != NULL){
+        wrt->stop(false);
+      }
+      wrtLock.unlock();
+#endif
+      return;
+    }
+    exportMode = LIVE_EXPORT_TEXT;
+    if((pid > 0)&&(kill(pid,9) != 0)){
       perror("kill()");
     }
     this->terminate();
@@ -231,14 +596,79 @@ void classifierThread::stopClassifier(){
 void classifierThread::stopped(){
   fprintf(stderr,"CT thread terminated\n");
   running = false;
+  shmExport.setActive(false);
+  exportMode = LIVE_EXPORT_TEXT;
+  deleteWrt();
+  emit startedStopped(false);
+}
+
+void classifierThread::setWrt(classifierWrThread* wrt){
+#if USE_WRT
+  wrtLock.lockForWrite();
+  this->wrt = wrt;
+  wrtLock.unlock();
+#endif
+}
+
+void classifierThread::deleteWrt(){
+#if USE_WRT
+  //stop it first, such that addData() does not wait for space in the queue while holding the lock
+  wrtLock.lockForRead();
   if(wrt != NULL){
     wrt->stop(false);
+  }
+  wrtLock.unlock();
+
+  wrtLock.lockForWrite();
+  if(wrt != NULL){
+    wrt->wait();
+    delete wrt;
     wrt = NULL;
   }
-  emit startedStopped(false);
+  wrtLock.unlock();
+#endif
 }
 
 bool classifierThread::getStatus(){
   return running;
 }
 
+CSIShmExport* classifierThread::getShmExport(){
+  return &shmExport;
+}
+
+CSIWindowAssembler* classifierThread::getWindowAssembler(){
+  return &windowAssembler;
+}
+
+CSIFeatureExtractor* classifierThread::getFeatureExtractor(){
+  return &featureExtractor;
+}
+
+bool classifierThread::isPlugin(){
+  return usePlugin;
+}
+
+CSIDecisionLatency* classifierThread::getLatency(){
+  return &latency;
+}
+
+liveExportMode classifierThread::getExportMode(){
+  return exportMode;
+}
+
+bool classifierThread::getQueueStats(classifierQueueStats* stats){
+#if USE_WRT
+  bool ok = false;
+  wrtLock.lockForRead();
+  if((running)&&(wrt != NULL)){
+    *stats = wrt->getStats();
+    ok = true;
+  }
+  wrtLock.unlock();
+  return ok;
+#else
+  return false;
+#endif
+}
+
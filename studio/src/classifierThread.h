@@ -16,9 +16,50 @@
 #include <QString>
 #include <QObject>
 #include "classifierWrThread.h"
+#include "CSIShmExport.h"
+#include "CSIWindowAssembler.h"
+#include "CSIFeatureExtractor.h"
+#include "CSIClassifierObj.h"
+#include "CSIDecisionLatency.h"
+#include "CSISubcarrierMap.h"
 #include <QMutex>
+#include <QReadWriteLock>
 
+#define LIVE_EXPORT_ENV "WIRELESSEYE_EXPORT"   ///Environment variable that tells the classifier how the data is passed: "text", "shm", "windows" or "features"
+#define CLASSIFIER_MAX_SINKS 4                ///Number of classifiers that can run concurrently. The entries of cbClassifierSink correspond to them.
+#define CLASSIFIER_MAX_SCOPE_MACS 64          ///Maximum number of MAC addresses a classifier can be restricted to
+#define CLASSIFIER_RESULT_TAG 'R'             ///First character of structured result lines, which carry the time of the last frame the result is based on
 
+/**
+ * How the CSI data is passed to the classifier. The values correspond to the entries of cbLiveExportMode.
+ */
+enum liveExportMode{
+  LIVE_EXPORT_TEXT = 0,                 ///Frames in the simple CSV format via stdin
+  LIVE_EXPORT_SHM = 1,                  ///Frames in binary form via shared memory (see CSIShmExport)
+  LIVE_EXPORT_WINDOWS = 2,              ///Windows of frames as binary tensors via stdin (see CSIWindowAssembler)
+  LIVE_EXPORT_FEATURES = 3,             ///Features of sliding windows per subcarrier via stdin (see CSIFeatureExtractor)
+  LIVE_EXPORT_FRAMES = 4                ///Frames in memory to a classifier plugin (see CSIClassifierObj). Not selectable, used for plugins if the mode is not LIVE_EXPORT_WINDOWS
+};
+
+/**
+ * Settings of a classifier. They are taken over when the classifier is started.
+ */
+struct classifierConfig{
+  QString command;                      ///The command to be executed to launch the classifier, a classifier plugin (ending with CSI_CLASSIFIER_EXTENSION) or a model (ending with CSI_MODEL_EXTENSION)
+  QString arguments;                    ///Arguments of this command, or of classifier_init() for a plugin
+  liveExportMode mode;                  ///How the data is passed to the classifier
+  uint32_t nSubCarriers;                ///Number of subcarriers passed to the classifier. 0 => the export bandwidth. Cannot exceed the export bandwidth.
+  QString subCarriers;                  ///Comma-separated list of the native indices of the subcarriers passed to the classifier (e.g., "4-31,33-60"), overriding nSubCarriers. Only exported subcarriers are passed.
+  QString MACs;                         ///Comma-separated list of the MAC addresses whose frames are passed to the classifier. Empty => the MAC filter of the live export is used
+  uint32_t windowFrames;                ///Frames per window in LIVE_EXPORT_WINDOWS and LIVE_EXPORT_FEATURES mode
+  uint32_t windowHop;                   ///Frames between the starts of two consecutive windows, i.e., between two feature messages in LIVE_EXPORT_FEATURES mode
+  double windowRate;                    ///Frames per second of the time grid of the windows. 0 => no time grid
+  CSIGapFill windowGapFill;             ///Policy for missing frames in the windows
+  bool windowPhase;                     ///true => the windows contain the phases, too
+  uint32_t featureBins;                 ///Number of frequency bins per subcarrier in LIVE_EXPORT_FEATURES mode
+  uint64_t queueCapacity;               ///Size of the queue to the classifier in bytes
+  classifierQueuePolicy queuePolicy;    ///What happens if the queue to the classifier is full
+};
 
 class MainWindow;
 
@@ -29,6 +70,8 @@ class MainWindow;
  * This thread also launches the classifier.
  * It does not write data to the classifier. This is either (depending on the configuration macros) the network thread, or a separate classifier write thread (classifierWrThread)
  *
+ * If the command is a classifier plugin or a model for the built-in inference runtime, no process is launched. The plugin is loaded into WirelessEye and runs on the classifier write thread, which passes the queued frames or windows to it instead of writing them to a pipe.
+ *
  */
 class classifierThread: public QThread{
   Q_OBJECT
@@ -37,27 +80,122 @@ class classifierThread: public QThread{
   MainWindow* mw;                       ///Pointer to the main window
   classifierWrThread* wrt;              ///Pointer to the classifier write thread, who is (depending on the configuration macrods) resposible for streaming data to the classifier
   bool running;                         ///Flag if the thread (and hence the classifier) is running
-  QString Command;                      ///The command to be executed to launch the classifier
-  QString Arguments;                    ///Arguments of this command
+  uint32_t sink;                        ///Counting number of this classifier, between 0 and CLASSIFIER_MAX_SINKS - 1
+  classifierConfig config;              ///Settings of the classifier
+  uint8_t scopeMACs[CLASSIFIER_MAX_SCOPE_MACS][6];      ///The MAC addresses in config.MACs
+  uint32_t nScopeMACs;                  ///Number of entries in scopeMACs. 0 => the MAC filter of the live export is used
+  CSISubcarrierMap subcarrierMap;       ///The subcarriers in config.subCarriers. Not custom => config.nSubCarriers is used
+  CSIGatherTable gather;                ///Extracts the subcarriers of the classifier from the exported frames
+  uint32_t gatherEpoch;                 ///Epoch of the exported subcarriers gather has been compiled for. 0 => not compiled
   int pipe_fds_child2Parent[2];         ///A pipeline from the classifier to us
   int pipe_fds_parent2Child[2];         ///A pipeline from our process to that of the classifier.
   pid_t pid;                            ///The process ID of the forked classifier
   char buf[CLASSIFIER_RCV_BUF_LEN];
   char localBuf[CLASSIFIER_RCV_BUF_LEN];
   QMutex mutex;
+  QReadWriteLock wrtLock;               ///Protects wrt. Held for reading while wrt is used, and for writing while it is set or deleted
+  CSIShmExport shmExport;               ///Binary live export via shared memory
+  CSIWindowAssembler windowAssembler;   ///Assembles the windows passed to the classifier in LIVE_EXPORT_WINDOWS mode
+  CSIFeatureExtractor featureExtractor; ///Computes the features passed to the classifier in LIVE_EXPORT_FEATURES mode
+  liveExportMode exportMode;            ///How the data is passed to the running classifier
+  classifierThread* windowFollowers[CLASSIFIER_MAX_SINKS];      ///Classifiers with the same windows as this one, which get the windows of our assembler
+  uint32_t nWindowFollowers;            ///Number of entries in windowFollowers
+  CSIClassifierObj plugin;              ///The classifier plugin, if the command is one
+  bool usePlugin;                       ///true => the running classifier is a plugin
+  char frameMsg[sizeof(uint64_t) + sizeof(CSIData)];    ///A frame packed for the queue in LIVE_EXPORT_FRAMES mode: time in ns, the fields of CSIData up to amplitude, nSubCarriers amplitudes and phases
+  CSIData pluginFrame;                  ///A frame unpacked for the plugin
+  CSIClassifierResult results[CSI_CLASSIFIER_MAX_RESULTS];      ///Results of the plugin
+  CSIDecisionLatency latency;           ///Frame-to-decision latency of the results
+
+  /**
+   * Callback of the window assembler. Passes a window message to the classifier and its followers.
+   */
+  static void windowReady(void* context, const char* msg, uint32_t len);
+
+  /**
+   * Callback of the feature extractor. Passes a feature message to the classifier.
+   */
+  static void featuresReady(void* context, const char* msg, uint32_t len);
+
+  /**
+   * Consumer of the classifier write thread in plugin mode. Passes a queued frame or window to the plugin.
+   */
+  static void pluginConsume(void* context, const char* msg, uint32_t len);
+
+  /**
+   * Run a classifier plugin until it is stopped
+   */
+  void runPlugin();
+
+  /**
+   * Pass the results of a plugin for the frame or window whose last frame has the time frameTime to the display, the ring recorder and the output label
+   */
+  void processResults(const CSIClassifierResult* results, uint32_t n, uint64_t frameTime);
+
+  /**
+   * Pass one output of the classifier to the results of the recording, the ring recorder and the classifier display widget.
+   * frameTime is the time of the last frame the output is based on (0 if unknown), latencyMs the frame-to-decision latency (negative if unknown).
+   */
+  void addResult(unsigned int classifID, unsigned int classNo, float certainty, uint64_t frameTime, double latencyMs);
+
+  /**
+   * Handle one line of output of the classifier
+   */
+  void processLine(char* line);
+
+  /**
+   * Set wrt to a started classifier write thread
+   */
+  void setWrt(classifierWrThread* wrt);
+
+  /**
+   * Stop the classifier write thread, wait until it has finished and delete it
+   */
+  void deleteWrt();
   public:
-  classifierThread();
+  classifierThread(uint32_t sink = 0);
   ~classifierThread();
 
   /**
-   * Set the command to be executed as our classiifer
+   * Set the settings of the classifier. They are used the next time it is started. Returns false if the list of MAC addresses or subcarriers is invalid.
+   */
+  bool setConfig(const classifierConfig &config);
+
+  /**
+   * Returns the settings of the classifier
    */
-  void setCommand(const QString &Command);
+  const classifierConfig& getConfig();
 
   /**
-   * Set the command line arguments of the executable
+   * Returns the counting number of this classifier
    */
-  void setArguments(const QString &Arguments);
+  uint32_t getSink();
+
+  /**
+   * Returns true, if the classifier is restricted to its own list of MAC addresses rather than the MAC filter of the live export.
+   */
+  bool hasMACScope();
+
+  /**
+   * Returns true, if the frames of the given MAC address are on the list of MAC addresses of this classifier.
+   */
+  bool inMACScope(const uint8_t* MAC);
+
+  /**
+   * Returns the gather table that extracts the subcarriers passed to the classifier from the exported frames, which hold the subcarriers of exportMap (out of nNative).
+   * The table is compiled only if epoch differs from that of the previous call, i.e., if the exported subcarriers have changed, or if the settings have changed.
+   */
+  const CSIGatherTable* getGather(uint32_t nNative, const CSISubcarrierMap* exportMap, uint32_t epoch);
+
+  /**
+   * Returns true, if other is running with the same windows as this classifier, i.e., the same MAC addresses, subcarriers and window settings.
+   */
+  bool sharesWindows(classifierThread* other);
+
+  /**
+   * Pass all windows assembled by this classifier to the given classifiers, too. Their own window assemblers are not used meanwhile.
+   */
+  void setWindowFollowers(classifierThread** followers, uint32_t n);
 
   /**
    * Run the classiifier
@@ -70,7 +208,7 @@ class classifierThread: public QThread{
   void setMainWindow(MainWindow* mw);
 
   /**
-   * Parse the data received from the classifier.
+   * Parse one line received from the classifier, i.e., "class0:certainty0:class1:certainty1..." or, as a structured result, "R <time of the last frame in ns> class0:certainty0:...".
    */
   void parseData(char* data);
 
@@ -79,6 +217,41 @@ class classifierThread: public QThread{
    * */
   bool getStatus();
 
+  /**
+   * Returns the binary live export. Frames are only written to it if it is active, i.e., if the classifier has been started in binary export mode.
+   */
+  CSIShmExport* getShmExport();
+
+  /**
+   * Returns the window assembler, to which the frames are passed in LIVE_EXPORT_WINDOWS mode.
+   */
+  CSIWindowAssembler* getWindowAssembler();
+
+  /**
+   * Returns the feature extractor, to which the frames are passed in LIVE_EXPORT_FEATURES mode.
+   */
+  CSIFeatureExtractor* getFeatureExtractor();
+
+  /**
+   * Returns true, if the running classifier is a plugin
+   */
+  bool isPlugin();
+
+  /**
+   * Returns the frame-to-decision latency of the results. The network thread records the frames passed to the classifier via shared memory there.
+   */
+  CSIDecisionLatency* getLatency();
+
+  /**
+   * Returns how the data is passed to the running classifier.
+   */
+  liveExportMode getExportMode();
+
+  /**
+   * Fill stats with the statistics of the queue to the classifier. Returns false if the classifier is not running.
+   */
+  bool getQueueStats(classifierQueueStats* stats);
+
   /** The classifier will provide its output in the form of a string
    * This function copies the most recently received string into bufDest.
    * MaxLength should be equal to the number of bytes allocated in bufDest.
@@ -106,11 +279,12 @@ class classifierThread: public QThread{
 
   /**
    * This signal is emitted to add data tot he classifier display widget*
+   * sink:      Counting number of this classifier thread
    * classifID: Counting number of the classifier
    * classNo:   Class it has identified
    * certainty: The certainty of this classification
    */
-  void addDataToCDW(unsigned int classifID, unsigned int classNo, float certainty);
+  void addDataToCDW(unsigned int sink, unsigned int classifID, unsigned int classNo, float certainty);
 
   /*Reset classifier display widget.*/
   void resetCDW();
@@ -123,6 +297,23 @@ class classifierThread: public QThread{
    * data: A string to be sent to stdin of the classifier
    */
   void addData(const QString& data);
+
+  /**
+   * Add data to be sent to the classifier, e.g., text or a window message. It will usually be passed on to the classifier WR thread.
+   * Params:
+   * data: The data to be written to stdin of the classifier
+   * len: Number of bytes
+   */
+  void addData(const char* data, uint32_t len);
+
+  /**
+   * Add a frame for a classifier plugin in LIVE_EXPORT_FRAMES mode. It is queued for the classifier write thread.
+   * Params:
+   * data: The frame
+   * t: Time the frame has been received
+   */
+  void addFrame(const CSIData* data, const struct timespec_16bytes* t);
+
   /**
    * Stop the classifier
    */
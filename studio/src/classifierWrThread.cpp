@@ -1,5 +1,5 @@
 /*
- * classifierThread.cpp
+ * classifierWrThread.cpp
  *
  *  Jan. 2021, Philipp H. Kindt <philipp.kindt@informatik.tu-chemnitz.de>
  *
@@ -11,84 +11,263 @@
  */
 
 #include "classifierWrThread.h"
-#include "mainwindow.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
 classifierWrThread::classifierWrThread(){
   mutex.unlock();
   running = false;
   pipe_fd = 0;
+  ring = NULL;
+  capacity = 0;
+  head = 0;
+  tail = 0;
+  msgs = NULL;
+  msgHead = 0;
+  msgTail = 0;
+  policy = CLASSIFIER_DROP_OLDEST;
+  memset(&stats, 0, sizeof(stats));
+  consumer = NULL;
+  consumerContext = NULL;
+  batchBuf = NULL;
+  batchBufLen = 0;
  }
 classifierWrThread::~classifierWrThread(){
   mutex.unlock();
   running = false;
   wq.wakeAll();
+  wqSpace.wakeAll();
+  wait();
+  free(ring);
+  free(msgs);
+  free(batchBuf);
   printf("CWT: destroy\n");
 }
 void classifierWrThread::setMainWindow(MainWindow* mw){
   this->mw = mw;
 }
 
+bool classifierWrThread::setQueue(uint64_t capacity, classifierQueuePolicy policy){
+  free(ring);
+  free(msgs);
+  free(batchBuf);
+  ring = (char*) malloc(capacity);
+  msgs = (queuedMsg*) malloc(CLASSIFIER_MAX_MSGS * sizeof(queuedMsg));
+  batchBufLen = (capacity < CLASSIFIER_WRITE_BATCH) ? capacity : CLASSIFIER_WRITE_BATCH;
+  batchBuf = (char*) malloc(batchBufLen);
+  if((ring == NULL)||(msgs == NULL)||(batchBuf == NULL)){
+    printf("Cannot allocate %" PRIu64 " bytes for the queue to the classifier\n", capacity);
+    free(ring);
+    free(msgs);
+    free(batchBuf);
+    ring = NULL;
+    msgs = NULL;
+    batchBuf = NULL;
+    batchBufLen = 0;
+    return false;
+  }
+  this->capacity = capacity;
+  this->policy = policy;
+  head = 0;
+  tail = 0;
+  msgHead = 0;
+  msgTail = 0;
+  memset(&stats, 0, sizeof(stats));
+  running = true;
+  return true;
+}
+
+bool classifierWrThread::fits(uint32_t len){
+  return (head - tail + len <= capacity)&&(msgHead - msgTail < CLASSIFIER_MAX_MSGS);
+}
+
+bool classifierWrThread::dropOldest(){
+  if(msgTail == msgHead){
+    return false;
+  }
+  queuedMsg* q = &msgs[msgTail % CLASSIFIER_MAX_MSGS];
+  tail = q->start + q->len;
+  msgTail++;
+  stats.msgsDropped++;
+  return true;
+}
 
 void classifierWrThread::addData(const QString& data){
+  QByteArray bytes = data.toLocal8Bit();
+  addData(bytes.constData(), bytes.length());
+}
+
+void classifierWrThread::addData(const char* data, uint32_t len){
   mutex.lock();
-  queue.enqueue(data);
+  if((ring == NULL)||(len > capacity)){
+    stats.msgsDropped++;
+    mutex.unlock();
+    return;
+  }
+  //drop only as many of the oldest messages as needed to make room for this one
+  while(!fits(len)){
+    if((policy == CLASSIFIER_BLOCK)&&(running)){
+      wqSpace.wait(&mutex);
+    }else if((policy != CLASSIFIER_DROP_OLDEST)||(!dropOldest())){
+      stats.msgsDropped++;
+      mutex.unlock();
+      return;
+    }
+  }
+
+  uint64_t pos = head % capacity;
+  uint64_t first = (len < capacity - pos) ? len : capacity - pos;
+  memcpy(ring + pos, data, first);
+  memcpy(ring, data + first, len - first);
+  queuedMsg* m = &msgs[msgHead % CLASSIFIER_MAX_MSGS];
+  m->start = head;
+  m->len = len;
+  head += len;
+  msgHead++;
   mutex.unlock();
   wq.wakeAll();
 }
 
+classifierQueueStats classifierWrThread::getStats(){
+  mutex.lock();
+  classifierQueueStats s = stats;
+  s.bytesQueued = head - tail;
+  s.msgsQueued = msgHead - msgTail;
+  s.capacity = capacity;
+  stats.writeLatencyMax = 0;
+  mutex.unlock();
+  return s;
+}
+
+void classifierWrThread::addLatency(double latency){
+  stats.writeLatencyAvg = (stats.writeLatencyAvg == 0) ? latency : 0.95 * stats.writeLatencyAvg + 0.05 * latency;
+  if(latency > stats.writeLatencyMax){
+    stats.writeLatencyMax = latency;
+  }
+}
+
+uint32_t classifierWrThread::takeBatch(uint32_t maxLen){
+  uint32_t len = 0;
+  while(msgTail < msgHead){
+    queuedMsg* q = &msgs[msgTail % CLASSIFIER_MAX_MSGS];
+    if((len > 0)&&(len + q->len > maxLen)){
+      break;
+    }
+    if(q->len > batchBufLen){
+      //only the first message of a batch can be larger than the buffer
+      char* buf = (char*) realloc(batchBuf, q->len);
+      if(buf == NULL){
+        printf("Cannot allocate %u bytes for a message to the classifier\n", q->len);
+        dropOldest();
+        return 0;
+      }
+      batchBuf = buf;
+      batchBufLen = q->len;
+    }
+    uint64_t pos = q->start % capacity;
+    uint64_t first = (q->len < capacity - pos) ? q->len : capacity - pos;
+    memcpy(batchBuf + len, ring + pos, first);
+    memcpy(batchBuf + len + first, ring, q->len - first);
+    len += q->len;
+    tail = q->start + q->len;
+    msgTail++;
+  }
+  return len;
+}
+
+void classifierWrThread::consumeMessage(){
+  uint32_t len = takeBatch(0);
+  mutex.unlock();
+  wqSpace.wakeAll();
+  if(len == 0){
+    return;
+  }
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  consumer(consumerContext, batchBuf, len);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  mutex.lock();
+  addLatency((t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+  mutex.unlock();
+}
+
   void classifierWrThread::run(){
     printf("CWT starting...\n");
-    running = true;
-    int nBytes;
-    char* str;
     uint32_t len;
+    uint32_t written;
+    ssize_t nBytes;
+    struct timespec t0, t1;
     while(1){
       mutex.lock();
-        if(!queue.isEmpty()){
-          str = queue.head().toLocal8Bit().data();
-          len = strlen(str);
-          if(len>CLASSIFIER_RCV_BUF_LEN){
-            printf("WARNING - string to large. increase CLASSIFIER_RCV_BUF_LEN.\n");
-            queue.dequeue();
-            continue;
-          }
-          memcpy(buf,str, len);
-          buf[CLASSIFIER_RCV_BUF_LEN - 1] = '\0';
-
-          queue.dequeue();
-          mutex.unlock();
+      while((msgTail == msgHead)&&(running)){
+        wq.wait(&mutex);
+      }
+      if(!running){
+        mutex.unlock();
+        return;
+      }
+      if(consumer != NULL){
+        consumeMessage();
+        continue;
+      }
 
+      //take all queued messages up to the batch size out of the ring, so the ring has room for new messages while the batch is written
+      len = takeBatch(CLASSIFIER_WRITE_BATCH);
+      mutex.unlock();
+      wqSpace.wakeAll();
 
-          if(pipe_fd > 0){
-            nBytes = write(pipe_fd, buf, len);
-            //   write(pipe_fd, data, 3);
-          }
-          if(nBytes < 0){
-            printf("write failure - CWT thread terminating\n");
+      //continue partial writes until the entire batch has been written
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+      written = 0;
+      while(written < len){
+        nBytes = write(pipe_fd, batchBuf + written, len - written);
+        if(nBytes < 0){
+          if(errno == EINTR){
+            continue;
           }
- //         fprintf(stderr,str.toUtf8().data());
-        }else{
-
-          wq.wait(&mutex);
+          printf("write failure - CWT thread terminating\n");
+          mutex.lock();
+          running = false;
           mutex.unlock();
+          wqSpace.wakeAll();
+          return;
         }
+        written += nBytes;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &t1);
 
-        if(!running){
-         return;
-       }
+      if(len > 0){
+        mutex.lock();
+        addLatency((t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+        mutex.unlock();
       }
+    }
   }
 
   void classifierWrThread::setFD(int fd){
     this->pipe_fd = fd;
   }
 
+void classifierWrThread::setConsumer(classifierConsumer consumer, void* context){
+  this->consumer = consumer;
+  this->consumerContext = context;
+}
+
 
 void classifierWrThread::stop(bool start){
   if(!start){
     if(running){
       printf("CWT: stopping\n");
+      mutex.lock();
       running = false;
+      mutex.unlock();
+      wq.wakeAll();
+      wqSpace.wakeAll();
       this->quit();
     }
   }
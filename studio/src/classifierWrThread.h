@@ -17,27 +17,107 @@
 #include <inttypes.h>
 #include <QString>
 #include <QObject>
-#include <QQueue>
 #include <QMutex>
 #include <QWaitCondition>
 
 #define CLASSIFIER_RCV_BUF_LEN 500*256
+#define CLASSIFIER_MAX_MSGS 65536               ///Maximum number of messages waiting to be sent to the classifier
+#define CLASSIFIER_WRITE_BATCH (256*1024)       ///Maximum number of bytes written to the pipe at once, unless a single message is larger
+
+/**
+ * What happens if data is added while the queue to the classifier is full
+ */
+enum classifierQueuePolicy{
+  CLASSIFIER_DROP_OLDEST = 0,                   ///Discard the oldest queued messages, as many as the new message needs space
+  CLASSIFIER_DROP_NEWEST = 1,                   ///Discard the new message
+  CLASSIFIER_BLOCK = 2                          ///Wait until there is enough space, i.e., the network thread waits for the classifier
+};
+
+/**
+ * Statistics of the queue to the classifier
+ */
+struct classifierQueueStats{
+  uint64_t bytesQueued;                         ///Number of bytes waiting to be written
+  uint64_t capacity;                            ///Size of the queue in bytes
+  uint32_t msgsQueued;                          ///Number of messages waiting to be written
+  uint64_t msgsDropped;                         ///Number of messages dropped since the classifier has been started
+  double writeLatencyAvg;                       ///Average duration of a write to the pipe in ms
+  double writeLatencyMax;                       ///Maximum duration of a write to the pipe in ms since the statistics have been read most recently
+};
+
+/**
+ * Called on the thread of the classifierWrThread for each message, if the messages are not written to a pipe. msg is only valid during the call.
+ */
+typedef void (*classifierConsumer)(void* context, const char* msg, uint32_t len);
 
 class MainWindow;
 /**
  * \brief a thread to stream data to the classifier - without delaying anything else when the classifier stalls.
+ *
+ * Messages are copied into a ring of fixed capacity, such that the memory does not grow if the classifier stalls. What happens if the ring is full
+ * is defined by the classifierQueuePolicy. The thread takes all messages queued (up to CLASSIFIER_WRITE_BATCH bytes) out of the ring into a batch buffer and writes them
+ * with a single write(). As the messages being written no longer occupy the ring, dropping the oldest messages always frees space at its beginning, even while the
+ * classifier blocks the write.
+ * Instead of writing the messages to a pipe, the thread can pass them to a consumer, e.g., a classifier plugin. The queue then works the same way.
  */
 class classifierWrThread: public QThread{
   Q_OBJECT
 
   private:
+  /**
+   * A message in the ring
+   */
+  struct queuedMsg{
+    uint64_t start;             ///Position of the first byte, counted like head
+    uint32_t len;               ///Number of bytes
+  };
+
   MainWindow* mw;               ///Pointer to the main window
   bool running;                 ///True, if the thread is running
   int pipe_fd;                  ///A file descriptor for a pipe to write to the classifier
-  QQueue<QString> queue;        ///A queue to store data that is yet to be sent to the classifier
+  char* ring;                   ///The ring the messages are stored in
+  uint64_t capacity;            ///Size of ring
+  uint64_t head;                ///Number of bytes added to the ring so far. The next byte goes to ring[head % capacity]
+  uint64_t tail;                ///Number of bytes released from the ring so far
+  queuedMsg* msgs;              ///All messages in the ring. Message i is msgs[i % CLASSIFIER_MAX_MSGS]
+  uint64_t msgHead;             ///Number of messages added so far
+  uint64_t msgTail;             ///Number of messages released so far
+  classifierQueuePolicy policy; ///What happens if the ring is full
+  classifierQueueStats stats;   ///Statistics, protected by the mutex
+  classifierConsumer consumer;  ///If not NULL, the messages are passed to this function instead of being written to the pipe
+  void* consumerContext;        ///Passed to consumer
+  char* batchBuf;               ///The messages taken out of the ring to be written or passed to the consumer
+  uint32_t batchBufLen;         ///Size of batchBuf. Grows if a single message is larger
   QMutex mutex;                 ///A mutex to protect this class against uncoordinate access from different threads
   QWaitCondition wq;            ///This thread will go asleep when there is no data waiting to be sent out. As soon as addData() is called, this QWaitContition will wakeup the thread again
-  char buf[CLASSIFIER_RCV_BUF_LEN];/// A temporary buffer to store what has been taken from the queue most recently
+  QWaitCondition wqSpace;       ///Wakes up addData() in CLASSIFIER_BLOCK mode when space has become available
+
+  /**
+   * Returns true, if a message of len bytes fits into the ring. The mutex must be locked by the caller.
+   */
+  bool fits(uint32_t len);
+
+  /**
+   * Drop the oldest queued message. Returns false if there is none. The mutex must be locked by the caller.
+   */
+  bool dropOldest();
+
+  /**
+   * Move the oldest messages, up to maxLen bytes but at least one message, from the ring to batchBuf. Returns the number of bytes, 0 if batchBuf cannot be enlarged.
+   * The mutex must be locked by the caller.
+   */
+  uint32_t takeBatch(uint32_t maxLen);
+
+  /**
+   * Add the duration of writing or consuming messages to the statistics. The mutex must be locked by the caller.
+   */
+  void addLatency(double latency);
+
+  /**
+   * Pass the oldest message to the consumer. The mutex must be locked by the caller and is unlocked when this function returns.
+   */
+  void consumeMessage();
+
   public:
 
   classifierWrThread();
@@ -48,11 +128,26 @@ class classifierWrThread: public QThread{
    */
   void setFD(int fd);
 
+  /**
+   * Pass the messages to consumer instead of writing them to the pipe. Call before the thread is started.
+   */
+  void setConsumer(classifierConsumer consumer, void* context);
+
   /**
    * Set a pointer to the main widnow
    */
   void setMainWindow(MainWindow* mw);
 
+  /**
+   * Set the size of the queue in bytes and what happens if it is full. Call before the thread is started. Returns false if the memory cannot be allocated.
+   */
+  bool setQueue(uint64_t capacity, classifierQueuePolicy policy);
+
+  /**
+   * Returns the statistics of the queue and resets the maximum write latency.
+   */
+  classifierQueueStats getStats();
+
   /**
    * Run this thread
    */
@@ -65,6 +160,11 @@ class classifierWrThread: public QThread{
    */
   void addData(const QString &data);
 
+  /**
+   * Add len bytes of data to be sent to the classifier, e.g., text in the simple CSV format or a window message.
+   */
+  void addData(const char* data, uint32_t len);
+
   /**
    *  Stop this thread.
    */
@@ -0,0 +1,5 @@
+#!/bin/bash
+# how to compile?
+# type ./compile.sh sample_classifier to compile sample_classifier.c
+gcc $1.c -c -g -fPIC
+gcc -shared $1.o -lm -o $1.cci
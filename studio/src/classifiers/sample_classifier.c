@@ -0,0 +1,155 @@
+/**
+ * sample_classifier.c - simple example on how to write a classifier plugin for WirelessEye
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ *
+ *    GENERIC INFOS:
+ *
+ * 1) Classification
+ *     A classifier plugin runs within WirelessEye instead of in a separate process. It receives the CSI data in memory and returns its results as an array of struct CSIClassifierResult.
+ *     When the classifier is started, classifier_init() is called with the arguments entered in the GUI. When it is stopped, classifier_finalize() is called.
+ *     If the live export mode is "Windows", classifier_runWindow() is called once per window. Otherwise, classifier_runFrame() is called once per frame.
+ *     A plugin must provide at least one of these two functions. If it only provides classifier_runFrame(), it gets frames in every mode.
+ *     The run functions are called on a worker thread of WirelessEye. Frames and windows are queued in front of it. If the plugin is slower than the frames arrive, the queue policy chosen in the GUI applies.
+ *
+ * 2) Results
+ *     A plugin can contain multiple classifiers, which are distinguished by classifID. Each result is shown like the output of an external classifier, i.e., in the classifier display and the ring recorder.
+ *
+ * 3) Using the plugin in the GUI
+ *     Classifier plugins are compiled into a shared object (see below) and get the ending of ".cci" (CSI classifier). Enter the path to the ".cci" file as the executable of the classifier.
+ * 4) Compiling classifiers
+ *     In a terminal and in the classifiers folder, type "./compile.sh sample_classifier" (e.g., the filename of the .c-file without the .c-extension"). Alternatively, "make" compiles all classifiers.
+ *
+ * Note: Declare additional functions that are only used within the plugin as static.
+ */
+
+#ifdef __cplusplus                      //this is needed because our plugin is written in C, whreas WirelessEye is a C++ program
+  extern "C" {
+#endif
+
+#include "../CSIClassifier.h"           //for struct CSIClassifierResult and struct CSIClassifierWindow
+#include "../CSIData.h"                 //for struct CSIData
+#include <string.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define MAX_SENDERS 16                  //Number of senders whose previous frame we remember
+
+///Relative change of the mean amplitude above which we detect motion. Set by the arguments.
+static double threshold = 0.1;
+
+///The previous frame of each sender
+static uint8_t senderMAC[MAX_SENDERS][6];
+static double senderMean[MAX_SENDERS];
+static uint32_t nSenders = 0;
+
+/**
+ * The name of the classifier. WirelessEye provides a buffer of length CSI_CLASSIFIER_NAME_STLEN (which is defined in CSIClassifier.h).
+ */
+void classifier_getName(char* str){
+  snprintf(str, CSI_CLASSIFIER_NAME_STLEN, "A simple sample motion detector");
+}
+
+/**
+ * Called once when the classifier is started. "arguments" contains the arguments entered in the GUI. Return 0 on success. Otherwise, the classifier is not started.
+ */
+int classifier_init(const char* arguments){
+  nSenders = 0;
+  threshold = 0.1;
+  if((arguments != NULL)&&(strlen(arguments) > 0)){
+    threshold = atof(arguments);
+  }
+  if(threshold <= 0){
+    printf("CSI sample classifier: invalid threshold %s\n", arguments);
+    return -1;
+  }
+  printf("CSI sample classifier initialized with threshold %f.\n", threshold);
+  return 0;
+}
+
+/**
+ * Called once after the classifier has been stopped.
+ */
+void classifier_finalize(){
+  printf("CSI sample classifier finalized.\n");
+}
+
+/**
+ * Mean of n values
+ */
+static double mean(const double* values, uint32_t n){
+  double sum = 0;
+  for(uint32_t i = 0; i < n; i++){
+    sum += values[i];
+  }
+  return (n > 0) ? sum / n : 0;
+}
+
+/**
+ * Classify one frame. "data" is the frame, "time" the time it has been received in ns since 1970.
+ * Write up to maxResults results into "results" and return their number.
+ * Here: class 1 (motion), if the mean amplitude has changed by more than the threshold compared to the previous frame of the same sender. Class 0 otherwise.
+ */
+uint32_t classifier_runFrame(const struct CSIData* data, uint64_t time, struct CSIClassifierResult* results, uint32_t maxResults){
+  uint32_t s;
+  (void) time;
+  double m = mean(data->amplitude, data->nSubCarriers);
+  for(s = 0; (s < nSenders)&&(memcmp(senderMAC[s], data->senderMAC, 6) != 0); s++);
+  if(s == nSenders){
+    if(nSenders == MAX_SENDERS){
+      return 0;
+    }
+    memcpy(senderMAC[s], data->senderMAC, 6);
+    senderMean[s] = m;
+    nSenders++;
+  }
+  double change = fabs(m - senderMean[s]) / ((senderMean[s] > 0) ? senderMean[s] : 1);
+  senderMean[s] = m;
+  if(maxResults < 1){
+    return 0;
+  }
+  results[0].classifID = 0;
+  results[0].classNo = (change > threshold) ? 1 : 0;
+  results[0].certainty = (change > threshold) ? 1 : 1 - change / threshold;
+  return 1;
+}
+
+/**
+ * Classify one window. The layout of the window is described in CSIClassifier.h.
+ * Here: class 1 (motion), if the relative standard deviation of the mean amplitudes of the frames exceeds the threshold.
+ */
+uint32_t classifier_runWindow(const struct CSIClassifierWindow* window, struct CSIClassifierResult* results, uint32_t maxResults){
+  double sum = 0;
+  double sumSq = 0;
+  for(uint32_t f = 0; f < window->nFrames; f++){
+    double m = 0;
+    for(uint32_t i = 0; i < window->nSubCarriers; i++){
+      m += window->tensor[f * window->nSubCarriers + i];
+    }
+    m = (window->nSubCarriers > 0) ? m / window->nSubCarriers : 0;
+    sum += m;
+    sumSq += m * m;
+  }
+  if((maxResults < 1)||(window->nFrames == 0)){
+    return 0;
+  }
+  double avg = sum / window->nFrames;
+  double var = sumSq / window->nFrames - avg * avg;
+  double rsd = (var > 0) ? sqrt(var) / ((avg > 0) ? avg : 1) : 0;
+  results[0].classifID = 0;
+  results[0].classNo = (rsd > threshold) ? 1 : 0;
+  results[0].certainty = (rsd > threshold) ? 1 : 1 - rsd / threshold;
+  return 1;
+}
+
+#ifdef __cplusplus
+  }
+#endif
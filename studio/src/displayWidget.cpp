@@ -34,26 +34,21 @@ displayWidget::displayWidget(QWidget* parent)
     exit(1);
   };
   this->mutex->unlock();
-  maxValue = DBL_MIN;
-  minValue = DBL_MAX;
 
-  upperValueBound = 0;
-  lowerValueBound = 0;
   scaleFactor = 1;
   subCarrierIndex = 0;
-  img = NULL;
-  painter = NULL;
-  dataOffset = 0.0;
+  viewImg = NULL;
+  viewLive = true;
+  viewLevel = 0;
+  viewEnd = 0;
+  viewDirty = true;
+  dragX = 0;
   this->setAutoFillBackground(true);
   QPalette pal = this->palette();
   pal.setColor(QPalette::Normal, QPalette::Window, Qt::white);
   this->setPalette(pal);
   this->setBackgroundRole(QPalette::Window);
   this->show();
-  scrollAmount = 0;
-  autoScaling = true;
-  flatCurve = false;
-  scrollDelay = 1;
 }
 
 displayWidget::~displayWidget(){
@@ -61,8 +56,7 @@ displayWidget::~displayWidget(){
     delete mutex;
     mutex = NULL;
   }
-  delete img;
-  delete painter;
+  delete viewImg;
 }
 
 /**
@@ -81,7 +75,7 @@ void displayWidget::setNCSISamples(uint32_t NCSISamples){
   if(mutex != NULL){
     mutex->lock();
   }
-  this->NCSISamples = NCSISamples;
+  renderer.setNCSISamples(NCSISamples);
   if(mutex != NULL){
     mutex->unlock();
   }
@@ -91,14 +85,26 @@ void displayWidget::setNCSISamples(uint32_t NCSISamples){
  * The widget needs to be (re-)painted
  */
 void displayWidget::paintEvent(QPaintEvent* ev) {
-  if ((mw == NULL)||(img == NULL)) {
+  if ((mw == NULL)||(renderer.getWidth() == 0)) {
     return;
   }
   if(mutex != NULL){
     mutex->lock();
   }
   QPainter p(this);
-  p.drawImage(0,0,*img);
+  if((viewLive)&&(viewLevel == 0)){
+    renderer.draw(&p);
+  }else if(viewImg != NULL){
+    //a live view at a lower resolution changes with every column
+    if((viewDirty)||(viewLive)){
+      renderer.renderHistory(viewImg, viewLive, viewLevel, viewEnd, &viewLabel);
+      viewDirty = false;
+    }
+    p.drawImage(0, 0, *viewImg);
+    p.setPen(Qt::white);
+    p.drawText(rect().adjusted(4, 0, -4, 0), Qt::AlignRight|Qt::AlignTop, viewLabel);
+  }
+  renderer.drawLaneLabels(&p, height());
   p.end();
   if(mutex != NULL){
     mutex->unlock();
@@ -106,6 +112,20 @@ void displayWidget::paintEvent(QPaintEvent* ev) {
 
 }
 
+/**
+ * Returns a copy of the live plot with the oldest column at the left edge
+ */
+QImage displayWidget::snapshot(){
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  QImage image = renderer.snapshot();
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+  return image;
+}
+
 
 /**
  * Set a scroll delay. If scrollDelay is set to N > 1, we
@@ -113,7 +133,31 @@ void displayWidget::paintEvent(QPaintEvent* ev) {
  * Values of scrollDelay > 1 can increase the performance. But they make the plot look less fluent.
  */
 void displayWidget::setScrollDelay(int scrollDelay){
-  this->scrollDelay = scrollDelay;
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  renderer.setScrollDelay(scrollDelay);
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+}
+
+/**
+ * Move the view by dx pixels. Positive values move it to older columns.
+ */
+void displayWidget::pan(int dx){
+  uint64_t end = renderer.getHistory()->getEnd(0);
+  uint64_t begin = renderer.getHistory()->getBegin(0);
+  int64_t pos = (int64_t) (viewLive ? end : viewEnd) - ((int64_t) dx << viewLevel);
+  if(pos >= (int64_t) end){
+    viewLive = true;
+  }else{
+    viewLive = false;
+    viewEnd = (pos > (int64_t) begin) ? (uint64_t) pos : begin + 1;
+  }
+  viewDirty = true;
+  emit viewChanged(viewLive, viewLevel, viewLive ? 0 : end - viewEnd);
+  update();
 }
 
 
@@ -124,109 +168,33 @@ void displayWidget::setScrollDelay(int scrollDelay){
  * csi is not necessarily CSI data (and in fact never represents an entire complex CSI value). It can be RSSI, CSI amplitude or phase.
  */
 void displayWidget::addData(double data){
-  double color, ub, lb;
+  if(renderer.isFlatCurve()){
+    // "Flat" curves = Curves in 2D => RSSI
+    addLaneData(0, &data, 1);
+    nextColumn();
+    return;
+  }
+  // "Plastic" curves = Curves in 3D with different colors => CSI. The column is drawn when the last sample has arrived.
   if(mutex != NULL){
     mutex->lock();
   }
-  if(flatCurve){
-    // "Flat" curves = Curves in 2D => RSSI
-    if(autoScaling){
-      if(data < minValue){
-        minValue = data;
-      }
-      if(data > maxValue){
-        maxValue = data;
-      }
-    }
-    color = (data - minValue) * (double) (255.0)/(maxValue - minValue);
-    if(color > 255){
-      color = 255;
-    }
-    if(color < 0){
-      color = 0;
-    }
-    painter->begin(img);
-    if(img != NULL){
-      img->setPixelColor(img->width()-scrollDelay + scrollAmount-1,((double)(data - minValue)) * ((double) (img->height() - 1.0))/((double)(maxValue - minValue)),QColor(255-color,color, 0));
-      img->setPixelColor(img->width()-scrollDelay + scrollAmount-1,((double)(data - minValue)) * ((double) (img->height() - 1.9))/((double)(maxValue - minValue) +1),QColor(255-color,color, 0));
-      painter->drawImage(-scrollDelay,0,*img);
-    }
-    painter->end();
-  }else{
-    // "Plastic" curves = Curves in 3D with different colors => CSI
-    if(img == NULL){
-      if(mutex != NULL){
-        mutex->unlock();
-      }
-      return;
-    }
-    data = data + dataOffset;
-    if(autoScaling){
-      if(fabs(data) < minValue){
-        minValue = fabs(data);
-      }
-      if(fabs(data) > maxValue){
-        maxValue = fabs(data);
-      }
-    }
-    uint32_t scaleFactor =  (img->height()/NCSISamples);
-
-    ub = (double) upperValueBound/1000.0 * (maxValue - minValue) + minValue;
-    lb = (double) lowerValueBound/1000.0 * (maxValue - minValue) + minValue;
-
-    /* Goals:
-     * 1) Chop off everything below lb and above rb
-     * 2) bring range to lie within -255, 255
-     *
-     * to 1) This would scale between 0...1
-     *  color = (data - minValue) / (maxValue - minValue)
-     * -> modify to "artificial" min and max values
-     *  color = (data - lb) / (ub - lb)
-     * ... and chop of what now lies below 0 or above 1
-     * to 2): Now rescale: color= color * 510 - 255;
-     */
-    if(data >= 0){
-      color = ((data - lb)/(ub - lb)) * 255.0;
-    }else{
-      color = -((fabs(data) - lb)/(ub - lb)) * 255.0;
-
-    }
-    if(color < -255.0){
-      color = -255.0;
-    }
-    if(color > 255.0){
-      color = 255.0;
-    }
-    /* old color scaling:
-     *  color = ((double) fabs(data) - lb) * 255.0/(maxValue - minValue)* (maxValue / (ub - lb));
-     */
-    painter->begin(img);
-    for(uint8_t i = 0;i < scaleFactor;i++){
-      if(img != NULL){
-        if(color > 0){
-          img->setPixelColor(img->width()-scrollDelay + scrollAmount-1, (subCarrierIndex)*scaleFactor + i,QColor((uint8_t)(color),0, (uint8_t) (255.0 - color)));
-        }else{
-          img->setPixelColor(img->width()-scrollDelay + scrollAmount-1, (subCarrierIndex)*scaleFactor + i,QColor(0,(uint8_t)(color),(uint8_t) (255.0 - color)));
-        }
-      };
-    };
+  uint32_t n = renderer.valuesPerLane();
+  bool complete = false;
+  if(subCarrierIndex < n){
+    samples[subCarrierIndex] = data;
     subCarrierIndex++;
-    if(subCarrierIndex >= NCSISamples){                      //when the last sample has arrived
-      subCarrierIndex = 0;
-      if(scrollAmount >= scrollDelay-1){
-        painter->drawImage(-scrollDelay,0,*img);
-        //      painter->setBrush(QBrush(QColor(0,0,0)));
-        //     painter->drawRect(img->width() - scrollDelay,0,scrollDelay,img->height());
-        scrollAmount = 0;
-      }else{
-        scrollAmount++;
-      }
-    };
-    painter->end();
+  }
+  if(subCarrierIndex >= n){
+    subCarrierIndex = 0;
+    complete = (n > 0);
   }
   if(mutex != NULL){
     mutex->unlock();
   }
+  if(complete){
+    addLaneData(0, samples, n);
+    nextColumn();
+  }
 }
 
 /**
@@ -235,83 +203,69 @@ void displayWidget::addData(double data){
  * - nsamples is the number of values in data. This should be equal to the number of subcarriers
  */
 void displayWidget::addDataForEntireFrame(double* data, int nSamples){
-  double color, ub, lb;
-  if(flatCurve){
+  if(renderer.isFlatCurve()){
     printf("addDataForEntireFrame() not implemented for flat curves.\n");
     return;
   }
-  if(nSamples != NCSISamples){
-    printf("Skipping display data sicne nSamples != NCSISamples. Probably, it has changed recently\n");
+  addLaneData(0, data, nSamples);
+  nextColumn();
+}
+
+/**
+ * Set the values of a lane for the current column. nSamples has to be equal to the number of subcarriers, or 1 for flat curves.
+ */
+void displayWidget::addLaneData(int lane, double* data, int nSamples){
+  if((lane < 0)||(nSamples < 0)){
     return;
   }
   if(mutex != NULL){
     mutex->lock();
   }
-  if(img == NULL){
-    if(mutex != NULL){
-      mutex->unlock();
-    }
+  renderer.addLaneData(lane, data, nSamples);
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+}
+
+/**
+ * Complete the current column
+ */
+void displayWidget::nextColumn(){
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  renderer.nextColumn();
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+}
+
+/**
+ * Split the height into the given number of lanes (1...DISPLAY_MAX_LANES). The plot, the history and the scaling are reset.
+ */
+void displayWidget::setNLanes(int nLanes){
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  if(renderer.setNLanes((nLanes > 0) ? nLanes : 1)){
+    viewDirty = true;
+  }
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+}
+
+/**
+ * Set the text shown in the corner of a lane, e.g., the MAC address of its sender
+ */
+void displayWidget::setLaneLabel(int lane, const QString& label){
+  if(lane < 0){
     return;
   }
-  painter->begin(img);
-  for(uint32_t j= 1; j < nSamples; j++){
-    data[j] = data[j] + dataOffset;
-
-    if(autoScaling){
-      if(fabs(data[j]) < minValue){
-        minValue = fabs(data[j]);
-      }
-      if(fabs(data[j]) > maxValue){
-        maxValue = fabs(data[j]);
-      }
-    }
-    uint32_t scaleFactor = (img->height()/NCSISamples);
-
-    ub = (double) upperValueBound/1000.0 * (maxValue - minValue) + minValue;
-    lb = (double) lowerValueBound/1000.0 * (maxValue - minValue) + minValue;
-
-    /* Goals:
-     * 1) Chop off everything below lb and above rb
-     * 2) bring range to lie within -255, 255
-     * 3) If color is negative, treat like a positive value of same magnitude, but paint in green
-     *
-     * to 1) This would scale between 0...1
-     *  color = (data - minValue) / (maxValue - minValue)
-     * -> modify to "artificial" min and max values
-     *  color = (data - lb) / (ub - lb)
-     * ... and chop of what now lies below 0 or above 1
-     * to 2): Now rescale: color= color * 255;
-     */
-    if(data[j] > 0){
-      color = ((data[j] - lb)/(ub - lb)) * 255;
-    }else{
-      color = -((fabs(data[j]) + lb)/(ub - lb)) * 255;
-    }
-    if(color < -255.0){
-      color = -255.0;
-    }
-    if(color > 255.0){
-      color = 255.0;
-    }
-    for(uint8_t i = 0;i < scaleFactor;i++){
-      if(img != NULL){
-        if(color > 0){
-          img->setPixelColor(img->width()-scrollDelay + scrollAmount-1, (j)*scaleFactor + i,QColor((uint8_t)(color),0, (uint8_t) (255.0 - color)));
-        }else{
-          img->setPixelColor(img->width()-scrollDelay + scrollAmount-1, (j)*scaleFactor + i,QColor(0,(uint8_t)(color),(uint8_t) (255.0 - color)));
-        }
-      };
-    };
-  };
-  if(scrollAmount >= scrollDelay-1){
-    painter->drawImage(-scrollDelay,0,*img);
-    //      painter->setBrush(QBrush(QColor(0,0,0)));
-    //     painter->drawRect(img->width() - scrollDelay,0,scrollDelay,img->height());
-    scrollAmount = 0;
-  }else{
-    scrollAmount++;
+  if(mutex != NULL){
+    mutex->lock();
   }
-  painter->end();
+  renderer.setLaneLabel(lane, label);
   if(mutex != NULL){
     mutex->unlock();
   }
@@ -326,12 +280,11 @@ void displayWidget::resizeEvent(QResizeEvent* event){
   if(this->mutex != NULL){
     this->mutex->lock();
   }
-  delete img;
-  delete painter;
   cout<<"CR new image"<<endl;
-  img = new QImage(event->size().width(),event->size().height(),QImage::Format_RGB32);
-  painter = new QPainter();
-  img->fill(QColor(0, 0, 0, 0));
+  renderer.resize(event->size().width(), event->size().height());
+  delete viewImg;
+  viewImg = new QImage(event->size().width(),event->size().height(),QImage::Format_RGB32);
+  viewDirty = true;
 
   if(this->mutex != NULL){
     this->mutex->unlock();
@@ -359,8 +312,7 @@ void displayWidget::setScaleFactor(double scaleFactor){
  */
 void displayWidget::reset(){
   subCarrierIndex = 0;
-  maxValue = FLT_MIN;
-  minValue = FLT_MAX;
+  resetMaximumValue();
 
 }
 
@@ -370,7 +322,7 @@ void displayWidget::reset(){
  * This function sets the upper bound of this range.
  */
 void displayWidget::setUB(int value){
-  this->upperValueBound = value;
+  renderer.setUB(value);
 }
 
 /**
@@ -379,7 +331,7 @@ void displayWidget::setUB(int value){
   * This function sets the lower bound of this range.
   */
 void displayWidget::setLB(int value){
-  this->lowerValueBound = value;
+  renderer.setLB(value);
 }
 
 /**
@@ -388,37 +340,42 @@ void displayWidget::setLB(int value){
  * E.g., when setting dataOffset to the mean of a signal to be plotted, it will be plotted around 0.
  */
 void displayWidget::setDataOffset(double offset){
-  this->dataOffset = offset;
+  renderer.setDataOffset(offset);
 }
 
 /**
  * Read the data offset. See setDataOffset()
  */
 double displayWidget::getDataOffset(){
-  return dataOffset;
+  return renderer.getDataOffset();
 }
 
 /**
- * The widget keeps track of the minimum and maximum observed value so far to scale the data to this range.
+ * The widget scales the data to the range of the recent values.
  * This function resets the previously observed values
  */
 void displayWidget::resetMaximumValue(){
-  maxValue = FLT_MIN;
-  minValue = FLT_MAX;
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  renderer.resetScaling();
+  if(mutex != NULL){
+    mutex->unlock();
+  }
 }
 
 /**
- * Get the maximum value to be displayed so far
+ * Get the maximum value to be displayed so far in the first lane
  */
 double displayWidget::getMaximumValue(){
-  return maxValue;
+  return renderer.getMaximumValue();
 }
 
 /**
- * Activate and deactivate the automatic tracking of the highest value observed so far.
+ * Activate and deactivate the automatic tracking of the range of the recent values.
  */
 void displayWidget::setAutoScaling(bool onOff){
-  this->autoScaling = onOff;
+  renderer.setAutoScaling(onOff);
 }
 
 /**
@@ -434,7 +391,116 @@ void displayWidget::resetSubCarrierIndex(){
  * Otherwise, we plot a 3D curve, e.g., CSI, in which the 3rd dimension is encoded by the color
  */
 void displayWidget::setFlatCurve(bool flatCurve){
-  this->flatCurve = flatCurve;
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  renderer.setFlatCurve(flatCurve);
+  if(mutex != NULL){
+    mutex->unlock();
+  }
 }
 
+/**
+ * Keep the columns of the given number of minutes for panning and zooming. 0 => no history
+ */
+void displayWidget::setHistoryMinutes(int minutes){
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  renderer.setHistoryMinutes(minutes);
+  viewLive = true;
+  viewLevel = 0;
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+  update();
+}
 
+/**
+ * Show the history at the given resolution level, back columns of level 0 before the newest one, or follow the newest column if live == true.
+ */
+void displayWidget::setView(bool live, int level, qint64 back){
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  uint64_t end = renderer.getHistory()->getEnd(0);
+  uint64_t begin = renderer.getHistory()->getBegin(0);
+  viewLive = live;
+  viewLevel = ((level >= 0)&&(level < HISTORY_LEVELS)) ? level : 0;
+  if(!live){
+    viewEnd = ((uint64_t) back < end - begin) ? end - back : begin + 1;
+  }
+  viewDirty = true;
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+  update();
+}
+
+/**
+ * Zoom in or out of the history
+ */
+void displayWidget::wheelEvent(QWheelEvent* event){
+  if(!renderer.getHistory()->isEnabled()){
+    event->ignore();
+    return;
+  }
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  if((event->angleDelta().y() > 0)&&(viewLevel > 0)){
+    viewLevel--;
+  }else if((event->angleDelta().y() < 0)&&(viewLevel + 1 < HISTORY_LEVELS)){
+    viewLevel++;
+  }
+  viewDirty = true;
+  uint64_t back = viewLive ? 0 : renderer.getHistory()->getEnd(0) - viewEnd;
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+  event->accept();
+  emit viewChanged(viewLive, viewLevel, back);
+  update();
+}
+
+/**
+ * Start dragging the plot through the history
+ */
+void displayWidget::mousePressEvent(QMouseEvent* event){
+  if(!renderer.getHistory()->isEnabled()){
+    QWidget::mousePressEvent(event);
+    return;
+  }
+  dragX = event->x();
+}
+
+/**
+ * Drag the plot through the history
+ */
+void displayWidget::mouseMoveEvent(QMouseEvent* event){
+  if(!renderer.getHistory()->isEnabled()){
+    QWidget::mouseMoveEvent(event);
+    return;
+  }
+  int dx = event->x() - dragX;
+  dragX = event->x();
+  if(mutex != NULL){
+    mutex->lock();
+  }
+  pan(dx);
+  if(mutex != NULL){
+    mutex->unlock();
+  }
+}
+
+/**
+ * Return to the newest data at full resolution
+ */
+void displayWidget::mouseDoubleClickEvent(QMouseEvent* event){
+  if(!renderer.getHistory()->isEnabled()){
+    QWidget::mouseDoubleClickEvent(event);
+    return;
+  }
+  setView(true, 0, 0);
+  emit viewChanged(true, 0, 0);
+}
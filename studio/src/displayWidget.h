@@ -21,8 +21,10 @@
 #include <QQueue>
 #include <QImage>
 #include <QSlider>
+#include <QElapsedTimer>
 #include <inttypes.h>
 #include "CSIData.h"
+#include "CSIHeatmapRenderer.h"
 #include "ui_mainwindow.h"
 class MainWindow;
 
@@ -31,6 +33,7 @@ using namespace std;
 /**
  * \brief A widget to display CSI and RSSI data
  *
+ * The data is drawn by a CSIHeatmapRenderer, which the widget shows and lets the user pan and zoom through its history.
  */
 class displayWidget : public QWidget{
 
@@ -40,21 +43,23 @@ private:
         MainWindow* mw;                 ///Pinter to the mainw ondow
         double scaleFactor;             ///A scale factor to adjust the height of the plot to the available space
         QMutex* mutex;                  ///A mutex to protect this class fromt he concurrent access by multiple threads
-        double maxValue;                ///The maximum value to be displayed we have seen so far, used for scaling the color values
-        double minValue;                ///The minimum value to be displayed we have seen so far, used for scaling the color values
-        QImage *img;                    ///Pointer to QImage to plot into
+        CSIHeatmapRenderer renderer;    ///Draws the data. It does not depend on the widget, so snapshots can be taken without a display
         uint32_t subCarrierIndex;       ///We get the data to be plotted sequentially for all subcarriers. addData() is called once for every subcarrier.
                                         ///Thsi value "counts" through all subcarriers to assign the data to the right subcarrier.
-        double upperValueBound;         ///The upper value selected by the sliders to rescale the color range to a range of interest
-        double lowerValueBound;         ///The lower value selected by the sliders to rescale the color range to a range of interest
-        double dataOffset;              ///An offset to be added to each value to be displayed. E.g., when setting  dataOffset to the mean of a signal to be plotted, it will be plotted around 0
-        uint32_t scrollAmount;          ///For performance reasons, we do not scroll the data to be plotted by one pixel for every arrived frame. Instead we can configure to scroll after every N frames by N pixels, where N is the accumulated number of pixels in this amount of time. This variable counts how much we have to scroll (i.e., N in our example),.
-        bool autoScaling;               ///If true, we automatically adjust lowerValueBound and upperValueBound during operation to the minimum/maximum values we have observed so far.
-        QPainter* painter;              ///QPainter to plot our stuff
-        bool flatCurve;                 ///true => our curve is "flat", hence, we plot a traditional 2D curve, such as RSSI.
-                                        ///false=> we plot a 3D-curve, e.g., CSI using different color codes
-        uint32_t NCSISamples;           ///The number of CSI samples per frame, i.e., the number of subcarriers
-        uint32_t scrollDelay;           ///After how many received frames we have to scroll the entire plot. See subCarrierIndex for a deeper understanding
+        double samples[DISPLAY_MAX_SUBCARRIERS]; ///The values passed to addData() for the current frame so far
+        QImage *viewImg;                ///The part of the history shown while the plot is panned or zoomed
+        QString viewLabel;              ///Position and zoom factor of the view, shown in its corner
+        bool viewLive;                  ///true => the view follows the newest column. false => it stays at viewEnd
+        uint32_t viewLevel;             ///Resolution level of the history shown, i.e., each pixel shows 2^viewLevel columns. 0 and viewLive => the live plot is shown
+        uint64_t viewEnd;               ///Column of history level 0 after the newest column shown, if !viewLive
+        bool viewDirty;                 ///true => viewImg has to be rendered again
+        int dragX;                      ///Position of the mouse while the plot is being dragged
+
+        /**
+         * Move the view by dx pixels. Positive values move it to older columns.
+         */
+        void pan(int dx);
+
 public:
         displayWidget(QWidget* parent = 0);
         ~displayWidget();
@@ -74,6 +79,26 @@ public:
          */
         void resizeEvent(QResizeEvent* event);
 
+        /**
+         * Zoom in or out of the history
+         */
+        void wheelEvent(QWheelEvent* event);
+
+        /**
+         * Start dragging the plot through the history
+         */
+        void mousePressEvent(QMouseEvent* event);
+
+        /**
+         * Drag the plot through the history
+         */
+        void mouseMoveEvent(QMouseEvent* event);
+
+        /**
+         * Return to the newest data at full resolution
+         */
+        void mouseDoubleClickEvent(QMouseEvent* event);
+
         /**
          * Set the scale factor to scale the height of the plot
          */
@@ -97,7 +122,7 @@ public:
         double getDataOffset();
 
         /**
-         * Get the maximum value to be displayed so far
+         * Get the maximum value to be displayed so far in the first lane
          */
         double getMaximumValue();
 
@@ -108,6 +133,11 @@ public:
          */
         void setFlatCurve(bool flatCurve);
 
+        /**
+         * Returns a copy of the live plot with the oldest column at the left edge, e.g., to be saved to a file. A null image if the widget has no size yet.
+         */
+        QImage snapshot();
+
 public slots:
 
         /**
@@ -126,13 +156,34 @@ public slots:
         void addDataForEntireFrame(double* data, int nSamples);
 
         /**
-         * The widget keeps track of the minimum and maximum observed value so far to scale the data to this range.
+         * Split the height into the given number of lanes (1...DISPLAY_MAX_LANES). The plot, the history and the scaling are reset.
+         */
+        void setNLanes(int nLanes);
+
+        /**
+         * Set the text shown in the corner of a lane, e.g., the MAC address of its sender
+         */
+        void setLaneLabel(int lane, const QString& label);
+
+        /**
+         * Set the values of a lane for the current column. nSamples has to be equal to the number of subcarriers, or 1 for flat curves.
+         * Values may be changed by the offset. The column is shown after nextColumn().
+         */
+        void addLaneData(int lane, double* data, int nSamples);
+
+        /**
+         * Complete the current column. Lanes without data keep showing their last values for HEATMAP_LANE_HOLD_MS, then they are cleared.
+         */
+        void nextColumn();
+
+        /**
+         * The widget scales the data to the range of the recent values.
          * This function resets the previously observed values
          */
         void resetMaximumValue();
 
         /**
-         * Activate and deactivate the automatic tracking of the highest value observed so far.
+         * Activate and deactivate the automatic tracking of the range of the recent values.
          */
         void setAutoScaling(bool);
 
@@ -167,5 +218,22 @@ public slots:
          */
         void setLB(int value);
 
+        /**
+         * Keep the columns of the given number of minutes for panning and zooming. 0 => no history
+         */
+        void setHistoryMinutes(int minutes);
+
+        /**
+         * Show the history at the given resolution level, back columns of level 0 before the newest one, or follow the newest column if live == true.
+         * Used to move all widgets along with the one the user moves.
+         */
+        void setView(bool live, int level, qint64 back);
+
+signals:
+        /**
+         * The user has panned or zoomed the plot. See setView()
+         */
+        void viewChanged(bool live, int level, qint64 back);
+
 };
 #endif
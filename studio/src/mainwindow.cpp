@@ -12,6 +12,8 @@
 #include "ui_mainwindow.h"
 #include <iostream>
 #include <QScrollBar>
+#include <inttypes.h>
+#include <math.h>
 
 using namespace std;
 MainWindow::MainWindow(QWidget *parent) :
@@ -46,6 +48,13 @@ MainWindow::MainWindow(QWidget *parent) :
     dwRSSI->setDataOffset(0);
     dwRSSI->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
     dwRSSI->setFlatCurve(true);
+    //the spectrogram is scaled to the full range of its recent magnitudes
+    dwS = new displayWidget(ui->saSpectrogram);
+    dwS->setMainWindow(this);
+    dwS->setDataOffset(0);
+    dwS->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
+    dwS->setLB(0);
+    dwS->setUB(1000);
     cdw = new classifierDisplayWidget(ui->saClassif);
     cdw->setMainWindow(this);
 
@@ -54,9 +63,17 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->saClassif->setWidget(cdw);
     ui->saPhase->setWidget(dwP);
     ui->saRSSI->setWidget(dwRSSI);
-
-    ct = new classifierThread();
-    ct->setMainWindow(this);
+    ui->saSpectrogram->setWidget(dwS);
+
+    //all classifiers start with the settings in the GUI
+    classifierConfig config;
+    readClassifierConfig(&config);
+    for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+      ct[i] = new classifierThread(i);
+      ct[i]->setMainWindow(this);
+      ct[i]->setConfig(config);
+    }
+    selectedSink = 0;
 
     nt = NULL;
     nt_thread = NULL;
@@ -66,10 +83,15 @@ MainWindow::MainWindow(QWidget *parent) :
     showHidePhase(ui->cbDisplayPhase->isChecked());
     showHideRSSI(ui->cbDisplayRSSI->isChecked());
     showHideClassifier(ui->cbDisplayClassifierOutput->isChecked());
+    showHideSpectrogram(ui->cbDisplaySpectrogram->isChecked());
     connect(ui->cbDisplayAmplitude, SIGNAL(toggled(bool)), this,SLOT(showHideAmplitude(bool)));
     connect(ui->cbDisplayPhase, SIGNAL(toggled(bool)), this,SLOT(showHidePhase(bool)));
     connect(ui->cbDisplayClassifierOutput, SIGNAL(toggled(bool)), this,SLOT(showHideClassifier(bool)));
     connect(ui->cbDisplayRSSI, SIGNAL(toggled(bool)), this,SLOT(showHideRSSI(bool)));
+    connect(ui->cbDisplaySpectrogram, SIGNAL(toggled(bool)), this,SLOT(showHideSpectrogram(bool)));
+    connect(ui->sbSpectrogramWindow, SIGNAL(valueChanged(int)), this,SLOT(updateSpectrogram()));
+    connect(ui->sbSpectrogramGroups, SIGNAL(valueChanged(int)), this,SLOT(updateSpectrogram()));
+    updateSpectrogram();
 
 
 
@@ -90,29 +112,62 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->spWidth, SIGNAL(valueChanged(int)), this, SLOT(updateDisplayWidgetSize()));
 
     connect(ui->sbRefreshPeriod,SIGNAL(valueChanged(int)),this,SLOT(updateDisplayPeriod()));
+    connect(ui->dsbTimeSpan,SIGNAL(valueChanged(double)),this,SLOT(updateDisplayAggregation()));
+    connect(ui->cbDisplayReducer,SIGNAL(currentIndexChanged(int)),this,SLOT(updateDisplayAggregation()));
+    connect(ui->sbDisplayLanes,SIGNAL(valueChanged(int)),this,SLOT(updateDisplayLanes()));
+    displayFrameRate = 0;
+    displayLanesShown = 0;
+    updateDisplayAggregation();
+    updateDisplayLanes();
     connect(&updateLayoutTimer,SIGNAL(timeout()), this, SLOT(updateDisplayWidgetSize()));
     ui->saAmplitude->horizontalScrollBar()->setSliderPosition(ui->saAmplitude->horizontalScrollBar()->maximum());
     ui->saPhase->horizontalScrollBar()->setSliderPosition(ui->saPhase->horizontalScrollBar()->maximum());
     ui->saRSSI->horizontalScrollBar()->setSliderPosition(ui->saRSSI->horizontalScrollBar()->maximum());
+    ui->saSpectrogram->horizontalScrollBar()->setSliderPosition(ui->saSpectrogram->horizontalScrollBar()->maximum());
     ui->saClassif->horizontalScrollBar()->setSliderPosition(ui->saClassif->horizontalScrollBar()->maximum());
 
 
     connect((QObject*) ui->saAmplitude->horizontalScrollBar(),SIGNAL(sliderMoved(int)),(QObject*) ui->saClassif->horizontalScrollBar(),SLOT(setValue(int)));
     connect((QObject*) ui->saAmplitude->horizontalScrollBar(),SIGNAL(sliderMoved(int)),(QObject*) ui->saPhase->horizontalScrollBar(),SLOT(setValue(int)));
     connect((QObject*) ui->saAmplitude->horizontalScrollBar(),SIGNAL(sliderMoved(int)),(QObject*) ui->saRSSI->horizontalScrollBar(),SLOT(setValue(int)));
+    connect((QObject*) ui->saAmplitude->horizontalScrollBar(),SIGNAL(sliderMoved(int)),(QObject*) ui->saSpectrogram->horizontalScrollBar(),SLOT(setValue(int)));
 
     connect(ui->sbScrollDelay, SIGNAL(valueChanged(int)), dwA, SLOT(setScrollDelay(int)));
     connect(ui->sbScrollDelay, SIGNAL(valueChanged(int)), dwP, SLOT(setScrollDelay(int)));
     connect(ui->sbScrollDelay, SIGNAL(valueChanged(int)), dwRSSI, SLOT(setScrollDelay(int)));
+    connect(ui->sbScrollDelay, SIGNAL(valueChanged(int)), dwS, SLOT(setScrollDelay(int)));
+
+    //history for panning and zooming. A widget moved by the user moves the others along.
+    connect(ui->sbHistory, SIGNAL(valueChanged(int)), dwA, SLOT(setHistoryMinutes(int)));
+    connect(ui->sbHistory, SIGNAL(valueChanged(int)), dwP, SLOT(setHistoryMinutes(int)));
+    connect(ui->sbHistory, SIGNAL(valueChanged(int)), dwRSSI, SLOT(setHistoryMinutes(int)));
+    connect(ui->sbHistory, SIGNAL(valueChanged(int)), dwS, SLOT(setHistoryMinutes(int)));
+    dwA->setHistoryMinutes(ui->sbHistory->value());
+    dwP->setHistoryMinutes(ui->sbHistory->value());
+    dwRSSI->setHistoryMinutes(ui->sbHistory->value());
+    dwS->setHistoryMinutes(ui->sbHistory->value());
+    connect(dwA, SIGNAL(viewChanged(bool,int,qint64)), dwP, SLOT(setView(bool,int,qint64)));
+    connect(dwA, SIGNAL(viewChanged(bool,int,qint64)), dwRSSI, SLOT(setView(bool,int,qint64)));
+    connect(dwP, SIGNAL(viewChanged(bool,int,qint64)), dwA, SLOT(setView(bool,int,qint64)));
+    connect(dwP, SIGNAL(viewChanged(bool,int,qint64)), dwRSSI, SLOT(setView(bool,int,qint64)));
+    connect(dwRSSI, SIGNAL(viewChanged(bool,int,qint64)), dwA, SLOT(setView(bool,int,qint64)));
+    connect(dwRSSI, SIGNAL(viewChanged(bool,int,qint64)), dwP, SLOT(setView(bool,int,qint64)));
+    connect(dwA, SIGNAL(viewChanged(bool,int,qint64)), dwS, SLOT(setView(bool,int,qint64)));
+    connect(dwP, SIGNAL(viewChanged(bool,int,qint64)), dwS, SLOT(setView(bool,int,qint64)));
+    connect(dwRSSI, SIGNAL(viewChanged(bool,int,qint64)), dwS, SLOT(setView(bool,int,qint64)));
+    connect(dwS, SIGNAL(viewChanged(bool,int,qint64)), dwA, SLOT(setView(bool,int,qint64)));
+    connect(dwS, SIGNAL(viewChanged(bool,int,qint64)), dwP, SLOT(setView(bool,int,qint64)));
+    connect(dwS, SIGNAL(viewChanged(bool,int,qint64)), dwRSSI, SLOT(setView(bool,int,qint64)));
 
     updateLayoutTimer.setSingleShot(true);
     updateLayoutTimer.start(1);
 
     connect(ui->pbRunClassifier, SIGNAL(clicked()),this, SLOT(startClassifier()));
-    connect(ct,SIGNAL(startedStopped(bool)),this,SLOT(classifierStartedStopped(bool)));
-    connect(ct,SIGNAL(dataReady(const QString&)),this,SLOT(updateClassifierData(const QString&)));
-    connect(this,SIGNAL(startClassifierThread()),ct,SLOT(start()));
-    connect(this,SIGNAL(stopClassifierThread()), ct, SLOT(stopClassifier()));
+    connect(ui->cbClassifierSink, SIGNAL(currentIndexChanged(int)), this, SLOT(selectClassifierSink(int)));
+    for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+      connect(ct[i],SIGNAL(startedStopped(bool)),this,SLOT(classifierStartedStopped(bool)));
+      connect(ct[i],SIGNAL(dataReady(const QString&)),this,SLOT(updateClassifierData(const QString&)));
+    }
     connect(ui->sbMaxClass,SIGNAL(valueChanged(int)),cdw,SLOT(setMaxValue(int)));
     cdw->setMaxValue(ui->sbMaxClass->value());
 
@@ -125,10 +180,44 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->leFilterPath,SIGNAL(textChanged(const QString&)), fgm, SLOT(setFilterPath(const QString&)));
 
     connect(ui->actionDetachFilters,SIGNAL(triggered()), fgm, SLOT(attachDetach()));
+    connect(ui->actionSaveFilterPipeline,SIGNAL(triggered()), fgm, SLOT(savePipeline()));
     cbx = new checkableComboBox(this);
     ui->buttonBarLayout->addWidget((QWidget*) cbx);
     connect(ui->actionClearMACFilterList, SIGNAL(triggered()), cbx, SLOT(resetMACs()));
 
+    rr = new CSIRingRecorder();
+    rr->start();
+    connect(ui->cbPreTrigger, SIGNAL(toggled(bool)), this, SLOT(preTriggerHandler()));
+    connect(ui->sbPreTriggerSeconds, SIGNAL(valueChanged(int)), this, SLOT(preTriggerHandler()));
+    connect(ui->sbPostTriggerSeconds, SIGNAL(valueChanged(int)), this, SLOT(preTriggerHandler()));
+    connect(ui->sbPreTriggerMemory, SIGNAL(valueChanged(int)), this, SLOT(preTriggerHandler()));
+    connect(ui->rbFileFormatCSVSimple, SIGNAL(toggled(bool)), this, SLOT(preTriggerHandler()));
+    connect(ui->rbFileFormatCSVCompact, SIGNAL(toggled(bool)), this, SLOT(preTriggerHandler()));
+    connect(ui->rbFileFormatBinary, SIGNAL(toggled(bool)), this, SLOT(preTriggerHandler()));
+    connect(ui->rbFileFormatNpy, SIGNAL(toggled(bool)), this, SLOT(preTriggerHandler()));
+    connect(ui->pbTrigger, SIGNAL(clicked()), rr, SLOT(trigger()));
+    connect(ui->cbTriggerClassChange, SIGNAL(toggled(bool)), rr, SLOT(setTriggerOnClassChange(bool)));
+    connect(rr, SIGNAL(dumpStartedStopped(const QString&, bool)), this, SLOT(preTriggerDumpStartedStopped(const QString&, bool)));
+    rr->setTriggerOnClassChange(ui->cbTriggerClassChange->isChecked());
+    ui->pbTrigger->setEnabled(false);
+
+    pub = new CSIPublisher();
+    connect(ui->cbPublish, SIGNAL(toggled(bool)), this, SLOT(publishHandler()));
+
+    snapshotWriter = new CSISnapshotWriter();
+    snapshotWriter->start();
+    connect(ui->sbSnapshotInterval, SIGNAL(valueChanged(int)), this, SLOT(snapshotHandler()));
+    connect(ui->leSnapshotDirectory, SIGNAL(editingFinished()), this, SLOT(snapshotHandler()));
+    connect(ui->sbSnapshotKeep, SIGNAL(valueChanged(int)), this, SLOT(snapshotHandler()));
+    connect(ui->pbSnapshot, SIGNAL(clicked()), this, SLOT(takeSnapshot()));
+    snapshotHandler();
+
+    shedOfferedShown = 0;
+    shedLostShown = 0;
+    shedEventsShown = 0;
+    lDisplayLoad = new QLabel(this);
+    ui->statusBar->addPermanentWidget(lDisplayLoad);
+
 }
 
 MainWindow::~MainWindow()
@@ -141,14 +230,24 @@ MainWindow::~MainWindow()
 
   }
 
-  ct->stopClassifier();
+  for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+    ct[i]->stopClassifier();
+  }
+  rr->disarm();
+  pub->close();
+  snapshotWriter->stop();
 //  delete dwA;
  // delete cdw;
  // delete dwP;
  // delete dwRSSI;
   delete animTimer;
-  delete ct;
+  for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+    delete ct[i];
+  }
  // delete cbx;
+  delete rr;
+  delete pub;
+  delete snapshotWriter;
   delete ui;
 delete fgm;
 }
@@ -161,8 +260,11 @@ void MainWindow::startStreaming(){
     connect(ui->qcBandwidth, SIGNAL(currentIndexChanged(int)), this, SLOT(updateBandwidthHandling()));
     connect(ui->qcBandwidthDisplay, SIGNAL(currentIndexChanged(int)), this, SLOT(updateBandwidthHandling()));
     connect(ui->qcBandwidthExport, SIGNAL(currentIndexChanged(int)), this, SLOT(updateBandwidthHandling()));
+    connect(ui->leDisplaySubcarriers, SIGNAL(editingFinished()), this, SLOT(updateSubcarrierLists()));
+    connect(ui->leExportSubcarriers, SIGNAL(editingFinished()), this, SLOT(updateSubcarrierLists()));
 
     updateBandwidthHandling();
+    updateSubcarrierLists();
 
     cout<<"start streaming"<<endl;
     isStarted = true;
@@ -179,17 +281,21 @@ void MainWindow::startStreaming(){
     connect(ui->cbFilterFileRecording,SIGNAL(toggled(bool)), nt, SLOT(setMACFilterRecording(bool)));
     connect(ui->cbFilterLiveExport,SIGNAL(toggled(bool)), nt, SLOT(setMACFilterLiveExport(bool)));
 
-    connect(ct,SIGNAL(startedStopped(bool)), nt, SLOT(setClassifierThreadActive(bool)));
+    for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+      connect(ct[i],SIGNAL(startedStopped(bool)), nt, SLOT(setClassifierThreadActive(bool)));
+    }
     connect(cbx,SIGNAL(updateMacFilterList(QStringList)),nt,SLOT(setMACFilterList(QStringList)));
     connect(nt,SIGNAL(addMAC(QString)),cbx,SLOT(addMAC(QString)));
 
 
-    connect(ui->cbDisplayAmplitude, SIGNAL(toggled(bool)), nt,SLOT(setDisplayAmplitude(bool)));
+    //the spectrogram is computed from the amplitude
+    connect(ui->cbDisplayAmplitude, SIGNAL(toggled(bool)), this,SLOT(updateDisplayAmplitude()));
+    connect(ui->cbDisplaySpectrogram, SIGNAL(toggled(bool)), this,SLOT(updateDisplayAmplitude()));
     connect(ui->cbDisplayPhase, SIGNAL(toggled(bool)), nt,SLOT(setDisplayPhase(bool)));
     connect(ui->cbDisplayRSSI, SIGNAL(toggled(bool)), nt,SLOT(setDisplayRSSI(bool)));
     connect(ui->cbDisplayClassifierOutput, SIGNAL(toggled(bool)), nt,SLOT(setDisplayClassifier(bool)));
 
-    nt->setDisplayAmplitude(ui->cbDisplayAmplitude->isChecked());
+    nt->setDisplayAmplitude(ui->cbDisplayAmplitude->isChecked() || ui->cbDisplaySpectrogram->isChecked());
     nt->setDisplayPhase(ui->cbDisplayPhase->isChecked());
     nt->setDisplayRSSI(ui->cbDisplayRSSI->isChecked());
     nt->setDisplayClassifier(ui->cbDisplayClassifierOutput->isChecked());
@@ -213,6 +319,9 @@ void MainWindow::streamStartStop(bool started){
     ui->pbConnect->setText("Disconnect");
     ui->pbRecord->setEnabled(true);
    animTimer->start(ui->sbRefreshPeriod->value());
+    displayClock.invalidate();
+    displayLanes.clear();
+    spectrogram.clear();
     isStarted = true;
   }else{
     ui->pbConnect->setText("Connect");
@@ -250,7 +359,147 @@ void MainWindow::updateDisplayPeriod(){
 }
 
 
+void MainWindow::updateDisplayAggregation(){
+  CSIDisplayReducer reducer = (CSIDisplayReducer) ui->cbDisplayReducer->currentIndex();
+  displayTimeSpan = ui->dsbTimeSpan->value();
+  displayLanes.setReducer(reducer);
+}
+
+void MainWindow::updateDisplayLanes(){
+  displayLanes.setNLanes(ui->sbDisplayLanes->value());
+  spectrogram.setNLanes(ui->sbDisplayLanes->value());
+}
+
+void MainWindow::updateSpectrogram(){
+  spectrogram.configure(ui->sbSpectrogramWindow->value(), ui->sbSpectrogramGroups->value());
+  dwS->setNCSISamples(spectrogram.getNValues());
+}
+
+void MainWindow::showDisplayColumn(){
+  uint32_t nUsed = displayLanes.getNUsed();
+  double* column;
+  bool hasAmplitude = false;
+  bool hasPhase = false;
+  bool hasRSSI = false;
+  bool hasSpectrogram = false;
+  bool showSpectrogram = ui->cbDisplaySpectrogram->isChecked();
+
+  //a new sender gets its own lane, so the displays are split anew
+  if(nUsed != displayLanesShown){
+    char MACBuf[CSI_MAC_STLEN];
+    displayLanesShown = nUsed;
+    dwA->setNLanes(nUsed);
+    dwP->setNLanes(nUsed);
+    dwRSSI->setNLanes(nUsed);
+    dwS->setNLanes(nUsed);
+    for(uint32_t l = 0; (l < nUsed)&&(ui->sbDisplayLanes->value() > 1); l++){
+      CSIFormatMAC(displayLanes.getMAC(l), MACBuf);
+      dwA->setLaneLabel(l, MACBuf);
+      dwP->setLaneLabel(l, MACBuf);
+      dwRSSI->setLaneLabel(l, MACBuf);
+      dwS->setLaneLabel(l, MACBuf);
+    }
+  }
+
+  for(uint32_t l = 0; l < nUsed; l++){
+    if((column = displayLanes.getAmplitude(l)) != NULL){
+      dwA->addLaneData(l, column, displayLanes.getNSubCarriers(l));
+      hasAmplitude = true;
+    }
+    if((column = displayLanes.getPhase(l)) != NULL){
+      dwP->addLaneData(l, column, displayLanes.getNSubCarriers(l));
+      hasPhase = true;
+    }
+    if((column = displayLanes.getRSSI(l)) != NULL){
+      dwRSSI->addLaneData(l, column, 1);
+      hasRSSI = true;
+    }
+    if((showSpectrogram)&&((column = spectrogram.getColumn(displayLanes.getMAC(l))) != NULL)){
+      dwS->addLaneData(l, column, spectrogram.getNValues());
+      hasSpectrogram = true;
+    }
+  }
+  if(hasAmplitude){
+    dwA->nextColumn();
+  }
+  if(hasPhase){
+    dwP->nextColumn();
+  }
+  if(hasRSSI){
+    dwRSSI->nextColumn();
+  }
+  if(hasSpectrogram){
+    dwS->nextColumn();
+  }
+}
+
 void MainWindow::animate(){
+    //frames per column such that the width of the display covers the selected time span, based on the frame rate measured so far
+    uint32_t K = 1;
+    if((displayTimeSpan > 0)&&(displayFrameRate > 0)){
+      int width = (dwA->width() > 0) ? dwA->width() : 1;
+      double k = ceil(displayFrameRate * displayTimeSpan / width);
+      K = (k > DISPLAY_QUEUE_LEN) ? DISPLAY_QUEUE_LEN : (uint32_t) k;
+    }
+    displayLanes.setFramesPerColumn(K);
+    //the classifier output advances by time, as fast as the other displays
+    if(displayFrameRate > 0){
+      cdw->setColumnTime(K * 1000.0 / displayFrameRate);
+    }
+
+    //render the frames received since the last refresh. Only the GUI thread paints into the display widgets.
+    CSIDisplayFrame* f;
+    uint32_t nFrames = 0;
+    bool showSpectrogram = ui->cbDisplaySpectrogram->isChecked();
+    while((f = displayQueue.front()) != NULL){
+      //the spectrogram sees every frame, also those folded into a column
+      if(showSpectrogram){
+        spectrogram.add(f);
+      }
+      if(displayLanes.add(f)){
+        showDisplayColumn();
+      }
+      //a frame stands for the frames shed before it, so the frame rate includes them
+      nFrames += f->decimation;
+      displayQueue.pop();
+    }
+
+    //measure the frame rate. The first refresh after starting only starts the clock.
+    if(displayClock.isValid()){
+      qint64 elapsed = displayClock.restart();
+      if(elapsed > 0){
+        double rate = nFrames * 1000.0 / elapsed;
+        displayFrameRate = (displayFrameRate > 0) ? 0.8 * displayFrameRate + 0.2 * rate : rate;
+      }
+    }else{
+      displayClock.start();
+    }
+
+    //frequency range of the spectrogram. The frame rate is that of a single sender only if all senders share one lane.
+    if(showSpectrogram){
+      char buf[128] = "<b>Doppler Spectrogram</b>";
+      if((displayFrameRate > 0)&&(ui->sbDisplayLanes->value() == 1)){
+        snprintf(buf, sizeof(buf), "<b>Doppler Spectrogram</b> (up to %.1f Hz)", spectrogram.getMaxFrequency(displayFrameRate));
+      }
+      if(ui->labelSpectrogram->text() != buf){
+        ui->labelSpectrogram->setText(QString(buf));
+      }
+    }
+
+    //snapshots at the selected interval or on SIGUSR2. Only the images are copied here, they are encoded by the snapshot writer.
+    bool snapshotDue = snapshotWriter->isRequested();
+    if(ui->sbSnapshotInterval->value() > 0){
+      if(!snapshotClock.isValid()){
+        snapshotClock.start();
+      }else if(snapshotClock.elapsed() >= ui->sbSnapshotInterval->value() * 1000){
+        snapshotClock.restart();
+        snapshotDue = true;
+      }
+    }
+    if(snapshotDue){
+      takeSnapshot();
+    }
+
     dwA->update();
     if(ui->cbDisplayPhase->isChecked()){
      dwP->update();
@@ -258,11 +507,72 @@ void MainWindow::animate(){
     if(ui->cbDisplayRSSI->isChecked()){
       dwRSSI->update();
     }
+    if(showSpectrogram){
+      dwS->update();
+    }
 
     if(ui->cbDisplayClassifierOutput->isChecked()){
      cdw->update();
    }
 
+    //statistics of the queue to the selected classifier
+    classifierQueueStats qs;
+    if(ct[selectedSink]->getQueueStats(&qs)){
+      char buf[256];
+      //for plugins, the time to pass a message on is the inference time
+      snprintf(buf, sizeof(buf), "Queue: %.1f of %.0f MB, %u messages, %" PRIu64 " dropped. %s: %.2f ms (max. %.2f ms)",
+               qs.bytesQueued / 1048576.0, qs.capacity / 1048576.0, qs.msgsQueued, qs.msgsDropped, ct[selectedSink]->isPlugin() ? "Inference" : "Write",
+               qs.writeLatencyAvg, qs.writeLatencyMax);
+      ui->lClassifierQueue->setText(QString(buf));
+    }
+
+    //frame-to-decision latency of the selected classifier
+    CSILatencyStats ls = ct[selectedSink]->getLatency()->getStats();
+    if(ls.n > 0){
+      char buf[256];
+      snprintf(buf, sizeof(buf), "Latency: %" PRIu64 " results, median %.1f ms, 90%% %.1f ms, 99%% %.1f ms, max. %.1f ms",
+               ls.n, ls.p50, ls.p90, ls.p99, ls.max);
+      ui->lClassifierLatency->setText(QString(buf));
+    }
+
+    //lag of the local subscribers
+    if(pub->isOpen()){
+      CSIPubSubscriberStats ps[PUB_MAX_SUBSCRIBERS];
+      uint32_t n = pub->getStats(ps, PUB_MAX_SUBSCRIBERS);
+      char buf[1024];
+      uint32_t len = snprintf(buf, sizeof(buf), "%u subscribers", n);
+      for(uint32_t i = 0; (i < n)&&(len < sizeof(buf)); i++){
+        len += snprintf(buf + len, sizeof(buf) - len, "%s #%u: %.0f KB queued, %" PRIu64 " dropped", (i == 0) ? ":" : ";", i + 1, ps[i].queued / 1024.0, ps[i].dropped);
+      }
+      ui->lPublishStatus->setText(QString(buf));
+    }
+
+    //load shedding of the display: share of the frames not displayed since the previous refresh, and a message whenever shedding starts
+    uint64_t offered = displayShedder.getOffered();
+    uint64_t lost = displayShedder.getShed() + displayQueue.getDropped();
+    if(offered > shedOfferedShown){
+      double rate = 100.0 * (lost - shedLostShown) / (offered - shedOfferedShown);
+      if((rate > 0)||(displayShedder.getDecimation() > 1)){
+        char buf[128];
+        snprintf(buf, sizeof(buf), "Display: %.0f%% of frames shed (1 of %u shown)", rate, displayShedder.getDecimation());
+        lDisplayLoad->setText(QString(buf));
+      }else{
+        lDisplayLoad->setText("");
+      }
+      shedOfferedShown = offered;
+      shedLostShown = lost;
+    }
+    if(displayShedder.getEvents() != shedEventsShown){
+      shedEventsShown = displayShedder.getEvents();
+      ui->statusBar->showMessage("Processing falls behind: frames are shed from the display, recording and export keep all frames", 5000);
+    }
+
+    //snapshots written so far
+    if(snapshotWriter->getWritten() + snapshotWriter->getDropped() > 0){
+      char buf[128];
+      snprintf(buf, sizeof(buf), "%" PRIu64 " snapshots written, %" PRIu64 " dropped", snapshotWriter->getWritten(), snapshotWriter->getDropped());
+      ui->lSnapshotStatus->setText(QString(buf));
+    }
 }
 void MainWindow::recordButtonHandler(){
   if(ui->pbRecord->isChecked()){
@@ -280,10 +590,12 @@ void MainWindow::updateDisplayWidgetSize(){
         dwP->setMinimumSize(QSize(1,1));
         cdw->setMinimumSize(QSize(1,1));
         dwRSSI->setMinimumSize(QSize(1,1));
+        dwS->setMinimumSize(QSize(1,1));
         dwA->setMaximumSize(QWIDGETSIZE_MAX,QWIDGETSIZE_MAX);
         dwP->setMaximumSize(QWIDGETSIZE_MAX,QWIDGETSIZE_MAX);
         cdw->setMaximumSize(QWIDGETSIZE_MAX,QWIDGETSIZE_MAX);
         dwRSSI->setMaximumSize(QWIDGETSIZE_MAX,QWIDGETSIZE_MAX);
+        dwS->setMaximumSize(QWIDGETSIZE_MAX,QWIDGETSIZE_MAX);
         emit resizecdw(ui->saClassif->width()-10,ui->saClassif->height());
         emit resizedwA(ui->saAmplitude->width()-10,ui->saAmplitude->height());
         emit resizedwP(ui->saPhase->width()-10,ui->saPhase->height());
@@ -299,18 +611,23 @@ void MainWindow::updateDisplayWidgetSize(){
         ui->saClassif->horizontalScrollBar()->setSliderPosition(ui->saAmplitude->horizontalScrollBar()->maximum());
         ui->saRSSI->horizontalScrollBar()->setMaximum(ui->spWidth->value());
         ui->saRSSI->horizontalScrollBar()->setSliderPosition(ui->saRSSI->horizontalScrollBar()->maximum());
+        ui->saSpectrogram->horizontalScrollBar()->setMaximum(ui->spWidth->value());
+        ui->saSpectrogram->horizontalScrollBar()->setSliderPosition(ui->saSpectrogram->horizontalScrollBar()->maximum());
         dwA->setMinimumSize(QSize(ui->spWidth->value() - 10,1));
         dwP->setMinimumSize(QSize(ui->spWidth->value() - 10,1));
         cdw->setMinimumSize(QSize(ui->spWidth->value() - 10,1));
         dwRSSI->setMinimumSize(QSize(ui->spWidth->value() - 10,1));
+        dwS->setMinimumSize(QSize(ui->spWidth->value() - 10,1));
         dwA->setMaximumSize(QSize(ui->spWidth->value() - 10,QWIDGETSIZE_MAX));
         dwP->setMaximumSize(QSize(ui->spWidth->value() - 10,QWIDGETSIZE_MAX));
         cdw->setMaximumSize(QSize(ui->spWidth->value() - 10,QWIDGETSIZE_MAX));
         dwRSSI->setMaximumSize(QSize(ui->spWidth->value() - 10,QWIDGETSIZE_MAX));
+        dwS->setMaximumSize(QSize(ui->spWidth->value() - 10,QWIDGETSIZE_MAX));
         dwP->resize(ui->spWidth->value() - 10,ui->saPhase->height());
         cdw->resize(ui->spWidth->value() - 10,ui->saClassif->height());
         dwA->resize(ui->spWidth->value() - 10,ui->saAmplitude->height());
         dwRSSI->resize(ui->spWidth->value() - 10,ui->saAmplitude->height());
+        dwS->resize(ui->spWidth->value() - 10,ui->saSpectrogram->height());
 
 
     }
@@ -322,41 +639,126 @@ void MainWindow::resizeEvent(QResizeEvent* event){
 }
 
 void MainWindow::startClassifier(){
-  if(ct->getStatus() == false){
-    printf("starting classifier from main window\n");
+  if(ct[selectedSink]->getStatus() == false){
+    printf("starting classifier %u from main window\n", selectedSink + 1);
+    classifierConfig config;
+    readClassifierConfig(&config);
+    if(!ct[selectedSink]->setConfig(config)){
+      ui->lClassifierOutput->setText("[Invalid list of MAC addresses or subcarriers]");
+      return;
+    }
     ui->cbDisplayClassifierOutput->setChecked(true);
     showHideClassifier(true);
-    ct->setCommand(ui->leClassifierExecutable->text());
-    ct->setArguments(ui->leClassifierArguments->text());
-    emit startClassifierThread();
+    ct[selectedSink]->start();
   }else{
-    printf("stopping classifier\n");
-    emit stopClassifierThread();
+    printf("stopping classifier %u\n", selectedSink + 1);
+    ct[selectedSink]->stopClassifier();
 
   }
 }
 
+void MainWindow::selectClassifierSink(int sink){
+  if((sink < 0)||(sink >= CLASSIFIER_MAX_SINKS)){
+    return;
+  }
+  //keep the settings of the previously selected classifier. The settings of a running classifier are those it has been started with.
+  if(!ct[selectedSink]->getStatus()){
+    classifierConfig config;
+    readClassifierConfig(&config);
+    ct[selectedSink]->setConfig(config);
+  }
+  selectedSink = sink;
+  showClassifierConfig(ct[selectedSink]->getConfig());
+  classifierStartedStopped(ct[selectedSink]->getStatus());
+  if(ct[selectedSink]->getStatus()){
+    ct[selectedSink]->getData(classifierBuf, CLASSIFIER_RCV_BUF_LEN);
+    ui->lClassifierOutput->setText(QString(classifierBuf));
+  }
+}
+
+void MainWindow::readClassifierConfig(classifierConfig* config){
+  const uint32_t nSubCarriers[] = {0, 64, 128, 256};    //entries of cbClassifierBandwidth
+  config->command = ui->leClassifierExecutable->text();
+  config->arguments = ui->leClassifierArguments->text();
+  config->mode = (liveExportMode) ui->cbLiveExportMode->currentIndex();
+  config->nSubCarriers = nSubCarriers[ui->cbClassifierBandwidth->currentIndex()];
+  config->MACs = ui->leClassifierMACs->text();
+  config->subCarriers = ui->leClassifierSubcarriers->text();
+  config->windowFrames = ui->sbWindowFrames->value();
+  config->windowHop = ui->sbWindowHop->value();
+  config->windowRate = ui->dsbWindowRate->value();
+  config->windowGapFill = (CSIGapFill) ui->cbWindowGapFill->currentIndex();
+  config->windowPhase = ui->cbWindowPhase->isChecked();
+  config->featureBins = ui->sbFeatureBins->value();
+  config->queueCapacity = ((uint64_t) ui->sbClassifierQueueMB->value())*1024*1024;
+  config->queuePolicy = (classifierQueuePolicy) ui->cbClassifierQueuePolicy->currentIndex();
+}
+
+void MainWindow::showClassifierConfig(const classifierConfig &config){
+  ui->leClassifierExecutable->setText(config.command);
+  ui->leClassifierArguments->setText(config.arguments);
+  ui->cbLiveExportMode->setCurrentIndex(config.mode);
+  if(config.nSubCarriers == 64){
+    ui->cbClassifierBandwidth->setCurrentIndex(1);
+  }else if(config.nSubCarriers == 128){
+    ui->cbClassifierBandwidth->setCurrentIndex(2);
+  }else if(config.nSubCarriers == 256){
+    ui->cbClassifierBandwidth->setCurrentIndex(3);
+  }else{
+    ui->cbClassifierBandwidth->setCurrentIndex(0);
+  }
+  ui->leClassifierMACs->setText(config.MACs);
+  ui->leClassifierSubcarriers->setText(config.subCarriers);
+  ui->sbWindowFrames->setValue(config.windowFrames);
+  ui->sbWindowHop->setValue(config.windowHop);
+  ui->dsbWindowRate->setValue(config.windowRate);
+  ui->cbWindowGapFill->setCurrentIndex(config.windowGapFill);
+  ui->cbWindowPhase->setChecked(config.windowPhase);
+  ui->sbFeatureBins->setValue(config.featureBins);
+  ui->sbClassifierQueueMB->setValue(config.queueCapacity / (1024*1024));
+  ui->cbClassifierQueuePolicy->setCurrentIndex(config.queuePolicy);
+}
+
 void MainWindow::classifierStartedStopped(bool started){
   printf("classifierStartedStopped - %u\n",started);
   isStarted = false;
-  if(started){
+  //the classifier that has started or stopped is not necessarily the selected one
+  if(ct[selectedSink]->getStatus()){
     ui->pbRunClassifier->setText("Stop Classifier");
     ui->pbRunClassifier->setChecked(true);
   }else{
     ui->pbRunClassifier->setText("Run Classifier");
     ui->pbRunClassifier->setChecked(false);
     ui->lClassifierOutput->setText("[Classifier not running]");
+    ui->lClassifierQueue->setText("");
+    ui->lClassifierLatency->setText("");
 
   }
 }
 
-classifierThread* MainWindow::getCT(){
-  return ct;
+classifierThread* MainWindow::getCT(uint32_t sink){
+  return ct[sink];
+}
+
+uint32_t MainWindow::getSelectedSink(){
+  return selectedSink;
+}
+
+uint32_t MainWindow::getNClassifiersRunning(){
+  uint32_t n = 0;
+  for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+    if(ct[i]->getStatus()){
+      n++;
+    }
+  }
+  return n;
 }
 
 
 void MainWindow::updateClassifierData(const QString& data){
+  if(sender() == ct[selectedSink]){
     ui->lClassifierOutput->setText(data);
+  }
 }
 
 void MainWindow::activateAmplitudeScaling(){
@@ -396,6 +798,20 @@ void MainWindow::showHideRSSI(bool shown){
   ui->saRSSI->setHidden(!shown);
   updateDisplayWidgetSize();
 }
+void MainWindow::showHideSpectrogram(bool shown){
+  ui->labelSpectrogram->setHidden(!shown);
+  ui->labelPlaceholderSpectrogramLeft->setHidden(!shown);
+  ui->labelPlaceholderSpectrogramRight->setHidden(!shown);
+  ui->saSpectrogram->setHidden(!shown);
+  //the windows start anew, since frames were not added while hidden
+  spectrogram.clear();
+  updateDisplayWidgetSize();
+}
+void MainWindow::updateDisplayAmplitude(){
+  if(nt != NULL){
+    nt->setDisplayAmplitude(ui->cbDisplayAmplitude->isChecked() || ui->cbDisplaySpectrogram->isChecked());
+  }
+}
 void MainWindow::showHideClassifier(bool shown){
   ui->saClassif->setHidden(!shown);
   ui->labelClassif->setHidden(!shown);
@@ -428,6 +844,91 @@ void MainWindow::moveEvent(QMoveEvent * event){
 checkableComboBox* MainWindow::getCBX(){
   return cbx;
 }
+
+CSIRingRecorder* MainWindow::getRR(){
+  return rr;
+}
+
+CSIResultLog* MainWindow::getResultLog(){
+  return &resultLog;
+}
+
+CSIPublisher* MainWindow::getPublisher(){
+  return pub;
+}
+
+CSIDisplayQueue* MainWindow::getDisplayQueue(){
+  return &displayQueue;
+}
+
+CSIDisplayShedder* MainWindow::getDisplayShedder(){
+  return &displayShedder;
+}
+
+CSIRecordFormat MainWindow::getRecordFormat(){
+  if(ui->rbFileFormatBinary->isChecked()){
+    return CSI_FORMAT_BINARY;
+  }else if(ui->rbFileFormatNpy->isChecked()){
+    return CSI_FORMAT_NPY;
+  }else if(ui->rbFileFormatCSVCompact->isChecked()){
+    return CSI_FORMAT_CSV_COMPACT;
+  }
+  return CSI_FORMAT_CSV_SIMPLE;
+}
+
+void MainWindow::preTriggerHandler(){
+  if(ui->cbPreTrigger->isChecked()){
+    //(re-)arming drops the frames kept so far
+    if(!rr->arm(ui->sbPreTriggerSeconds->value(), ui->sbPostTriggerSeconds->value(), ui->sbPreTriggerMemory->value(), getRecordFormat())){
+      ui->statusBar->showMessage("Could not allocate memory for pre-trigger recording", 5000);
+      ui->cbPreTrigger->setChecked(false);
+      return;
+    }
+    ui->pbTrigger->setEnabled(true);
+  }else{
+    rr->disarm();
+    ui->pbTrigger->setEnabled(false);
+  }
+}
+
+void MainWindow::publishHandler(){
+  if(ui->cbPublish->isChecked()){
+    if(!pub->open(ui->lePublishPath->text().toLocal8Bit().constData())){
+      ui->statusBar->showMessage(QString("Cannot publish on ") + ui->lePublishPath->text(), 5000);
+      ui->cbPublish->setChecked(false);
+      return;
+    }
+    ui->lePublishPath->setEnabled(false);
+  }else{
+    pub->close();
+    ui->lePublishPath->setEnabled(true);
+    ui->lPublishStatus->setText("");
+  }
+}
+
+void MainWindow::snapshotHandler(){
+  snapshotWriter->setDirectory(ui->leSnapshotDirectory->text());
+  snapshotWriter->setKeep(ui->sbSnapshotKeep->value());
+  //the interval starts anew
+  snapshotClock.invalidate();
+}
+
+void MainWindow::takeSnapshot(){
+  snapshotWriter->add(dwA->snapshot(), "amplitude");
+  snapshotWriter->add(dwP->snapshot(), "phase");
+  snapshotWriter->add(dwRSSI->snapshot(), "rssi");
+  if(ui->cbDisplaySpectrogram->isChecked()){
+    snapshotWriter->add(dwS->snapshot(), "spectrogram");
+  }
+}
+
+void MainWindow::preTriggerDumpStartedStopped(const QString& filename, bool started){
+  if(started){
+    ui->statusBar->showMessage(QString("Writing pre-trigger recording to ") + filename);
+  }else{
+    ui->statusBar->showMessage(QString("Pre-trigger recording written to ") + filename, 5000);
+  }
+}
 void MainWindow::proccessCmdLineArguments(char* url,char* bw, char* bwDisplay, char* bwExport){
   proccessCmdLineArguments(url, bw, bwDisplay);
   if(QString("80").compare(bwExport)==0){
@@ -519,5 +1020,16 @@ void MainWindow::updateBandwidthHandling(){
 
   }
 
+  //a list of displayed subcarriers overrides the display bandwidth
+  dwA->setNCSISamples(nt->getNDisplaySubcarriers());
+  dwP->setNCSISamples(nt->getNDisplaySubcarriers());
+}
 
+void MainWindow::updateSubcarrierLists(){
+  if(!nt->setSubcarrierLists(ui->leDisplaySubcarriers->text(), ui->leExportSubcarriers->text())){
+    ui->statusBar->showMessage("Invalid list of subcarriers, see the console", 5000);
+    return;
+  }
+  dwA->setNCSISamples(nt->getNDisplaySubcarriers());
+  dwP->setNCSISamples(nt->getNDisplaySubcarriers());
 }
@@ -19,6 +19,16 @@
 #include "dialogabout.h"                                ///The "about" dialog
 #include "CSIFilterGUIManager.h"                        ///Builds and controls the adaptive GUI of the filter manager
 #include "checkableComboBox.h"                          ///A checkable combo box for the MAC filter
+#include "CSIRingRecorder.h"                            ///Keeps recent frames in memory for pre-trigger recording
+#include "CSIResultLog.h"                               ///Stores the results of the classifiers next to the recording
+#include "CSIPublisher.h"                               ///Publishes the frames to local subscribers
+#include "CSIDisplayQueue.h"                            ///Passes the frames to be displayed from the network thread to the GUI thread
+#include "CSIDisplayLanes.h"                            ///Splits the displayed frames by sender and folds them into columns
+#include "CSIDisplayShedder.h"                          ///Sheds frames of the display when the network thread or the display falls behind
+#include "CSISnapshotWriter.h"                          ///Saves snapshots of the displays as PNG files
+#include "CSISpectrogram.h"                             ///Short-time spectrum of groups of subcarriers for the Doppler spectrogram
+#include <QElapsedTimer>
+#include <QLabel>
 namespace Ui {
 class MainWindow;
 }
@@ -63,9 +73,19 @@ public:
     classifierDisplayWidget* getCDW();
 
     /**
-     *  Returns a pointer to the classifier thread
+     *  Returns a pointer to the classifier thread of the given sink
      */
-    classifierThread* getCT();
+    classifierThread* getCT(uint32_t sink = 0);
+
+    /**
+     *  Returns the sink whose settings are shown in the GUI
+     */
+    uint32_t getSelectedSink();
+
+    /**
+     *  Returns the number of classifiers running
+     */
+    uint32_t getNClassifiersRunning();
 
     /**
      * Returns a pointer to the filter gui manager
@@ -77,6 +97,36 @@ public:
      */
     checkableComboBox* getCBX();
 
+    /**
+     *  Returns a pointer to the pre-trigger ring recorder
+     */
+    CSIRingRecorder* getRR();
+
+    /**
+     *  Returns a pointer to the log of the classifier results of the current recording
+     */
+    CSIResultLog* getResultLog();
+
+    /**
+     *  Returns a pointer to the publisher of frames to local subscribers
+     */
+    CSIPublisher* getPublisher();
+
+    /**
+     *  Returns a pointer to the queue of frames to be displayed. The network thread is its only producer.
+     */
+    CSIDisplayQueue* getDisplayQueue();
+
+    /**
+     *  Returns a pointer to the load shedding of the display. The network thread asks it which frames to display.
+     */
+    CSIDisplayShedder* getDisplayShedder();
+
+    /**
+     *  Returns the record format selected in the GUI
+     */
+    CSIRecordFormat getRecordFormat();
+
     /**
      *  Processes the command line arguments when 2 parameters are given on the command line (url/IP of the server, recorded bandwidth)
      *  @parameters:
@@ -125,8 +175,10 @@ private:
     displayWidget* dwA;                         ///display widget amplitude
     displayWidget* dwP;                         ///display widget phase
     displayWidget* dwRSSI;                      ///display widget RSSI
+    displayWidget* dwS;                         ///display widget Doppler spectrogram
     classifierDisplayWidget* cdw;               ///classifier display widget
-    classifierThread *ct;                       ///thread to read dat afrom the classifier
+    classifierThread *ct[CLASSIFIER_MAX_SINKS]; ///threads to read data from the classifiers
+    uint32_t selectedSink;                      ///the classifier whose settings are shown in the GUI
     QTimer* animTimer;                          ///timer that triggers the refreshing of all visualization widgets
     QTimer updateLayoutTimer;                   ///timer to update the layout after a resize event
     QThread *nt_thread;                         ///the *actual thread* hosting the network thread class
@@ -134,7 +186,38 @@ private:
     DialogAbout da;                             ///a dialog widget to show some information
     CSIFilterGUIManager *fgm;                   ///a GUI Manager for building the widgets to control the filters
     checkableComboBox *cbx;                     ///list of MAC addresses that can be selected.
+    CSIRingRecorder *rr;                        ///keeps recent frames in memory and writes them to a file on a trigger
+    CSIResultLog resultLog;                     ///results of the classifiers during the current recording
+    CSIPublisher *pub;                          ///publishes the frames to local subscribers
+    CSIDisplayQueue displayQueue;               ///frames to be displayed, rendered by animate()
+    CSIDisplayShedder displayShedder;           ///decides which frames are displayed while the network thread or the display falls behind
+    uint64_t shedOfferedShown;                  ///frames offered to the display at the previous refresh
+    uint64_t shedLostShown;                     ///frames shed or dropped by the display queue at the previous refresh
+    uint64_t shedEventsShown;                   ///shedding events reported in the status bar so far
+    QLabel* lDisplayLoad;                       ///shows the share of the frames shed in the status bar
+    CSIDisplayLanes displayLanes;               ///splits the displayed frames by sender and folds several frames into one column
+    uint32_t displayLanesShown;                 ///number of lanes the display widgets are split into
+    CSISpectrogram spectrogram;                 ///spectrum of the displayed frames of each sender, shown by dwS
+    QElapsedTimer displayClock;                 ///time since the previous refresh, for measuring the frame rate
+    double displayFrameRate;                    ///smoothed rate of the frames to be displayed in frames/s
+    double displayTimeSpan;                     ///time span shown by the display widgets in s. 0 => one column per frame
+    CSISnapshotWriter *snapshotWriter;          ///encodes the snapshots of the displays to PNG files
+    QElapsedTimer snapshotClock;                ///time since the previous periodic snapshot
 
+    /**
+     *  Fill config with the classifier settings in the GUI
+     */
+    void readClassifierConfig(classifierConfig* config);
+
+    /**
+     *  Show the given classifier settings in the GUI
+     */
+    void showClassifierConfig(const classifierConfig &config);
+
+    /**
+     *  Pass the column completed by displayLanes to the display widgets
+     */
+    void showDisplayColumn();
 
 
 
@@ -145,22 +228,32 @@ public slots:
 
     void recordButtonHandler();                 ///Record-Button clicked -> recording starts or stops
     void updateDisplayWidgetSize();             ///Update the size of the display widget
-    void startClassifier();                     ///Start the classifier
+    void startClassifier();                     ///Start or stop the selected classifier
+    void selectClassifierSink(int sink);        ///Another classifier has been selected. Its settings are shown in the GUI
     void classifierStartedStopped(bool started);///The classifier has either started (-> started == true) or stopped (-> started == false)
     void updateClassifierData(const QString&);  ///The most recent data output from  the classifier is displayed in the GUI
     void updateDisplayPeriod();                 ///The refresh rate of all visualizations has been changed
+    void updateDisplayAggregation();            ///The time span per screen or the reducer of the display has been changed
+    void updateDisplayLanes();                  ///The maximum number of senders displayed in lanes has been changed
     void activateAmplitudeScaling();            ///Activates that the amplitude color scale is adjusted when an amplitude exceeding any previously seen maximum amplitude arrives
     void activatePhaseScaling();                ///Activates that the phase color scale is adjusted when an phaseexceeding any previously seen maximum phase arrives
     void showHidePhase(bool shown);             ///Toggle showing/hiding the phase display widget
     void showHideClassifier(bool shown);        ///Toggle showing/hiding the classifier display widget
     void showHideRSSI(bool shown);              ///Toggle showing/hiding the RSSI display widget
     void showHideAmplitude(bool shown);         ///Toggle showing/hiding the amplitude display widget
+    void showHideSpectrogram(bool shown);       ///Toggle showing/hiding the Doppler spectrogram display widget
+    void updateDisplayAmplitude();              ///The network thread passes the amplitude on if the amplitude or the spectrogram is displayed
+    void updateSpectrogram();                   ///The window or the number of subcarrier groups of the spectrogram has been changed
     void updateBandwidthHandling();             ///The selected bandwidth for display or export or for the input stream has changed
+    void updateSubcarrierLists();               ///The list of displayed or exported subcarriers has changed
+    void preTriggerHandler();                   ///Pre-trigger recording has been activated/deactivated or its settings have changed
+    void preTriggerDumpStartedStopped(const QString& filename, bool started);   ///A pre-trigger recording has started (-> started == true) or has been completed (-> started == false)
+    void publishHandler();                      ///Publishing on the local socket has been activated/deactivated
+    void snapshotHandler();                     ///The interval, the directory or the number of files kept of the snapshots has been changed
+    void takeSnapshot();                        ///Save snapshots of the displays
 
    signals:
    void stopStreaming();                        ///Stop streaming data from the WiFi SoC
-   void startClassifierThread();                ///Start the classifier thread
-   void stopClassifierThread();                 ///Stop the classifier
    void resizedwA(int width, int height);       ///Resize amplitude display widget
    void resizedwP(int width, int height);       ///Resize phase display widget
    void resizedwRSSI(int width, int height);    ///Resize RSSI widget
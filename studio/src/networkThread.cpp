@@ -15,6 +15,7 @@
 
 #include <iostream>
 #include <stdio.h>
+#include <stddef.h>
 #include <dlfcn.h>
 #include "debug.h"
 #include "displayWidget.h"
@@ -22,6 +23,7 @@
 #include "CSIData.h"
 #include "classifierThread.h"
 #include "CSIFilterManager.h"
+#include "CSIRecordFormat.h"
 #include "networkThread.h"
 
 #define CLASSIFIER_ACCUM_BUF_LEN CLASSIFIER_RCV_BUF_LEN
@@ -32,6 +34,7 @@ using namespace std;
 networkThread::networkThread(){
   status = false;
   recording = false;
+  recordFormat = CSI_FORMAT_CSV_SIMPLE;
   s_udp = NULL;
   s = NULL;
   nBytesRead = 0;
@@ -42,6 +45,10 @@ networkThread::networkThread(){
   CSIDataLen = 0;
   CSIDataLenDisplay = 0;
   CSIDataLenExport = 0;
+  mapsChanged = true;
+  mapEpoch = 0;
+  CSIBandwidthMap(0, 0, &nextDisplayMap);
+  CSIBandwidthMap(0, 0, &nextExportMap);
   displayAmplitude = false;
   displayPhase = false;
   displayRSSI = false;
@@ -73,8 +80,6 @@ networkThread::~networkThread(){
  */
 void networkThread::operate(){
   //  cout<<"initiating.. "<<endl;
-  connect(this, SIGNAL(addTimeToCDW()),this->mw->getCDW(),SLOT(addTime()));
-  connect(this, SIGNAL(addDataToClassifierThread(const QString&)), this->mw->getCT(), SLOT(addData(const QString&)));
   connect(this, SIGNAL(addDataToRSSIDisplayWidget(double)), this->mw->getdwRSSI(), SLOT(addData(double)));
   connect(this, SIGNAL(addDataArrayToDisplayWidget(double*, int)), this->mw->getdwA(), SLOT(addDataForEntireFrame(double*, int)));
   connect(this, SIGNAL(addDataArrayToPhaseDisplayWidget(double*, int)), this->mw->getdwP(), SLOT(addDataForEntireFrame(double*, int)));
@@ -194,21 +199,24 @@ bool networkThread::processData(char* buf, struct timespec timeNow){
   static CSIData data_Display;                  //Data to show in visualisation
   static CSIData data_Export;                   //Data to export to Files/Classifier
   static QString MACStr;                        //String buffer for MAC addresses
-  static char MACBuf[50];                       //Char buffer for MAC addresses
+  static char MACBuf[CSI_MAC_STLEN];            //Char buffer for MAC addresses
   static int16_t real;                          //Real part of CSI
   static int16_t imag;                          //Imaginary part of CSI
-  static double magnitude;                      //CSI magnitude
-  static double phase;                          //CSI phase
-  static char timestamp[100];                   //Buffer for timestamp in string format
+  static char timestamp[CSI_TIMESTAMP_STLEN];   //Buffer for timestamp in string format
   static char fileBuf_CT_accum_Recording[CLASSIFIER_ACCUM_BUF_LEN];     //Accumulated filebuffer for recording - an entry for the recorded file will be prepared in memory here
   uint32_t wrPointerfileBuf_CT_accum_Recording = 0;                     //Write pointer for this file buffer
-  static char fileBuf_CT_accum_LiveExport[CLASSIFIER_ACCUM_BUF_LEN];    //Accumulated filebuffer for live recording
-  uint32_t wrPointerfileBuf_CT_accum_LiveExport = 0;                    //Write pointer for this file buffer
-  static char fileBuf_Record[FILEBUF_LEN];                              //Buffer for temp data for recording
-  static char fileBuf_LiveExport[FILEBUF_LEN];                          //Buffer for temp data for live export
-  static double exchangeBuf_amplitudes[256];                            //Data buffer for exchaning data with the display widgets
-  static double exchangeBuf_phases[256];                                //Data buffer for exchaning data with the display widgets
+  static char fileBuf_CT_accum_LiveExport[CLASSIFIER_MAX_SINKS][CLASSIFIER_ACCUM_BUF_LEN];      //Accumulated filebuffers for live export, one per selection of subcarriers of the classifiers
+  static CSIData data_Sink[CLASSIFIER_MAX_SINKS];                       //Data gathered to the subcarriers of the classifiers
+  static CSIData data_Converted;                                        //Amplitude and phase of the subcarriers in convertMap
+#if DATA_EXCHANGE_THROUGH_QT_SIGNALS
+  static double exchangeBuf_amplitudes[CSI_MAX_SUBCARRIERS];            //Data buffer for exchaning data with the display widgets
+  static double exchangeBuf_phases[CSI_MAX_SUBCARRIERS];                //Data buffer for exchaning data with the display widgets
+#endif
   static struct timespec_16bytes timeNow16;                             //Timespec function
+  struct timespec tStart;                                               //Start of the processing, for the load of this thread
+  struct timespec tEnd;                                                 //End of the processing
+
+  clock_gettime(CLOCK_MONOTONIC, &tStart);
 
   //fill timespec with current time
   timeNow16.tv_sec = timeNow.tv_sec;
@@ -216,8 +224,6 @@ bool networkThread::processData(char* buf, struct timespec timeNow){
 
   //initialize buffers for recording/live export
   strcpy(fileBuf_CT_accum_Recording,"");
-  strcpy(fileBuf_CT_accum_LiveExport,"");
-  uint32_t strlen_filebuf;
 
 
   DEBUG("processing.\n");
@@ -257,14 +263,7 @@ bool networkThread::processData(char* buf, struct timespec timeNow){
 
   //Create a timestamp string
   gmtime_r(&(timeNow.tv_sec),&timeNowLocal);
-  sprintf(timestamp, "%04u-%02u-%02u %02u:%02u:%02u:%06u"             //format specified by Florenc
-          ,timeNowLocal.tm_year + 1900
-          ,timeNowLocal.tm_mon+1
-          ,timeNowLocal.tm_mday
-          ,timeNowLocal.tm_hour+1
-          ,timeNowLocal.tm_min
-          ,timeNowLocal.tm_sec
-          ,timeNow.tv_nsec/1000);
+  CSIFormatTimestamp(&timeNow16, timestamp);
   data_Display.timeStamp = timeNowLocal;
   DEBUG("Timestamp: %s\n", timestamp);
 
@@ -272,7 +271,7 @@ bool networkThread::processData(char* buf, struct timespec timeNow){
   //Create
   memcpy(data_Display.senderMAC, (buf+4), 6);
   DEBUG("MAC: %c:%c:%c:%c:%c:%x\n", data_Display.senderMAC[0],data_Display.senderMAC[1],data_Display.senderMAC[2],data_Display.senderMAC[3],data_Display.senderMAC[4],data_Display.senderMAC[5]);
-  sprintf(MACBuf,"%x:%x:%x:%x:%x:%x", data_Display.senderMAC[0],data_Display.senderMAC[1],data_Display.senderMAC[2],data_Display.senderMAC[3],data_Display.senderMAC[4],data_Display.senderMAC[5]);
+  CSIFormatMAC(data_Display.senderMAC, MACBuf);
   MACStr = MACBuf;                      //Create QString from character array
 
   emit addMAC(QString(MACStr));         //Add MAC to the list of known MACs
@@ -302,103 +301,31 @@ bool networkThread::processData(char* buf, struct timespec timeNow){
   data_Export.chanSpec = data_Display.chanSpec;
 
   data_Export.chipVersion = data_Display.chipVersion;
-  if(CSIDataLenDisplay > CSIDataLen){
-    data_Display.nSubCarriers = CSIDataLen;
-  }else{
-    data_Display.nSubCarriers = CSIDataLenDisplay;
-  }
-  if(CSIDataLenExport > CSIDataLen){
-    data_Export.nSubCarriers = CSIDataLen;
-  }else{
-    data_Export.nSubCarriers = CSIDataLenExport;
-  }
-
-
-  uint32_t beginD, endD;
-  uint32_t beginE, endE;
-
-
-  //reduce bandwidth if the bandwidth using which CSI has been captured
-  if(CSIDataLen == 256){
-    if(CSIDataLenDisplay == 64){
-      //80 MHz => 20MHz
-      beginD = 128;
-      endD = 191;
-    }else if(CSIDataLenDisplay == 128){
-      //80 MHz => 20MHz
-      beginD = 128;
-      endD = 255;
-    }else{
-      beginD = 0;
-      endD = 255;
-    }
-
-    if(CSIDataLenExport== 64){
-      //80 MHz => 20MHz
-      beginE = 128;
-      endE = 191;
-    }else if(CSIDataLenExport== 128){
-      //80 MHz => 20MHz
-      beginE = 128;
-      endE = 255;
-    }else{
-      beginE = 0;
-      endE = 255;
-    }
 
+  //take over subcarrier selections changed by the GUI. The flag is read without the mutex, which is locked only if the maps have changed.
+  if(__atomic_load_n(&mapsChanged, __ATOMIC_ACQUIRE)){
+    applyMaps();
   }
-  if(CSIDataLen == 128){
-    if(CSIDataLenDisplay == 64){
-      //80 MHz => 20MHz
-      beginD = 64;
-      endD = 127;
-    }else{
-      beginD = 0;
-      endD = 127;
-    }
 
-    if(CSIDataLenExport== 64){
-      //80 MHz => 20MHz
-      beginE = 64;
-      endE = 127;
-    }else{
-      beginE = 0;
-      endE = 127;
-    }
-  }
+  bool display = (isMACActive(MACStr))&&((displayAmplitude)||(displayPhase)||(displayRSSI));
 
-  if(CSIDataLen == 64){
-    beginD = 0;
-    endD = 127;
-    beginE  = 0;
-    endE = 127;
-  }
-  uint32_t begin, end;
-  if(beginD > beginE){
-    begin = beginE;
-  }else{
-    begin = beginD;
-  }
-  if(endD > endE){
-    end = endD;
-  }else{
-    end = endE;
-  }
-
-  //Compute amplitude and phase and fill it into data_Display and data_Export structures
-  for(uint16_t cnt = begin; cnt <= end; cnt++){
+  //Compute amplitude and phase of the subcarriers displayed or exported only, then gather them into data_Display and data_Export
+  for(uint32_t i = 0; i < convertMap.n; i++){
+    uint16_t cnt = convertMap.index[i];
     real =  payloadPointer[2*cnt + 0];
     imag =  payloadPointer[2*cnt + 1];
-    magnitude = sqrt((((double) real)*((double) real)) + (((double) imag)*((double) imag)));
-    phase = atan2(double(imag),(double) real);
-    if((cnt >= beginD)&&(cnt <= endD)){
-      data_Display.amplitude[cnt - beginD] = magnitude;
-      data_Display.phase[cnt - beginD] = phase;
-    }
-    if((cnt >= beginE)&&(cnt <= endE)){
-      data_Export.amplitude[cnt - beginE] = magnitude;
-      data_Export.phase[cnt - beginE] = phase;
-    }
+    data_Converted.amplitude[i] = sqrt((((double) real)*((double) real)) + (((double) imag)*((double) imag)));
+    data_Converted.phase[i] = atan2(double(imag),(double) real);
+  }
+  data_Display.nSubCarriers = displayGather.map.n;
+  for(uint32_t i = 0; (display)&&(i < displayGather.map.n); i++){
+    data_Display.amplitude[i] = data_Converted.amplitude[displayGather.positions[i]];
+    data_Display.phase[i] = data_Converted.phase[displayGather.positions[i]];
+  }
+  data_Export.nSubCarriers = exportGather.map.n;
+  for(uint32_t i = 0; i < exportGather.map.n; i++){
+    data_Export.amplitude[i] = data_Converted.amplitude[exportGather.positions[i]];
+    data_Export.phase[i] = data_Converted.phase[exportGather.positions[i]];
   }
 
   //Filters obtain both data_Display and data_Export in an alternating manner.
@@ -417,231 +344,210 @@ bool networkThread::processData(char* buf, struct timespec timeNow){
 #endif
 
 
+  //local subscribers get the frame before and after the filters
+  this->mw->getPublisher()->publish(CSI_TOPIC_RAW, &data_Export, &timeNow16);
+
   /* Apply filter pipeline */
   if(filterManager != NULL){
-    filterManager->applyFilterPipeline(&data_Display);
+    if(display){
+      filterManager->applyFilterPipeline(&data_Display);
+    }
     filterManager->applyFilterPipeline(&data_Export);
   }
 
+  this->mw->getPublisher()->publish(CSI_TOPIC_FILTERED, &data_Export, &timeNow16);
+
 
 
 
 
   /*
-   * Preparation of per-frame (and not per sub-carrier) information for recording. Per frame data is normally data such as e.g., the timestamp.
+   * Encode the frame for recording and live export. The live export always uses the simple CSV format.
+   * If we are recording in the simple CSV format, too, the frame is encoded only once.
    */
-  if(recording){
-    if(this->mw->getUI()->rbFileFormatCSVCompact->isChecked()){
-      //** Compact CSV Format**//
-
-      //Compact format. Only add the data unique per frame
-      sprintf(fileBuf_Record,"%s;%s;%.10f;%u",timestamp,MACBuf,data_Export.RSSI,data_Export.frame_control);
-      if(wrPointerfileBuf_CT_accum_Recording + strlen(fileBuf_Record)+1 >= FILEBUF_LEN){
-        cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-        exit(1);
-      }
-
-      memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), fileBuf_Record,strlen(fileBuf_Record)+1);
-      wrPointerfileBuf_CT_accum_Recording += strlen(fileBuf_Record);
-
-
-    }else if(this->mw->getUI()->rbFileFormatBinary->isChecked()){
-      //** Binary Format**//
-
-      //timestamp
-      if(wrPointerfileBuf_CT_accum_Recording + sizeof(struct timespec_16bytes) >= FILEBUF_LEN){
-        cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-        exit(1);
-      }
-      memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), (char*) &(timeNow16),sizeof(struct timespec_16bytes));
-      wrPointerfileBuf_CT_accum_Recording += sizeof(struct timespec_16bytes);
-
-      //MAC
-      if(wrPointerfileBuf_CT_accum_Recording + 6 >= FILEBUF_LEN){
-        cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-        exit(1);
-      }
-      memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), (char*) &(data_Export.senderMAC), 6);  //6 bytes are the actual MAC, data_Export.senderMAC contains an additional byte to distinguish between export and displaying
-      wrPointerfileBuf_CT_accum_Recording += 6;                 //6 bytes are the actual MAC, data_Export.senderMAC contains an additional byte to distinguish between export and displaying
-
-      //RSSI
-      if(wrPointerfileBuf_CT_accum_Recording +sizeof(data_Display.RSSI) >= FILEBUF_LEN){
-        cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-        exit(1);
-      }
-      memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), (char*) &(data_Export.RSSI),sizeof(data_Display.RSSI));
-      wrPointerfileBuf_CT_accum_Recording += sizeof(data_Export.RSSI);
-
-      //frame control
-      if(wrPointerfileBuf_CT_accum_Recording +sizeof(data_Export.frame_control) >= FILEBUF_LEN){
-        cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-        exit(1);
-      }
-      memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), (char*) &(data_Export.frame_control),sizeof(data_Display.frame_control));
-      wrPointerfileBuf_CT_accum_Recording += sizeof(data_Export.frame_control);
+  if((recording)&&(recordFormat == CSI_FORMAT_NPY)&&((!MACFilterRecording)||(isMACActive(MACStr)))){
+    //NumPy arrays are written directly
+    if(!npyWriter.writeFrame(&data_Export, &timeNow16)){
+      cout<<"Error writing file: "<<npyWriter.getError()<<endl;
+      this->stopRecording();
+      return false;
+    }
+  }else if((recording)&&((!MACFilterRecording)||(isMACActive(MACStr)))){
+    wrPointerfileBuf_CT_accum_Recording = CSIEncodeFrame(recordFormat, &data_Export, &timeNow16, timestamp, MACBuf, (exportMap.custom) ? exportMap.index : NULL, fileBuf_CT_accum_Recording, CLASSIFIER_ACCUM_BUF_LEN);
+    if((wrPointerfileBuf_CT_accum_Recording == 0)&&(data_Export.nSubCarriers > 0)){
+      printf("err - filebuf overfull - more than %u bytes per frame\n", CLASSIFIER_ACCUM_BUF_LEN);
+      exit(1);
     }
-
-    //** Simple CSV Format**//
-    //-> data will only be created per-subcarrier
-
   }
 
-  //Preparation of  per sub-carrier information for recording.
-  //The data in fileBuf_* will be later added to wrPointerfileBuf_CT_accum_Recording/wrPointerfileBuf_CT_accum_LiveExport
-
-
-  for(uint16_t cnt = 0; cnt < CSIDataLenExport; cnt++){
-
-    //for live export + simple CSV, which share the same format
-    sprintf(fileBuf_LiveExport,"%s;%s;%d;%.10f;%.10f;%.10f;%u\n",timestamp,MACBuf,cnt,data_Export.amplitude[cnt],data_Export.phase[cnt],data_Export.RSSI, data_Export.frame_control);
-
-
-    if(recording){
-
-      if(this->mw->getUI()->rbFileFormatCSVSimple->isChecked()){
-        //** Simple CSV Format**//
-        //use the 'simple' format as for live-export
-
-        //since both buffers have the same size, this cannot fail
-        memcpy(fileBuf_Record,fileBuf_LiveExport,strlen(fileBuf_LiveExport)+1);
-
-      }else if(this->mw->getUI()->rbFileFormatCSVCompact->isChecked()){
-        //** Compact CSV Format**//
-
-        if(cnt == CSIDataLenExport-1){
-          //with newline
-          sprintf(fileBuf_Record,";%.10f;%.10f\n",data_Export.amplitude[cnt],data_Export.phase[cnt]);
-        }else{
-          //no newline
-          sprintf(fileBuf_Record,";%.10f;%.10f",data_Export.amplitude[cnt],data_Export.phase[cnt]);
-        }
-      }else{
-        //** Binary Format**//
-        if(wrPointerfileBuf_CT_accum_Recording +sizeof(data_Export.amplitude[cnt]) >= FILEBUF_LEN){
-          cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-          exit(1);
-        }
-        memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), (char*) &(data_Export.amplitude[cnt]),sizeof(data_Export.amplitude[cnt]));
-        wrPointerfileBuf_CT_accum_Recording += sizeof(data_Export.amplitude[cnt]);
+  //keep the frame in memory for pre-trigger recording
+  if((this->mw->getRR()->isArmed())&&((!MACFilterRecording)||(isMACActive(MACStr)))){
+    this->mw->getRR()->addFrame(&data_Export, &timeNow16, (exportMap.custom) ? exportMap.index : NULL);
+  }
 
-        if(wrPointerfileBuf_CT_accum_Recording + sizeof(data_Export.phase[cnt]) >= FILEBUF_LEN){
-          cerr<<"Warning - File buffer is full. Please report this as a bug. Exiting.\n";
-          exit(1);
-        }
-        memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), (char*) &(data_Export.phase[cnt]),sizeof(data_Export.phase[cnt]));
-        wrPointerfileBuf_CT_accum_Recording += sizeof(data_Export.phase[cnt]);
-        strcpy(fileBuf_Record,"");
+  /*
+   * Export to the classifiers. Each classifier gets the frames of its own MAC addresses, or those passing the MAC filter of the live export.
+   * The frame is gathered and encoded as text only once per selection of subcarriers, no matter how many classifiers it is passed to.
+   * Classifiers with the same windows share the window assembler of the first of them.
+   */
+  if(classifierThreadActive){
+    classifierThread* sinks[CLASSIFIER_MAX_SINKS];      //the running classifiers the frame is passed to
+    uint32_t nSinks = 0;
+    const CSIGatherTable* bandwidthGather[CLASSIFIER_MAX_SINKS];  //the different selections of subcarriers of these classifiers
+    CSIData* bandwidthData[CLASSIFIER_MAX_SINKS];       //the frame gathered to each of them
+    const char* bandwidthText[CLASSIFIER_MAX_SINKS];    //the frame encoded as text for each of them
+    uint32_t bandwidthTextLen[CLASSIFIER_MAX_SINKS];    //length of the text. 0 => not encoded yet
+    uint32_t nBandwidths = 0;
+
+    for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+      classifierThread* ct = this->mw->getCT(i);
+      if(!ct->getStatus()){
+        continue;
+      }
+      if((ct->hasMACScope()) ? (ct->inMACScope(data_Export.senderMAC)) : ((!MACFilterLiveExport)||(isMACActive(MACStr)))){
+        sinks[nSinks] = ct;
+        nSinks++;
       }
     }
 
-    //Live Export
-    if(classifierThreadActive){
-      if((!MACFilterLiveExport)||(isMACActive(MACStr))){
-        strlen_filebuf = strlen(fileBuf_LiveExport);
-        if(wrPointerfileBuf_CT_accum_LiveExport + strlen_filebuf + 1 <= CLASSIFIER_ACCUM_BUF_LEN){
-          memcpy((char*)(fileBuf_CT_accum_LiveExport+wrPointerfileBuf_CT_accum_LiveExport), fileBuf_LiveExport,strlen_filebuf+1);
-          wrPointerfileBuf_CT_accum_LiveExport += strlen_filebuf;
+    for(uint32_t i = 0; i < nSinks; i++){
+      const CSIGatherTable* gather = sinks[i]->getGather(CSIDataLen, &exportMap, mapEpoch);
+      uint32_t b = 0;
+      while((b < nBandwidths)&&(!CSISameSubcarriers(&bandwidthGather[b]->map, &gather->map))){
+        b++;
+      }
+      if(b == nBandwidths){
+        bandwidthGather[b] = gather;
+        if(gather->identity){
+          bandwidthData[b] = &data_Export;
         }else{
-          printf("err - buffer for classifier thread overfull\n");
-          exit(1);
+          CSIGather(&data_Export, gather->positions, gather->map.n, &data_Sink[b]);
+          bandwidthData[b] = &data_Sink[b];
         }
+        bandwidthTextLen[b] = 0;
+        nBandwidths++;
       }
-    }
 
-    //Recording
-    if(recording){
-      // Reasons not to add data related to this frame to the final buffer to be written into the file
-      // 1) The MAC filter is active and the selected MAC is not included, or,
-      // 2) we are in binary format - the buffer is already filled in this case
-      if(!(this->mw->getUI()->rbFileFormatBinary->isChecked())){
-        if((!MACFilterRecording)||(isMACActive(MACStr))){
-          strlen_filebuf = strlen(fileBuf_Record);
-          //     printf("filter: %u - found: %u -  adding :%s\n",MACFilterRecording,isMACActive(MACStr), MACStr.toUtf8().data());
-          if(wrPointerfileBuf_CT_accum_Recording + strlen_filebuf + 1 <= CLASSIFIER_ACCUM_BUF_LEN){
-           if(strlen_filebuf > 0){
-              memcpy((char*)(fileBuf_CT_accum_Recording+wrPointerfileBuf_CT_accum_Recording), fileBuf_Record,strlen_filebuf+1);
-              wrPointerfileBuf_CT_accum_Recording += strlen_filebuf;
-           }
+      if(sinks[i]->getExportMode() == LIVE_EXPORT_SHM){
+        sinks[i]->getLatency()->addInput(timeNow16.tv_sec * 1000000000ULL + timeNow16.tv_nsec);
+        sinks[i]->getShmExport()->writeFrame(bandwidthData[b], &timeNow16);
+      }else if(sinks[i]->getExportMode() == LIVE_EXPORT_FRAMES){
+        sinks[i]->addFrame(bandwidthData[b], &timeNow16);
+      }else if(sinks[i]->getExportMode() == LIVE_EXPORT_FEATURES){
+        sinks[i]->getFeatureExtractor()->addFrame(bandwidthData[b], &timeNow16);
+      }else if(sinks[i]->getExportMode() == LIVE_EXPORT_WINDOWS){
+        bool isFollower = false;
+        for(uint32_t j = 0; j < i; j++){
+          isFollower = isFollower || sinks[j]->sharesWindows(sinks[i]);
+        }
+        if(!isFollower){
+          classifierThread* followers[CLASSIFIER_MAX_SINKS];
+          uint32_t nFollowers = 0;
+          for(uint32_t j = i + 1; j < nSinks; j++){
+            if(sinks[i]->sharesWindows(sinks[j])){
+              followers[nFollowers] = sinks[j];
+              nFollowers++;
+            }
+          }
+          sinks[i]->setWindowFollowers(followers, nFollowers);
+          sinks[i]->getWindowAssembler()->addFrame(bandwidthData[b], &timeNow16);
+        }
+      }else{
+        if(bandwidthTextLen[b] == 0){
+          //if we are recording in the simple CSV format, too, the text of the recording is reused
+          if((recordFormat == CSI_FORMAT_CSV_SIMPLE)&&(wrPointerfileBuf_CT_accum_Recording > 0)&&(bandwidthData[b] == &data_Export)){
+            bandwidthText[b] = fileBuf_CT_accum_Recording;
+            bandwidthTextLen[b] = wrPointerfileBuf_CT_accum_Recording;
           }else{
-            printf("err - filebuf overfull - %u/%u bytes written\n", wrPointerfileBuf_CT_accum_Recording + strlen_filebuf + 1 ,CLASSIFIER_ACCUM_BUF_LEN);
+            bandwidthText[b] = fileBuf_CT_accum_LiveExport[b];
+            bandwidthTextLen[b] = CSIEncodeFrame(CSI_FORMAT_CSV_SIMPLE, bandwidthData[b], &timeNow16, timestamp, MACBuf, (bandwidthGather[b]->map.custom) ? bandwidthGather[b]->map.index : NULL, fileBuf_CT_accum_LiveExport[b], CLASSIFIER_ACCUM_BUF_LEN);
+          }
+          if((bandwidthTextLen[b] == 0)&&(bandwidthData[b]->nSubCarriers > 0)){
+            printf("err - buffer for classifier thread overfull\n");
             exit(1);
           }
-
         }
-      }
-    }
-  }
-
-  //Export time for classifier
-  if(classifierThreadActive){
-    if(((!MACFilterLiveExport)||(isMACActive(MACStr)))&&(displayClassifier)){
+        if(bandwidthTextLen[b] > 0){
 #if DATA_EXCHANGE_THROUGH_QT_SIGNALS
-      emit addTimeToCDW();
+          QMetaObject::invokeMethod(sinks[i], "addData", Qt::QueuedConnection, Q_ARG(QString, QString(bandwidthText[b])));
 #else
-      this->mw->getCDW()->addTime();
+          sinks[i]->addData(bandwidthText[b], bandwidthTextLen[b]);
 #endif
+        }
+      }
     }
   }
 
 
-  //RSSI to RSSI display widget
-#ifdef CSI_CONTAINS_RSSI
-  if((isMACActive(MACStr))&&(displayRSSI)){
+  //The display is best effort: while this thread or the display falls behind, frames are shed after the filters of the display, so recording and export keep all frames
+  //and the state of the filters does not jump. A frame displayed stands for the frames shed before it.
+  uint32_t decimation = 0;
+  if(display){
+    decimation = this->mw->getDisplayShedder()->admit(this->mw->getDisplayQueue()->getDepth());
+    display = (decimation > 0);
+  }
+
+  //display RSSI, amplitude and phase
 #if DATA_EXCHANGE_THROUGH_QT_SIGNALS
+#ifdef CSI_CONTAINS_RSSI
+  if((display)&&(displayRSSI)){
     emit addDataToRSSIDisplayWidget((double) data_Display.RSSI);
-#else
-    this->mw->getdwRSSI()->addData(data_Display.RSSI);
-#endif
   }
 #endif
-
-
-  //display amplitude and phase
-  if(isMACActive(MACStr)){
-    memcpy(exchangeBuf_amplitudes, data_Display.amplitude, CSIDataLenDisplay*sizeof(double));
-    memcpy(exchangeBuf_phases, data_Display.phase, CSIDataLenDisplay*sizeof(double));
-#if DATA_EXCHANGE_THROUGH_QT_SIGNALS
+  if(display){
+    memcpy(exchangeBuf_amplitudes, data_Display.amplitude, data_Display.nSubCarriers*sizeof(double));
+    memcpy(exchangeBuf_phases, data_Display.phase, data_Display.nSubCarriers*sizeof(double));
     if(displayAmplitude){
-      emit addDataArrayToDisplayWidget(exchangeBuf_amplitudes,CSIDataLenDisplay);
+      emit addDataArrayToDisplayWidget(exchangeBuf_amplitudes,data_Display.nSubCarriers);
     }
     if(displayPhase){
-      emit addDataArrayToPhaseDisplayWidget(exchangeBuf_phases,CSIDataLenDisplay);
+      emit addDataArrayToPhaseDisplayWidget(exchangeBuf_phases,data_Display.nSubCarriers);
     }
+  }
 #else
-    if(displayAmplitude){
-      this->mw->getdwA()->addDataForEntireFrame(exchangeBuf_amplitudes,CSIDataLenDisplay);
-    }
-    if(displayPhase){
-      this->mw->getdwP()->addDataForEntireFrame(exchangeBuf_phases,CSIDataLenDisplay);
-    }
-#endif
-
-
-    // Export to classifier
-    if((classifierThreadActive)&&(wrPointerfileBuf_CT_accum_LiveExport > 0)){
-#if DATA_EXCHANGE_THROUGH_QT_SIGNALS
-      emit addDataToClassifierThread(QString(fileBuf_CT_accum_LiveExport));
+  //The frame is queued for the GUI thread, which renders it with the next refresh of the display. We never wait for the GUI: if the queue is full, the frame is not displayed.
+  if(display){
+    CSIDisplayFrame* f = this->mw->getDisplayQueue()->beginWrite();
+    if(f != NULL){
+      memcpy(f->MAC, data_Display.senderMAC, 6);
+      f->nSubCarriers = data_Display.nSubCarriers;
+      f->decimation = decimation;
+      f->hasAmplitude = displayAmplitude;
+      f->hasPhase = displayPhase;
+#ifdef CSI_CONTAINS_RSSI
+      f->hasRSSI = displayRSSI;
 #else
-      this->mw->getCT()->addData(fileBuf_CT_accum_LiveExport);
+      f->hasRSSI = false;
 #endif
+      f->RSSI = data_Display.RSSI;
+      if(displayAmplitude){
+        memcpy(f->amplitude, data_Display.amplitude, data_Display.nSubCarriers*sizeof(double));
+      }
+      if(displayPhase){
+        memcpy(f->phase, data_Display.phase, data_Display.nSubCarriers*sizeof(double));
+      }
+      this->mw->getDisplayQueue()->commitWrite();
     }
   }
+#endif
 
 
   //do the actual recodging
 
   if((recording)&&(wrPointerfileBuf_CT_accum_Recording > 0)){
-    if((!MACFilterRecording)||(isMACActive(MACStr))){
-
-      if(file->write(fileBuf_CT_accum_Recording, wrPointerfileBuf_CT_accum_Recording)<=0){
-        cout<<"Error writing file"<<endl;;
-        this->stopRecording();
-        return false;
-      }
+    if(!recWriter.write(data_Export.senderMAC, fileBuf_CT_accum_Recording, wrPointerfileBuf_CT_accum_Recording)){
+      cout<<"Error writing file"<<endl;;
+      this->stopRecording();
+      return false;
     }
     wrPointerfileBuf_CT_accum_Recording = 0;
   }
 
+  //waiting for the recording or the classifiers counts as busy, too
+  clock_gettime(CLOCK_MONOTONIC, &tEnd);
+  uint64_t start = tStart.tv_sec * 1000000000ULL + tStart.tv_nsec;
+  this->mw->getDisplayShedder()->addLoad(start, tEnd.tv_sec * 1000000000ULL + tEnd.tv_nsec - start);
+
   return true;
 }
 
@@ -699,6 +605,15 @@ void networkThread::startRecording(){
     cout<<"cannot start recording - no connection to CSI Server\n"<<endl;
     return;
   }
+  //The format is fixed for the entire recording, such that we don't need to query the GUI for every frame
+  CSIRecordFormat format = this->mw->getRecordFormat();
+  CSIDecisionLatency* latencies[CLASSIFIER_MAX_SINKS];
+  //the exported subcarriers are fixed for the entire recording, too. processData() takes over the same selection before the next frame.
+  CSISubcarrierMap map;
+  mapMutex.lock();
+  map = nextExportMap;
+  mapMutex.unlock();
+
   QString filename;
   if(mw->getUI()->rbFilenameStatic->isChecked()){
     filename = mw->getUI()->leStaticFilename->text();
@@ -708,56 +623,42 @@ void networkThread::startRecording(){
     filename.append(QDate::currentDate().toString("MMMM_d_yy"));
     filename.append("_");
     filename.append(QTime::currentTime().toString());
-    if(this->mw->getUI()->rbFileFormatBinary->isChecked()){
-      filename.append(".wbin");
-    }else{
-      filename.append(".csv");
+    filename.append(CSIRecordFormatExtension(format));
+  }
+
+  if(format == CSI_FORMAT_NPY){
+    if(!npyWriter.open(filename.toLocal8Bit().data(), map.n, (map.custom) ? map.index : NULL)){
+      cout<<"Could not create directory: "<<npyWriter.getError()<<endl;
+      return;
     }
+    cout<<"Recording to directory '"<<filename.toUtf8().data()<<"' in NumPy format"<<endl;
+    getLatencies(latencies);
+    mw->getResultLog()->open(filename, latencies, CLASSIFIER_MAX_SINKS);
+    recordFormat = format;
+    recording = true;
+    return;
   }
 
-  file = new QFile(filename);
-  char header[5000];
-  char tmp1[20], tmp2[20];
-  if(this->mw->getUI()->rbFileFormatCSVSimple->isChecked()){
-    strcpy(header,"timestamp;MAC;subcarrier;amplitude;phase;RSSI;frame_control\n");
+  bool split = mw->getUI()->cbSplitPerMAC->isChecked();
+  if(format == CSI_FORMAT_CSV_SIMPLE){
     cout<<"Recording to file '"<<filename.toUtf8().data()<<"' in simple CSV format"<<endl;
-  }else if(this->mw->getUI()->rbFileFormatCSVCompact->isChecked()){
-    strcpy(header,"timestamp;MAC;RSSI;frame_control");
-    for(uint16_t cnt = 0; cnt < CSIDataLenExport; cnt++){
-      sprintf(tmp1, ";a%u",cnt);
-      sprintf(tmp2, ";p%u",cnt);
-      strcat(header,tmp1);
-      strcat(header,tmp2);
-    }
-    sprintf(tmp1, "\n");
-    strcat(header,tmp1);
+  }else if(format == CSI_FORMAT_CSV_COMPACT){
     cout<<"Recording to file '"<<filename.toUtf8().data()<<"' in compact CSV format"<<endl;
   }else{
-    strcpy(header,"WifEyeBinary");
-    memcpy(header + 12, (char*) &CSIDataLenExport, sizeof(CSIDataLenExport));
     cout<<"Recording to file '"<<filename.toUtf8().data()<<"' in WifEyeBinary format"<<endl;
   }
-  if (!file->open(QIODevice::WriteOnly|QIODevice::Unbuffered)){
-    cout<<"Could not create file"<<endl;
-    file->close();
-    delete file;
-    return;
-  }
-
-
-  bool success;
-  if(this->mw->getUI()->rbFileFormatBinary->isChecked()){
-    success = (file->write(header, 12+sizeof(CSIDataLenExport)) > 0);
-  }else{
-    success = (file->write(header, strlen(header)) > 0);
+  if(split){
+    cout<<"One file per MAC address"<<endl;
   }
-  if(!success){
-    cout<<"Could not write to file"<<endl;
-    file->close();
-    delete file;
+  //the files are written asynchronously. With split == true, they are created when a MAC address appears for the first time.
+  if(!recWriter.open(filename.toLocal8Bit().data(), format, map.n, (map.custom) ? map.index : NULL, split)){
+    cout<<"Could not create file"<<endl;
     return;
   }
+  getLatencies(latencies);
+  mw->getResultLog()->open(filename, latencies, CLASSIFIER_MAX_SINKS);
 
+  recordFormat = format;
   recording = true;
 }
 
@@ -767,8 +668,16 @@ void networkThread::startRecording(){
 void networkThread::stopRecording(){
   if(recording){
     recording = false;
-    file->close();
-    delete file;
+    if(recordFormat == CSI_FORMAT_NPY){
+      if(!npyWriter.close()){
+        cout<<"Error finalizing recording: "<<npyWriter.getError()<<endl;
+      }
+    }else if(!recWriter.close()){
+      cout<<"Error writing file"<<endl;
+    }
+    CSIDecisionLatency* latencies[CLASSIFIER_MAX_SINKS];
+    getLatencies(latencies);
+    mw->getResultLog()->close(latencies, CLASSIFIER_MAX_SINKS);
     cout<<"Recording stopped."<<endl;
   }else{
     cout<<"Not recording."<<endl;
@@ -839,14 +748,18 @@ bool networkThread::isMACActive(QString MAC){
  * Notify the networkThread if the classifierThread (i.e., the thread reading the input from the classfier) is active.
  */
 void networkThread::setClassifierThreadActive(bool active){
-  classifierThreadActive = active;
+  //another classifier might still be running
+  classifierThreadActive = (active)||(this->mw->getNClassifiersRunning() > 0);
 }
 
 /**
  * Set the number of subcarriers in the input data.
  */
 void networkThread::setNCSISamples(uint32_t NCSISamples){
+  mapMutex.lock();
   CSIDataLen = NCSISamples;
+  updateMaps();
+  mapMutex.unlock();
   printf("Native CSI data length set to: %u\n",NCSISamples);
 }
 
@@ -855,7 +768,10 @@ void networkThread::setNCSISamples(uint32_t NCSISamples){
  */
 void networkThread::setNCSISamplesDisplay(uint32_t NCSISamples){
   printf("DisplayCSI data length set to: %u\n",NCSISamples);
+  mapMutex.lock();
   CSIDataLenDisplay = NCSISamples;
+  updateMaps();
+  mapMutex.unlock();
 }
 
 /**
@@ -863,7 +779,104 @@ void networkThread::setNCSISamplesDisplay(uint32_t NCSISamples){
  */
 void networkThread::setNCSISamplesExport(uint32_t NCSISamples){
   printf("Export CSI data length set to: %u\n",NCSISamples);
+  mapMutex.lock();
   CSIDataLenExport = NCSISamples;
+  updateMaps();
+  mapMutex.unlock();
+}
+
+/**
+ * Set the lists of displayed and exported subcarriers. Empty lists select them by the numbers of subcarriers.
+ */
+bool networkThread::setSubcarrierLists(const QString& display, const QString& exportList){
+  char err[CSI_SUBCARRIER_ERROR_STLEN];
+  CSISubcarrierMap map;
+  QByteArray displaySpec = display.trimmed().toLocal8Bit();
+  QByteArray exportSpec = exportList.trimmed().toLocal8Bit();
+  //the lists are checked against the largest frames here, and against the actual frames by updateMaps()
+  if((!displaySpec.isEmpty())&&(!CSIParseSubcarrierMap(displaySpec.constData(), CSI_MAX_SUBCARRIERS, &map, err))){
+    printf("Displayed subcarriers: %s\n", err);
+    return false;
+  }
+  if((!exportSpec.isEmpty())&&(!CSIParseSubcarrierMap(exportSpec.constData(), CSI_MAX_SUBCARRIERS, &map, err))){
+    printf("Exported subcarriers: %s\n", err);
+    return false;
+  }
+  mapMutex.lock();
+  displaySubcarriers = displaySpec;
+  exportSubcarriers = exportSpec;
+  updateMaps();
+  mapMutex.unlock();
+  return true;
+}
+
+/**
+ * Returns the number of displayed subcarriers
+ */
+uint32_t networkThread::getNDisplaySubcarriers(){
+  mapMutex.lock();
+  uint32_t n = nextDisplayMap.n;
+  mapMutex.unlock();
+  return n;
+}
+
+/**
+ * Get the latency histograms of all classifier sinks
+ */
+void networkThread::getLatencies(CSIDecisionLatency** latencies){
+  for(uint32_t i = 0; i < CLASSIFIER_MAX_SINKS; i++){
+    latencies[i] = mw->getCT(i)->getLatency();
+  }
+}
+
+/**
+ * Compute nextDisplayMap and nextExportMap. The mutex must be locked by the caller.
+ */
+void networkThread::updateMaps(){
+  char err[CSI_SUBCARRIER_ERROR_STLEN];
+  if((displaySubcarriers.isEmpty())||(!CSIParseSubcarrierMap(displaySubcarriers.constData(), CSIDataLen, &nextDisplayMap, err))){
+    if(!displaySubcarriers.isEmpty()){
+      printf("Displayed subcarriers: %s. Displaying %u subcarriers instead.\n", err, CSIDataLenDisplay);
+    }
+    CSIBandwidthMap(CSIDataLen, CSIDataLenDisplay, &nextDisplayMap);
+  }
+  if((exportSubcarriers.isEmpty())||(!CSIParseSubcarrierMap(exportSubcarriers.constData(), CSIDataLen, &nextExportMap, err))){
+    if(!exportSubcarriers.isEmpty()){
+      printf("Exported subcarriers: %s. Exporting %u subcarriers instead.\n", err, CSIDataLenExport);
+    }
+    CSIBandwidthMap(CSIDataLen, CSIDataLenExport, &nextExportMap);
+  }
+  __atomic_store_n(&mapsChanged, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take over the maps set by the GUI and compile the gather tables
+ */
+void networkThread::applyMaps(){
+  mapMutex.lock();
+  displayMap = nextDisplayMap;
+  exportMap = nextExportMap;
+  __atomic_store_n(&mapsChanged, false, __ATOMIC_RELEASE);
+  mapMutex.unlock();
+
+  //the union of both maps, sorted
+  uint32_t d = 0;
+  uint32_t e = 0;
+  convertMap.n = 0;
+  convertMap.custom = false;
+  while((d < displayMap.n)||(e < exportMap.n)){
+    if((e == exportMap.n)||((d < displayMap.n)&&(displayMap.index[d] < exportMap.index[e]))){
+      convertMap.index[convertMap.n++] = displayMap.index[d++];
+    }else if((d == displayMap.n)||(exportMap.index[e] < displayMap.index[d])){
+      convertMap.index[convertMap.n++] = exportMap.index[e++];
+    }else{
+      convertMap.index[convertMap.n++] = displayMap.index[d++];
+      e++;
+    }
+  }
+  CSICompileGather(&convertMap, &displayMap, &displayGather);
+  CSICompileGather(&convertMap, &exportMap, &exportGather);
+  mapEpoch++;
 }
 
 
@@ -17,7 +17,6 @@
 #define CSI_PORT 5501                           ///The port of the CSI Server from which we obtain the data
 #define HEADER_OFFSET 18                        ///18 bytes of a packet belong to the header
 #define RCV_BUF_LEN 4*256+HEADER_OFFSET+16      ///80 MHZ channel has 256 samples a 4 byte. Then we need HEADER_OFFSET for the header from nexmon and 16 bytes fo the timestamp. + 100 just for safety
-#define FILEBUF_LEN (10*1024)                   ///The length of the buffer to write data into a file. This should exceed the size of the CSI-rleated data belonging to one WiFi frame
 #define CSI_CONTAINS_RSSI true                  ///If the Nexmon has been additionally pateched (see README.md) to also provide RSSI, then set this to true.
 #define DATA_EXCHANGE_THROUGH_QT_SIGNALS false  ///If true, we don't directly call functions belonging to another thread but excessively use QT signals instead. No reason to do this in the current version of WirelessEye, since this will hamper the performance.
 #define DIFFERENT_MACS_IN_FILTER_FOR_DISPLAY_AND_LIVE_EXPORT true       ///Support different MACS in the filter plugins for live export and for displaying. This is realized by adding an additional byte to the MAC, which indicates
@@ -34,16 +33,15 @@
 #include <QFile>
 #include <sys/time.h>
 #include "CSIFilterManager.h"
+#include "CSIRecordFormat.h"
+#include "CSINpyWriter.h"
+#include "CSIRecordingWriter.h"
+#include "CSISubcarrierMap.h"
+#include "CSIDecisionLatency.h"
+#include <QMutex>
+#include <QByteArray>
 #include <QStringList>
 
-/**
- * Struct timespec has a platform-dependent length. We always use the 16-byte-version and hence define it explicitly here.
- */
-struct timespec_16bytes{
-  uint64_t tv_sec;
-  uint64_t tv_nsec;
-};
-
 class MainWindow;
 
 /**
@@ -60,7 +58,8 @@ class networkThread: public QObject{
   bool status;                                  ///true => we are connected to the Nexmon firmware. false otherwise.
   QTcpSocket* s;                                ///A socket for contacting the CSI server
   QUdpSocket* s_udp;                            ///A UDP socket for directly contacting the Nexmon firmware, if we directly run on a Raspi
-  QFile* file;                                  ///A file to record data to
+  CSIRecordingWriter recWriter;                 ///Writes recordings in the CSV and binary formats asynchronously
+  CSINpyWriter npyWriter;                       ///Writes recordings in the NumPy format
   uint32_t nBytesRead;                          ///Number of bytes read
   struct tm timeNowLocal;                       ///Timestamp on this machine
   struct timespec timeNow;                      ///A timestamp in the local struct timespec format
@@ -68,12 +67,25 @@ class networkThread: public QObject{
   QStringList MACFilterList;                    ///A list of allowed (e.g., non-filtered) MACs
   bool MACFilterRecording;                      ///Use MAC filtering for recodring files
   bool MACFilterLiveExport;                     ///Use MAC filtering for live export
-  bool classifierThreadActive;                  ///True, if the classifier is running. False, otherwise
+  bool classifierThreadActive;                  ///True, if any classifier is running. False, otherwise
   uint32_t CSIDataLen;                          ///Number of subcarriers in input data
   uint32_t CSIDataLenDisplay;                   ///Number of subcarriers in data for displaying
   uint32_t CSIDataLenExport;                    ///Number of subcarriers in data for export (recodring + liveExport)
+  QByteArray displaySubcarriers;                ///List of the displayed subcarriers. Empty => CSIDataLenDisplay applies
+  QByteArray exportSubcarriers;                 ///List of the exported subcarriers. Empty => CSIDataLenExport applies
+  CSISubcarrierMap nextDisplayMap;              ///Displayed subcarriers as set by the GUI, taken over by processData()
+  CSISubcarrierMap nextExportMap;               ///Exported subcarriers as set by the GUI, taken over by processData()
+  bool mapsChanged;                             ///true => nextDisplayMap or nextExportMap has not been taken over yet. Written under mapMutex, read atomically by processData()
+  QMutex mapMutex;                              ///Protects the fields above
+  CSISubcarrierMap displayMap;                  ///Subcarriers in data_Display
+  CSISubcarrierMap exportMap;                   ///Subcarriers in data_Export
+  CSISubcarrierMap convertMap;                  ///Subcarriers of either of them, i.e., the only ones converted into amplitude and phase
+  CSIGatherTable displayGather;                 ///Extracts data_Display from the converted subcarriers
+  CSIGatherTable exportGather;                  ///Extracts data_Export from the converted subcarriers
+  uint32_t mapEpoch;                            ///Incremented whenever exportMap changes, such that the classifiers compile their gather tables again
   CSIFilterManager* filterManager;              ///The filter manager controls all preprocessing plugins
   bool recording;                               ///True, if we are currently recording to a file-
+  CSIRecordFormat recordFormat;                 ///The format of the current recording. Set when the recording is started.
   bool displayAmplitude;                        ///True, if we are currently displaying the CSI amplitude
   bool displayPhase;                            ///True, if we are currently displaying the CSI phase
   bool displayRSSI;                             ///True, if we are currently displaying the RSSI
@@ -86,6 +98,21 @@ class networkThread: public QObject{
    */
   bool processData(char* buf, struct timespec timeNow);
 
+  /**
+   * Compute nextDisplayMap and nextExportMap from the subcarrier lists and numbers. The mutex must be locked by the caller.
+   */
+  void updateMaps();
+
+  /**
+   * Take over nextDisplayMap and nextExportMap and compile the gather tables. Called by processData() if the maps have changed.
+   */
+  void applyMaps();
+
+  /**
+   * Get the latency histograms of all classifier sinks for the result log. latencies needs to hold CLASSIFIER_MAX_SINKS pointers.
+   */
+  void getLatencies(CSIDecisionLatency** latencies);
+
   public:
   networkThread();
   ~networkThread();
@@ -129,13 +156,11 @@ class networkThread: public QObject{
   signals:
   void streamingStartedStopped(bool started);           ///Streaming has been started (started == true) or stopped (stared == false)
   void finished();                                      ///Streaming has ended
-  void addTimeToCDW();                                  ///Add one unit of time to the classifier display widget. One time unit is the reception of one single WiFi frame.
   void addDataToDisplayWidget(double);                  ///Send data of a single subcarrier to amplitude display widget. This mechanism is only used if DATA_EXCHANGE_THROUGH_QT_SIGNALS==true. Otherwise, a direct function call is used instead of a QT signal.
   void addDataToPhaseDisplayWidget(double);             ///Send data of a single subcarrier to phase display widget. This mechanism is only used if DATA_EXCHANGE_THROUGH_QT_SIGNALS==true. Otherwise, a direct function call is used instead of a QT signal. It's more performant to always send the data of an entire frame instead (see below).
   void addDataToRSSIDisplayWidget(double);              ///Send data of a single subcarrier  to display widget. This mechanism is only used if DATA_EXCHANGE_THROUGH_QT_SIGNALS==true. Otherwise, a direct function call is used instead of a QT signal. It's more performant to always send the data of an entire frame instead (see below).
   void addDataArrayToDisplayWidget(double*, int);       ///Send the data of an entire frame to amplitude display widget. This mechanism is only used if DATA_EXCHANGE_THROUGH_QT_SIGNALS==true. Otherwise, a direct function call is used instead of a QT signal. It's more performant to always send the data of an entire frame instead (see below).
   void addDataArrayToPhaseDisplayWidget(double*, int);  ///Send the data of an entire frame to phase display widget. This mechanism is only used if DATA_EXCHANGE_THROUGH_QT_SIGNALS==true. Otherwise, a direct function call is used instead of a QT signal. It's more performant to always send the data of an entire frame instead (see below).
-  void addDataToClassifierThread(const QString&);       ///Send data to the classifier thread. The string sent should be in "simple" .csv format.
   void addMAC(QString);                                 ///Add a certain MAC address to the list of known mMACS
 
   public slots:
@@ -205,6 +230,17 @@ class networkThread: public QObject{
    */
   void setNCSISamplesExport(uint32_t NCSISamples);
 
+  /**
+   * Set the lists of displayed and exported subcarriers (e.g., "4-31,33-60"), which are native indices into the received frames. They override the numbers of subcarriers
+   * to display and export. An empty list selects the subcarriers by these numbers again. Returns false and keeps the previous lists if a list is invalid.
+   */
+  bool setSubcarrierLists(const QString& display, const QString& exportList);
+
+  /**
+   * Returns the number of displayed subcarriers
+   */
+  uint32_t getNDisplaySubcarriers();
+
   /**
    * Notfiy the network thread that amplitude displaying has been activated. If active==true, then data will be streamed to the amplitude display widget.
    */
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# classifierQueueTest - checks the queue of classifierWrThread while the classifier stalls
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = classifierQueueTest
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+        main.cpp \
+        ../../src/classifierWrThread.cpp
+
+HEADERS += \
+        ../../src/classifierWrThread.h
@@ -0,0 +1,206 @@
+/*
+ * main.cpp
+ * Checks that the queue of classifierWrThread drops exactly as many messages as needed while the classifier stalls, and keeps the order of the others.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "classifierWrThread.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#define MSG_LEN 16                              ///Bytes per message
+#define N_MSGS 100                              ///Messages that fill the queue
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  if(!ok){
+    failures++;
+  }
+}
+
+static void makeMsg(char* buf, uint32_t i){
+  snprintf(buf, MSG_LEN + 1, "message %07u\n", i);
+}
+
+/**
+ * Wait until the writer thread has taken all messages out of the queue. Returns false on timeout.
+ */
+static bool waitEmpty(classifierWrThread* wrt){
+  for(int i = 0; i < 5000; i++){
+    if(wrt->getStats().msgsQueued == 0){
+      return true;
+    }
+    usleep(1000);
+  }
+  return false;
+}
+
+/**
+ * Read exactly len bytes from fd
+ */
+static bool readAll(int fd, char* buf, size_t len){
+  size_t got = 0;
+  while(got < len){
+    ssize_t n = read(fd, buf + got, len - got);
+    if(n < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      return false;
+    }
+    if(n == 0){
+      return false;
+    }
+    got += n;
+  }
+  return true;
+}
+
+/**
+ * Expected order after N_MSGS + 2 messages, one of them dropped: #0 was being written, #1 is the oldest queued message and is dropped
+ */
+static bool checkOrder(const char* data, uint32_t nMsgs){
+  char expected[MSG_LEN + 1];
+  for(uint32_t i = 0; i < nMsgs; i++){
+    makeMsg(expected, (i == 0) ? 0 : i + 1);
+    if(memcmp(data + i * MSG_LEN, expected, MSG_LEN) != 0){
+      printf("message %u: expected %.*s, got %.*s\n", i, MSG_LEN - 1, expected, MSG_LEN - 1, data + i * MSG_LEN);
+      return false;
+    }
+  }
+  return true;
+}
+
+static void testPipe(){
+  printf("pipe, classifier stalls in write()\n");
+  int fds[2];
+  if(pipe(fds) != 0){
+    check(false, "create pipe");
+    return;
+  }
+  //fill the pipe, such that the next write blocks
+  fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+  char filler[4096];
+  memset(filler, 'x', sizeof(filler));
+  size_t nFiller = 0;
+  while(1){
+    ssize_t n = write(fds[1], filler, 1);
+    if(n <= 0){
+      break;
+    }
+    nFiller += n;
+  }
+  fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) & ~O_NONBLOCK);
+
+  classifierWrThread* wrt = new classifierWrThread();
+  wrt->setQueue(N_MSGS * MSG_LEN, CLASSIFIER_DROP_OLDEST);
+  wrt->setFD(fds[1]);
+  wrt->start();
+
+  char msg[MSG_LEN + 1];
+  makeMsg(msg, 0);
+  wrt->addData(msg, MSG_LEN);
+  check(waitEmpty(wrt), "the writer takes the first message and blocks");
+
+  for(uint32_t i = 1; i <= N_MSGS + 1; i++){
+    makeMsg(msg, i);
+    wrt->addData(msg, MSG_LEN);
+  }
+  classifierQueueStats s = wrt->getStats();
+  check(s.msgsDropped == 1, "exactly one message is dropped");
+  check(s.msgsQueued == N_MSGS, "the queue is full");
+
+  //let the classifier catch up
+  char* data = new char[nFiller + (N_MSGS + 1) * MSG_LEN];
+  bool ok = readAll(fds[0], data, nFiller + (N_MSGS + 1) * MSG_LEN);
+  check(ok, "all messages not dropped are written");
+  if(ok){
+    check(checkOrder(data + nFiller, N_MSGS + 1), "the messages are written in order");
+  }
+  delete[] data;
+
+  wrt->stop(false);
+  wrt->wait();
+  delete wrt;
+  close(fds[0]);
+  close(fds[1]);
+}
+
+static int blockFds[2];                         ///The consumer blocks until a byte can be read from blockFds[0]
+static char consumed[(N_MSGS + 1) * MSG_LEN];   ///Messages received by the consumer
+static uint32_t nConsumed = 0;                  ///Number of bytes in consumed
+
+static void blockingConsumer(void* context, const char* msg, uint32_t len){
+  (void) context;
+  char c;
+  if(read(blockFds[0], &c, 1) != 1){
+    return;
+  }
+  if(nConsumed + len <= sizeof(consumed)){
+    memcpy(consumed + nConsumed, msg, len);
+    nConsumed += len;
+  }
+}
+
+static void testConsumer(){
+  printf("consumer, classifier stalls in the consumer\n");
+  if(pipe(blockFds) != 0){
+    check(false, "create pipe");
+    return;
+  }
+  classifierWrThread* wrt = new classifierWrThread();
+  wrt->setQueue(N_MSGS * MSG_LEN, CLASSIFIER_DROP_OLDEST);
+  wrt->setConsumer(blockingConsumer, NULL);
+  wrt->start();
+
+  char msg[MSG_LEN + 1];
+  makeMsg(msg, 0);
+  wrt->addData(msg, MSG_LEN);
+  check(waitEmpty(wrt), "the consumer takes the first message and blocks");
+
+  for(uint32_t i = 1; i <= N_MSGS + 1; i++){
+    makeMsg(msg, i);
+    wrt->addData(msg, MSG_LEN);
+  }
+  classifierQueueStats s = wrt->getStats();
+  check(s.msgsDropped == 1, "exactly one message is dropped");
+  check(s.msgsQueued == N_MSGS, "the queue is full");
+
+  //let the classifier catch up
+  char go[N_MSGS + 1];
+  memset(go, 'g', sizeof(go));
+  check(write(blockFds[1], go, sizeof(go)) == (ssize_t) sizeof(go), "unblock the consumer");
+  check(waitEmpty(wrt), "all messages not dropped are consumed");
+  wrt->stop(false);
+  wrt->wait();
+  check(nConsumed == (N_MSGS + 1) * MSG_LEN, "the consumer has received every message not dropped");
+  if(nConsumed == (N_MSGS + 1) * MSG_LEN){
+    check(checkOrder(consumed, N_MSGS + 1), "the messages are consumed in order");
+  }
+  delete wrt;
+  close(blockFds[0]);
+  close(blockFds[1]);
+}
+
+int main(){
+  testPipe();
+  testConsumer();
+  if(failures > 0){
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
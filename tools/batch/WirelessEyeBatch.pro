@@ -0,0 +1,36 @@
+#-------------------------------------------------
+#
+# WirelessEyeBatch - offline conversion and filtering of recordings
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = WirelessEyeBatch
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+LIBS += -ldl
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../../studio/src ../wbinReader
+
+SOURCES += \
+        main.cpp \
+        recordingReader.cpp \
+        batchWorker.cpp \
+        ../../studio/src/CSIFilterManager.cpp \
+        ../../studio/src/CSIFilterObj.cpp \
+        ../../studio/src/CSIRecordFormat.cpp \
+        ../../studio/src/CSINpyWriter.cpp \
+        ../wbinReader/wbinReader.cpp
+
+HEADERS += \
+        recordingReader.h \
+        batchWorker.h \
+        ../../studio/src/CSIFilterManager.h \
+        ../../studio/src/CSIFilterObj.h \
+        ../../studio/src/CSIRecordFormat.h \
+        ../../studio/src/CSINpyWriter.h \
+        ../wbinReader/wbinReader.h
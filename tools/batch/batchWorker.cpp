@@ -0,0 +1,149 @@
+/*
+ * batchWorker.cpp
+ * Processing of a single block of a recording by one worker process of WirelessEyeBatch.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "batchWorker.h"
+#include "recordingReader.h"
+#include "CSINpyWriter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+/**
+ * Write len bytes from buf to fd, handling partial writes. Returns false on failure.
+ */
+static bool writeAll(int fd, const char* buf, size_t len){
+  ssize_t n;
+  while(len > 0){
+    n = write(fd, buf, len);
+    if(n < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+bool batchProcessJob(const char* inFile, const batchJob* job, CSIFilterManager* filterManager, CSIRecordFormat outFormat, batchStatistics* stats){
+  static CSIData data;
+  char timestamp[CSI_TIMESTAMP_STLEN];
+  char MACBuf[CSI_MAC_STLEN];
+  struct timespec_16bytes t;
+  struct timespec t0, t1;
+  recordingReader reader;
+  uint32_t len;
+  size_t outLen = 0;
+  bool success = true;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  stats->nFrames = 0;
+  stats->bytesOut = 0;
+  stats->status = 1;
+
+  if(!reader.open(inFile)){
+    printf("Error: %s\n", reader.getError());
+    return false;
+  }
+  //pass the frames before the block through the filters to build up their state. They are written by the previous job.
+  if((filterManager != NULL)&&(job->warmup < job->begin)){
+    reader.setRange(job->warmup, job->begin);
+    while(reader.readFrame(&data, &t)){
+      filterManager->applyFilterPipeline(&data);
+    }
+  }
+  reader.setRange(job->begin, job->end);
+
+  //NumPy arrays are written by CSINpyWriter into one directory per job
+  if(outFormat == CSI_FORMAT_NPY){
+    CSINpyWriter writer;
+    if(!writer.open(job->partName, reader.getNSubCarriers(), reader.getSubCarriers())){
+      printf("Error: %s\n", writer.getError());
+      return false;
+    }
+    while(reader.readFrame(&data, &t)){
+      if(filterManager != NULL){
+        filterManager->applyFilterPipeline(&data);
+      }
+      if(!writer.writeFrame(&data, &t)){
+        printf("Error: %s\n", writer.getError());
+        success = false;
+        break;
+      }
+      stats->nFrames++;
+      stats->bytesOut += 14 + 8*reader.getNSubCarriers();
+    }
+    success = writer.close() && success;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    stats->seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    stats->status = success ? 0 : 1;
+    return success;
+  }
+
+  int fd = open(job->partName, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  if(fd < 0){
+    printf("Error: cannot create '%s': %s\n", job->partName, strerror(errno));
+    return false;
+  }
+  char* outBuf = (char*) malloc(BATCH_OUTBUF_LEN);
+
+  while(reader.readFrame(&data, &t)){
+    if(filterManager != NULL){
+      filterManager->applyFilterPipeline(&data);
+    }
+    if(outFormat != CSI_FORMAT_BINARY){
+      CSIFormatTimestamp(&t, timestamp);
+      CSIFormatMAC(data.senderMAC, MACBuf);
+    }
+    //encode directly into the output buffer. It is flushed whenever the space left might not suffice for one frame.
+    if(BATCH_OUTBUF_LEN - outLen < BATCH_FRAMEBUF_LEN){
+      if(!writeAll(fd, outBuf, outLen)){
+        success = false;
+        break;
+      }
+      stats->bytesOut += outLen;
+      outLen = 0;
+    }
+    len = CSIEncodeFrame(outFormat, &data, &t, timestamp, MACBuf, reader.getSubCarriers(), outBuf + outLen, BATCH_OUTBUF_LEN - outLen);
+    if(len == 0){
+      printf("Error: encoded frame exceeds %u bytes\n", BATCH_OUTBUF_LEN - (uint32_t) outLen);
+      success = false;
+      break;
+    }
+    outLen += len;
+    stats->nFrames++;
+  }
+  if((success)&&(outLen > 0)){
+    success = writeAll(fd, outBuf, outLen);
+    stats->bytesOut += outLen;
+  }
+  if(!success){
+    printf("Error writing '%s': %s\n", job->partName, strerror(errno));
+  }
+  free(outBuf);
+  if(close(fd) != 0){
+    success = false;
+  }
+  reader.close();
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  stats->seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  stats->status = success ? 0 : 1;
+  return success;
+}
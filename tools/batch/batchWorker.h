@@ -0,0 +1,56 @@
+/*
+ * batchWorker.h
+ * Processing of a single block of a recording by one worker process of WirelessEyeBatch.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCHWORKER_H_
+#define BATCHWORKER_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "CSIRecordFormat.h"
+#include "CSIFilterManager.h"
+
+#define BATCH_OUTBUF_LEN (4*1024*1024)          ///Output is collected in a buffer of this size before it is written
+#define BATCH_FRAMEBUF_LEN (128*1024)           ///Space reserved for one encoded frame. The simple CSV format of 512 subcarriers needs the most space.
+#define BATCH_DEFAULT_WARMUP 1000               ///Default number of frames before a block that are passed through stateful filters, but not written
+
+/**
+ * Results of one job. The array of all statistics is shared between the worker processes and the main process.
+ */
+struct batchStatistics{
+  uint64_t nFrames;                             ///Number of frames processed
+  uint64_t bytesOut;                            ///Number of bytes written
+  double seconds;                               ///Processing time of the job
+  int32_t status;                               ///0 => success
+};
+
+/**
+ * A unit of work: one block of one file.
+ */
+struct batchJob{
+  uint32_t fileIdx;                             ///Index of the input file
+  size_t warmup;                                ///First byte of the frames before the block that are filtered, but not written. = begin => no warm-up
+  size_t begin;                                 ///First byte of the block in the input file
+  size_t end;                                   ///Byte behind the block
+  char partName[1024];                          ///Temporary file the result is written to
+};
+
+/**
+ * Read all frames of job from inFile, apply the filter pipeline (if filterManager != NULL), and write them in outFormat
+ * to job->partName. The frames from job->warmup to job->begin are passed through the filters beforehand, such that filters
+ * that keep state per MAC address start the block as if the file was processed from the beginning. No file header is written, such that the parts of a file can be concatenated.
+ * For CSI_FORMAT_NPY, job->partName is a directory that needs to be merged using CSINpyWriter::merge().
+ * Returns false on failure.
+ */
+bool batchProcessJob(const char* inFile, const batchJob* job, CSIFilterManager* filterManager, CSIRecordFormat outFormat, batchStatistics* stats);
+
+#endif /* BATCHWORKER_H_ */
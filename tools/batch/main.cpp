@@ -0,0 +1,383 @@
+/*
+ * main.cpp
+ * WirelessEyeBatch - converts and re-filters recordings of WirelessEye Studio offline, using all CPU cores.
+ *
+ * Usage: WirelessEyeBatch [-j jobs] [-F simple|compact|binary|npy] [-o outDir] [-p filterDir] [-c pipeline.conf] [-s] [-w frames] file1 [file2 ...]
+ *
+ * The input files are split into jobs that are executed by up to <jobs> worker processes. We use processes and not threads,
+ * since the filter plugins keep their state in global variables. Each worker hence gets its own copy of the filter pipeline.
+ * If there are fewer files than jobs, each file is split into contiguous blocks of frames. The output keeps the original order of frames.
+ * Filters that treat the data of each MAC address as a time series need the frames before a block. Hence, unless the filters are
+ * stateless (-s, or no filters), each worker first passes the last <frames> frames before its block through the filters without writing them.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "CSIFilterManager.h"
+#include "CSIRecordFormat.h"
+#include "CSINpyWriter.h"
+#include "recordingReader.h"
+#include "batchWorker.h"
+
+#define MAX_FILES 4096                          ///Maximum number of input files
+#define COPYBUF_LEN (1024*1024)                 ///Buffer size for concatenating the parts of a file
+
+/**
+ * Per-file bookkeeping of the main process
+ */
+struct batchFile{
+  const char* inName;                           ///Input file
+  char outName[1024];                           ///Output file
+  CSIRecordFormat format;                       ///Output format
+  uint32_t nSubCarriers;                        ///Number of subcarriers
+  uint16_t subCarriers[WBIN_MAX_SUBCARRIERS];   ///Native index of each subcarrier
+  bool hasIndices;                              ///True, if the input file contains the indices, which are then written to the output file, too
+  size_t size;                                  ///Size of the input file
+  uint32_t firstJob;                            ///Index of the first job of this file
+  uint32_t nJobs;                               ///Number of jobs of this file
+  uint32_t nJobsLeft;                           ///Number of jobs not yet finished
+  double tStart;                                ///Time the first job was started
+};
+
+/**
+ * Monotonic time in seconds
+ */
+static double now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void printUsage(const char* name){
+  printf("Usage: %s [-j jobs] [-F simple|compact|binary|npy] [-o outDir] [-p filterDir] [-c pipeline.conf] [-s] [-w frames] file1 [file2 ...]\n", name);
+  printf(" -j: number of worker processes (default: number of CPU cores)\n");
+  printf(" -F: output format (default: format of the input file). npy creates a directory of NumPy arrays per MAC address.\n");
+  printf(" -o: output directory (default: directory of the input file). Output files are named <input>_batch.<ext>\n");
+  printf(" -p: directory containing the filter plugins (.cfi). Without -p, the data is only converted.\n");
+  printf(" -c: filter pipeline as saved by WirelessEye Studio (Main -> Save Filter Pipeline). Without -c, the default filters are used.\n");
+  printf(" -s: the filters are stateless - no warm-up is needed when a file is split into blocks. This is the default without -p.\n");
+  printf(" -w: number of frames before each block that are passed through the filters to build up their state, but not written (default: %u)\n", BATCH_DEFAULT_WARMUP);
+}
+
+/**
+ * Remove the parts written by the workers for file
+ */
+static void removeParts(batchFile* file, batchJob* jobs){
+  for(uint32_t i = file->firstJob; i < file->firstJob + file->nJobs; i++){
+    if(file->format == CSI_FORMAT_NPY){
+      CSINpyWriter::remove(jobs[i].partName);
+    }else{
+      unlink(jobs[i].partName);
+    }
+  }
+}
+
+/**
+ * Create the output file from the file header and the parts written by the workers, and remove the parts.
+ */
+static bool finalizeFile(batchFile* file, batchJob* jobs){
+  static char header[CSI_HEADER_LEN];
+  char* buf;
+  ssize_t n;
+  bool success = true;
+
+  if(file->format == CSI_FORMAT_NPY){
+    const char** partDirs = new const char*[file->nJobs];
+    for(uint32_t i = 0; i < file->nJobs; i++){
+      partDirs[i] = jobs[file->firstJob + i].partName;
+    }
+    success = CSINpyWriter::merge(file->outName, partDirs, file->nJobs);
+    delete[] partDirs;
+    removeParts(file, jobs);
+    if(!success){
+      printf("Error writing '%s'\n", file->outName);
+    }
+    return success;
+  }
+
+  int out = open(file->outName, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  if(out < 0){
+    printf("Error: cannot create '%s': %s\n", file->outName, strerror(errno));
+    return false;
+  }
+  uint32_t headerLen = CSIEncodeHeader(file->format, file->nSubCarriers, (file->hasIndices) ? file->subCarriers : NULL, header, CSI_HEADER_LEN);
+  if((headerLen == 0)||(write(out, header, headerLen) != (ssize_t) headerLen)){
+    success = false;
+  }
+  buf = (char*) malloc(COPYBUF_LEN);
+  for(uint32_t i = file->firstJob; (success)&&(i < file->firstJob + file->nJobs); i++){
+    int in = open(jobs[i].partName, O_RDONLY);
+    if(in < 0){
+      success = false;
+      break;
+    }
+    while((n = read(in, buf, COPYBUF_LEN)) > 0){
+      if(write(out, buf, n) != n){
+        success = false;
+        break;
+      }
+    }
+    close(in);
+  }
+  free(buf);
+  removeParts(file, jobs);
+  if(close(out) != 0){
+    success = false;
+  }
+  if(!success){
+    printf("Error writing '%s'\n", file->outName);
+  }
+  return success;
+}
+
+int main(int argc, char* argv[]){
+  uint32_t maxJobs = sysconf(_SC_NPROCESSORS_ONLN);
+  bool stateless = false;
+  uint32_t warmupFrames = BATCH_DEFAULT_WARMUP;
+  bool formatGiven = false;
+  CSIRecordFormat outFormat = CSI_FORMAT_CSV_SIMPLE;
+  const char* outDir = NULL;
+  const char* filterDir = NULL;
+  const char* pipelineFile = NULL;
+  CSIFilterManager* filterManager = NULL;
+  int opt;
+
+  //numbers are always written and parsed with '.' as decimal separator
+  setlocale(LC_NUMERIC, "C");
+
+  while((opt = getopt(argc, argv, "j:F:o:p:c:sw:h")) != -1){
+    switch(opt){
+      case 'j':
+        maxJobs = strtoul(optarg, NULL, 10);
+        break;
+      case 'F':
+        formatGiven = true;
+        if(strcmp(optarg, "simple") == 0){
+          outFormat = CSI_FORMAT_CSV_SIMPLE;
+        }else if(strcmp(optarg, "compact") == 0){
+          outFormat = CSI_FORMAT_CSV_COMPACT;
+        }else if(strcmp(optarg, "binary") == 0){
+          outFormat = CSI_FORMAT_BINARY;
+        }else if(strcmp(optarg, "npy") == 0){
+          outFormat = CSI_FORMAT_NPY;
+        }else{
+          printf("Unknown format '%s'\n", optarg);
+          return 1;
+        }
+        break;
+      case 'o':
+        outDir = optarg;
+        break;
+      case 'p':
+        filterDir = optarg;
+        break;
+      case 'c':
+        pipelineFile = optarg;
+        break;
+      case 's':
+        stateless = true;
+        break;
+      case 'w':
+        warmupFrames = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        printUsage(argv[0]);
+        return 1;
+    }
+  }
+  if(maxJobs == 0){
+    maxJobs = 1;
+  }
+  uint32_t nFiles = argc - optind;
+  if((nFiles == 0)||(nFiles > MAX_FILES)){
+    printUsage(argv[0]);
+    return 1;
+  }
+  if((pipelineFile != NULL)&&(filterDir == NULL)){
+    printf("-c requires -p\n");
+    return 1;
+  }
+  //without filters, no state is kept between frames
+  if(filterDir == NULL){
+    stateless = true;
+  }
+
+  //Load the filter pipeline. It is inherited by all worker processes.
+  if(filterDir != NULL){
+    filterManager = new CSIFilterManager();
+    filterManager->loadFilterList(filterDir);
+    if(pipelineFile != NULL){
+      if(!filterManager->loadPipelineConfiguration(pipelineFile)){
+        return 1;
+      }
+    }else{
+      filterManager->activateDefaultFilters();
+    }
+  }
+
+  //Split each file into jobs. If there are fewer files than workers, the files are split into several jobs each.
+  uint32_t jobsPerFile = (nFiles < maxJobs) ? (maxJobs + nFiles - 1) / nFiles : 1;
+  batchFile* files = new batchFile[nFiles];
+  batchJob* jobs = new batchJob[nFiles * jobsPerFile];
+  size_t* bounds = new size_t[jobsPerFile + 1];
+  uint32_t nJobs = 0;
+  recordingReader reader;
+
+  for(uint32_t f = 0; f < nFiles; f++){
+    batchFile* file = &files[f];
+    file->inName = argv[optind + f];
+    if(!reader.open(file->inName)){
+      printf("Error: %s\n", reader.getError());
+      return 1;
+    }
+    file->format = formatGiven ? outFormat : reader.getFormat();
+    file->nSubCarriers = reader.getNSubCarriers();
+    file->hasIndices = reader.getSubCarriers() != NULL;
+    if(file->hasIndices){
+      memcpy(file->subCarriers, reader.getSubCarriers(), file->nSubCarriers * sizeof(uint16_t));
+    }
+    file->size = reader.getFileSize();
+    file->firstJob = nJobs;
+
+    //output name: <outDir>/<name without extension>_batch.<ext>
+    const char* baseName = strrchr(file->inName, '/');
+    baseName = (baseName == NULL) ? file->inName : baseName + 1;
+    uint32_t baseLen = strlen(baseName);
+    const char* ext = strrchr(baseName, '.');
+    if(ext != NULL){
+      baseLen = ext - baseName;
+    }
+    if(outDir != NULL){
+      snprintf(file->outName, sizeof(file->outName), "%s/%.*s_batch%s", outDir, baseLen, baseName, CSIRecordFormatExtension(file->format));
+    }else{
+      snprintf(file->outName, sizeof(file->outName), "%.*s%.*s_batch%s", (int)(baseName - file->inName), file->inName, baseLen, baseName, CSIRecordFormatExtension(file->format));
+    }
+
+    reader.getBlocks(jobsPerFile, bounds);
+    for(uint32_t i = 0; i < jobsPerFile; i++){
+      batchJob* job = &jobs[nJobs];
+      job->fileIdx = f;
+      job->warmup = stateless ? bounds[i] : reader.getWarmupStart(bounds[i], warmupFrames);
+      job->begin = bounds[i];
+      job->end = bounds[i+1];
+      snprintf(job->partName, sizeof(job->partName), "%s.part%u", file->outName, i);
+      nJobs++;
+    }
+    file->nJobs = jobsPerFile;
+    file->nJobsLeft = jobsPerFile;
+    reader.close();
+  }
+  delete[] bounds;
+
+  //Statistics are written by the workers and read by the main process
+  batchStatistics* stats = (batchStatistics*) mmap(NULL, nJobs*sizeof(batchStatistics), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+  if(stats == MAP_FAILED){
+    perror("mmap");
+    return 1;
+  }
+  memset(stats, 0, nJobs*sizeof(batchStatistics));
+  pid_t* pids = new pid_t[nJobs];
+
+  if((stateless)||(jobsPerFile == 1)){
+    printf("Processing %u file(s) in %u job(s) using up to %u worker process(es)\n", nFiles, nJobs, maxJobs);
+  }else{
+    printf("Processing %u file(s) in %u job(s) using up to %u worker process(es), %u frames of warm-up per block\n", nFiles, nJobs, maxJobs, warmupFrames);
+  }
+  fflush(stdout);
+
+  double tStart = now();
+  uint64_t totalBytes = 0, totalFrames = 0;
+  uint32_t next = 0, running = 0;
+  bool success = true;
+  int status;
+  pid_t pid;
+
+  while((next < nJobs)||(running > 0)){
+    //start as many workers as allowed
+    while((next < nJobs)&&(running < maxJobs)){
+      batchJob* job = &jobs[next];
+      batchFile* file = &files[job->fileIdx];
+      if(next == file->firstJob){
+        file->tStart = now();
+      }
+      pid = fork();
+      if(pid < 0){
+        perror("fork");
+        return 1;
+      }
+      if(pid == 0){
+        bool ok = batchProcessJob(file->inName, job, filterManager, file->format, &stats[next]);
+        fflush(stdout);
+        _exit(ok ? 0 : 1);            //don't run destructors - the filters belong to the main process
+      }
+      pids[next] = pid;
+      next++;
+      running++;
+    }
+
+    //wait for a worker to finish
+    pid = wait(&status);
+    if(pid < 0){
+      perror("wait");
+      return 1;
+    }
+    running--;
+    for(uint32_t i = 0; i < next; i++){
+      if(pids[i] != pid){
+        continue;
+      }
+      if((!WIFEXITED(status))||(WEXITSTATUS(status) != 0)){
+        stats[i].status = 1;
+      }
+      batchFile* file = &files[jobs[i].fileIdx];
+      file->nJobsLeft--;
+      if(file->nJobsLeft == 0){
+        uint64_t nFrames = 0;
+        bool fileOk = true;
+        for(uint32_t j = file->firstJob; j < file->firstJob + file->nJobs; j++){
+          nFrames += stats[j].nFrames;
+          fileOk = fileOk && (stats[j].status == 0);
+        }
+        if((fileOk)&&(finalizeFile(file, jobs))){
+          double t = now() - file->tStart;
+          printf("%s -> %s: %" PRIu64 " frames, %.1f MB/s, %.0f frames/s\n", file->inName, file->outName, nFrames, file->size / t / 1e6, nFrames / t);
+          totalBytes += file->size;
+          totalFrames += nFrames;
+        }else{
+          if(!fileOk){
+            removeParts(file, jobs);
+          }
+          printf("%s: FAILED\n", file->inName);
+          success = false;
+        }
+        fflush(stdout);
+      }
+    }
+  }
+
+  double t = now() - tStart;
+  printf("Total: %" PRIu64 " frames, %.1f MB in %.2f s: %.1f MB/s, %.0f frames/s\n", totalFrames, totalBytes / 1e6, t, totalBytes / t / 1e6, totalFrames / t);
+
+  munmap(stats, nJobs*sizeof(batchStatistics));
+  delete[] pids;
+  delete[] jobs;
+  delete[] files;
+  delete filterManager;
+  return success ? 0 : 1;
+}
@@ -0,0 +1,465 @@
+/*
+ * recordingReader.cpp
+ * Reads recordings of WirelessEye Studio in all formats (simple CSV, compact CSV and WifEyeBinary) frame by frame.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "recordingReader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define HEADER_SIMPLE "timestamp;MAC;subcarrier;"
+#define HEADER_COMPACT "timestamp;MAC;RSSI;frame_control"
+
+/**
+ * Copy the field starting at s into buf and convert it to a double. Fields end at ';', at a line break or at end.
+ * WirelessEye Studio writes numbers using the locale of the machine it runs on, hence we also accept ',' as decimal separator.
+ * On success, s points behind the field (and its separator) and true is returned.
+ */
+static bool parseDouble(const char** s, const char* end, double* value){
+  char buf[RECORDING_FIELD_STLEN];
+  uint32_t len = 0;
+  const char* p = *s;
+  char* endPtr;
+  while((p < end)&&(*p != ';')&&(*p != '\n')&&(*p != '\r')){
+    if(len >= RECORDING_FIELD_STLEN - 1){
+      return false;
+    }
+    buf[len++] = (*p == ',') ? '.' : *p;
+    p++;
+  }
+  if(len == 0){
+    return false;
+  }
+  buf[len] = '\0';
+  *value = strtod(buf, &endPtr);
+  if(*endPtr != '\0'){
+    return false;
+  }
+  if((p < end)&&(*p == ';')){
+    p++;
+  }
+  *s = p;
+  return true;
+}
+
+/**
+ * Same as parseDouble() for unsigned integers
+ */
+static bool parseUInt(const char** s, const char* end, uint32_t* value){
+  uint32_t v = 0;
+  const char* p = *s;
+  if((p >= end)||(*p < '0')||(*p > '9')){
+    return false;
+  }
+  while((p < end)&&(*p >= '0')&&(*p <= '9')){
+    v = 10*v + (*p - '0');
+    p++;
+  }
+  if((p < end)&&(*p == ';')){
+    p++;
+  }
+  *value = v;
+  *s = p;
+  return true;
+}
+
+recordingReader::recordingReader(){
+  fd = -1;
+  map = NULL;
+  mapLen = 0;
+  format = CSI_FORMAT_CSV_SIMPLE;
+  nSubCarriers = 0;
+  hasIndices = false;
+  dataOffset = 0;
+  dataEnd = 0;
+  pos = 0;
+  limit = 0;
+  strcpy(errorMsg, "");
+}
+
+recordingReader::~recordingReader(){
+  close();
+}
+
+void recordingReader::setError(const char* fmt, ...){
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(errorMsg, RECORDING_ERROR_STLEN, fmt, args);
+  va_end(args);
+}
+
+bool recordingReader::open(const char* fileName){
+  struct stat st;
+
+  close();
+  fd = ::open(fileName, O_RDONLY);
+  if(fd < 0){
+    setError("cannot open '%s': %s", fileName, strerror(errno));
+    return false;
+  }
+  if((fstat(fd, &st) != 0)||(st.st_size == 0)){
+    setError("'%s' is empty or cannot be accessed", fileName);
+    close();
+    return false;
+  }
+  mapLen = st.st_size;
+  map = (const char*) mmap(NULL, mapLen, PROT_READ, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED){
+    map = NULL;
+    setError("cannot map '%s': %s", fileName, strerror(errno));
+    close();
+    return false;
+  }
+
+  //binary format -> handled by wbinReader
+  if((mapLen >= WBIN_MAGIC_LEN)&&(memcmp(map, WBIN_MAGIC, WBIN_MAGIC_LEN) == 0)){
+    close();
+    if(!wbin.open(fileName)){
+      setError("%s", wbin.getError());
+      return false;
+    }
+    if(wbin.isTruncated()){
+      printf("Warning: the last frame of '%s' is incomplete and will be ignored\n", fileName);
+    }
+    wbin.adviseSequential();
+    format = CSI_FORMAT_BINARY;
+    nSubCarriers = wbin.getNSubCarriers();
+    hasIndices = wbin.getSubCarriers() != NULL;
+    for(uint32_t i = 0; i < nSubCarriers; i++){
+      subCarriers[i] = (hasIndices) ? wbin.getSubCarriers()[i] : i;
+    }
+    mapLen = wbin.getFileSize();
+    dataOffset = wbin.getHeaderLen();
+    dataEnd = dataOffset + wbin.getNFrames()*wbin.getFrameSize();
+    setRange(dataOffset, dataEnd);
+    return true;
+  }
+
+  madvise((void*) map, mapLen, MADV_SEQUENTIAL);
+  dataOffset = nextLine(0);
+  dataEnd = mapLen;
+  if((dataOffset > strlen(HEADER_SIMPLE))&&(memcmp(map, HEADER_SIMPLE, strlen(HEADER_SIMPLE)) == 0)){
+    //simple CSV: the subcarriers are given by the lines of the first frame
+    format = CSI_FORMAT_CSV_SIMPLE;
+    size_t p = dataOffset;
+    uint32_t sc;
+    nSubCarriers = 0;
+    if(parseSubCarrier(p, &sc)){
+      subCarriers[0] = sc;
+      size_t end = skipFrame(dataOffset);
+      while((p < end)&&(nSubCarriers < WBIN_MAX_SUBCARRIERS)&&(parseSubCarrier(p, &sc))){
+        subCarriers[nSubCarriers++] = sc;
+        p = nextLine(p);
+      }
+    }
+  }else if((dataOffset > strlen(HEADER_COMPACT))&&(memcmp(map, HEADER_COMPACT, strlen(HEADER_COMPACT)) == 0)){
+    //compact CSV: the header contains one ";aX;pX" pair per subcarrier, X being its index
+    format = CSI_FORMAT_CSV_COMPACT;
+    nSubCarriers = 0;
+    for(size_t p = 0; p + 1 < dataOffset; p++){
+      if((map[p] == ';')&&(map[p+1] == 'a')&&(nSubCarriers < WBIN_MAX_SUBCARRIERS)){
+        const char* s = map + p + 2;
+        uint32_t sc;
+        if(!parseUInt(&s, map + dataOffset, &sc)){
+          sc = nSubCarriers;
+        }
+        subCarriers[nSubCarriers++] = sc;
+      }
+    }
+  }else{
+    setError("'%s' is not a recording of WirelessEye - unknown header", fileName);
+    close();
+    return false;
+  }
+  if((nSubCarriers == 0)||(nSubCarriers > WBIN_MAX_SUBCARRIERS)){
+    setError("'%s' has an invalid number of subcarriers (%u)", fileName, nSubCarriers);
+    close();
+    return false;
+  }
+  hasIndices = false;
+  for(uint32_t i = 0; i < nSubCarriers; i++){
+    hasIndices = (hasIndices)||(subCarriers[i] != i);
+  }
+  setRange(dataOffset, dataEnd);
+  return true;
+}
+
+void recordingReader::close(){
+  if(map != NULL){
+    munmap((void*) map, mapLen);
+    map = NULL;
+  }
+  if(fd >= 0){
+    ::close(fd);
+    fd = -1;
+  }
+  wbin.close();
+  mapLen = 0;
+  nSubCarriers = 0;
+  hasIndices = false;
+  dataOffset = 0;
+  dataEnd = 0;
+  pos = 0;
+  limit = 0;
+}
+
+const char* recordingReader::getError() const{
+  return errorMsg;
+}
+
+CSIRecordFormat recordingReader::getFormat() const{
+  return format;
+}
+
+uint32_t recordingReader::getNSubCarriers() const{
+  return nSubCarriers;
+}
+
+const uint16_t* recordingReader::getSubCarriers() const{
+  return (hasIndices) ? subCarriers : NULL;
+}
+
+size_t recordingReader::getFileSize() const{
+  return mapLen;
+}
+
+size_t recordingReader::nextLine(size_t p) const{
+  if(p >= mapLen){
+    return mapLen;
+  }
+  const char* nl = (const char*) memchr(map + p, '\n', mapLen - p);
+  if(nl == NULL){
+    return mapLen;
+  }
+  return (nl - map) + 1;
+}
+
+const char* recordingReader::parseFrameStart(size_t p, struct timespec_16bytes* t, uint8_t* MAC) const{
+  char buf[CSI_TIMESTAMP_STLEN + CSI_MAC_STLEN];
+  const char* s = map + p;
+  const char* end = map + mapLen;
+  uint32_t len = 0;
+  uint32_t nSeparators = 0;
+  uint32_t year, month, day, hour, min, sec, usec;
+  uint32_t m[6];
+  struct tm tm;
+
+  //copy "timestamp;MAC" into buf
+  while((s < end)&&(len < sizeof(buf) - 1)&&(*s != '\n')){
+    if(*s == ';'){
+      nSeparators++;
+      if(nSeparators == 2){
+        break;
+      }
+    }
+    buf[len++] = *s;
+    s++;
+  }
+  if(nSeparators != 2){
+    return NULL;
+  }
+  buf[len] = '\0';
+  if(sscanf(buf, "%u-%u-%u %u:%u:%u:%u;%x:%x:%x:%x:%x:%x", &year, &month, &day, &hour, &min, &sec, &usec, &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != 13){
+    return NULL;
+  }
+
+  //The hour is written with an offset of 1 by WirelessEye Studio. timegm() normalizes hour = -1.
+  memset(&tm, 0, sizeof(tm));
+  tm.tm_year = year - 1900;
+  tm.tm_mon = month - 1;
+  tm.tm_mday = day;
+  tm.tm_hour = hour - 1;
+  tm.tm_min = min;
+  tm.tm_sec = sec;
+  t->tv_sec = timegm(&tm);
+  t->tv_nsec = ((uint64_t) usec)*1000;
+  for(uint32_t i = 0; i < 6; i++){
+    MAC[i] = m[i];
+  }
+  return s + 1;
+}
+
+size_t recordingReader::skipFrame(size_t p) const{
+  if(format == CSI_FORMAT_BINARY){
+    return p + wbin.getFrameSize();
+  }else if(format == CSI_FORMAT_CSV_COMPACT){
+    return nextLine(p);
+  }
+
+  //simple CSV: a frame ends where the next line begins with the first subcarrier
+  size_t q = nextLine(p);
+  uint32_t sc;
+  while(q < mapLen){
+    if((parseSubCarrier(q, &sc))&&(sc == subCarriers[0])){
+      return q;
+    }
+    q = nextLine(q);
+  }
+  return mapLen;
+}
+
+bool recordingReader::parseSubCarrier(size_t q, uint32_t* sc) const{
+  //skip timestamp and MAC
+  const char* s = map + q;
+  const char* end = map + mapLen;
+  uint32_t nSeparators = 0;
+  while((s < end)&&(*s != '\n')&&(nSeparators < 2)){
+    if(*s == ';'){
+      nSeparators++;
+    }
+    s++;
+  }
+  return (nSeparators == 2)&&(parseUInt(&s, end, sc));
+}
+
+size_t recordingReader::alignToFrame(size_t p) const{
+  if(p <= dataOffset){
+    return dataOffset;
+  }
+  if(p >= dataEnd){
+    return dataEnd;
+  }
+  if(format == CSI_FORMAT_BINARY){
+    size_t frameSize = wbin.getFrameSize();
+    size_t idx = (p - dataOffset + frameSize - 1) / frameSize;
+    return dataOffset + idx*frameSize;
+  }
+  if(map[p-1] != '\n'){
+    p = nextLine(p);
+  }
+  if((format == CSI_FORMAT_CSV_SIMPLE)&&(p < dataEnd)){
+    //skipFrame() from the line before finds the next line starting with the first subcarrier
+    size_t lineBefore = p - 1;
+    while((lineBefore > dataOffset)&&(map[lineBefore-1] != '\n')){
+      lineBefore--;
+    }
+    p = skipFrame(lineBefore);
+  }
+  return p;
+}
+
+void recordingReader::getBlocks(uint32_t nBlocks, size_t* bounds) const{
+  size_t len = dataEnd - dataOffset;
+  bounds[0] = dataOffset;
+  for(uint32_t i = 1; i < nBlocks; i++){
+    bounds[i] = alignToFrame(dataOffset + (len / nBlocks) * i);
+    if(bounds[i] < bounds[i-1]){
+      bounds[i] = bounds[i-1];
+    }
+  }
+  bounds[nBlocks] = dataEnd;
+}
+
+size_t recordingReader::getWarmupStart(size_t begin, uint32_t nFrames) const{
+  size_t frameLen = skipFrame(dataOffset) - dataOffset;
+  if((frameLen == 0)||(begin <= dataOffset)||((begin - dataOffset) / frameLen <= nFrames)){
+    return dataOffset;
+  }
+  return alignToFrame(begin - nFrames*frameLen);
+}
+
+void recordingReader::setRange(size_t begin, size_t end){
+  pos = begin;
+  limit = (end < dataEnd) ? end : dataEnd;
+  if(format == CSI_FORMAT_BINARY){
+    wbin.adviseWillNeed((pos - dataOffset) / wbin.getFrameSize(), WBIN_DEFAULT_PREFETCH_BYTES / wbin.getFrameSize());
+  }
+}
+
+bool recordingReader::readFrame(CSIData* data, struct timespec_16bytes* t){
+  size_t next;
+  const char* s;
+  const char* end;
+  uint32_t sc;
+  uint32_t fc = 0;
+  bool ok;
+
+  while(pos < limit){
+    next = skipFrame(pos);
+
+    if(format == CSI_FORMAT_BINARY){
+      wbinFrameView frame = wbin.getFrame((pos - dataOffset) / wbin.getFrameSize());
+      if((next - dataOffset) % WBIN_DEFAULT_PREFETCH_BYTES < wbin.getFrameSize()){
+        wbin.adviseWillNeed((next - dataOffset) / wbin.getFrameSize(), WBIN_DEFAULT_PREFETCH_BYTES / wbin.getFrameSize());
+      }
+      pos = next;
+      t->tv_sec = frame.getSeconds();
+      t->tv_nsec = frame.getNanoseconds();
+      memcpy(data->senderMAC, frame.getMAC(), 6);
+      data->RSSI = frame.getRSSI();
+      data->frame_control = frame.getFrameControl();
+      frame.getAmplitudes().copyTo(data->amplitude);
+      frame.getPhases().copyTo(data->phase);
+      ok = true;
+    }else{
+      s = parseFrameStart(pos, t, data->senderMAC);
+      if(s == NULL){
+        printf("Warning: cannot parse timestamp or MAC at offset %zu - skipping frame\n", pos);
+        pos = next;
+        continue;
+      }
+      end = map + next;
+      if(format == CSI_FORMAT_CSV_COMPACT){
+        ok = parseDouble(&s, end, &data->RSSI) && parseUInt(&s, end, &fc);
+        for(uint32_t i = 0; (ok)&&(i < nSubCarriers); i++){
+          ok = parseDouble(&s, end, &data->amplitude[i]) && parseDouble(&s, end, &data->phase[i]);
+        }
+      }else{
+        //simple CSV: one line per subcarrier
+        ok = true;
+        for(uint32_t i = 0; (ok)&&(i < nSubCarriers); i++){
+          ok = parseUInt(&s, end, &sc) && (sc == subCarriers[i]) && parseDouble(&s, end, &data->amplitude[i]) && parseDouble(&s, end, &data->phase[i])
+               && parseDouble(&s, end, &data->RSSI) && parseUInt(&s, end, &fc);
+          if((ok)&&(i + 1 < nSubCarriers)){
+            //next line: skip timestamp and MAC, which are identical within the frame
+            s = (const char*) memchr(s, '\n', end - s);
+            if(s == NULL){
+              ok = false;
+            }else{
+              for(uint32_t n = 0; (s < end)&&(n < 2); s++){
+                if(*s == ';'){
+                  n++;
+                }
+              }
+            }
+          }
+        }
+      }
+      data->frame_control = fc;
+      if(!ok){
+        printf("Warning: malformed frame at offset %zu - skipping frame\n", pos);
+        pos = next;
+        continue;
+      }
+      pos = next;
+    }
+
+    //fill the remaining fields. Sequence number etc. are not part of any recording format.
+    time_t sec = (time_t) t->tv_sec;
+    gmtime_r(&sec, &(data->timeStamp));
+    data->senderMAC[6] = 1;             //the filters are called as for export, see DIFFERENT_MACS_IN_FILTER_FOR_DISPLAY_AND_LIVE_EXPORT in studio/src/networkThread.h
+    data->seqNr = 0;
+    data->streamNr = 0;
+    data->chanSpec = 0;
+    data->chipVersion = 0;
+    data->nSubCarriers = nSubCarriers;
+    data->nSubCarriers_orig = nSubCarriers;
+    return ok;
+  }
+  return false;
+}
@@ -0,0 +1,142 @@
+/*
+ * recordingReader.h
+ * Reads recordings of WirelessEye Studio in all formats (simple CSV, compact CSV and WifEyeBinary) frame by frame.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDINGREADER_H_
+#define RECORDINGREADER_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "CSIData.h"
+#include "CSIRecordFormat.h"
+#include "wbinReader.h"
+
+#define RECORDING_ERROR_STLEN 256               ///Maximum length of an error message
+#define RECORDING_FIELD_STLEN 64                ///Maximum length of a single numeric field in a CSV file
+
+/**
+ * \brief Frame-wise access to a recording.
+ *
+ * The file is mapped into memory. The format is detected from the file header. A recording can be split into blocks
+ * whose boundaries are aligned to the beginning of a frame, such that several processes can work on one file in parallel.
+ * Positions are byte offsets into the file.
+ */
+class recordingReader{
+private:
+  int fd;                                       ///File descriptor of the opened file (CSV formats only)
+  const char* map;                              ///Mapping of the entire file (CSV formats only)
+  size_t mapLen;                                ///Length of the mapping in bytes
+  wbinReader wbin;                              ///Reader for the WifEyeBinary format
+  CSIRecordFormat format;                       ///Format of the opened file
+  uint32_t nSubCarriers;                        ///Number of subcarriers per frame
+  uint16_t subCarriers[WBIN_MAX_SUBCARRIERS];   ///Native index of each subcarrier. 0...nSubCarriers-1 if the file does not contain them
+  bool hasIndices;                              ///True, if the subcarriers are not numbered from 0, i.e., a list of subcarriers was exported
+  size_t dataOffset;                            ///Offset of the first frame (= length of the file header)
+  size_t dataEnd;                               ///Position behind the last complete frame
+  size_t pos;                                   ///Current read position
+  size_t limit;                                 ///Reading stops at this position
+  char errorMsg[RECORDING_ERROR_STLEN];         ///Last error message
+
+  /**
+   * Store an error message that can be obtained via getError()
+   */
+  void setError(const char* fmt, ...);
+
+  /**
+   * Read the subcarrier index at the beginning of the simple CSV line at q, i.e., behind timestamp and MAC. Returns false if the line has none.
+   */
+  bool parseSubCarrier(size_t q, uint32_t* sc) const;
+
+  /**
+   * Returns the position of the first frame that starts at or after p.
+   */
+  size_t alignToFrame(size_t p) const;
+
+  /**
+   * Returns the position directly behind the line that contains p
+   */
+  size_t nextLine(size_t p) const;
+
+  /**
+   * Parse timestamp and MAC at the beginning of the line at p. Returns a pointer behind the second ';', or NULL on failure.
+   */
+  const char* parseFrameStart(size_t p, struct timespec_16bytes* t, uint8_t* MAC) const;
+
+  /**
+   * Returns the position behind the frame starting at p
+   */
+  size_t skipFrame(size_t p) const;
+
+public:
+  recordingReader();
+  ~recordingReader();
+
+  /**
+   * Open a recording and detect its format. Returns false on failure. The reason can then be obtained via getError().
+   */
+  bool open(const char* fileName);
+
+  /**
+   * Close the file
+   */
+  void close();
+
+  /**
+   * Returns the last error message
+   */
+  const char* getError() const;
+
+  /**
+   * Returns the format of the opened file
+   */
+  CSIRecordFormat getFormat() const;
+
+  /**
+   * Returns the number of subcarriers per frame
+   */
+  uint32_t getNSubCarriers() const;
+
+  /**
+   * Returns the native index of each subcarrier, or NULL if the subcarriers are numbered from 0
+   */
+  const uint16_t* getSubCarriers() const;
+
+  /**
+   * Returns the file size in bytes
+   */
+  size_t getFileSize() const;
+
+  /**
+   * Split the frames into nBlocks blocks of about the same size. bounds needs to hold nBlocks+1 positions.
+   * Block i ranges from bounds[i] to bounds[i+1]. Each block begins with a frame, but blocks can be empty.
+   */
+  void getBlocks(uint32_t nBlocks, size_t* bounds) const;
+
+  /**
+   * Returns the position of the frame about nFrames frames before the block boundary begin, but not before the first frame.
+   * The position is exact for WifEyeBinary. For the CSV formats, it is estimated from the length of the first frame.
+   */
+  size_t getWarmupStart(size_t begin, uint32_t nFrames) const;
+
+  /**
+   * Restrict reading to the range [begin, end). Both need to be block boundaries as obtained by getBlocks() or getWarmupStart().
+   */
+  void setRange(size_t begin, size_t end);
+
+  /**
+   * Read the next frame within the range set by setRange() into data and t.
+   * Returns false if there are no more frames. Malformed frames are skipped with a warning.
+   */
+  bool readFrame(CSIData* data, struct timespec_16bytes* t);
+};
+
+#endif /* RECORDINGREADER_H_ */
@@ -0,0 +1,225 @@
+/*
+ * wbinBenchmark.cpp
+ * Measures the throughput of wbinReader in GB/s.
+ *
+ * Usage: wbinBenchmark [-g sizeInMB] [-n nSubcarriers] [-r repetitions] [file.wbin]
+ *  - Without a file, a synthetic recording of the given size is generated in /tmp and removed afterwards.
+ *  - Each pass is repeated and the best result is reported. The first pass hence typically measures the page cache and not the disk.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include "wbinReader.h"
+
+#define DEFAULT_SIZE_MB 1024
+#define DEFAULT_NSUBCARRIERS 256
+#define DEFAULT_REPETITIONS 3
+
+/**
+ * Monotonic time in seconds
+ */
+static double now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Write a synthetic recording with the given size to fileName. Returns false on failure.
+ */
+static bool generateFile(const char* fileName, uint64_t sizeMB, uint32_t nSubCarriers){
+  FILE* f = fopen(fileName, "wb");
+  if(f == NULL){
+    perror("fopen");
+    return false;
+  }
+  size_t frameSize = WBIN_FRAME_HEADER_LEN + 2*sizeof(double)*nSubCarriers;
+  uint64_t nFrames = (sizeMB*1024*1024) / frameSize;
+  char* frame = (char*) malloc(frameSize);
+  uint8_t mac[6] = {0xca, 0xff, 0xee, 0x00, 0x00, 0x01};
+  uint64_t sec, nsec;
+  double value;
+
+  fwrite(WBIN_MAGIC, 1, WBIN_MAGIC_LEN, f);
+  fwrite(&nSubCarriers, sizeof(nSubCarriers), 1, f);
+  for(uint64_t i = 0; i < nFrames; i++){
+    sec = 1600000000 + i/1000;
+    nsec = (i % 1000) * 1000000;
+    memcpy(frame, &sec, 8);
+    memcpy(frame + 8, &nsec, 8);
+    mac[5] = i % 4;
+    memcpy(frame + 16, mac, 6);
+    value = -40.0 - (i % 20);
+    memcpy(frame + 22, &value, 8);
+    frame[30] = (char) 0x80;
+    for(uint32_t j = 0; j < nSubCarriers; j++){
+      value = sin(0.01*i + 0.1*j) + 1.0;
+      memcpy(frame + WBIN_FRAME_HEADER_LEN + 16*j, &value, 8);
+      value = 0.001*j;
+      memcpy(frame + WBIN_FRAME_HEADER_LEN + 16*j + 8, &value, 8);
+    }
+    if(fwrite(frame, 1, frameSize, f) != frameSize){
+      perror("fwrite");
+      free(frame);
+      fclose(f);
+      return false;
+    }
+  }
+  free(frame);
+  fclose(f);
+  return true;
+}
+
+/**
+ * Pass 1: Touch every value of every frame via the zero-copy iterator.
+ */
+static double passFull(wbinReader& reader, double* checksum){
+  double sum = 0;
+  for(wbinReader::iterator it = reader.begin(); it != reader.end(); ++it){
+    wbinFrameView frame = *it;
+    wbinValueSpan amplitudes = frame.getAmplitudes();
+    wbinValueSpan phases = frame.getPhases();
+    sum += frame.getRSSI();
+    for(uint32_t i = 0; i < amplitudes.size(); i++){
+      sum += amplitudes[i] + phases[i];
+    }
+  }
+  *checksum = sum;
+  return sum;
+}
+
+/**
+ * Pass 2: Only read the per-frame header data (timestamp, MAC, RSSI), e.g., to build an index.
+ */
+static double passHeaders(wbinReader& reader, double* checksum){
+  double sum = 0;
+  for(wbinReader::iterator it = reader.begin(); it != reader.end(); ++it){
+    wbinFrameView frame = *it;
+    sum += frame.getSeconds() + frame.getMAC()[5] + frame.getRSSI();
+  }
+  *checksum = sum;
+  return sum;
+}
+
+/**
+ * Baseline: fread() every frame into a buffer and copy the values into arrays, as done by simple parsers.
+ */
+static double passFread(const char* fileName, uint32_t nSubCarriers, double* checksum){
+  FILE* f = fopen(fileName, "rb");
+  size_t frameSize = WBIN_FRAME_HEADER_LEN + 2*sizeof(double)*nSubCarriers;
+  char* frame = (char*) malloc(frameSize);
+  double amplitudes[WBIN_MAX_SUBCARRIERS];
+  double phases[WBIN_MAX_SUBCARRIERS];
+  double rssi, sum = 0;
+  uint32_t n = 0;
+  fseek(f, WBIN_MAGIC_LEN, SEEK_SET);
+  if((fread(&n, sizeof(n), 1, f) == 1)&&((n & WBIN_INDEX_FLAG) != 0)){
+    fseek(f, nSubCarriers*sizeof(uint16_t), SEEK_CUR);
+  }
+  while(fread(frame, 1, frameSize, f) == frameSize){
+    memcpy(&rssi, frame + 22, 8);
+    for(uint32_t i = 0; i < nSubCarriers; i++){
+      memcpy(amplitudes + i, frame + WBIN_FRAME_HEADER_LEN + 16*i, 8);
+      memcpy(phases + i, frame + WBIN_FRAME_HEADER_LEN + 16*i + 8, 8);
+    }
+    sum += rssi;
+    for(uint32_t i = 0; i < nSubCarriers; i++){
+      sum += amplitudes[i] + phases[i];
+    }
+  }
+  free(frame);
+  fclose(f);
+  *checksum = sum;
+  return sum;
+}
+
+int main(int argc, char* argv[]){
+  uint64_t sizeMB = DEFAULT_SIZE_MB;
+  uint32_t nSubCarriers = DEFAULT_NSUBCARRIERS;
+  uint32_t repetitions = DEFAULT_REPETITIONS;
+  char fileName[512];
+  bool generated = false;
+  int opt;
+
+  strcpy(fileName, "");
+  while((opt = getopt(argc, argv, "g:n:r:h")) != -1){
+    switch(opt){
+      case 'g':
+        sizeMB = strtoull(optarg, NULL, 10);
+        break;
+      case 'n':
+        nSubCarriers = strtoul(optarg, NULL, 10);
+        break;
+      case 'r':
+        repetitions = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        printf("Usage: %s [-g sizeInMB] [-n nSubcarriers] [-r repetitions] [file.wbin]\n", argv[0]);
+        return 1;
+    }
+  }
+  if(repetitions == 0){
+    repetitions = 1;
+  }
+  if(optind < argc){
+    strncpy(fileName, argv[optind], sizeof(fileName) - 1);
+    fileName[sizeof(fileName) - 1] = '\0';
+  }else{
+    snprintf(fileName, sizeof(fileName), "/tmp/wbinBenchmark_%d.wbin", (int) getpid());
+    printf("Generating %" PRIu64 " MB synthetic recording with %u subcarriers in %s...\n", sizeMB, nSubCarriers, fileName);
+    if(!generateFile(fileName, sizeMB, nSubCarriers)){
+      return 1;
+    }
+    generated = true;
+  }
+
+  wbinReader reader;
+  if(!reader.open(fileName)){
+    printf("Error: %s\n", reader.getError());
+    return 1;
+  }
+  double gb = reader.getFileSize() / 1e9;
+  printf("%s: %" PRIu64 " frames, %u subcarriers, %.3f GB%s\n", fileName, reader.getNFrames(), reader.getNSubCarriers(), gb, reader.isTruncated() ? " (truncated)" : "");
+
+  double best[3] = {1e100, 1e100, 1e100};
+  double checksum[3] = {0, 0, 0};
+  double t;
+  for(uint32_t r = 0; r < repetitions; r++){
+    t = now();
+    passFull(reader, &checksum[0]);
+    t = now() - t;
+    if(t < best[0]) best[0] = t;
+
+    t = now();
+    passHeaders(reader, &checksum[1]);
+    t = now() - t;
+    if(t < best[1]) best[1] = t;
+
+    t = now();
+    passFread(fileName, reader.getNSubCarriers(), &checksum[2]);
+    t = now() - t;
+    if(t < best[2]) best[2] = t;
+  }
+
+  printf("mmap iterator, all values:  %8.3f GB/s  (%.0f frames/s, checksum %g)\n", gb/best[0], reader.getNFrames()/best[0], checksum[0]);
+  printf("mmap iterator, headers:     %8.3f GB/s  (%.0f frames/s, checksum %g)\n", gb/best[1], reader.getNFrames()/best[1], checksum[1]);
+  printf("fread + copy (baseline):    %8.3f GB/s  (%.0f frames/s, checksum %g)\n", gb/best[2], reader.getNFrames()/best[2], checksum[2]);
+
+  reader.close();
+  if(generated){
+    unlink(fileName);
+  }
+  return 0;
+}
@@ -0,0 +1,222 @@
+/*
+ * wbinReader.cpp
+ * A memory-mapped, zero-copy reader for recordings in the WirelessEye binary (.wbin) format.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wbinReader.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+wbinReader::wbinReader(){
+  fd = -1;
+  map = NULL;
+  mapLen = 0;
+  nSubCarriers = 0;
+  hasIndices = false;
+  headerLen = WBIN_FILE_HEADER_LEN;
+  frameSize = 0;
+  nFrames = 0;
+  truncated = false;
+  prefetchBytes = WBIN_DEFAULT_PREFETCH_BYTES;
+  strcpy(errorMsg, "");
+}
+
+wbinReader::~wbinReader(){
+  close();
+}
+
+void wbinReader::setError(const char* fmt, ...){
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(errorMsg, WBIN_ERROR_STLEN, fmt, args);
+  va_end(args);
+}
+
+bool wbinReader::open(const char* fileName){
+  struct stat st;
+  uint32_t n;
+
+  close();
+  fd = ::open(fileName, O_RDONLY);
+  if(fd < 0){
+    setError("cannot open '%s': %s", fileName, strerror(errno));
+    return false;
+  }
+  if(fstat(fd, &st) != 0){
+    setError("cannot stat '%s': %s", fileName, strerror(errno));
+    close();
+    return false;
+  }
+  if((size_t) st.st_size < WBIN_FILE_HEADER_LEN){
+    setError("'%s' is too short to be a WifEyeBinary file", fileName);
+    close();
+    return false;
+  }
+  mapLen = st.st_size;
+  map = (const char*) mmap(NULL, mapLen, PROT_READ, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED){
+    map = NULL;
+    mapLen = 0;
+    setError("cannot map '%s': %s", fileName, strerror(errno));
+    close();
+    return false;
+  }
+
+  //validate header
+  if(memcmp(map, WBIN_MAGIC, WBIN_MAGIC_LEN) != 0){
+    setError("'%s' does not start with \"%s\"", fileName, WBIN_MAGIC);
+    close();
+    return false;
+  }
+  memcpy(&n, map + WBIN_MAGIC_LEN, sizeof(n));
+  hasIndices = (n & WBIN_INDEX_FLAG) != 0;
+  n &= ~WBIN_INDEX_FLAG;
+  if((n == 0)||(n > WBIN_MAX_SUBCARRIERS)){
+    setError("'%s' has an invalid number of subcarriers (%u)", fileName, n);
+    close();
+    return false;
+  }
+  headerLen = WBIN_FILE_HEADER_LEN;
+  if(hasIndices){
+    headerLen += n*sizeof(uint16_t);
+    if(mapLen < headerLen){
+      setError("'%s' is too short to contain the indices of its subcarriers", fileName);
+      close();
+      return false;
+    }
+    memcpy(subCarriers, map + WBIN_FILE_HEADER_LEN, n*sizeof(uint16_t));
+  }
+  nSubCarriers = n;
+  frameSize = WBIN_FRAME_HEADER_LEN + 2*sizeof(double)*nSubCarriers;
+  nFrames = (mapLen - headerLen) / frameSize;
+  truncated = ((mapLen - headerLen) % frameSize) != 0;
+  return true;
+}
+
+void wbinReader::close(){
+  if(map != NULL){
+    munmap((void*) map, mapLen);
+    map = NULL;
+  }
+  if(fd >= 0){
+    ::close(fd);
+    fd = -1;
+  }
+  mapLen = 0;
+  nSubCarriers = 0;
+  hasIndices = false;
+  headerLen = WBIN_FILE_HEADER_LEN;
+  frameSize = 0;
+  nFrames = 0;
+  truncated = false;
+}
+
+bool wbinReader::isOpen() const{
+  return map != NULL;
+}
+
+const char* wbinReader::getError() const{
+  return errorMsg;
+}
+
+uint32_t wbinReader::getNSubCarriers() const{
+  return nSubCarriers;
+}
+
+const uint16_t* wbinReader::getSubCarriers() const{
+  return (hasIndices) ? subCarriers : NULL;
+}
+
+size_t wbinReader::getHeaderLen() const{
+  return headerLen;
+}
+
+uint64_t wbinReader::getNFrames() const{
+  return nFrames;
+}
+
+size_t wbinReader::getFrameSize() const{
+  return frameSize;
+}
+
+size_t wbinReader::getFileSize() const{
+  return mapLen;
+}
+
+bool wbinReader::isTruncated() const{
+  return truncated;
+}
+
+/**
+ * madvise() needs page-aligned addresses. This helper aligns the range [begin, begin+len) accordingly and clips it to the mapping.
+ */
+static void adviseRange(const char* map, size_t mapLen, size_t begin, size_t len, int advice){
+  static size_t pageSize = sysconf(_SC_PAGESIZE);
+  if((map == NULL)||(begin >= mapLen)){
+    return;
+  }
+  if(begin + len > mapLen){
+    len = mapLen - begin;
+  }
+  size_t alignedBegin = begin - (begin % pageSize);
+  madvise((void*) (map + alignedBegin), len + (begin - alignedBegin), advice);
+}
+
+wbinFrameView wbinReader::getFrame(uint64_t idx) const{
+  return wbinFrameView(map + headerLen + idx*frameSize, nSubCarriers);
+}
+
+wbinReader::iterator wbinReader::begin() const{
+  if(map == NULL){
+    return iterator(this, NULL);
+  }
+  if(prefetchBytes > 0){
+    adviseRange(map, mapLen, 0, prefetchBytes, MADV_WILLNEED);
+  }
+  return iterator(this, map + headerLen);
+}
+
+wbinReader::iterator wbinReader::end() const{
+  if(map == NULL){
+    return iterator(this, NULL);
+  }
+  return iterator(this, map + headerLen + nFrames*frameSize);
+}
+
+void wbinReader::setPrefetchWindow(size_t bytes){
+  prefetchBytes = bytes;
+}
+
+void wbinReader::adviseSequential() const{
+  if(map != NULL){
+    madvise((void*) map, mapLen, MADV_SEQUENTIAL);
+  }
+}
+
+void wbinReader::adviseWillNeed(uint64_t firstFrame, uint64_t count) const{
+  adviseRange(map, mapLen, headerLen + firstFrame*frameSize, count*frameSize, MADV_WILLNEED);
+}
+
+void wbinReader::adviseDontNeed(uint64_t firstFrame, uint64_t count) const{
+  adviseRange(map, mapLen, headerLen + firstFrame*frameSize, count*frameSize, MADV_DONTNEED);
+}
+
+const char* wbinReader::prefetch(const char* pos) const{
+  //We request the window behind the one that is currently being read, such that the kernel can fetch it while we process the current one.
+  size_t offset = pos - map;
+  adviseRange(map, mapLen, offset + prefetchBytes, prefetchBytes, MADV_WILLNEED);
+  return pos + prefetchBytes;
+}
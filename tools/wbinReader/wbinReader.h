@@ -0,0 +1,353 @@
+/*
+ * wbinReader.h
+ * A memory-mapped, zero-copy reader for recordings in the WirelessEye binary (.wbin) format.
+ *
+ *  Oct. 2026
+ *
+ *  This file is part of WirelessEye.
+ *
+ *  WirelessEye is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *  WirelessEye is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License along with WirelessEye. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef WBINREADER_H_
+#define WBINREADER_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <iterator>
+
+#define WBIN_MAGIC "WifEyeBinary"                       ///The first 12 bytes of every .wbin file
+#define WBIN_MAGIC_LEN 12                               ///Length of WBIN_MAGIC without the terminating zero
+#define WBIN_FILE_HEADER_LEN (WBIN_MAGIC_LEN + 4)       ///Magic value + number of subcarriers as uint32_t. Followed by the subcarrier indices if WBIN_INDEX_FLAG is set
+#define WBIN_INDEX_FLAG 0x80000000                      ///Set in the number of subcarriers if it is followed by the native index of each subcarrier as uint16_t
+#define WBIN_FRAME_HEADER_LEN (16 + 6 + 8 + 1)          ///timespec_16bytes + MAC + RSSI (double) + frame control
+#define WBIN_MAX_SUBCARRIERS 512                        ///Same limit as CSIData::amplitude[] in studio/src/CSIData.h
+#define WBIN_DEFAULT_PREFETCH_BYTES (4*1024*1024)       ///The iterator asks the kernel to read ahead this many bytes of the mapping
+#define WBIN_ERROR_STLEN 256                            ///Maximum length of an error message
+
+/**
+ * \brief A view on the amplitudes or the phases of one frame.
+ *
+ * In a .wbin file, amplitude and phase of each subcarrier are stored as interleaved pairs of doubles, and a frame
+ * starts at an odd offset. Hence, the values are neither contiguous nor aligned. This class provides indexed access
+ * directly into the mapped file without copying the frame.
+ */
+class wbinValueSpan{
+private:
+  const char* base;                     ///Pointer to the first value within the mapping
+  uint32_t n;                           ///Number of values (= number of subcarriers)
+
+public:
+  wbinValueSpan(const char* base, uint32_t n){
+    this->base = base;
+    this->n = n;
+  }
+
+  /**
+   * Returns the number of values in this span.
+   */
+  uint32_t size() const{
+    return n;
+  }
+
+  /**
+   * Returns the value of subcarrier i. No bounds are checked.
+   */
+  double operator[](uint32_t i) const{
+    double value;
+    memcpy(&value, base + 2*sizeof(double)*i, sizeof(double));     //unaligned load
+    return value;
+  }
+
+  /**
+   * Copies all values into the contiguous array dest, which must have space for size() values.
+   */
+  void copyTo(double* dest) const{
+    for(uint32_t i = 0; i < n; i++){
+      memcpy(dest + i, base + 2*sizeof(double)*i, sizeof(double));
+    }
+  }
+};
+
+/**
+ * \brief A view on one frame of a .wbin file.
+ *
+ * The view only holds a pointer into the memory mapping, it is valid as long as the wbinReader it has been obtained from is open.
+ */
+class wbinFrameView{
+private:
+  const char* ptr;                      ///Start of the frame within the mapping
+  uint32_t nSubCarriers;                ///Number of subcarriers per frame
+
+  uint64_t readU64(uint32_t offset) const{
+    uint64_t value;
+    memcpy(&value, ptr + offset, sizeof(value));
+    return value;
+  }
+
+public:
+  wbinFrameView(const char* ptr, uint32_t nSubCarriers){
+    this->ptr = ptr;
+    this->nSubCarriers = nSubCarriers;
+  }
+
+  /**
+   * Seconds of the timestamp (tv_sec of struct timespec_16bytes)
+   */
+  uint64_t getSeconds() const{
+    return readU64(0);
+  }
+
+  /**
+   * Nanoseconds of the timestamp (tv_nsec of struct timespec_16bytes)
+   */
+  uint64_t getNanoseconds() const{
+    return readU64(8);
+  }
+
+  /**
+   * Pointer to the 6 bytes of the sender MAC address
+   */
+  const uint8_t* getMAC() const{
+    return (const uint8_t*) (ptr + 16);
+  }
+
+  /**
+   * RSSI of the frame
+   */
+  double getRSSI() const{
+    double rssi;
+    memcpy(&rssi, ptr + 22, sizeof(rssi));
+    return rssi;
+  }
+
+  /**
+   * Frame control field
+   */
+  uint8_t getFrameControl() const{
+    return (uint8_t) ptr[30];
+  }
+
+  /**
+   * Number of subcarriers in this frame
+   */
+  uint32_t getNSubCarriers() const{
+    return nSubCarriers;
+  }
+
+  /**
+   * The CSI amplitudes of all subcarriers
+   */
+  wbinValueSpan getAmplitudes() const{
+    return wbinValueSpan(ptr + WBIN_FRAME_HEADER_LEN, nSubCarriers);
+  }
+
+  /**
+   * The CSI phases of all subcarriers
+   */
+  wbinValueSpan getPhases() const{
+    return wbinValueSpan(ptr + WBIN_FRAME_HEADER_LEN + sizeof(double), nSubCarriers);
+  }
+
+  /**
+   * Pointer to the raw bytes of this frame within the mapping
+   */
+  const char* getRawData() const{
+    return ptr;
+  }
+};
+
+/**
+ * \brief Reads a .wbin file via mmap().
+ *
+ * The header ("WifEyeBinary" + number of subcarriers, optionally followed by their indices) is validated when opening the file. The frames can then be accessed
+ * either by index (getFrame()) or by a forward iterator. Nothing is copied - all frames are views into the mapping.
+ * The iterator issues read-ahead hints to the kernel (madvise(MADV_WILLNEED)) for the next prefetch window, and prefetches the next frame into the CPU cache.
+ *
+ * Example:
+ *   wbinReader r;
+ *   if(r.open("capture.wbin")){
+ *     for(wbinReader::iterator it = r.begin(); it != r.end(); ++it){
+ *       printf("%f\n", (*it).getAmplitudes()[10]);
+ *     }
+ *   }
+ */
+class wbinReader{
+private:
+  int fd;                               ///File descriptor of the opened file. -1 if no file is open
+  const char* map;                      ///Start of the memory mapping
+  size_t mapLen;                        ///Length of the mapping (= file size)
+  uint32_t nSubCarriers;                ///Number of subcarriers as read from the header
+  uint16_t subCarriers[WBIN_MAX_SUBCARRIERS];   ///Native indices of the subcarriers as read from the header
+  bool hasIndices;                      ///True, if the header contains the indices
+  size_t headerLen;                     ///Length of the file header, i.e., offset of the first frame
+  size_t frameSize;                     ///Number of bytes per frame
+  uint64_t nFrames;                     ///Number of complete frames in the file
+  bool truncated;                       ///True, if the file ends with an incomplete frame (e.g., recording was interrupted)
+  size_t prefetchBytes;                 ///Size of the read-ahead window of the iterator in bytes. 0 disables the hints
+  char errorMsg[WBIN_ERROR_STLEN];      ///Description of the last error
+
+  /**
+   * Store a printf-like error message that can be read via getError()
+   */
+  void setError(const char* fmt, ...);
+
+public:
+
+  /**
+   * \brief A forward iterator over all frames of the file
+   */
+  class iterator{
+  private:
+    const wbinReader* reader;           ///The reader this iterator belongs to
+    const char* ptr;                    ///Current frame
+    const char* nextHint;               ///When ptr reaches this address, the next read-ahead hint is issued
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef wbinFrameView value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const wbinFrameView* pointer;
+    typedef wbinFrameView reference;
+
+    iterator(const wbinReader* reader, const char* ptr){
+      this->reader = reader;
+      this->ptr = ptr;
+      this->nextHint = ptr;
+    }
+
+    wbinFrameView operator*() const{
+      return wbinFrameView(ptr, reader->nSubCarriers);
+    }
+
+    iterator& operator++(){
+      ptr += reader->frameSize;
+      __builtin_prefetch(ptr + reader->frameSize);
+      if((reader->prefetchBytes > 0)&&(ptr >= nextHint)){
+        nextHint = reader->prefetch(ptr);
+      }
+      return *this;
+    }
+
+    iterator operator++(int){
+      iterator old = *this;
+      ++(*this);
+      return old;
+    }
+
+    bool operator==(const iterator& other) const{
+      return ptr == other.ptr;
+    }
+
+    bool operator!=(const iterator& other) const{
+      return ptr != other.ptr;
+    }
+  };
+
+  wbinReader();
+  ~wbinReader();
+
+  /**
+   * Open and map the file fileName, and validate its header.
+   * Returns false on failure. A description of the failure can then be obtained via getError().
+   */
+  bool open(const char* fileName);
+
+  /**
+   * Unmap and close the file. All frame views obtained from this reader become invalid.
+   */
+  void close();
+
+  /**
+   * Returns true, if a file is open
+   */
+  bool isOpen() const;
+
+  /**
+   * Returns a description of the most recent error
+   */
+  const char* getError() const;
+
+  /**
+   * Returns the number of subcarriers per frame
+   */
+  uint32_t getNSubCarriers() const;
+
+  /**
+   * Returns the native index of each subcarrier, i.e., its index in the frames as received from Nexmon, or NULL if the file does not contain them
+   * (then, the subcarriers are numbered from 0)
+   */
+  const uint16_t* getSubCarriers() const;
+
+  /**
+   * Returns the number of complete frames in the file
+   */
+  uint64_t getNFrames() const;
+
+  /**
+   * Returns the number of bytes per frame
+   */
+  size_t getFrameSize() const;
+
+  /**
+   * Returns the length of the file header, i.e., the offset of the first frame
+   */
+  size_t getHeaderLen() const;
+
+  /**
+   * Returns the size of the file in bytes
+   */
+  size_t getFileSize() const;
+
+  /**
+   * Returns true, if the file ends with an incomplete frame. The incomplete frame is ignored.
+   */
+  bool isTruncated() const;
+
+  /**
+   * Returns a view on frame number idx. idx must be smaller than getNFrames().
+   */
+  wbinFrameView getFrame(uint64_t idx) const;
+
+  /**
+   * Iterator to the first frame
+   */
+  iterator begin() const;
+
+  /**
+   * Iterator behind the last complete frame
+   */
+  iterator end() const;
+
+  /**
+   * Set the size of the read-ahead window used by the iterator. 0 disables read-ahead hints.
+   */
+  void setPrefetchWindow(size_t bytes);
+
+  /**
+   * Tell the kernel that the file will be read sequentially (MADV_SEQUENTIAL). Useful for single-pass tools.
+   */
+  void adviseSequential() const;
+
+  /**
+   * Tell the kernel that the frames [firstFrame, firstFrame + count) will be needed soon (MADV_WILLNEED).
+   */
+  void adviseWillNeed(uint64_t firstFrame, uint64_t count) const;
+
+  /**
+   * Tell the kernel that the frames [firstFrame, firstFrame + count) will not be needed again (MADV_DONTNEED). This keeps the resident
+   * set small when processing files larger than the main memory.
+   */
+  void adviseDontNeed(uint64_t firstFrame, uint64_t count) const;
+
+  /**
+   * Issue a read-ahead hint for the window starting at pos. Returns the address at which the next hint should be issued.
+   * Used by the iterator.
+   */
+  const char* prefetch(const char* pos) const;
+};
+
+#endif /* WBINREADER_H_ */